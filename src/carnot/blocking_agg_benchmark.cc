@@ -26,6 +26,7 @@
 #include <sole.hpp>
 
 #include "src/carnot/carnot.h"
+#include "src/carnot/exec/agg_node.h"
 #include "src/carnot/exec/local_grpc_result_server.h"
 #include "src/carnot/exec/test_utils.h"
 #include "src/carnot/funcs/funcs.h"
@@ -65,6 +66,14 @@ df = df.groupby(['col0', 'col1']).agg(sum=('col2', px.sum))
 px.display(df, '$0')
 )pxl";
 
+constexpr char kGroupByOneMultipleAggsQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='test_table', select=['col0', 'col1'])
+df = df.groupby('col0').agg(sum=('col1', px.sum), count=('col1', px.count),
+                            mean=('col1', px.mean), max=('col1', px.max))
+px.display(df, '$0')
+)pxl";
+
 std::unique_ptr<Carnot> SetUpCarnot(std::shared_ptr<table_store::TableStore> table_store,
                                     LocalGRPCResultSinkServer* server) {
   auto func_registry = std::make_unique<px::carnot::udf::Registry>("default_registry");
@@ -130,6 +139,21 @@ void BM_Query_Int(benchmark::State& state, std::vector<types::DataType> types,
   BM_Query(state, types, distribution_types, query, num_batches, default_params, default_params);
 }
 
+// Runs the query with the group by aggregates computed either by the vectorized hash table, or by
+// per group UDAs.
+// NOLINTNEXTLINE : runtime/references.
+void BM_Query_Vectorized(benchmark::State& state, bool vectorized,
+                         std::vector<types::DataType> types,
+                         std::vector<datagen::DistributionType> distribution_types,
+                         const std::string& query, int64_t num_batches,
+                         const datagen::DistributionParams* dist_vars,
+                         const datagen::DistributionParams* len_vars) {
+  bool prev_vectorized = FLAGS_carnot_vectorized_agg;
+  FLAGS_carnot_vectorized_agg = vectorized;
+  BM_Query(state, types, distribution_types, query, num_batches, dist_vars, len_vars);
+  FLAGS_carnot_vectorized_agg = prev_vectorized;
+}
+
 const std::unique_ptr<const datagen::DistributionParams> sample_selection_params =
     std::make_unique<const datagen::ZipfianParams>(2, 2, 999);
 const std::unique_ptr<const datagen::DistributionParams> sample_length_params =
@@ -198,6 +222,42 @@ BENCHMARK_CAPTURE(BM_Query_Int, eval_group_by_one_exponential_int,
     ->RangeMultiplier(2)
     ->Range(1, 1 << 16);
 
+// High cardinality group by tests, with and without the vectorized hash table.
+const std::unique_ptr<const datagen::DistributionParams> high_cardinality_selection_params =
+    std::make_unique<const datagen::UniformParams>(0, 1 << 16);
+const std::unique_ptr<const datagen::DistributionParams> short_length_params =
+    std::make_unique<const datagen::UniformParams>(8, 32);
+
+BENCHMARK_CAPTURE(BM_Query_Vectorized, eval_group_by_one_high_cardinality_int_vectorized, true,
+                  {types::DataType::INT64, types::DataType::INT64},
+                  {datagen::DistributionType::kUniform, datagen::DistributionType::kUniform},
+                  kGroupByOneMultipleAggsQuery, 20, nullptr, nullptr)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+BENCHMARK_CAPTURE(BM_Query_Vectorized, eval_group_by_one_high_cardinality_int_udas, false,
+                  {types::DataType::INT64, types::DataType::INT64},
+                  {datagen::DistributionType::kUniform, datagen::DistributionType::kUniform},
+                  kGroupByOneMultipleAggsQuery, 20, nullptr, nullptr)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+BENCHMARK_CAPTURE(BM_Query_Vectorized, eval_group_by_one_high_cardinality_string_vectorized, true,
+                  {types::DataType::STRING, types::DataType::INT64},
+                  {datagen::DistributionType::kUniform, datagen::DistributionType::kUniform},
+                  kGroupByOneMultipleAggsQuery, 20, high_cardinality_selection_params.get(),
+                  short_length_params.get())
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+BENCHMARK_CAPTURE(BM_Query_Vectorized, eval_group_by_one_high_cardinality_string_udas, false,
+                  {types::DataType::STRING, types::DataType::INT64},
+                  {datagen::DistributionType::kUniform, datagen::DistributionType::kUniform},
+                  kGroupByOneMultipleAggsQuery, 20, high_cardinality_selection_params.get(),
+                  short_length_params.get())
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -16,8 +16,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+
+#include <absl/time/clock.h>
 
 #include "src/carnot/carnot.h"
 #include "src/carnot/carnotpb/carnot.grpc.pb.h"
@@ -25,6 +30,7 @@
 #include "src/carnot/engine_state.h"
 #include "src/carnot/exec/exec_graph.h"
 #include "src/carnot/exec/grpc_router.h"
+#include "src/carnot/exec/plan_result_cache.h"
 #include "src/carnot/funcs/builtins/builtins.h"
 #include "src/carnot/plan/operators.h"
 #include "src/carnot/plan/plan.h"
@@ -35,6 +41,11 @@
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/table_store.h"
 
+DEFINE_int32(carnot_max_exec_parallelism,
+             gflags::Int32FromEnv("PL_CARNOT_MAX_EXEC_PARALLELISM", 16),
+             "The maximum number of threads a query may request to execute each plan fragment "
+             "with, see PlanOptions.exec_parallelism.");
+
 namespace px {
 namespace carnot {
 
@@ -70,6 +81,18 @@ class CarnotImpl final : public Carnot {
   Status RegisterUDFs(exec::ExecState* exec_state, plan::Plan* plan);
 
   Status RegisterUDFsInPlanFragment(exec::ExecState* exec_state, plan::PlanFragment* pf);
+
+  /**
+   * Executes the plan fragment of a cacheable plan (see PlanResultCache). The time buckets of the
+   * plan's window whose results aren't cached are executed on their own, after which the sinks of
+   * exec_graph consume the results of all of the buckets.
+   */
+  Status ExecuteWithResultCache(const planpb::Plan& logical_plan,
+                                const exec::PlanResultCache::CacheablePlan& cacheable_plan,
+                                plan::PlanState* plan_state, exec::ExecState* exec_state,
+                                int32_t exec_parallelism, exec::ExecutionGraph* exec_graph,
+                                int64_t* bytes_processed, int64_t* rows_processed);
+
   Status WalkExpression(exec::ExecState* exec_state, const plan::ScalarExpression& expr);
   /**
    * Returns the Table Store.
@@ -90,6 +113,8 @@ class CarnotImpl final : public Carnot {
   AgentMetadataCallbackFunc agent_md_callback_;
   planner::compiler::Compiler compiler_;
   std::unique_ptr<EngineState> engine_state_;
+  // Null if the cache is disabled.
+  std::unique_ptr<exec::PlanResultCache> result_cache_;
 
   std::unique_ptr<std::thread> grpc_server_thread_;
   std::unique_ptr<grpc::Server> grpc_server_;
@@ -116,6 +141,10 @@ Status CarnotImpl::Init(const sole::uuid& agent_id, std::unique_ptr<udf::Registr
                                                  clients_config_->stub_generator,
                                                  clients_config_->add_auth_to_grpc_context_func,
                                                  &server_config_->grpc_router));
+  if (FLAGS_carnot_result_cache_max_bytes > 0) {
+    result_cache_ = std::make_unique<exec::PlanResultCache>(
+        FLAGS_carnot_result_cache_max_bytes, absl::Seconds(FLAGS_carnot_result_cache_ttl_seconds));
+  }
   return Status::OK();
 }
 
@@ -174,6 +203,8 @@ Status CarnotImpl::RegisterUDFsInPlanFragment(exec::ExecState* exec_state, plan:
       .OnMemorySource(no_op)
       .OnUnion(no_op)
       .OnJoin(no_op)
+      .OnSort(no_op)
+      .OnTopK(no_op)
       .OnGRPCSource(no_op)
       .OnGRPCSink(no_op)
       .OnUDTFSource(no_op)
@@ -316,6 +347,81 @@ Status InitiateOutgoingConns(
                                                 std::move(req));
 }
 
+Status CarnotImpl::ExecuteWithResultCache(
+    const planpb::Plan& logical_plan, const exec::PlanResultCache::CacheablePlan& cacheable_plan,
+    plan::PlanState* plan_state, exec::ExecState* exec_state, int32_t exec_parallelism,
+    exec::ExecutionGraph* exec_graph, int64_t* bytes_processed, int64_t* rows_processed) {
+  using exec::PlanResultCache;
+  auto now = absl::Now();
+  auto segments = PlanResultCache::SplitWindow(
+      cacheable_plan.start_time, cacheable_plan.stop_time, FLAGS_carnot_result_cache_bucket_ns,
+      absl::ToUnixNanos(now - absl::Seconds(FLAGS_carnot_result_cache_settle_seconds)));
+  auto* table =
+      exec_state->table_store()->GetTable(cacheable_plan.table_name, cacheable_plan.tablet);
+
+  std::vector<std::shared_ptr<const PlanResultCache::SinkResults>> segment_results;
+  for (const auto& segment : segments) {
+    // Cached results whose rows may have been expired from the table since are executed again.
+    if (segment.cacheable && table != nullptr &&
+        PlanResultCache::TableHoldsSegment(*table, segment)) {
+      auto cached = result_cache_->Get(cacheable_plan.key, segment, now);
+      if (cached != nullptr) {
+        segment_results.push_back(std::move(cached));
+        continue;
+      }
+    }
+
+    plan::Plan segment_plan;
+    PL_RETURN_IF_ERROR(segment_plan.Init(PlanResultCache::WithTimeRange(
+        logical_plan, segment.start_time, segment.stop_time)));
+    auto schema = std::make_unique<table_store::schema::Schema>();
+    exec::ExecutionGraph segment_graph;
+    segment_graph.set_capture_sink_results(true);
+    PL_RETURN_IF_ERROR(plan::PlanWalker()
+                           .OnPlanFragment([&](auto* pf) {
+                             PL_RETURN_IF_ERROR(segment_graph.Init(
+                                 schema.get(), plan_state, exec_state, pf,
+                                 /* collect_exec_node_stats */ false,
+                                 exec::kDefaultConsecutiveGenerateCallsPerSource,
+                                 exec_parallelism));
+                             return segment_graph.Execute();
+                           })
+                           .Walk(&segment_plan));
+    auto exec_stats = segment_graph.GetStats();
+    *bytes_processed += exec_stats.bytes_processed;
+    *rows_processed += exec_stats.rows_processed;
+
+    auto results =
+        std::make_shared<PlanResultCache::SinkResults>(segment_graph.TakeSinkResults());
+    if (segment.cacheable) {
+      result_cache_->Put(cacheable_plan.key, segment, *results, now);
+    }
+    segment_results.push_back(std::move(results));
+  }
+  VLOG(1) << absl::Substitute("Executed plan with $0 segments, result cache hits: $1, bytes: $2",
+                              segments.size(), result_cache_->hits(), result_cache_->bytes());
+
+  // The sinks consume the results of the segments in time order, with a single end of stream.
+  PlanResultCache::SinkResults results;
+  for (const auto& sink_results : segment_results) {
+    for (const auto& [sink_id, row_batches] : *sink_results) {
+      auto& sink_row_batches = results[sink_id];
+      for (const auto& rb : row_batches) {
+        sink_row_batches.push_back(rb);
+        sink_row_batches.back().set_eow(false);
+        sink_row_batches.back().set_eos(false);
+      }
+    }
+  }
+  for (auto& [sink_id, row_batches] : results) {
+    if (!row_batches.empty()) {
+      row_batches.back().set_eow(true);
+      row_batches.back().set_eos(true);
+    }
+  }
+  return exec_graph->ExecuteSinks(results);
+}
+
 Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uuid& query_id,
                                bool analyze) {
   auto timer = ElapsedTimer();
@@ -337,6 +443,7 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
   if (metadata_state) {
     exec_state->set_metadata_state(metadata_state);
   }
+  exec_state->set_grpc_row_batch_encoding(logical_plan.plan_options().grpc_row_batch_encoding());
 
   PL_RETURN_IF_ERROR(RegisterUDFs(exec_state.get(), &plan));
 
@@ -349,14 +456,37 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
   // Unclear how we'll use plan fragments in the future (they're currently unused). For now, we will
   // share the schema between plan fragments.
   auto schema = std::make_unique<table_store::schema::Schema>();
+  int32_t exec_parallelism = std::clamp(logical_plan.plan_options().exec_parallelism(), 1,
+                                        std::max(1, FLAGS_carnot_max_exec_parallelism));
   std::vector<statuspb::Status> incoming_errors;
+
+  // Plans that are executed repeatedly reuse the cached results of the time buckets of their
+  // window. Analyzed queries are always executed in full, so that their stats are complete.
+  std::optional<exec::PlanResultCache::CacheablePlan> cacheable_plan;
+  if (result_cache_ != nullptr && !analyze) {
+    cacheable_plan =
+        exec::PlanResultCache::GetCacheablePlan(logical_plan, *engine_state_->func_registry());
+    if (cacheable_plan.has_value() &&
+        !result_cache_->RecordExecution(cacheable_plan->key, absl::Now())) {
+      cacheable_plan.reset();
+    }
+  }
+
   auto s =
       plan::PlanWalker()
           .OnPlanFragment([&](auto* pf) {
             auto exec_graph = exec::ExecutionGraph();
             PL_RETURN_IF_ERROR(exec_graph.Init(schema.get(), plan_state.get(), exec_state.get(), pf,
-                                               /* collect_exec_node_stats */ analyze));
-            PL_RETURN_IF_ERROR(exec_graph.Execute());
+                                               /* collect_exec_node_stats */ analyze,
+                                               exec::kDefaultConsecutiveGenerateCallsPerSource,
+                                               exec_parallelism));
+            if (cacheable_plan.has_value()) {
+              PL_RETURN_IF_ERROR(ExecuteWithResultCache(
+                  logical_plan, *cacheable_plan, plan_state.get(), exec_state.get(),
+                  exec_parallelism, &exec_graph, &bytes_processed, &rows_processed));
+            } else {
+              PL_RETURN_IF_ERROR(exec_graph.Execute());
+            }
 
             // We must get this while exec_graph is alive. ExecutionGraph destructor calls
             // GRPCRouter::DeleteQuery() which would delete this data.
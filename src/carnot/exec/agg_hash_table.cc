@@ -0,0 +1,630 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/agg_hash_table.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include <absl/hash/hash.h>
+
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+template <types::DataType DT>
+using ArrowArray = typename types::DataTypeTraits<DT>::arrow_array_type;
+template <types::DataType DT>
+using ArrowBuilder = typename types::DataTypeTraits<DT>::arrow_builder_type;
+template <types::DataType DT>
+using NativeType = typename types::DataTypeTraits<DT>::native_type;
+
+// Returns the index in the columns of the i-th row of a batch.
+inline int64_t RowIndex(const std::vector<int64_t>* selection, size_t i) {
+  return selection == nullptr ? i : (*selection)[i];
+}
+
+size_t FixedKeySize(types::DataType type) {
+  switch (type) {
+    case types::DataType::BOOLEAN:
+      return sizeof(bool);
+    case types::DataType::INT64:
+    case types::DataType::TIME64NS:
+      return sizeof(int64_t);
+    case types::DataType::FLOAT64:
+      return sizeof(double);
+    case types::DataType::UINT128:
+      return sizeof(absl::uint128);
+    default:
+      return 0;
+  }
+}
+
+// Copies the fixed size values of a group column into the keys of the batch.
+template <types::DataType DT>
+void PackFixedSizeColumn(const arrow::Array* arr, const std::vector<int64_t>* selection,
+                         char* keys, std::vector<size_t>* pos) {
+  auto* typed = static_cast<const ArrowArray<DT>*>(arr);
+  for (size_t i = 0; i < pos->size(); ++i) {
+    NativeType<DT> value = typed->Value(RowIndex(selection, i));
+    std::memcpy(keys + (*pos)[i], &value, sizeof(value));
+    (*pos)[i] += sizeof(value);
+  }
+}
+
+void PackStringColumn(const arrow::Array* arr, const std::vector<int64_t>* selection, char* keys,
+                      std::vector<size_t>* pos) {
+  auto* typed = static_cast<const arrow::StringArray*>(arr);
+  for (size_t i = 0; i < pos->size(); ++i) {
+    auto value = typed->GetView(RowIndex(selection, i));
+    uint32_t size = value.size();
+    std::memcpy(keys + (*pos)[i], &size, sizeof(size));
+    std::memcpy(keys + (*pos)[i] + sizeof(size), value.data(), size);
+    (*pos)[i] += sizeof(size) + size;
+  }
+}
+
+// Appends a group value from a packed key, and advances the key past it.
+template <types::DataType DT>
+arrow::Status UnpackFixedSizeValue(arrow::ArrayBuilder* builder, std::string_view* key) {
+  NativeType<DT> value;
+  std::memcpy(&value, key->data(), sizeof(value));
+  key->remove_prefix(sizeof(value));
+  return static_cast<ArrowBuilder<DT>*>(builder)->Append(value);
+}
+
+arrow::Status UnpackStringValue(arrow::ArrayBuilder* builder, std::string_view* key) {
+  uint32_t size;
+  std::memcpy(&size, key->data(), sizeof(size));
+  key->remove_prefix(sizeof(size));
+  auto status = static_cast<arrow::StringBuilder*>(builder)->Append(key->data(), size);
+  key->remove_prefix(size);
+  return status;
+}
+
+// Applies `update` to the state of the group of every row, with the row's value.
+template <types::DataType DT, typename TState, typename TUpdate>
+void UpdateGroups(const arrow::Array* arr, const std::vector<int64_t>* selection,
+                  const std::vector<uint32_t>& groups, std::vector<TState>* states,
+                  TUpdate update) {
+  auto* typed = static_cast<const ArrowArray<DT>*>(arr);
+  TState* data = states->data();
+  if (selection == nullptr) {
+    for (size_t i = 0; i < groups.size(); ++i) {
+      update(&data[groups[i]], typed->Value(i));
+    }
+    return;
+  }
+  for (size_t i = 0; i < groups.size(); ++i) {
+    update(&data[groups[i]], typed->Value((*selection)[i]));
+  }
+}
+
+template <types::DataType DT, typename TValue>
+Status AppendValues(arrow::MemoryPool* mem_pool, const std::vector<TValue>& values,
+                    RowBatch* output_rb) {
+  auto builder = types::MakeArrowBuilder(DT, mem_pool);
+  auto* typed = static_cast<ArrowBuilder<DT>*>(builder.get());
+  PL_RETURN_IF_ERROR(typed->Reserve(values.size()));
+  for (const auto& value : values) {
+    typed->UnsafeAppend(value);
+  }
+  std::shared_ptr<arrow::Array> arr;
+  PL_RETURN_IF_ERROR(builder->Finish(&arr));
+  return output_rb->AddColumn(arr);
+}
+
+}  // namespace
+
+std::optional<VectorizedAggHashTable::AggFunc> VectorizedAggHashTable::MatchAggFunc(
+    std::string_view uda_name, types::DataType arg_type, types::DataType return_type) {
+  auto is_one_of = [arg_type](std::initializer_list<types::DataType> types) {
+    return std::find(types.begin(), types.end(), arg_type) != types.end();
+  };
+  if (uda_name == "count" && return_type == types::DataType::INT64) {
+    return AggFunc::kCount;
+  }
+  if (uda_name == "sum" && is_one_of({types::DataType::INT64, types::DataType::FLOAT64,
+                                      types::DataType::BOOLEAN})) {
+    auto expected = arg_type == types::DataType::FLOAT64 ? types::DataType::FLOAT64
+                                                         : types::DataType::INT64;
+    if (return_type == expected) {
+      return AggFunc::kSum;
+    }
+  }
+  if (uda_name == "mean" &&
+      is_one_of({types::DataType::INT64, types::DataType::FLOAT64, types::DataType::BOOLEAN}) &&
+      return_type == types::DataType::FLOAT64) {
+    return AggFunc::kMean;
+  }
+  if ((uda_name == "min" || uda_name == "max") &&
+      is_one_of({types::DataType::INT64, types::DataType::FLOAT64, types::DataType::TIME64NS}) &&
+      return_type == arg_type) {
+    return uda_name == "min" ? AggFunc::kMin : AggFunc::kMax;
+  }
+  return std::nullopt;
+}
+
+VectorizedAggHashTable::VectorizedAggHashTable(std::vector<int64_t> group_col_idxs,
+                                               std::vector<types::DataType> group_types,
+                                               std::vector<Aggregate> aggs)
+    : group_col_idxs_(std::move(group_col_idxs)),
+      group_types_(std::move(group_types)),
+      aggs_(std::move(aggs)) {
+  DCHECK_EQ(group_col_idxs_.size(), group_types_.size());
+  for (size_t i = 0; i < group_types_.size(); ++i) {
+    state_group_col_idxs_.push_back(i);
+  }
+  Clear();
+}
+
+void VectorizedAggHashTable::Clear() {
+  // Replace the containers rather than clearing them, so that their memory is freed, e.g. when
+  // the table is spilled.
+  slots_ = std::vector<Slot>(16, Slot{0, kEmptySlot});
+  key_arena_ = std::string();
+  key_offsets_ = std::vector<size_t>(1, 0);
+  states_ = std::vector<AggState>(aggs_.size());
+}
+
+void VectorizedAggHashTable::Reserve(size_t num_groups) {
+  // Keep the load factor at or below 1/2.
+  if (num_groups * 2 <= slots_.size()) {
+    return;
+  }
+  size_t capacity = slots_.size();
+  while (num_groups * 2 > capacity) {
+    capacity *= 2;
+  }
+  std::vector<Slot> slots(capacity, Slot{0, kEmptySlot});
+  size_t mask = capacity - 1;
+  for (const auto& slot : slots_) {
+    if (slot.group == kEmptySlot) {
+      continue;
+    }
+    size_t idx = slot.hash & mask;
+    while (slots[idx].group != kEmptySlot) {
+      idx = (idx + 1) & mask;
+    }
+    slots[idx] = slot;
+  }
+  slots_ = std::move(slots);
+}
+
+void VectorizedAggHashTable::AddGroupState(const Aggregate& agg, AggState* state) {
+  if (agg.func == AggFunc::kMean) {
+    state->f64.push_back(0);
+    state->counts.push_back(0);
+    return;
+  }
+  double f64_init = 0;
+  int64_t i64_init = 0;
+  if (agg.func == AggFunc::kMin) {
+    f64_init = std::numeric_limits<double>::max();
+    i64_init = std::numeric_limits<int64_t>::max();
+  } else if (agg.func == AggFunc::kMax) {
+    // Same initial values as the max UDA.
+    f64_init = std::numeric_limits<double>::min();
+    i64_init = std::numeric_limits<int64_t>::min();
+  }
+  if (IsFloat(agg)) {
+    state->f64.push_back(f64_init);
+  } else {
+    state->i64.push_back(i64_init);
+  }
+}
+
+uint32_t VectorizedAggHashTable::FindOrAddGroup(uint64_t hash, std::string_view key) {
+  size_t mask = slots_.size() - 1;
+  for (size_t idx = hash & mask;; idx = (idx + 1) & mask) {
+    Slot& slot = slots_[idx];
+    if (slot.group == kEmptySlot) {
+      uint32_t group = num_groups();
+      slot = Slot{hash, group};
+      key_arena_.append(key);
+      key_offsets_.push_back(key_arena_.size());
+      for (size_t i = 0; i < aggs_.size(); ++i) {
+        AddGroupState(aggs_[i], &states_[i]);
+      }
+      return group;
+    }
+    if (slot.hash == hash && GroupKey(slot.group) == key) {
+      return slot.group;
+    }
+  }
+}
+
+void VectorizedAggHashTable::PackKeys(const RowBatch& rb, const std::vector<int64_t>& col_idxs) {
+  size_t num_rows = rb.num_selected_rows();
+  const auto* selection = rb.selection().get();
+  size_t fixed_size = 0;
+  for (auto type : group_types_) {
+    fixed_size += FixedKeySize(type);
+  }
+
+  // Compute where the key of each row starts.
+  batch_key_offsets_.assign(num_rows + 1, fixed_size);
+  batch_key_offsets_[0] = 0;
+  for (size_t col = 0; col < group_types_.size(); ++col) {
+    if (group_types_[col] != types::DataType::STRING) {
+      continue;
+    }
+    auto* arr = static_cast<const arrow::StringArray*>(rb.ColumnAt(col_idxs[col]).get());
+    for (size_t i = 0; i < num_rows; ++i) {
+      batch_key_offsets_[i + 1] += sizeof(uint32_t) + arr->value_length(RowIndex(selection, i));
+    }
+  }
+  for (size_t i = 1; i <= num_rows; ++i) {
+    batch_key_offsets_[i] += batch_key_offsets_[i - 1];
+  }
+
+  // Write the keys column by column.
+  batch_keys_.resize(batch_key_offsets_[num_rows]);
+  batch_key_pos_.assign(batch_key_offsets_.begin(), batch_key_offsets_.end() - 1);
+  char* keys = batch_keys_.data();
+  for (size_t col = 0; col < group_types_.size(); ++col) {
+    auto* arr = rb.ColumnAt(col_idxs[col]).get();
+    switch (group_types_[col]) {
+      case types::DataType::BOOLEAN:
+        PackFixedSizeColumn<types::DataType::BOOLEAN>(arr, selection, keys, &batch_key_pos_);
+        break;
+      case types::DataType::INT64:
+        PackFixedSizeColumn<types::DataType::INT64>(arr, selection, keys, &batch_key_pos_);
+        break;
+      case types::DataType::TIME64NS:
+        PackFixedSizeColumn<types::DataType::TIME64NS>(arr, selection, keys, &batch_key_pos_);
+        break;
+      case types::DataType::FLOAT64:
+        PackFixedSizeColumn<types::DataType::FLOAT64>(arr, selection, keys, &batch_key_pos_);
+        break;
+      case types::DataType::UINT128:
+        PackFixedSizeColumn<types::DataType::UINT128>(arr, selection, keys, &batch_key_pos_);
+        break;
+      case types::DataType::STRING:
+        PackStringColumn(arr, selection, keys, &batch_key_pos_);
+        break;
+      default:
+        LOG(DFATAL) << "Unsupported group type";
+    }
+  }
+
+  batch_hashes_.resize(num_rows);
+  absl::Hash<std::string_view> hasher;
+  for (size_t i = 0; i < num_rows; ++i) {
+    batch_hashes_[i] = hasher(std::string_view(keys + batch_key_offsets_[i],
+                                               batch_key_offsets_[i + 1] - batch_key_offsets_[i]));
+  }
+}
+
+void VectorizedAggHashTable::AddBatch(const RowBatch& rb) {
+  PackKeys(rb, group_col_idxs_);
+  FindOrAddBatchGroups();
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    UpdateAggregate(i, rb.ColumnAt(aggs_[i].arg_col_idx).get(), rb.selection().get());
+  }
+}
+
+void VectorizedAggHashTable::FindOrAddBatchGroups() {
+  size_t num_rows = batch_hashes_.size();
+  // Make room for every row to be a new group, so that the table isn't resized while probing.
+  Reserve(num_groups() + num_rows);
+  size_t mask = slots_.size() - 1;
+  for (size_t i = 0; i < num_rows; ++i) {
+    __builtin_prefetch(&slots_[batch_hashes_[i] & mask]);
+  }
+  batch_groups_.resize(num_rows);
+  for (size_t i = 0; i < num_rows; ++i) {
+    batch_groups_[i] = FindOrAddGroup(
+        batch_hashes_[i], std::string_view(batch_keys_.data() + batch_key_offsets_[i],
+                                           batch_key_offsets_[i + 1] - batch_key_offsets_[i]));
+  }
+}
+
+void VectorizedAggHashTable::UpdateAggregate(size_t agg_idx, const arrow::Array* arr,
+                                             const std::vector<int64_t>* selection) {
+  const auto& agg = aggs_[agg_idx];
+  auto& state = states_[agg_idx];
+  auto add = [](auto* state, auto value) { *state += value; };
+  auto min = [](auto* state, auto value) { *state = std::min(*state, value); };
+  auto max = [](auto* state, auto value) { *state = std::max(*state, value); };
+
+  switch (agg.func) {
+    case AggFunc::kCount:
+      for (auto group : batch_groups_) {
+        ++state.i64[group];
+      }
+      return;
+    case AggFunc::kMean:
+      for (auto group : batch_groups_) {
+        ++state.counts[group];
+      }
+      switch (agg.arg_type) {
+        case types::DataType::INT64:
+          return UpdateGroups<types::DataType::INT64>(arr, selection, batch_groups_, &state.f64,
+                                                      add);
+        case types::DataType::FLOAT64:
+          return UpdateGroups<types::DataType::FLOAT64>(arr, selection, batch_groups_, &state.f64,
+                                                        add);
+        case types::DataType::BOOLEAN:
+          return UpdateGroups<types::DataType::BOOLEAN>(arr, selection, batch_groups_, &state.f64,
+                                                        add);
+        default:
+          break;
+      }
+      break;
+    case AggFunc::kSum:
+      switch (agg.arg_type) {
+        case types::DataType::INT64:
+          return UpdateGroups<types::DataType::INT64>(arr, selection, batch_groups_, &state.i64,
+                                                      add);
+        case types::DataType::FLOAT64:
+          return UpdateGroups<types::DataType::FLOAT64>(arr, selection, batch_groups_, &state.f64,
+                                                        add);
+        case types::DataType::BOOLEAN:
+          return UpdateGroups<types::DataType::BOOLEAN>(arr, selection, batch_groups_, &state.i64,
+                                                        add);
+        default:
+          break;
+      }
+      break;
+    case AggFunc::kMin:
+      switch (agg.arg_type) {
+        case types::DataType::INT64:
+          return UpdateGroups<types::DataType::INT64>(arr, selection, batch_groups_, &state.i64,
+                                                      min);
+        case types::DataType::TIME64NS:
+          return UpdateGroups<types::DataType::TIME64NS>(arr, selection, batch_groups_, &state.i64,
+                                                         min);
+        case types::DataType::FLOAT64:
+          return UpdateGroups<types::DataType::FLOAT64>(arr, selection, batch_groups_, &state.f64,
+                                                        min);
+        default:
+          break;
+      }
+      break;
+    case AggFunc::kMax:
+      switch (agg.arg_type) {
+        case types::DataType::INT64:
+          return UpdateGroups<types::DataType::INT64>(arr, selection, batch_groups_, &state.i64,
+                                                      max);
+        case types::DataType::TIME64NS:
+          return UpdateGroups<types::DataType::TIME64NS>(arr, selection, batch_groups_, &state.i64,
+                                                         max);
+        case types::DataType::FLOAT64:
+          return UpdateGroups<types::DataType::FLOAT64>(arr, selection, batch_groups_, &state.f64,
+                                                        max);
+        default:
+          break;
+      }
+      break;
+  }
+  LOG(DFATAL) << "Unsupported vectorized aggregate argument type";
+}
+
+void VectorizedAggHashTable::Merge(const VectorizedAggHashTable& other) {
+  DCHECK(group_types_ == other.group_types_);
+  DCHECK_EQ(aggs_.size(), other.aggs_.size());
+  Reserve(num_groups() + other.num_groups());
+  absl::Hash<std::string_view> hasher;
+  for (uint32_t other_group = 0; other_group < other.num_groups(); ++other_group) {
+    auto key = other.GroupKey(other_group);
+    uint32_t group = FindOrAddGroup(hasher(key), key);
+    for (size_t i = 0; i < aggs_.size(); ++i) {
+      auto& state = states_[i];
+      const auto& other_state = other.states_[i];
+      bool is_float = IsFloat(aggs_[i]);
+      switch (aggs_[i].func) {
+        case AggFunc::kCount:
+        case AggFunc::kSum:
+          MergeState(is_float, other_state, other_group, group, &state, std::plus<>());
+          break;
+        case AggFunc::kMean:
+          MergeState(is_float, other_state, other_group, group, &state, std::plus<>());
+          state.counts[group] += other_state.counts[other_group];
+          break;
+        case AggFunc::kMin:
+          MergeState(is_float, other_state, other_group, group, &state, [](auto a, auto b) {
+            return std::min(a, b);
+          });
+          break;
+        case AggFunc::kMax:
+          MergeState(is_float, other_state, other_group, group, &state, [](auto a, auto b) {
+            return std::max(a, b);
+          });
+          break;
+      }
+    }
+  }
+}
+
+Status VectorizedAggHashTable::AppendGroupsToRowBatch(arrow::MemoryPool* mem_pool,
+                                                      RowBatch* output_rb) const {
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders;
+  for (auto type : group_types_) {
+    group_builders.push_back(types::MakeArrowBuilder(type, mem_pool));
+    PL_RETURN_IF_ERROR(group_builders.back()->Reserve(num_groups()));
+  }
+  for (uint32_t group = 0; group < num_groups(); ++group) {
+    auto key = GroupKey(group);
+    for (size_t col = 0; col < group_types_.size(); ++col) {
+      auto* builder = group_builders[col].get();
+      switch (group_types_[col]) {
+        case types::DataType::BOOLEAN:
+          PL_RETURN_IF_ERROR(UnpackFixedSizeValue<types::DataType::BOOLEAN>(builder, &key));
+          break;
+        case types::DataType::INT64:
+          PL_RETURN_IF_ERROR(UnpackFixedSizeValue<types::DataType::INT64>(builder, &key));
+          break;
+        case types::DataType::TIME64NS:
+          PL_RETURN_IF_ERROR(UnpackFixedSizeValue<types::DataType::TIME64NS>(builder, &key));
+          break;
+        case types::DataType::FLOAT64:
+          PL_RETURN_IF_ERROR(UnpackFixedSizeValue<types::DataType::FLOAT64>(builder, &key));
+          break;
+        case types::DataType::UINT128:
+          PL_RETURN_IF_ERROR(UnpackFixedSizeValue<types::DataType::UINT128>(builder, &key));
+          break;
+        case types::DataType::STRING:
+          PL_RETURN_IF_ERROR(UnpackStringValue(builder, &key));
+          break;
+        default:
+          return error::Internal("Unsupported group type");
+      }
+    }
+  }
+  for (const auto& builder : group_builders) {
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
+  }
+  return Status::OK();
+}
+
+Status VectorizedAggHashTable::AppendToRowBatch(arrow::MemoryPool* mem_pool,
+                                                RowBatch* output_rb) const {
+  PL_RETURN_IF_ERROR(AppendGroupsToRowBatch(mem_pool, output_rb));
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    const auto& agg = aggs_[i];
+    const auto& state = states_[i];
+    if (agg.func == AggFunc::kMean) {
+      std::vector<double> means(num_groups());
+      for (size_t group = 0; group < means.size(); ++group) {
+        means[group] = state.f64[group] / state.counts[group];
+      }
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::FLOAT64>(mem_pool, means, output_rb));
+    } else if (IsFloat(agg)) {
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::FLOAT64>(mem_pool, state.f64, output_rb));
+    } else if (agg.arg_type == types::DataType::TIME64NS && agg.func != AggFunc::kCount) {
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::TIME64NS>(mem_pool, state.i64, output_rb));
+    } else {
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::INT64>(mem_pool, state.i64, output_rb));
+    }
+  }
+  return Status::OK();
+}
+
+std::vector<types::DataType> VectorizedAggHashTable::StateTypes() const {
+  std::vector<types::DataType> types = group_types_;
+  for (const auto& agg : aggs_) {
+    types.push_back(IsFloat(agg) ? types::DataType::FLOAT64 : types::DataType::INT64);
+    if (agg.func == AggFunc::kMean) {
+      types.push_back(types::DataType::INT64);
+    }
+  }
+  return types;
+}
+
+Status VectorizedAggHashTable::AppendStateToRowBatch(arrow::MemoryPool* mem_pool,
+                                                     RowBatch* output_rb) const {
+  PL_RETURN_IF_ERROR(AppendGroupsToRowBatch(mem_pool, output_rb));
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    const auto& state = states_[i];
+    if (IsFloat(aggs_[i])) {
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::FLOAT64>(mem_pool, state.f64, output_rb));
+    } else {
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::INT64>(mem_pool, state.i64, output_rb));
+    }
+    if (aggs_[i].func == AggFunc::kMean) {
+      std::vector<int64_t> counts(state.counts.begin(), state.counts.end());
+      PL_RETURN_IF_ERROR(AppendValues<types::DataType::INT64>(mem_pool, counts, output_rb));
+    }
+  }
+  return Status::OK();
+}
+
+void VectorizedAggHashTable::MergeStateBatch(const RowBatch& rb) {
+  DCHECK(!rb.has_selection());
+  PackKeys(rb, state_group_col_idxs_);
+  FindOrAddBatchGroups();
+
+  auto add = [](auto* state, auto value) { *state += value; };
+  auto min = [](auto* state, auto value) { *state = std::min(*state, value); };
+  auto max = [](auto* state, auto value) { *state = std::max(*state, value); };
+  int64_t col_idx = group_types_.size();
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    const auto& agg = aggs_[i];
+    auto& state = states_[i];
+    const auto* arr = rb.ColumnAt(col_idx++).get();
+    bool is_float = IsFloat(agg);
+    switch (agg.func) {
+      case AggFunc::kCount:
+      case AggFunc::kSum:
+      case AggFunc::kMean:
+        if (is_float) {
+          UpdateGroups<types::DataType::FLOAT64>(arr, nullptr, batch_groups_, &state.f64, add);
+        } else {
+          UpdateGroups<types::DataType::INT64>(arr, nullptr, batch_groups_, &state.i64, add);
+        }
+        break;
+      case AggFunc::kMin:
+        if (is_float) {
+          UpdateGroups<types::DataType::FLOAT64>(arr, nullptr, batch_groups_, &state.f64, min);
+        } else {
+          UpdateGroups<types::DataType::INT64>(arr, nullptr, batch_groups_, &state.i64, min);
+        }
+        break;
+      case AggFunc::kMax:
+        if (is_float) {
+          UpdateGroups<types::DataType::FLOAT64>(arr, nullptr, batch_groups_, &state.f64, max);
+        } else {
+          UpdateGroups<types::DataType::INT64>(arr, nullptr, batch_groups_, &state.i64, max);
+        }
+        break;
+    }
+    if (agg.func == AggFunc::kMean) {
+      const auto* counts = rb.ColumnAt(col_idx++).get();
+      UpdateGroups<types::DataType::INT64>(counts, nullptr, batch_groups_, &state.counts, add);
+    }
+  }
+}
+
+std::vector<uint64_t> VectorizedAggHashTable::GroupHashes() const {
+  std::vector<uint64_t> hashes(num_groups());
+  absl::Hash<std::string_view> hasher;
+  for (uint32_t group = 0; group < num_groups(); ++group) {
+    hashes[group] = hasher(GroupKey(group));
+  }
+  return hashes;
+}
+
+int64_t VectorizedAggHashTable::MemoryUsage() const {
+  int64_t bytes = slots_.capacity() * sizeof(Slot) + key_arena_.capacity() +
+                  key_offsets_.capacity() * sizeof(size_t);
+  for (const auto& state : states_) {
+    bytes += state.i64.capacity() * sizeof(int64_t) + state.f64.capacity() * sizeof(double) +
+             state.counts.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * VectorizedAggHashTable computes a group by aggregate for the common aggregate functions (count,
+ * sum, mean, min and max), without the RowTuples and per group UDA instances of the generic
+ * AggNode path.
+ *
+ * The group keys of a batch are packed column by column into byte strings: fixed size values are
+ * copied as is, and strings are prefixed with their length. The packed keys are hashed and looked
+ * up in an open addressing table one batch at a time, which gives the group of every row. Each
+ * aggregate keeps its state in a vector indexed by group, so updating an aggregate with a batch is
+ * a single loop over its input column.
+ */
+class VectorizedAggHashTable {
+ public:
+  enum class AggFunc { kCount, kSum, kMean, kMin, kMax };
+
+  struct Aggregate {
+    AggFunc func;
+    // The index of the aggregate's argument in the input batches.
+    int64_t arg_col_idx;
+    types::DataType arg_type;
+  };
+
+  /**
+   * Returns the aggregate function for the UDA with the given name, if the hash table can compute
+   * it for the argument type, with the given return type. Checking the return type ensures that
+   * UDAs which only share their name with a builtin aggregate aren't replaced.
+   */
+  static std::optional<AggFunc> MatchAggFunc(std::string_view uda_name, types::DataType arg_type,
+                                             types::DataType return_type);
+
+  /**
+   * @param group_col_idxs the indices of the group columns in the input batches.
+   * @param group_types the types of the group columns.
+   * @param aggs the aggregates to compute, e.g. as matched by MatchAggFunc.
+   */
+  VectorizedAggHashTable(std::vector<int64_t> group_col_idxs,
+                         std::vector<types::DataType> group_types, std::vector<Aggregate> aggs);
+
+  /**
+   * Adds the rows of the batch to the aggregates of their groups. Only the selected rows are added
+   * if the batch has a selection vector.
+   */
+  void AddBatch(const table_store::schema::RowBatch& rb);
+
+  /**
+   * Merges the groups of another table with the same group columns and aggregates into this one.
+   */
+  void Merge(const VectorizedAggHashTable& other);
+
+  /**
+   * Adds the group columns followed by the aggregate columns to the row batch, with a row per
+   * group.
+   */
+  Status AppendToRowBatch(arrow::MemoryPool* mem_pool,
+                          table_store::schema::RowBatch* output_rb) const;
+
+  /**
+   * Adds the group columns followed by the intermediate state of the aggregates to the row batch,
+   * with a row per group. The state of an aggregate is a column of its running value, with the
+   * type given by StateTypes, plus an INT64 column of the row counts for means. The state can be
+   * merged back into a table with MergeStateBatch, e.g. after it was spilled to disk.
+   */
+  Status AppendStateToRowBatch(arrow::MemoryPool* mem_pool,
+                               table_store::schema::RowBatch* output_rb) const;
+
+  /**
+   * Merges the groups of a batch that was created by AppendStateToRowBatch into this table.
+   */
+  void MergeStateBatch(const table_store::schema::RowBatch& rb);
+
+  /**
+   * @return the types of the columns added by AppendStateToRowBatch.
+   */
+  std::vector<types::DataType> StateTypes() const;
+
+  /**
+   * @return the hash of the group key of every group. Equal groups of different tables with the
+   * same group columns have equal hashes.
+   */
+  std::vector<uint64_t> GroupHashes() const;
+
+  /**
+   * @return an estimate of the number of bytes held by the groups and their state.
+   */
+  int64_t MemoryUsage() const;
+
+  void Clear();
+
+  size_t num_groups() const { return key_offsets_.size() - 1; }
+
+ private:
+  static constexpr uint32_t kEmptySlot = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    uint64_t hash;
+    uint32_t group;
+  };
+
+  // The state of an aggregate, indexed by group. Integer and time aggregates are kept in `i64`,
+  // float aggregates in `f64`. Means keep their sum in `f64` and their count in `counts`.
+  struct AggState {
+    std::vector<int64_t> i64;
+    std::vector<double> f64;
+    std::vector<uint64_t> counts;
+  };
+
+  static bool IsFloat(const Aggregate& agg) {
+    return agg.func == AggFunc::kMean ||
+           (agg.func != AggFunc::kCount && agg.arg_type == types::DataType::FLOAT64);
+  }
+  static void AddGroupState(const Aggregate& agg, AggState* state);
+  // Combines the state of a group of another table into the state of a group of this table.
+  template <typename TFn>
+  static void MergeState(bool is_float, const AggState& other, uint32_t other_group,
+                         uint32_t group, AggState* state, TFn fn) {
+    if (is_float) {
+      state->f64[group] = fn(state->f64[group], other.f64[other_group]);
+    } else {
+      state->i64[group] = fn(state->i64[group], other.i64[other_group]);
+    }
+  }
+
+  Status AppendGroupsToRowBatch(arrow::MemoryPool* mem_pool,
+                                table_store::schema::RowBatch* output_rb) const;
+  // Packs the keys of the rows of the batch, from the given group columns.
+  void PackKeys(const table_store::schema::RowBatch& rb, const std::vector<int64_t>& col_idxs);
+  // Looks up the group of every row of the packed batch, adding new groups as necessary.
+  void FindOrAddBatchGroups();
+  uint32_t FindOrAddGroup(uint64_t hash, std::string_view key);
+  void Reserve(size_t num_groups);
+  void UpdateAggregate(size_t agg_idx, const arrow::Array* arr,
+                       const std::vector<int64_t>* selection);
+  std::string_view GroupKey(uint32_t group) const {
+    return std::string_view(key_arena_).substr(key_offsets_[group],
+                                               key_offsets_[group + 1] - key_offsets_[group]);
+  }
+
+  const std::vector<int64_t> group_col_idxs_;
+  // The indices of the group columns in state batches, which come first.
+  std::vector<int64_t> state_group_col_idxs_;
+  const std::vector<types::DataType> group_types_;
+  const std::vector<Aggregate> aggs_;
+
+  std::vector<Slot> slots_;
+  // The packed keys of the groups, concatenated. The key of group g is in
+  // [key_offsets_[g], key_offsets_[g + 1]).
+  std::string key_arena_;
+  std::vector<size_t> key_offsets_;
+  std::vector<AggState> states_;
+
+  // Scratch space for the batch that is being added.
+  std::string batch_keys_;
+  std::vector<size_t> batch_key_offsets_;
+  std::vector<size_t> batch_key_pos_;
+  std::vector<uint64_t> batch_hashes_;
+  std::vector<uint32_t> batch_groups_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/agg_hash_table.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using types::DataType;
+using AggFunc = VectorizedAggHashTable::AggFunc;
+
+TEST(VectorizedAggHashTableTest, match_agg_func) {
+  EXPECT_EQ(AggFunc::kCount,
+            VectorizedAggHashTable::MatchAggFunc("count", DataType::STRING, DataType::INT64));
+  EXPECT_EQ(AggFunc::kSum,
+            VectorizedAggHashTable::MatchAggFunc("sum", DataType::BOOLEAN, DataType::INT64));
+  EXPECT_EQ(AggFunc::kMean,
+            VectorizedAggHashTable::MatchAggFunc("mean", DataType::INT64, DataType::FLOAT64));
+  EXPECT_EQ(AggFunc::kMax,
+            VectorizedAggHashTable::MatchAggFunc("max", DataType::TIME64NS, DataType::TIME64NS));
+  // A UDA that only shares its name with a builtin isn't matched.
+  EXPECT_FALSE(VectorizedAggHashTable::MatchAggFunc("sum", DataType::INT64, DataType::FLOAT64)
+                   .has_value());
+  EXPECT_FALSE(VectorizedAggHashTable::MatchAggFunc("min", DataType::STRING, DataType::STRING)
+                   .has_value());
+  EXPECT_FALSE(VectorizedAggHashTable::MatchAggFunc("quantiles", DataType::INT64, DataType::STRING)
+                   .has_value());
+}
+
+class VectorizedAggHashTableTest : public ::testing::Test {
+ protected:
+  VectorizedAggHashTableTest()
+      : input_rd_({DataType::STRING, DataType::INT64, DataType::INT64, DataType::FLOAT64}),
+        output_rd_({DataType::STRING, DataType::INT64, DataType::INT64, DataType::INT64,
+                    DataType::FLOAT64, DataType::FLOAT64}) {}
+
+  // Groups by (column 0, column 1), and computes count(2), sum(2), min(3) and mean(2).
+  VectorizedAggHashTable MakeTable() {
+    return VectorizedAggHashTable({0, 1}, {DataType::STRING, DataType::INT64},
+                                  {{AggFunc::kCount, 2, DataType::INT64},
+                                   {AggFunc::kSum, 2, DataType::INT64},
+                                   {AggFunc::kMin, 3, DataType::FLOAT64},
+                                   {AggFunc::kMean, 2, DataType::INT64}});
+  }
+
+  RowDescriptor input_rd_;
+  RowDescriptor output_rd_;
+};
+
+TEST_F(VectorizedAggHashTableTest, add_batches) {
+  auto table = MakeTable();
+  table.AddBatch(RowBatchBuilder(input_rd_, 4, /*eow*/ false, /*eos*/ false)
+                     .AddColumn<types::StringValue>({"a", "b", "a", ""})
+                     .AddColumn<types::Int64Value>({1, 1, 1, 2})
+                     .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                     .AddColumn<types::Float64Value>({0.5, 1.5, 2.5, 3.5})
+                     .get());
+  table.AddBatch(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ true)
+                     .AddColumn<types::StringValue>({"a", "b", ""})
+                     .AddColumn<types::Int64Value>({1, 2, 2})
+                     .AddColumn<types::Int64Value>({5, 6, 7})
+                     .AddColumn<types::Float64Value>({0.25, 1.0, 9.0})
+                     .get());
+  EXPECT_EQ(4, table.num_groups());
+
+  RowBatch output_rb(output_rd_, table.num_groups());
+  ASSERT_OK(table.AppendToRowBatch(arrow::default_memory_pool(), &output_rb));
+  // Groups are output in the order they were first seen.
+  EXPECT_TRUE(output_rb.ColumnAt(0)->Equals(
+      types::ToArrow(std::vector<types::StringValue>{"a", "b", "", "b"},
+                     arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(1)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{1, 1, 2, 2}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(2)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{3, 1, 2, 1}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(3)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{9, 2, 11, 6}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(4)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{0.25, 1.5, 3.5, 1.0}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(5)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{3.0, 2.0, 5.5, 6.0}, arrow::default_memory_pool())));
+
+  table.Clear();
+  EXPECT_EQ(0, table.num_groups());
+}
+
+TEST_F(VectorizedAggHashTableTest, merge) {
+  auto table = MakeTable();
+  auto other = MakeTable();
+  table.AddBatch(RowBatchBuilder(input_rd_, 2, /*eow*/ false, /*eos*/ false)
+                     .AddColumn<types::StringValue>({"a", "b"})
+                     .AddColumn<types::Int64Value>({1, 1})
+                     .AddColumn<types::Int64Value>({1, 2})
+                     .AddColumn<types::Float64Value>({0.5, 1.5})
+                     .get());
+  other.AddBatch(RowBatchBuilder(input_rd_, 2, /*eow*/ false, /*eos*/ false)
+                     .AddColumn<types::StringValue>({"c", "a"})
+                     .AddColumn<types::Int64Value>({1, 1})
+                     .AddColumn<types::Int64Value>({4, 3})
+                     .AddColumn<types::Float64Value>({3.5, 0.25})
+                     .get());
+  table.Merge(other);
+  EXPECT_EQ(3, table.num_groups());
+
+  RowBatch output_rb(output_rd_, table.num_groups());
+  ASSERT_OK(table.AppendToRowBatch(arrow::default_memory_pool(), &output_rb));
+  EXPECT_TRUE(output_rb.ColumnAt(0)->Equals(types::ToArrow(
+      std::vector<types::StringValue>{"a", "b", "c"}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(2)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{2, 1, 1}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(3)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{4, 2, 4}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(4)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{0.25, 1.5, 3.5}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(5)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{2.0, 2.0, 4.0}, arrow::default_memory_pool())));
+}
+
+TEST_F(VectorizedAggHashTableTest, merge_state_batch) {
+  auto table = MakeTable();
+  auto other = MakeTable();
+  table.AddBatch(RowBatchBuilder(input_rd_, 2, /*eow*/ false, /*eos*/ false)
+                     .AddColumn<types::StringValue>({"a", "b"})
+                     .AddColumn<types::Int64Value>({1, 1})
+                     .AddColumn<types::Int64Value>({1, 2})
+                     .AddColumn<types::Float64Value>({0.5, 1.5})
+                     .get());
+  other.AddBatch(RowBatchBuilder(input_rd_, 3, /*eow*/ false, /*eos*/ false)
+                     .AddColumn<types::StringValue>({"c", "a", "a"})
+                     .AddColumn<types::Int64Value>({1, 1, 1})
+                     .AddColumn<types::Int64Value>({4, 3, 2})
+                     .AddColumn<types::Float64Value>({3.5, 0.25, 1.0})
+                     .get());
+  EXPECT_GT(other.MemoryUsage(), 0);
+
+  // The state is (groups, count, sum, min, mean sum, mean count).
+  RowDescriptor state_rd(other.StateTypes());
+  EXPECT_EQ(7, state_rd.size());
+  RowBatch state_rb(state_rd, other.num_groups());
+  ASSERT_OK(other.AppendStateToRowBatch(arrow::default_memory_pool(), &state_rb));
+  EXPECT_EQ(other.GroupHashes()[1], table.GroupHashes()[0]);
+  table.MergeStateBatch(state_rb);
+  EXPECT_EQ(3, table.num_groups());
+
+  RowBatch output_rb(output_rd_, table.num_groups());
+  ASSERT_OK(table.AppendToRowBatch(arrow::default_memory_pool(), &output_rb));
+  EXPECT_TRUE(output_rb.ColumnAt(0)->Equals(types::ToArrow(
+      std::vector<types::StringValue>{"a", "b", "c"}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(2)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{3, 1, 1}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(3)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{6, 2, 4}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(4)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{0.25, 1.5, 3.5}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(5)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{2.0, 2.0, 4.0}, arrow::default_memory_pool())));
+}
+
+TEST_F(VectorizedAggHashTableTest, selected_rows) {
+  auto table = MakeTable();
+  RowBatchBuilder input_builder(input_rd_, 4, /*eow*/ true, /*eos*/ true);
+  auto& input_rb = input_builder.AddColumn<types::StringValue>({"a", "b", "a", "c"})
+                       .AddColumn<types::Int64Value>({1, 1, 1, 1})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({0.5, 1.5, 2.5, 3.5})
+                       .get();
+  input_rb.set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 2}));
+  table.AddBatch(input_rb);
+  EXPECT_EQ(2, table.num_groups());
+
+  RowBatch output_rb(output_rd_, table.num_groups());
+  ASSERT_OK(table.AppendToRowBatch(arrow::default_memory_pool(), &output_rb));
+  EXPECT_TRUE(output_rb.ColumnAt(0)->Equals(types::ToArrow(
+      std::vector<types::StringValue>{"b", "a"}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(3)->Equals(types::ToArrow(
+      std::vector<types::Int64Value>{2, 3}, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_rb.ColumnAt(4)->Equals(types::ToArrow(
+      std::vector<types::Float64Value>{1.5, 2.5}, arrow::default_memory_pool())));
+}
+
+TEST_F(VectorizedAggHashTableTest, grows_past_initial_capacity) {
+  VectorizedAggHashTable table({0}, {DataType::INT64}, {{AggFunc::kSum, 1, DataType::INT64}});
+  RowDescriptor rd({DataType::INT64, DataType::INT64});
+  std::vector<types::Int64Value> keys;
+  std::vector<types::Int64Value> values;
+  for (int64_t i = 0; i < 1000; ++i) {
+    keys.emplace_back(i % 300);
+    values.emplace_back(i);
+  }
+  table.AddBatch(RowBatchBuilder(rd, keys.size(), /*eow*/ true, /*eos*/ true)
+                     .AddColumn<types::Int64Value>(keys)
+                     .AddColumn<types::Int64Value>(values)
+                     .get());
+  EXPECT_EQ(300, table.num_groups());
+
+  RowBatch output_rb(RowDescriptor({DataType::INT64, DataType::INT64}), table.num_groups());
+  ASSERT_OK(table.AppendToRowBatch(arrow::default_memory_pool(), &output_rb));
+  // Key 0 is the sum of 0, 300, 600 and 900.
+  EXPECT_EQ(0, types::GetValueFromArrowArray<DataType::INT64>(output_rb.ColumnAt(0).get(), 0));
+  EXPECT_EQ(1800, types::GetValueFromArrowArray<DataType::INT64>(output_rb.ColumnAt(1).get(), 0));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cstdint>
 
+#include <absl/strings/str_cat.h>
 #include <magic_enum.hpp>
 
 #include "src/carnot/exec/expression_evaluator.h"
@@ -35,6 +36,10 @@
 #include "src/shared/types/type_utils.h"
 #include "src/shared/types/types.h"
 
+DEFINE_bool(carnot_vectorized_agg, gflags::BoolFromEnv("PL_CARNOT_VECTORIZED_AGG", true),
+            "Whether to compute group by aggregates of count, sum, mean, min and max with the "
+            "vectorized hash table, instead of per group UDAs.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -46,6 +51,15 @@ using table_store::schema::RowBatch;
 using table_store::schema::RowDescriptor;
 
 namespace {
+// The estimated bytes of the states of the UDAs of a group, see UDA::StateBytesEstimate.
+int64_t UDAStateBytes(const std::vector<UDAInfo>& udas) {
+  int64_t bytes = 0;
+  for (const auto& uda_info : udas) {
+    bytes += uda_info.def->state_bytes_estimate();
+  }
+  return bytes;
+}
+
 template <types::DataType DT>
 void ExtractIntoGroupArgs(std::vector<GroupArgs>* group_args, arrow::Array* col, int rt_col_idx) {
   auto num_rows = col->length();
@@ -78,6 +92,14 @@ void ExtractToColumnWrapper(const std::vector<GroupArgs>& group_args,
   }
 }
 
+int64_t RowTupleBytes(const RowTuple& rt) {
+  int64_t bytes = sizeof(RowTuple) + rt.fixed_values.size() * sizeof(types::FixedSizeValueUnion);
+  for (const auto& val : rt.variable_values) {
+    bytes += sizeof(val) + std::get<types::StringValue>(val).size();
+  }
+  return bytes;
+}
+
 }  // namespace
 
 std::string AggNode::DebugStringImpl() {
@@ -146,10 +168,58 @@ Status AggNode::PrepareImpl(ExecState* exec_state) {
 Status AggNode::OpenImpl(ExecState* exec_state) {
   if (HasNoGroups()) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
+  } else if (FLAGS_carnot_vectorized_agg) {
+    MaybeCreateVectorizedAgg(exec_state);
   }
+  can_spill_ = CanSpill(exec_state);
   return Status::OK();
 }
 
+bool AggNode::CanSpill(ExecState* exec_state) const {
+  if (HasNoGroups() || windowed()) {
+    return false;
+  }
+  if (vectorized_agg_ != nullptr) {
+    return true;
+  }
+  for (const auto& value : plan_node_->values()) {
+    if (!exec_state->GetUDADefinition(value->uda_id())->supports_partial()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AggNode::MaybeCreateVectorizedAgg(ExecState* exec_state) {
+  std::vector<VectorizedAggHashTable::Aggregate> aggs;
+  for (const auto& [i, value] : Enumerate(plan_node_->values())) {
+    auto deps = value->Deps();
+    if (!value->init_arguments().empty() || deps.size() != 1 ||
+        deps[0]->ExpressionType() != plan::Expression::kColumn) {
+      return;
+    }
+    auto col_idx = static_cast<const plan::Column*>(deps[0])->Index();
+    auto arg_type = input_descriptor_->type(col_idx);
+    auto* def = exec_state->GetUDADefinition(value->uda_id());
+    if (def->finalize_return_type() != value_data_types_[i]) {
+      return;
+    }
+    auto func =
+        VectorizedAggHashTable::MatchAggFunc(def->name(), arg_type, def->finalize_return_type());
+    if (!func.has_value()) {
+      return;
+    }
+    aggs.push_back({func.value(), col_idx, arg_type});
+  }
+
+  std::vector<int64_t> group_col_idxs;
+  for (const auto& group : plan_node_->groups()) {
+    group_col_idxs.push_back(group.idx);
+  }
+  vectorized_agg_ = std::make_unique<VectorizedAggHashTable>(std::move(group_col_idxs),
+                                                             group_data_types_, std::move(aggs));
+}
+
 Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
   if (HasNoGroups()) {
     return AggregateGroupByNone(exec_state, rb);
@@ -157,12 +227,79 @@ Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_
   return AggregateGroupByClause(exec_state, rb);
 }
 
-Status AggNode::CloseImpl(ExecState*) {
+Status AggNode::CloseImpl(ExecState* exec_state) {
   udas_no_groups_.clear();
   group_args_chunk_.clear();
   group_args_pool_.Clear();
   udas_pool_.Clear();
+  vectorized_agg_.reset();
+  merge_udas_.clear();
+  spill_files_.clear();
+  exec_state->memory_tracker()->Track(&tracked_bytes_, 0);
 
+  if (num_spills_ > 0) {
+    stats()->AddExtraInfo("num_spills", absl::StrCat(num_spills_));
+  }
+  return Status::OK();
+}
+
+Status AggNode::MergeFrom(ExecState* exec_state, AggNode* other) {
+  DCHECK(!windowed());
+  DCHECK_EQ(plan_node_->id(), other->plan_node_->id());
+  // Groups are partitioned the same way by both nodes, so the other node's spilled partitions are
+  // merged with this node's when they are read back.
+  if (!other->spill_files_.empty()) {
+    spill_files_.resize(kNumSpillPartitions);
+    for (size_t i = 0; i < kNumSpillPartitions; ++i) {
+      for (auto& file : other->spill_files_[i]) {
+        spill_files_[i].push_back(std::move(file));
+      }
+    }
+    other->spill_files_.clear();
+  }
+  if (vectorized_agg_ != nullptr) {
+    DCHECK(other->vectorized_agg_ != nullptr);
+    vectorized_agg_->Merge(*other->vectorized_agg_);
+    other->vectorized_agg_->Clear();
+    return Status::OK();
+  }
+  if (HasNoGroups()) {
+    for (size_t i = 0; i < udas_no_groups_.size(); ++i) {
+      const auto& uda_info = udas_no_groups_[i];
+      PL_RETURN_IF_ERROR(uda_info.def->Merge(uda_info.uda.get(),
+                                             other->udas_no_groups_[i].uda.get(),
+                                             function_ctx_.get()));
+    }
+    return Status::OK();
+  }
+
+  for (const auto& [other_key, other_val] : other->agg_hash_map_) {
+    // Apply the rows that the other node has buffered, but not yet passed to its UDAs.
+    PL_RETURN_IF_ERROR(other->EvaluateAggHashValue(exec_state, other_val));
+
+    auto it = agg_hash_map_.find(other_key);
+    if (it != agg_hash_map_.end()) {
+      auto* val = it->second;
+      for (size_t i = 0; i < val->udas.size(); ++i) {
+        const auto& uda_info = val->udas[i];
+        PL_RETURN_IF_ERROR(uda_info.def->Merge(uda_info.uda.get(), other_val->udas[i].uda.get(),
+                                               function_ctx_.get()));
+      }
+      continue;
+    }
+
+    // The group is new to this node, so it takes over the other node's UDAs.
+    auto* key = CreateGroupArgsRowTuple();
+    key->fixed_values = other_key->fixed_values;
+    key->variable_values = other_key->variable_values;
+    auto* val = udas_pool_.Add(new AggHashValue);
+    val->udas = std::move(other_val->udas);
+    for (const auto& dt : stored_cols_data_types_) {
+      val->agg_cols.emplace_back(types::ColumnWrapper::Make(dt, 0));
+    }
+    agg_hash_map_[key] = val;
+  }
+  other->agg_hash_map_.clear();
   return Status::OK();
 }
 
@@ -176,6 +313,18 @@ Status AggNode::ClearAggState(ExecState* exec_state) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
   }
   agg_hash_map_.clear();
+  if (!HasNoGroups()) {
+    // The group keys and UDAs are owned by the pools, and group_args_chunk_ is regrown with the
+    // next batch.
+    group_args_chunk_.clear();
+    group_args_pool_.Clear();
+    udas_pool_.Clear();
+    group_state_bytes_ = 0;
+  }
+  if (vectorized_agg_ != nullptr) {
+    vectorized_agg_->Clear();
+  }
+  exec_state->memory_tracker()->Track(&tracked_bytes_, 0);
   return Status::OK();
 }
 
@@ -247,6 +396,8 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
       // Create a val array.
       val = CreateAggHashValue(exec_state);
       agg_hash_map_[ga.rt] = val;
+      group_state_bytes_ +=
+          RowTupleBytes(*ga.rt) + sizeof(AggHashValue) + UDAStateBytes(val->udas);
       // We have inserted this, so the stored RowTuple is now in the table.
       ga.rt = nullptr;
     } else {
@@ -300,8 +451,8 @@ Status AggNode::ResetGroupArgs() {
   return Status::OK();
 }
 
-Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* output_rb) {
-  PL_UNUSED(exec_state);
+Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, bool serialize_state,
+                                            RowBatch* output_rb) {
   DCHECK(output_rb != nullptr);
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders;
   for (const auto& group_dt : group_data_types_) {
@@ -309,7 +460,8 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
   }
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> value_builders;
   for (const auto& value_data_type : value_data_types_) {
-    value_builders.push_back(types::MakeArrowBuilder(value_data_type, exec_state->exec_mem_pool()));
+    auto dt = serialize_state ? types::DataType::STRING : value_data_type;
+    value_builders.push_back(types::MakeArrowBuilder(dt, exec_state->exec_mem_pool()));
   }
 
   // Agg into agg values and emit!
@@ -328,6 +480,11 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
     PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, val));
     for (size_t i = 0; i < val->udas.size(); ++i) {
       const auto& uda_info = val->udas[i];
+      if (serialize_state) {
+        PL_RETURN_IF_ERROR(uda_info.def->SerializeArrow(uda_info.uda.get(), function_ctx_.get(),
+                                                        value_builders[i].get()));
+        continue;
+      }
       PL_RETURN_IF_ERROR(uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(),
                                                      value_builders[i].get()));
     }
@@ -357,20 +514,173 @@ Status AggNode::AggregateGroupByClause(ExecState* exec_state, const RowBatch& rb
   // 3. If the agg values are large then run aggregate and compact.
   // 4. Reset state to prepare for next row batch.
   // 5. If it's the last batch then emit the values.
-  PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
-  PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
-  if (plan_node_->values().size() > 0) {
-    PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
+  if (vectorized_agg_ != nullptr) {
+    vectorized_agg_->AddBatch(rb);
+  } else {
+    PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
+    PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
+    if (plan_node_->values().size() > 0) {
+      PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
+    }
+    PL_RETURN_IF_ERROR(ResetGroupArgs());
   }
-  PL_RETURN_IF_ERROR(ResetGroupArgs());
-  if (ReadyToEmitBatches(rb)) {
-    RowBatch output_rb(*output_descriptor_, agg_hash_map_.size());
-    PL_RETURN_IF_ERROR(ConvertAggHashMapToRowBatch(exec_state, &output_rb));
-    output_rb.set_eow(rb.eow());
-    output_rb.set_eos(rb.eos());
-    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
+  if (!ReadyToEmitBatches(rb)) {
+    return TrackMemory(exec_state);
+  }
+  if (!spill_files_.empty()) {
+    return EmitSpilledPartitions(exec_state, rb);
+  }
+  PL_RETURN_IF_ERROR(EmitGroups(exec_state, rb.eow(), rb.eos()));
+  return ClearAggState(exec_state);
+}
+
+Status AggNode::EmitGroups(ExecState* exec_state, bool eow, bool eos) {
+  if (vectorized_agg_ != nullptr) {
+    RowBatch output_rb(*output_descriptor_, vectorized_agg_->num_groups());
+    PL_RETURN_IF_ERROR(vectorized_agg_->AppendToRowBatch(exec_state->exec_mem_pool(), &output_rb));
+    output_rb.set_eow(eow);
+    output_rb.set_eos(eos);
+    return SendRowBatchToChildren(exec_state, output_rb);
+  }
+  RowBatch output_rb(*output_descriptor_, agg_hash_map_.size());
+  PL_RETURN_IF_ERROR(
+      ConvertAggHashMapToRowBatch(exec_state, /*serialize_state*/ false, &output_rb));
+  output_rb.set_eow(eow);
+  output_rb.set_eos(eos);
+  return SendRowBatchToChildren(exec_state, output_rb);
+}
+
+std::vector<types::DataType> AggNode::StateTypes() const {
+  if (vectorized_agg_ != nullptr) {
+    return vectorized_agg_->StateTypes();
+  }
+  std::vector<types::DataType> types = group_data_types_;
+  types.insert(types.end(), value_data_types_.size(), types::DataType::STRING);
+  return types;
+}
+
+Status AggNode::TrackMemory(ExecState* exec_state) {
+  int64_t bytes =
+      vectorized_agg_ != nullptr ? vectorized_agg_->MemoryUsage() : group_state_bytes_;
+  auto* tracker = exec_state->memory_tracker();
+  tracker->Track(&tracked_bytes_, bytes);
+  if (can_spill_ && tracker->LimitExceeded()) {
+    return SpillState(exec_state);
+  }
+  return Status::OK();
+}
+
+Status AggNode::SpillState(ExecState* exec_state) {
+  std::vector<uint64_t> hashes;
+  RowBatch state_rb(RowDescriptor(StateTypes()),
+                    vectorized_agg_ != nullptr ? vectorized_agg_->num_groups()
+                                               : agg_hash_map_.size());
+  if (vectorized_agg_ != nullptr) {
+    PL_RETURN_IF_ERROR(
+        vectorized_agg_->AppendStateToRowBatch(exec_state->exec_mem_pool(), &state_rb));
+    hashes = vectorized_agg_->GroupHashes();
+  } else {
+    PL_RETURN_IF_ERROR(
+        ConvertAggHashMapToRowBatch(exec_state, /*serialize_state*/ true, &state_rb));
+    // The map is iterated in the same order as by ConvertAggHashMapToRowBatch.
+    for (const auto& [key, val] : agg_hash_map_) {
+      hashes.push_back(key->Hash());
+    }
+  }
+
+  std::vector<std::vector<int64_t>> partition_rows(kNumSpillPartitions);
+  for (const auto& [row, hash] : Enumerate(hashes)) {
+    partition_rows[hash % kNumSpillPartitions].push_back(row);
+  }
+  spill_files_.resize(kNumSpillPartitions);
+  for (size_t i = 0; i < kNumSpillPartitions; ++i) {
+    if (partition_rows[i].empty()) {
+      continue;
+    }
+    if (spill_files_[i].empty()) {
+      PL_ASSIGN_OR_RETURN(auto file, SpillFile::Create());
+      spill_files_[i].push_back(std::move(file));
+    }
+    // Only the selected rows are written.
+    state_rb.set_selection(
+        std::make_shared<const std::vector<int64_t>>(std::move(partition_rows[i])));
+    PL_RETURN_IF_ERROR(spill_files_[i].back()->Write(state_rb));
+  }
+  ++num_spills_;
+  return ClearAggState(exec_state);
+}
+
+Status AggNode::MergeStateBatch(ExecState* exec_state, const RowBatch& state_rb) {
+  if (merge_udas_.empty()) {
+    PL_RETURN_IF_ERROR(CreateUDAInfoValues(&merge_udas_, exec_state));
+  }
+  size_t num_group_cols = group_data_types_.size();
+  RowTuple* key = nullptr;
+  for (int64_t row = 0; row < state_rb.num_rows(); ++row) {
+    if (key == nullptr) {
+      key = CreateGroupArgsRowTuple();
+    } else {
+      key->Reset();
+    }
+    for (size_t col = 0; col < num_group_cols; ++col) {
+      auto* arr = state_rb.ColumnAt(col).get();
+#define TYPE_CASE(_dt_) ExtractIntoRowTuple<_dt_>(key, arr, col, row);
+      PL_SWITCH_FOREACH_DATATYPE(group_data_types_[col], TYPE_CASE);
+#undef TYPE_CASE
+    }
+
+    auto it = agg_hash_map_.find(key);
+    bool new_group = it == agg_hash_map_.end();
+    AggHashValue* val;
+    if (new_group) {
+      val = CreateAggHashValue(exec_state);
+      agg_hash_map_[key] = val;
+      group_state_bytes_ += RowTupleBytes(*key) + sizeof(AggHashValue) + UDAStateBytes(val->udas);
+      key = nullptr;
+    } else {
+      val = it->second;
+    }
+    for (size_t i = 0; i < val->udas.size(); ++i) {
+      const auto& uda_info = val->udas[i];
+      auto data = types::GetValueFromArrowArray<types::DataType::STRING>(
+          state_rb.ColumnAt(num_group_cols + i).get(), row);
+      if (new_group) {
+        PL_RETURN_IF_ERROR(
+            uda_info.def->Deserialize(uda_info.uda.get(), function_ctx_.get(), data));
+        continue;
+      }
+      auto* merge_uda = merge_udas_[i].uda.get();
+      PL_RETURN_IF_ERROR(uda_info.def->Deserialize(merge_uda, function_ctx_.get(), data));
+      PL_RETURN_IF_ERROR(uda_info.def->Merge(uda_info.uda.get(), merge_uda, function_ctx_.get()));
+    }
+  }
+  return Status::OK();
+}
+
+Status AggNode::EmitSpilledPartitions(ExecState* exec_state, const RowBatch& rb) {
+  // Spill the groups that are still in memory, so that the state of every group is in the files
+  // of a single partition.
+  PL_RETURN_IF_ERROR(SpillState(exec_state));
+  for (size_t i = 0; i < kNumSpillPartitions; ++i) {
+    for (const auto& file : spill_files_[i]) {
+      while (true) {
+        PL_ASSIGN_OR_RETURN(auto state_rb, file->ReadNext());
+        if (state_rb == nullptr) {
+          break;
+        }
+        if (vectorized_agg_ != nullptr) {
+          vectorized_agg_->MergeStateBatch(*state_rb);
+        } else {
+          PL_RETURN_IF_ERROR(MergeStateBatch(exec_state, *state_rb));
+        }
+      }
+    }
+    spill_files_[i].clear();
+    bool last = i + 1 == kNumSpillPartitions;
+    PL_RETURN_IF_ERROR(EmitGroups(exec_state, last && rb.eow(), last && rb.eos()));
     PL_RETURN_IF_ERROR(ClearAggState(exec_state));
   }
+  spill_files_.clear();
   return Status::OK();
 }
 
@@ -24,10 +24,12 @@
 #include <utility>
 #include <vector>
 
+#include "src/carnot/exec/agg_hash_table.h"
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
 #include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/exec/spill_file.h"
 #include "src/carnot/plan/operators.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/udf/base.h"
@@ -40,6 +42,8 @@
 #include "src/shared/types/types.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_bool(carnot_vectorized_agg);
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -70,6 +74,15 @@ class AggNode : public ProcessingNode {
   AggNode() = default;
   virtual ~AggNode() = default;
 
+  /**
+   * Merges the aggregate state of another AggNode of the same plan node into this one, e.g. the
+   * thread-local partial aggregates of a parallel pipeline (see ParallelPipeline). Neither node
+   * may have been sent end of stream yet. The other node's UDAs are moved into this node.
+   */
+  Status MergeFrom(ExecState* exec_state, AggNode* other);
+
+  bool windowed() const { return plan_node_->windowed(); }
+
  protected:
   Status AggregateGroupByNone(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status AggregateGroupByClause(ExecState* exec_state, const table_store::schema::RowBatch& rb);
@@ -81,6 +94,8 @@ class AggNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  // Only the vectorized hash table handles selection vectors.
+  bool ConsumesSelection() const override { return vectorized_agg_ != nullptr; }
 
  private:
   AggHashMap agg_hash_map_;
@@ -140,8 +155,12 @@ class AggNode : public ProcessingNode {
   Status HashRowBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status EvaluatePartialAggregates(ExecState* exec_state, size_t num_records);
   Status ResetGroupArgs();
-  Status ConvertAggHashMapToRowBatch(ExecState* exec_state,
+  // Adds the groups and their finalized values to the row batch. If `serialize_state` is set, the
+  // serialized state of the UDAs is added instead of their values.
+  Status ConvertAggHashMapToRowBatch(ExecState* exec_state, bool serialize_state,
                                      table_store::schema::RowBatch* output_rb);
+  // Sends a row batch with the finalized values of every group to the children.
+  Status EmitGroups(ExecState* exec_state, bool eow, bool eos);
 
   AggHashValue* CreateAggHashValue(ExecState* exec_state);
   RowTuple* CreateGroupArgsRowTuple() {
@@ -149,6 +168,39 @@ class AggNode : public ProcessingNode {
   }
 
   Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
+
+  // Creates vectorized_agg_ if all of the aggregates can be computed by a VectorizedAggHashTable.
+  void MaybeCreateVectorizedAgg(ExecState* exec_state);
+
+  // Set when the group by aggregate is computed by a VectorizedAggHashTable, instead of the
+  // AggHashMap and UDAs.
+  std::unique_ptr<VectorizedAggHashTable> vectorized_agg_;
+
+  // Spilling of blocking group by aggregates. When the query exceeds its memory limit (see
+  // MemoryTracker), the state of every group is written to the spill file of its partition, and
+  // cleared. Once the input is done, the partitions are merged back and emitted one at a time.
+  // The state of a group is the serialized state of its UDAs, or the state of the
+  // VectorizedAggHashTable, so only aggregates whose UDAs support partial aggregation can spill.
+  static constexpr size_t kNumSpillPartitions = 16;
+  bool CanSpill(ExecState* exec_state) const;
+  // The types of the columns of the state batches that are spilled.
+  std::vector<types::DataType> StateTypes() const;
+  // Reports the size of the group state to the memory tracker, and spills it if necessary.
+  Status TrackMemory(ExecState* exec_state);
+  Status SpillState(ExecState* exec_state);
+  Status MergeStateBatch(ExecState* exec_state, const table_store::schema::RowBatch& state_rb);
+  Status EmitSpilledPartitions(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+
+  bool can_spill_ = false;
+  // An estimate of the bytes held by the groups of agg_hash_map_.
+  int64_t group_state_bytes_ = 0;
+  // The bytes reported to the memory tracker.
+  int64_t tracked_bytes_ = 0;
+  // The spill files of each partition. A partition can have multiple files after MergeFrom.
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> spill_files_;
+  int64_t num_spills_ = 0;
+  // UDAs that spilled state is deserialized into, before it's merged into the state of a group.
+  std::vector<UDAInfo> merge_udas_;
 };
 
 }  // namespace exec
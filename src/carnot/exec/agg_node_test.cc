@@ -19,12 +19,16 @@
 #include "src/carnot/exec/agg_node.h"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
 
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 #include <sole.hpp>
 
 #include "src/carnot/exec/test_utils.h"
+#include "src/carnot/funcs/builtins/math_sketches.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/testing/testing.h"
@@ -71,6 +75,89 @@ class MinSumWithInitUDA : public udf::UDA {
   types::Int64Value sum_ = 0;
 };
 
+// Test UDAs with the names and types of builtin aggregates, which the AggNode computes with a
+// VectorizedAggHashTable.
+class SumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg) { sum_ = sum_.val + arg.val; }
+  void Merge(udf::FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+  types::StringValue Serialize(udf::FunctionContext*) { return std::to_string(sum_.val); }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    sum_ = std::stoll(data);
+    return Status::OK();
+  }
+
+ protected:
+  types::Int64Value sum_ = 0;
+};
+
+class CountUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value) { count_ = count_.val + 1; }
+  void Merge(udf::FunctionContext*, const CountUDA& other) {
+    count_ = count_.val + other.count_.val;
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return count_; }
+  types::StringValue Serialize(udf::FunctionContext*) { return std::to_string(count_.val); }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    count_ = std::stoll(data);
+    return Status::OK();
+  }
+
+ protected:
+  types::Int64Value count_ = 0;
+};
+
+class MaxUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Float64Value arg) {
+    max_ = std::max(max_.val, arg.val);
+  }
+  void Merge(udf::FunctionContext*, const MaxUDA& other) {
+    max_ = std::max(max_.val, other.max_.val);
+  }
+  types::Float64Value Finalize(udf::FunctionContext*) { return max_; }
+  types::StringValue Serialize(udf::FunctionContext*) {
+    return types::StringValue(reinterpret_cast<char*>(&max_.val), sizeof(max_.val));
+  }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    std::memcpy(&max_.val, data.data(), sizeof(max_.val));
+    return Status::OK();
+  }
+
+ protected:
+  types::Float64Value max_ = std::numeric_limits<double>::min();
+};
+
+class MeanUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg) {
+    sum_ += arg.val;
+    ++count_;
+  }
+  void Merge(udf::FunctionContext*, const MeanUDA& other) {
+    sum_ += other.sum_;
+    count_ += other.count_;
+  }
+  types::Float64Value Finalize(udf::FunctionContext*) { return sum_ / count_; }
+  types::StringValue Serialize(udf::FunctionContext*) {
+    types::StringValue data(sizeof(sum_) + sizeof(count_), '\0');
+    std::memcpy(data.data(), &sum_, sizeof(sum_));
+    std::memcpy(data.data() + sizeof(sum_), &count_, sizeof(count_));
+    return data;
+  }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    std::memcpy(&sum_, data.data(), sizeof(sum_));
+    std::memcpy(&count_, data.data() + sizeof(sum_), sizeof(count_));
+    return Status::OK();
+  }
+
+ protected:
+  double sum_ = 0;
+  int64_t count_ = 0;
+};
+
 constexpr char kBlockingNoGroupAgg[] = R"(
 op_type: AGGREGATE_OPERATOR
 agg_op {
@@ -270,6 +357,88 @@ agg_op {
   value_names: "value1"
 })";
 
+constexpr char kBlockingBuiltinsAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "sum"
+    id: 2
+    args {
+      column {
+        node:0
+        index: 2
+      }
+    }
+  }
+  values {
+    name: "count"
+    id: 3
+    args {
+      column {
+        node:0
+        index: 2
+      }
+    }
+  }
+  values {
+    name: "max"
+    id: 4
+    args {
+      column {
+        node:0
+        index: 3
+      }
+    }
+  }
+  values {
+    name: "mean"
+    id: 5
+    args {
+      column {
+        node:0
+        index: 2
+      }
+    }
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  groups {
+     node: 0
+     index: 1
+  }
+  group_names: "g1"
+  group_names: "g2"
+  value_names: "sum"
+  value_names: "count"
+  value_names: "max"
+  value_names: "mean"
+})";
+
+constexpr char kBlockingSketchAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "approx_count_distinct"
+    id: 6
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "num_distinct"
+})";
+
 std::unique_ptr<ExecState> MakeTestExecState(udf::Registry* registry) {
   auto table_store = std::make_shared<table_store::TableStore>();
   return std::make_unique<ExecState>(registry, table_store, MockResultSinkStubGenerator,
@@ -294,6 +463,19 @@ class AggNodeTest : public ::testing::Test {
     EXPECT_OK(exec_state_->AddUDA(0, "minsum",
                                   std::vector<types::DataType>({types::INT64, types::INT64})));
     EXPECT_OK(exec_state_->AddUDA(1, "minsum_w_init", {types::INT64, types::INT64, types::INT64}));
+
+    EXPECT_OK(func_registry_->Register<SumUDA>("sum"));
+    EXPECT_OK(func_registry_->Register<CountUDA>("count"));
+    EXPECT_OK(func_registry_->Register<MaxUDA>("max"));
+    EXPECT_OK(func_registry_->Register<MeanUDA>("mean"));
+    EXPECT_OK(exec_state_->AddUDA(2, "sum", {types::INT64}));
+    EXPECT_OK(exec_state_->AddUDA(3, "count", {types::INT64}));
+    EXPECT_OK(exec_state_->AddUDA(4, "max", {types::FLOAT64}));
+    EXPECT_OK(exec_state_->AddUDA(5, "mean", {types::INT64}));
+
+    EXPECT_OK(func_registry_->Register<builtins::ApproxCountDistinctUDA<types::Int64Value>>(
+        "approx_count_distinct"));
+    EXPECT_OK(exec_state_->AddUDA(6, "approx_count_distinct", {types::INT64}));
   }
 
  protected:
@@ -611,6 +793,135 @@ TEST_F(AggNodeTest, single_group_blocking_init_args) {
       .Close();
 }
 
+TEST_F(AggNodeTest, sketch_state_is_spilled) {
+  // The state of each group is a HyperLogLog of a few KB, so a handful of groups exceed the limit
+  // and are spilled.
+  exec_state_->memory_tracker()->set_limit_bytes(16 * 1024);
+  auto plan_node = PlanNodeFromPbtxt(kBlockingSketchAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // A batch is output for each of the 16 spill partitions.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 6, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 1})
+                       .AddColumn<types::Int64Value>({1, 1, 1, 1, 1, 2})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, true, true)
+                       .AddColumn<types::Int64Value>({1, 2, 5, 5})
+                       .AddColumn<types::Int64Value>({3, 1, 2, 3})
+                       .get(),
+                   0, 16)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, 5, true, true)
+                                .AddColumn<types::Int64Value>({1, 2, 3, 4, 5})
+                                .AddColumn<types::Int64Value>({3, 1, 1, 1, 3})
+                                .get(),
+                            16)
+      .Close();
+  EXPECT_EQ(0, exec_state_->memory_tracker()->bytes_used());
+}
+
+class AggNodeBuiltinsTest : public AggNodeTest, public ::testing::WithParamInterface<bool> {
+ protected:
+  void SetUp() override {
+    vectorized_agg_ = FLAGS_carnot_vectorized_agg;
+    FLAGS_carnot_vectorized_agg = GetParam();
+  }
+  void TearDown() override { FLAGS_carnot_vectorized_agg = vectorized_agg_; }
+
+ private:
+  bool vectorized_agg_;
+};
+
+TEST_P(AggNodeBuiltinsTest, multiple_groups_blocking) {
+  auto plan_node = PlanNodeFromPbtxt(kBlockingBuiltinsAgg);
+  RowDescriptor input_rd({types::DataType::STRING, types::DataType::INT64, types::DataType::INT64,
+                          types::DataType::FLOAT64});
+
+  RowDescriptor output_rd({types::DataType::STRING, types::DataType::INT64, types::DataType::INT64,
+                           types::DataType::INT64, types::DataType::FLOAT64,
+                           types::DataType::FLOAT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({"a", "b", "a", "c"})
+                       .AddColumn<types::Int64Value>({1, 1, 1, 2})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({0.5, 1.5, 2.5, 3.5})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, true, true)
+                       .AddColumn<types::StringValue>({"a", "b", "c", "c"})
+                       .AddColumn<types::Int64Value>({1, 2, 2, 2})
+                       .AddColumn<types::Int64Value>({5, 6, 7, 8})
+                       .AddColumn<types::Float64Value>({4.5, 0.25, 1.0, 9.0})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, true, true)
+                          .AddColumn<types::StringValue>({"a", "b", "c", "b"})
+                          .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                          .AddColumn<types::Int64Value>({9, 2, 19, 6})
+                          .AddColumn<types::Int64Value>({3, 1, 3, 1})
+                          .AddColumn<types::Float64Value>({4.5, 1.5, 9.0, 0.25})
+                          .AddColumn<types::Float64Value>({3.0, 2.0, 19.0 / 3, 6.0})
+                          .get(),
+                      false)
+      .Close();
+}
+
+TEST_P(AggNodeBuiltinsTest, multiple_groups_blocking_spilled) {
+  // Every batch exceeds the memory limit, so the groups are spilled after each batch, and merged
+  // back at the end of the stream.
+  exec_state_->memory_tracker()->set_limit_bytes(1);
+  auto plan_node = PlanNodeFromPbtxt(kBlockingBuiltinsAgg);
+  RowDescriptor input_rd({types::DataType::STRING, types::DataType::INT64, types::DataType::INT64,
+                          types::DataType::FLOAT64});
+
+  RowDescriptor output_rd({types::DataType::STRING, types::DataType::INT64, types::DataType::INT64,
+                           types::DataType::INT64, types::DataType::FLOAT64,
+                           types::DataType::FLOAT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // A batch is output for each of the 16 spill partitions.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({"a", "b", "a", "c"})
+                       .AddColumn<types::Int64Value>({1, 1, 1, 2})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({0.5, 1.5, 2.5, 3.5})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, true, true)
+                       .AddColumn<types::StringValue>({"a", "b", "c", "c"})
+                       .AddColumn<types::Int64Value>({1, 2, 2, 2})
+                       .AddColumn<types::Int64Value>({5, 6, 7, 8})
+                       .AddColumn<types::Float64Value>({4.5, 0.25, 1.0, 9.0})
+                       .get(),
+                   0, 16)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, 4, true, true)
+                                .AddColumn<types::StringValue>({"a", "b", "c", "b"})
+                                .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                                .AddColumn<types::Int64Value>({9, 2, 19, 6})
+                                .AddColumn<types::Int64Value>({3, 1, 3, 1})
+                                .AddColumn<types::Float64Value>({4.5, 1.5, 9.0, 0.25})
+                                .AddColumn<types::Float64Value>({3.0, 2.0, 19.0 / 3, 6.0})
+                                .get(),
+                            16)
+      .Close();
+  EXPECT_EQ(0, exec_state_->memory_tracker()->bytes_used());
+}
+
+INSTANTIATE_TEST_SUITE_P(VectorizedAgg, AggNodeBuiltinsTest, ::testing::Bool());
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
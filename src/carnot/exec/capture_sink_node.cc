@@ -0,0 +1,52 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/capture_sink_node.h"
+
+#include <string>
+
+#include <absl/strings/substitute.h>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+std::string CaptureSinkNode::DebugStringImpl() {
+  return absl::Substitute("Exec::CaptureSinkNode<$0>", sink_debug_string_);
+}
+
+Status CaptureSinkNode::InitImpl(const plan::Operator& plan_node) {
+  if (input_descriptors_.size() != 1) {
+    return error::InvalidArgument("Sink operator expects a single input relation, got $0",
+                                  input_descriptors_.size());
+  }
+  sink_debug_string_ = plan_node.DebugString();
+  return Status::OK();
+}
+
+Status CaptureSinkNode::ConsumeNextImpl(ExecState*, const RowBatch& rb, size_t) {
+  row_batches_.push_back(rb);
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/plan/operators.h"
+#include "src/common/base/base.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * CaptureSinkNode stands in for the sink of a plan fragment whose results are cached (see
+ * PlanResultCache). Instead of writing them out, it keeps the row batches that the sink would have
+ * consumed, so that they can later be replayed into the actual sink.
+ */
+class CaptureSinkNode : public SinkNode {
+ public:
+  CaptureSinkNode() = default;
+  virtual ~CaptureSinkNode() = default;
+
+  std::vector<table_store::schema::RowBatch>* row_batches() { return &row_batches_; }
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState*) override { return Status::OK(); }
+  Status OpenImpl(ExecState*) override { return Status::OK(); }
+  Status CloseImpl(ExecState*) override { return Status::OK(); }
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  std::string sink_debug_string_;
+  std::vector<table_store::schema::RowBatch> row_batches_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
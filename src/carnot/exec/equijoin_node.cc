@@ -23,9 +23,11 @@
 #include <arrow/status.h>
 #include <algorithm>
 #include <cstdint>
+#include <numeric>
 #include <string>
 #include <utility>
 
+#include <absl/strings/str_cat.h>
 #include <absl/strings/str_join.h>
 #include <absl/strings/substitute.h>
 
@@ -35,6 +37,13 @@
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/type_utils.h"
 
+DEFINE_int32(carnot_join_partition_bits,
+             gflags::Int32FromEnv("PL_CARNOT_JOIN_PARTITION_BITS", 6),
+             "The number of hash bits the build side of a join is radix partitioned by.");
+DEFINE_bool(carnot_join_runtime_filter, gflags::BoolFromEnv("PL_CARNOT_JOIN_RUNTIME_FILTER", true),
+            "Whether joins push a bloom filter of their build keys down to the sources of their "
+            "probe side, to drop rows that can't match early.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -60,6 +69,8 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
   plan_node_ = std::make_unique<plan::JoinOperator>(*join_plan_node);
   output_rows_per_batch_ =
       plan_node_->rows_per_batch() == 0 ? kDefaultJoinRowBatchSize : plan_node_->rows_per_batch();
+  partition_bits_ = std::clamp(FLAGS_carnot_join_partition_bits, 0, 16);
+  build_partitions_.resize(size_t{1} << partition_bits_);
 
   if (plan_node_->order_by_time() && plan_node_->time_column().parent_index() == 0) {
     // Make the probe table the left table when we need to preserve the order of the left table in
@@ -112,6 +123,17 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
     selected_spec.output_col_indices.emplace_back(i);
   }
 
+  spilled_build_types_ = key_data_types_;
+  for (size_t i = 0; i < key_data_types_.size(); ++i) {
+    spilled_build_key_indices_.push_back(i);
+  }
+  for (size_t i = 0; i < build_spec_.input_col_types.size(); ++i) {
+    spilled_build_types_.push_back(build_spec_.input_col_types[i]);
+    spilled_build_col_indices_.push_back(key_data_types_.size() + i);
+  }
+  partition_bytes_.resize(build_partitions_.size());
+  build_spill_files_.resize(build_partitions_.size());
+  probe_spill_files_.resize(build_partitions_.size());
   return Status::OK();
 }
 
@@ -133,11 +155,17 @@ Status EquijoinNode::PrepareImpl(ExecState* /*exec_state*/) {
 
 Status EquijoinNode::OpenImpl(ExecState* /*exec_state*/) { return Status::OK(); }
 
-Status EquijoinNode::CloseImpl(ExecState* /*exec_state*/) {
+Status EquijoinNode::CloseImpl(ExecState* exec_state) {
   join_keys_chunk_.clear();
-  build_buffer_.clear();
-  probed_keys_.clear();
+  build_partitions_.clear();
   key_values_pool_.Clear();
+  build_spill_files_.clear();
+  probe_spill_files_.clear();
+  exec_state->memory_tracker()->Track(&tracked_bytes_, 0);
+
+  if (num_spilled_partitions_ > 0) {
+    stats()->AddExtraInfo("num_spilled_partitions", absl::StrCat(num_spilled_partitions_));
+  }
   return Status::OK();
 }
 
@@ -151,7 +179,7 @@ void ExtractIntoRowTuples(std::vector<RowTuple*>* row_tuples, arrow::Array* inpu
 }
 
 Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch& rb,
-                                             bool is_probe) {
+                                             const std::vector<int64_t>& key_indices) {
   // Reset the row tuples
   for (auto& rt : join_keys_chunk_) {
     if (rt == nullptr) {
@@ -172,11 +200,9 @@ Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch
     }
   }
 
-  const TableSpec& spec = is_probe ? probe_spec_ : build_spec_;
-
   // Scan through all the group args in column order and extract the entire column.
-  for (size_t tuple_col_idx = 0; tuple_col_idx < spec.key_indices.size(); ++tuple_col_idx) {
-    auto input_col_idx = spec.key_indices[tuple_col_idx];
+  for (size_t tuple_col_idx = 0; tuple_col_idx < key_indices.size(); ++tuple_col_idx) {
+    auto input_col_idx = key_indices[tuple_col_idx];
     auto dt = key_data_types_[tuple_col_idx];
     auto col = rb.ColumnAt(input_col_idx).get();
 
@@ -188,6 +214,21 @@ Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch
   return Status::OK();
 }
 
+void EquijoinNode::HashJoinKeys(int64_t num_rows) {
+  join_key_hashes_.resize(num_rows);
+  for (int64_t row_idx = 0; row_idx < num_rows; ++row_idx) {
+    join_key_hashes_[row_idx] = join_keys_chunk_[row_idx]->Hash();
+  }
+}
+
+size_t EquijoinNode::PartitionOf(size_t key_hash) const {
+  // The high bits pick the partition, since the hash maps use the low bits.
+  if (partition_bits_ == 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(key_hash) >> (64 - partition_bits_);
+}
+
 std::vector<types::SharedColumnWrapper>* CreateWrapper(ObjectPool* pool,
                                                        const std::vector<types::DataType>& types) {
   auto ptr = pool->Add(new std::vector<types::SharedColumnWrapper>(types.size()));
@@ -197,7 +238,8 @@ std::vector<types::SharedColumnWrapper>* CreateWrapper(ObjectPool* pool,
   return ptr;
 }
 
-Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
+Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb,
+                                  const std::vector<int64_t>& col_indices) {
   if (rb.num_rows() > static_cast<int64_t>(build_wrappers_chunk_.size())) {
     build_wrappers_chunk_.resize(rb.num_rows());
   }
@@ -208,15 +250,21 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
     }
   }
 
+  int64_t row_bytes = rb.num_rows() > 0 ? rb.NumBytes() / rb.num_rows() : 0;
   // Make sure the map has constructed the necessary column wrappers for all of the tuples.
   for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
-    auto& rt = join_keys_chunk_[row_idx];
-    auto& current = build_buffer_[rt];
-    auto wrappers_ptr = current != nullptr ? current : build_wrappers_chunk_[row_idx];
+    HashedKey key{join_keys_chunk_[row_idx], join_key_hashes_[row_idx]};
+    auto partition = PartitionOf(key.hash);
+    if (IsSpilled(partition)) {
+      continue;
+    }
+    partition_bytes_[partition] += row_bytes;
+    auto& entry = build_partitions_[partition][key];
+    auto wrappers_ptr = entry.wrappers != nullptr ? entry.wrappers : build_wrappers_chunk_[row_idx];
 
     // Now extract the values into the corresponding column wrappers.
-    for (size_t i = 0; i < build_spec_.input_col_indices.size(); ++i) {
-      const auto& rb_col_idx = build_spec_.input_col_indices[i];
+    for (size_t i = 0; i < col_indices.size(); ++i) {
+      const auto& rb_col_idx = col_indices[i];
       auto arr = rb.ColumnAt(rb_col_idx).get();
       const auto& dt = build_spec_.input_col_types[i];
 
@@ -226,10 +274,10 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
 #undef TYPE_CASE
     }
     // Keep track of the number of rows that the build buffer matches for each key.
-    build_buffer_rows_[rt]++;
+    ++entry.num_rows;
 
-    if (current == nullptr) {
-      std::swap(build_wrappers_chunk_[row_idx], current);
+    if (entry.wrappers == nullptr) {
+      std::swap(build_wrappers_chunk_[row_idx], entry.wrappers);
       // Reset the new tuples that we added
       join_keys_chunk_[row_idx] = nullptr;
     }
@@ -250,6 +298,14 @@ Status AppendValuesFromWrapper(arrow::ArrayBuilder* output_builder,
   return Status::OK();
 }
 
+template <types::DataType DT>
+Status AppendKeyValueRepeated(arrow::ArrayBuilder* output_builder, const RowTuple* key,
+                              size_t key_idx, size_t num_times) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  return table_store::schema::CopyValueRepeated<DT>(
+      output_builder, udf::UnWrap(key->GetValue<ValueType>(key_idx)), num_times);
+}
+
 template <types::DataType DT>
 Status AppendColumnDefaultValue(arrow::ArrayBuilder* output_builder, size_t num_times) {
   using ValueType = typename types::DataTypeTraits<DT>::value_type;
@@ -351,20 +407,62 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
     probe_eos_ = true;
   }
 
-  PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, true));
+  PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, probe_spec_.key_indices));
+  HashJoinKeys(rb.num_rows());
 
-  if (rb.num_rows() > static_cast<int64_t>(probe_wrappers_chunk_.size())) {
-    probe_wrappers_chunk_.resize(rb.num_rows());
+  if (rb.num_rows() > static_cast<int64_t>(probe_entries_chunk_.size())) {
+    probe_entries_chunk_.resize(rb.num_rows());
   }
 
+  // Order the rows by partition with a counting sort, then look up the rows of each partition.
+  partition_offsets_.assign(build_partitions_.size() + 1, 0);
   for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
-    auto it = build_buffer_.find(join_keys_chunk_[row_idx]);
-    if (it != build_buffer_.end()) {
-      probe_wrappers_chunk_[row_idx] = it->second;
-      probed_keys_.insert(it->first);
-    } else {
-      probe_wrappers_chunk_[row_idx] = nullptr;
+    ++partition_offsets_[PartitionOf(join_key_hashes_[row_idx]) + 1];
+  }
+  for (size_t p = 0; p < build_partitions_.size(); ++p) {
+    partition_offsets_[p + 1] += partition_offsets_[p];
+  }
+  probe_rows_by_partition_.resize(rb.num_rows());
+  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    // Each offset is advanced past the rows placed in its partition, which leaves it at the end
+    // of the partition.
+    auto partition = PartitionOf(join_key_hashes_[row_idx]);
+    probe_rows_by_partition_[partition_offsets_[partition]++] = row_idx;
+  }
+
+  int64_t partition_start = 0;
+  for (size_t p = 0; p < build_partitions_.size(); ++p) {
+    auto& partition = build_partitions_[p];
+    int64_t partition_end = partition_offsets_[p];
+    if (IsSpilled(p)) {
+      // The rows are joined once the partition is read back, see JoinSpilledPartitions.
+      if (partition_end > partition_start) {
+        if (probe_spill_files_[p] == nullptr) {
+          PL_ASSIGN_OR_RETURN(probe_spill_files_[p], SpillFile::Create());
+        }
+        RowBatch spill_rb = rb;
+        spill_rb.set_selection(std::make_shared<const std::vector<int64_t>>(
+            probe_rows_by_partition_.begin() + partition_start,
+            probe_rows_by_partition_.begin() + partition_end));
+        PL_RETURN_IF_ERROR(probe_spill_files_[p]->Write(spill_rb));
+      }
+      for (int64_t i = partition_start; i < partition_end; ++i) {
+        probe_entries_chunk_[probe_rows_by_partition_[i]] = &spilled_entry_;
+      }
+      partition_start = partition_end;
+      continue;
+    }
+    for (int64_t i = partition_start; i < partition_end; ++i) {
+      auto row_idx = probe_rows_by_partition_[i];
+      auto it = partition.find(HashedKey{join_keys_chunk_[row_idx], join_key_hashes_[row_idx]});
+      if (it != partition.end()) {
+        it->second.probed = true;
+        probe_entries_chunk_[row_idx] = &it->second;
+      } else {
+        probe_entries_chunk_[row_idx] = nullptr;
+      }
     }
+    partition_start = partition_end;
   }
 
   auto rb_ptr = std::make_shared<RowBatch>(rb);
@@ -374,7 +472,10 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
       PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
     }
 
-    if (probe_wrappers_chunk_[row_idx] == nullptr) {
+    if (probe_entries_chunk_[row_idx] == &spilled_entry_) {
+      continue;
+    }
+    if (probe_entries_chunk_[row_idx] == nullptr) {
       if (probe_spec_.emit_unmatched_rows) {
         OutputChunk c{rb_ptr, nullptr, 1, 0, row_idx};
         chunks_.emplace_back(c);
@@ -383,9 +484,9 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
       continue;
     }
 
-    PL_RETURN_IF_ERROR(MatchBuildValuesAndFlush(exec_state, probe_wrappers_chunk_[row_idx], rb_ptr,
-                                                row_idx,
-                                                build_buffer_rows_[join_keys_chunk_[row_idx]]));
+    const auto& entry = *probe_entries_chunk_[row_idx];
+    PL_RETURN_IF_ERROR(
+        MatchBuildValuesAndFlush(exec_state, entry.wrappers, rb_ptr, row_idx, entry.num_rows));
   }
 
   if (probe_eos_ && queued_rows_ > 0) {
@@ -396,12 +497,14 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
 }
 
 Status EquijoinNode::EmitUnmatchedBuildRows(ExecState* exec_state) {
-  for (auto it = build_buffer_.begin(); it != build_buffer_.end(); ++it) {
-    if (probed_keys_.find(it->first) != probed_keys_.end()) {
-      continue;
+  for (const auto& partition : build_partitions_) {
+    for (const auto& [key, entry] : partition) {
+      if (entry.probed) {
+        continue;
+      }
+      PL_RETURN_IF_ERROR(
+          MatchBuildValuesAndFlush(exec_state, entry.wrappers, nullptr, 0, entry.num_rows));
     }
-    PL_RETURN_IF_ERROR(MatchBuildValuesAndFlush(exec_state, it->second, nullptr, 0,
-                                                build_buffer_rows_[it->first]));
   }
 
   if (queued_rows_ > 0) {
@@ -410,16 +513,46 @@ Status EquijoinNode::EmitUnmatchedBuildRows(ExecState* exec_state) {
   return Status::OK();
 }
 
+Status EquijoinNode::PushDownRuntimeFilter() {
+  // The keys of spilled partitions aren't in memory, so they can't be added to the filter.
+  if (runtime_filter_targets_.empty() || num_spilled_partitions_ > 0) {
+    return Status::OK();
+  }
+  int64_t num_keys = 0;
+  for (const auto& partition : build_partitions_) {
+    num_keys += partition.size();
+  }
+  if (num_keys > kMaxRuntimeFilterKeys) {
+    return Status::OK();
+  }
+
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<RuntimeJoinFilter> filter,
+                      RuntimeJoinFilter::Create(key_data_types_, num_keys));
+  for (const auto& partition : build_partitions_) {
+    for (const auto& [key, entry] : partition) {
+      filter->Insert(key.hash);
+    }
+  }
+  for (const auto& target : runtime_filter_targets_) {
+    target.source->AddRuntimeFilter(filter, target.key_col_idxs);
+  }
+  return Status::OK();
+}
+
 Status EquijoinNode::ConsumeBuildBatch(ExecState* exec_state,
                                        const table_store::schema::RowBatch& rb) {
   if (rb.eos()) {
     build_eos_ = true;
   }
 
-  PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, false));
-  PL_RETURN_IF_ERROR(HashRowBatch(rb));
+  PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, build_spec_.key_indices));
+  HashJoinKeys(rb.num_rows());
+  PL_RETURN_IF_ERROR(SpillBuildRows(rb));
+  PL_RETURN_IF_ERROR(HashRowBatch(rb, build_spec_.input_col_indices));
+  PL_RETURN_IF_ERROR(TrackBuildMemory(exec_state));
 
   if (build_eos_) {
+    PL_RETURN_IF_ERROR(PushDownRuntimeFilter());
     while (probe_batches_.size()) {
       PL_RETURN_IF_ERROR(DoProbe(exec_state, probe_batches_.front()));
       probe_batches_.pop();
@@ -451,6 +584,9 @@ Status EquijoinNode::ConsumeNextImpl(ExecState* exec_state, const table_store::s
     if (build_spec_.emit_unmatched_rows) {
       PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
     }
+    if (num_spilled_partitions_ > 0) {
+      PL_RETURN_IF_ERROR(JoinSpilledPartitions(exec_state));
+    }
 
     if (column_builders_[0]->length()) {
       PL_RETURN_IF_ERROR(NextOutputBatch(exec_state));
@@ -472,6 +608,147 @@ Status EquijoinNode::ConsumeNextImpl(ExecState* exec_state, const table_store::s
   return Status::OK();
 }
 
+int64_t EquijoinNode::BuildBytes() const {
+  return std::accumulate(partition_bytes_.begin(), partition_bytes_.end(), int64_t{0});
+}
+
+Status EquijoinNode::TrackBuildMemory(ExecState* exec_state) {
+  auto* tracker = exec_state->memory_tracker();
+  tracker->Track(&tracked_bytes_, BuildBytes());
+  while (CanSpill() && tracker->LimitExceeded()) {
+    auto largest = std::max_element(partition_bytes_.begin(), partition_bytes_.end());
+    if (*largest == 0) {
+      break;
+    }
+    size_t partition = largest - partition_bytes_.begin();
+    PL_RETURN_IF_ERROR(SpillBuildPartition(partition));
+    ReleaseBuildPartition(exec_state, partition);
+  }
+  return Status::OK();
+}
+
+Status EquijoinNode::SpillBuildPartition(size_t partition) {
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders;
+  for (auto dt : spilled_build_types_) {
+    builders.push_back(MakeArrowBuilder(dt, arrow::default_memory_pool()));
+  }
+  size_t num_keys = key_data_types_.size();
+  int64_t num_rows = 0;
+  for (const auto& [key, entry] : build_partitions_[partition]) {
+    for (size_t i = 0; i < num_keys; ++i) {
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(AppendKeyValueRepeated<_dt_>(builders[i].get(), key.key, i, entry.num_rows))
+      PL_SWITCH_FOREACH_DATATYPE(key_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    for (size_t i = 0; i < build_spec_.input_col_types.size(); ++i) {
+#define TYPE_CASE(_dt_)                                                          \
+  PL_RETURN_IF_ERROR(AppendValuesFromWrapper<_dt_>(builders[num_keys + i].get(), \
+                                                   entry.wrappers->at(i), 0, entry.num_rows))
+      PL_SWITCH_FOREACH_DATATYPE(build_spec_.input_col_types[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    num_rows += entry.num_rows;
+  }
+
+  RowBatch spill_rb(RowDescriptor(spilled_build_types_), num_rows);
+  for (const auto& builder : builders) {
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(spill_rb.AddColumn(arr));
+  }
+  PL_ASSIGN_OR_RETURN(build_spill_files_[partition], SpillFile::Create());
+  ++num_spilled_partitions_;
+  return build_spill_files_[partition]->Write(spill_rb);
+}
+
+Status EquijoinNode::SpillBuildRows(const RowBatch& rb) {
+  if (num_spilled_partitions_ == 0) {
+    return Status::OK();
+  }
+  std::vector<std::vector<int64_t>> partition_rows(build_partitions_.size());
+  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    auto partition = PartitionOf(join_key_hashes_[row_idx]);
+    if (IsSpilled(partition)) {
+      partition_rows[partition].push_back(row_idx);
+    }
+  }
+
+  RowBatch spill_rb(RowDescriptor(spilled_build_types_), rb.num_rows());
+  for (auto col_idx : build_spec_.key_indices) {
+    PL_RETURN_IF_ERROR(spill_rb.AddColumn(rb.ColumnAt(col_idx)));
+  }
+  for (auto col_idx : build_spec_.input_col_indices) {
+    PL_RETURN_IF_ERROR(spill_rb.AddColumn(rb.ColumnAt(col_idx)));
+  }
+  for (size_t p = 0; p < partition_rows.size(); ++p) {
+    if (partition_rows[p].empty()) {
+      continue;
+    }
+    spill_rb.set_selection(
+        std::make_shared<const std::vector<int64_t>>(std::move(partition_rows[p])));
+    PL_RETURN_IF_ERROR(build_spill_files_[p]->Write(spill_rb));
+  }
+  return Status::OK();
+}
+
+void EquijoinNode::ReleaseBuildPartition(ExecState* exec_state, size_t partition) {
+  for (const auto& [key, entry] : build_partitions_[partition]) {
+    // The wrappers are owned by the pool, but the values they hold can be freed.
+    for (auto& col : *entry.wrappers) {
+      col.reset();
+    }
+  }
+  build_partitions_[partition] = BuildPartition();
+  partition_bytes_[partition] = 0;
+  exec_state->memory_tracker()->Track(&tracked_bytes_, BuildBytes());
+}
+
+Status EquijoinNode::JoinSpilledPartitions(ExecState* exec_state) {
+  // The in-memory partitions are done, so their rows are output and freed first.
+  if (queued_rows_ > 0) {
+    PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+  }
+  for (size_t p = 0; p < build_partitions_.size(); ++p) {
+    ReleaseBuildPartition(exec_state, p);
+  }
+
+  for (size_t p = 0; p < build_partitions_.size(); ++p) {
+    if (!IsSpilled(p)) {
+      continue;
+    }
+    // Once the spill files are taken, the partition is joined in memory like any other.
+    auto build_file = std::move(build_spill_files_[p]);
+    auto probe_file = std::move(probe_spill_files_[p]);
+    while (true) {
+      PL_ASSIGN_OR_RETURN(auto build_rb, build_file->ReadNext());
+      if (build_rb == nullptr) {
+        break;
+      }
+      PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(*build_rb, spilled_build_key_indices_));
+      HashJoinKeys(build_rb->num_rows());
+      PL_RETURN_IF_ERROR(HashRowBatch(*build_rb, spilled_build_col_indices_));
+    }
+    exec_state->memory_tracker()->Track(&tracked_bytes_, BuildBytes());
+
+    while (probe_file != nullptr) {
+      PL_ASSIGN_OR_RETURN(auto probe_rb, probe_file->ReadNext());
+      if (probe_rb == nullptr) {
+        break;
+      }
+      PL_RETURN_IF_ERROR(DoProbe(exec_state, *probe_rb));
+    }
+    if (build_spec_.emit_unmatched_rows) {
+      PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
+    }
+    if (queued_rows_ > 0) {
+      PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+    }
+    ReleaseBuildPartition(exec_state, p);
+  }
+  return Status::OK();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -31,6 +31,8 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/exec/runtime_join_filter.h"
+#include "src/carnot/exec/spill_file.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
@@ -39,11 +41,17 @@
 #include "src/shared/types/types.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_int32(carnot_join_partition_bits);
+DECLARE_bool(carnot_join_runtime_filter);
+
 namespace px {
 namespace carnot {
 namespace exec {
 
 constexpr size_t kDefaultJoinRowBatchSize = 1024;
+// Runtime filters aren't pushed down for build sides with more distinct keys than this, since the
+// filter would be large, and unlikely to drop enough rows to pay for itself.
+constexpr int64_t kMaxRuntimeFilterKeys = 1 << 20;
 
 class EquijoinNode : public ProcessingNode {
   enum class JoinInputTable { kLeftTable, kRightTable };
@@ -64,6 +72,32 @@ class EquijoinNode : public ProcessingNode {
   EquijoinNode() = default;
   virtual ~EquijoinNode() = default;
 
+  /**
+   * @return the index of the parent that is the probe side of the join.
+   */
+  size_t probe_parent_index() const {
+    return probe_table_ == EquijoinNode::JoinInputTable::kLeftTable ? 0 : 1;
+  }
+  const std::vector<int64_t>& probe_key_indices() const { return probe_spec_.key_indices; }
+
+  /**
+   * @return whether the join pushes a runtime filter down to its probe side, which is only the
+   * case if probe rows without a match aren't output.
+   */
+  bool HasRuntimeFilter() const {
+    return FLAGS_carnot_join_runtime_filter && !probe_spec_.emit_unmatched_rows;
+  }
+
+  /**
+   * Adds a source of the probe side that the runtime filter is pushed down to, once the build side
+   * is complete.
+   * @param source the source, which may only feed the join.
+   * @param key_col_idxs the output columns of the source that hold the join keys, in key order.
+   */
+  void AddRuntimeFilterTarget(SourceNode* source, std::vector<int64_t> key_col_idxs) {
+    runtime_filter_targets_.push_back({source, std::move(key_col_idxs)});
+  }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -77,8 +111,29 @@ class EquijoinNode : public ProcessingNode {
   Status InitializeColumnBuilders();
   bool IsProbeTable(size_t parent_index);
   Status FlushChunkedRows(ExecState* exec_state);
-  Status ExtractJoinKeysForBatch(const table_store::schema::RowBatch& rb, bool is_probe);
-  Status HashRowBatch(const table_store::schema::RowBatch& rb);
+  Status ExtractJoinKeysForBatch(const table_store::schema::RowBatch& rb,
+                                 const std::vector<int64_t>& key_indices);
+  void HashJoinKeys(int64_t num_rows);
+  // Adds the build rows of the batch to the partitions that aren't spilled.
+  // @param col_indices the indices of the build input columns in the batch.
+  Status HashRowBatch(const table_store::schema::RowBatch& rb,
+                      const std::vector<int64_t>& col_indices);
+  size_t PartitionOf(size_t key_hash) const;
+  Status PushDownRuntimeFilter();
+
+  // Spilling of the build side, see build_spill_files_.
+  bool CanSpill() const { return !plan_node_->order_by_time() && partition_bits_ > 0; }
+  bool IsSpilled(size_t partition) const { return build_spill_files_[partition] != nullptr; }
+  int64_t BuildBytes() const;
+  // Reports the size of the build side to the memory tracker, and spills the largest partitions
+  // while the query exceeds its memory limit.
+  Status TrackBuildMemory(ExecState* exec_state);
+  Status SpillBuildPartition(size_t partition);
+  // Writes the rows of the batch that belong to spilled partitions to their spill files.
+  Status SpillBuildRows(const table_store::schema::RowBatch& rb);
+  void ReleaseBuildPartition(ExecState* exec_state, size_t partition);
+  // Joins the spilled partitions, one at a time, once the in-memory partitions are done.
+  Status JoinSpilledPartitions(ExecState* exec_state);
 
   Status DoProbe(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status MatchBuildValuesAndFlush(ExecState* exec_state,
@@ -103,6 +158,9 @@ class EquijoinNode : public ProcessingNode {
   TableSpec probe_spec_;
 
   std::vector<types::DataType> key_data_types_;
+  // The build side is partitioned into 2^partition_bits_ hash maps by the high bits of the key
+  // hashes.
+  int partition_bits_ = 0;
 
   // Example of the above specs:
   // For input table A (build) which has [key_A_1, output_col_0, key_A_0/output_col_2]
@@ -138,18 +196,70 @@ class EquijoinNode : public ProcessingNode {
   // Chunk of data to use when performing the build stage of the join.
   std::vector<std::vector<types::SharedColumnWrapper>*> build_wrappers_chunk_;
 
-  // Chunk of data to use when performing the probe stage of the join.
-  // This will store build table data from `build_buffer_`.
-  std::vector<std::vector<types::SharedColumnWrapper>*> probe_wrappers_chunk_;
-  AbslRowTupleHashMap<std::vector<types::SharedColumnWrapper>*> build_buffer_;
-  // Store the number of rows that match a given set of keys for the build buffer.
-  // This is necessary to store in addition to the values in `build_buffer_` in
-  // the event that no columns from the build side are emitted.
-  AbslRowTupleHashMap<int64_t> build_buffer_rows_;
-
-  // For joins where the build_buffer_ needs to emit any non-probed rows at the end of the join,
-  // keep track of which ones they were.
-  AbslRowTupleHashSet probed_keys_;
+  // The hashes of the keys in join_keys_chunk_.
+  std::vector<size_t> join_key_hashes_;
+
+  // A join key along with its hash, which is computed once per row to pick the key's partition and
+  // to look it up within the partition.
+  struct HashedKey {
+    RowTuple* key;
+    size_t hash;
+  };
+  struct HashedKeyHasher {
+    size_t operator()(const HashedKey& k) const { return k.hash; }
+  };
+  struct HashedKeyEq {
+    bool operator()(const HashedKey& k1, const HashedKey& k2) const {
+      return k1.hash == k2.hash && *k1.key == *k2.key;
+    }
+  };
+  // The build rows for a set of keys.
+  struct BuildEntry {
+    std::vector<types::SharedColumnWrapper>* wrappers = nullptr;
+    // This is necessary to store in addition to the wrappers in the event that no columns from the
+    // build side are emitted.
+    int64_t num_rows = 0;
+    // For joins that emit the unmatched build rows at the end of the join, whether any probe row
+    // matched the keys.
+    bool probed = false;
+  };
+  using BuildPartition = absl::flat_hash_map<HashedKey, BuildEntry, HashedKeyHasher, HashedKeyEq>;
+  std::vector<BuildPartition> build_partitions_;
+
+  // Chunk of data to use when performing the probe stage of the join. The rows of a probe batch are
+  // radix partitioned like the build side, so that each partition is probed for all of its rows
+  // at once, while its hash map is in cache.
+  std::vector<int64_t> partition_offsets_;
+  std::vector<int64_t> probe_rows_by_partition_;
+  // The matching build entry of each probe row, or nullptr.
+  std::vector<BuildEntry*> probe_entries_chunk_;
+
+  struct RuntimeFilterTarget {
+    SourceNode* source;
+    std::vector<int64_t> key_col_idxs;
+  };
+  std::vector<RuntimeFilterTarget> runtime_filter_targets_;
+
+  // When the query exceeds its memory limit (see MemoryTracker) while the build side is consumed,
+  // the largest build partitions are written to spill files, followed by the later build rows and
+  // all of the probe rows of those partitions. Once both inputs are done, the spilled partitions
+  // are read back and joined one at a time. This reorders the output, so joins that are ordered by
+  // time don't spill.
+  // An estimate of the bytes held by each build partition.
+  std::vector<int64_t> partition_bytes_;
+  // The bytes reported to the memory tracker.
+  int64_t tracked_bytes_ = 0;
+  // The spill files of the build and probe rows of each partition, or nullptr if the partition
+  // isn't spilled.
+  std::vector<std::unique_ptr<SpillFile>> build_spill_files_;
+  std::vector<std::unique_ptr<SpillFile>> probe_spill_files_;
+  int64_t num_spilled_partitions_ = 0;
+  // Spilled build rows have the key columns followed by the build input columns.
+  std::vector<types::DataType> spilled_build_types_;
+  std::vector<int64_t> spilled_build_key_indices_;
+  std::vector<int64_t> spilled_build_col_indices_;
+  // The entry of probe rows in spilled partitions, which are joined later.
+  BuildEntry spilled_entry_;
 
   // Handle on the most recent RowBatch (in case it's the final one).
   std::unique_ptr<table_store::schema::RowBatch> pending_output_batch_;
@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <sole.hpp>
 
+#include "src/carnot/exec/exec_node_mock.h"
 #include "src/carnot/exec/test_utils.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/planpb/test_proto.h"
@@ -686,6 +687,171 @@ TEST_F(JoinNodeTest, unordered_many_matches) {
       .Close();
 }
 
+const char* kInnerJoinOnFirstColumnsProto = R"(
+  type: INNER
+  equality_conditions {
+    left_column_index: 0
+    right_column_index: 0
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 1
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 0
+  }
+  column_names: "left_1"
+  column_names: "right_0"
+  rows_per_batch: 1000
+)";
+
+TEST_F(JoinNodeTest, partitioned_probe_keeps_probe_order) {
+  // Left table input: [left_0:Int64, left_1:Int64]
+  // Right table input: [right_0:Int64]
+  // Output table: [left_1:Int64, right_0:Int64]
+  RowDescriptor input_rd_0({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor input_rd_1({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  std::vector<types::Int64Value> build_keys;
+  std::vector<types::Int64Value> build_values;
+  for (int64_t i = 0; i < 100; ++i) {
+    build_keys.push_back(i);
+    build_values.push_back(i * 10);
+  }
+  std::vector<types::Int64Value> probe_keys;
+  for (int64_t i = 199; i >= 0; --i) {
+    probe_keys.push_back(i);
+  }
+  std::vector<types::Int64Value> expected_values;
+  std::vector<types::Int64Value> expected_keys;
+  for (int64_t i = 99; i >= 0; --i) {
+    expected_values.push_back(i * 10);
+    expected_keys.push_back(i);
+  }
+
+  auto partition_bits = FLAGS_carnot_join_partition_bits;
+  for (int32_t bits : {0, 6}) {
+    FLAGS_carnot_join_partition_bits = bits;
+    auto plan_node = PlanNodeFromPbtxt(kInnerJoinOnFirstColumnsProto);
+    auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+        *plan_node, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+    tester
+        .ConsumeNext(RowBatchBuilder(input_rd_0, 100, /*eow*/ true, /*eos*/ true)
+                         .AddColumn<types::Int64Value>(build_keys)
+                         .AddColumn<types::Int64Value>(build_values)
+                         .get(),
+                     0, 0)
+        .ConsumeNext(RowBatchBuilder(input_rd_1, 200, /*eow*/ true, /*eos*/ true)
+                         .AddColumn<types::Int64Value>(probe_keys)
+                         .get(),
+                     1, 1)
+        .ExpectRowBatch(RowBatchBuilder(output_rd, 100, true, true)
+                            .AddColumn<types::Int64Value>(expected_values)
+                            .AddColumn<types::Int64Value>(expected_keys)
+                            .get(),
+                        true)
+        .Close();
+  }
+  FLAGS_carnot_join_partition_bits = partition_bits;
+}
+
+TEST_F(JoinNodeTest, spilled_build_partitions) {
+  // Every build batch exceeds the memory limit, so the partition of the build keys is spilled, and
+  // joined once both inputs are done.
+  exec_state_->memory_tracker()->set_limit_bytes(1);
+  RowDescriptor input_rd_0({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor input_rd_1({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(kInnerJoinOnFirstColumnsProto);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+  MockSourceNode probe_source(input_rd_1);
+  tester.node()->AddRuntimeFilterTarget(&probe_source, {0});
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 3, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 1})
+                       .AddColumn<types::Int64Value>({10, 20, 30})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 1})
+                       .AddColumn<types::Int64Value>({40, 50})
+                       .get(),
+                   0, 0);
+
+  // The spilled keys aren't in memory, so no runtime filter is pushed down.
+  RowBatchBuilder probe_builder(input_rd_1, 3, /*eow*/ true, /*eos*/ true);
+  auto& probe_rb = probe_builder.AddColumn<types::Int64Value>({1, 2, 1}).get();
+  ASSERT_OK(probe_source.ApplyRuntimeFilters(&probe_rb));
+  EXPECT_FALSE(probe_rb.has_selection());
+
+  tester.ConsumeNext(probe_rb, 1, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 10, true, true)
+                          .AddColumn<types::Int64Value>({10, 20, 30, 40, 50, 10, 20, 30, 40, 50})
+                          .AddColumn<types::Int64Value>({1, 1, 1, 1, 1, 1, 1, 1, 1, 1})
+                          .get(),
+                      false)
+      .Close();
+  EXPECT_EQ(0, exec_state_->memory_tracker()->bytes_used());
+}
+
+TEST_F(JoinNodeTest, runtime_filter_pushdown) {
+  RowDescriptor input_rd_0({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor input_rd_1({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(kInnerJoinOnFirstColumnsProto);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+  ASSERT_TRUE(tester.node()->HasRuntimeFilter());
+  EXPECT_EQ(1U, tester.node()->probe_parent_index());
+  MockSourceNode probe_source(input_rd_1);
+  tester.node()->AddRuntimeFilterTarget(&probe_source, {0});
+
+  tester.ConsumeNext(RowBatchBuilder(input_rd_0, 3, /*eow*/ true, /*eos*/ true)
+                         .AddColumn<types::Int64Value>({1, 2, 3})
+                         .AddColumn<types::Int64Value>({10, 20, 30})
+                         .get(),
+                     0, 0);
+
+  // The source drops the rows that can't match once the build side is complete.
+  RowBatchBuilder probe_builder(input_rd_1, 4, /*eow*/ true, /*eos*/ true);
+  auto& probe_rb = probe_builder.AddColumn<types::Int64Value>({1, 5, 3, 7}).get();
+  ASSERT_OK(probe_source.ApplyRuntimeFilters(&probe_rb));
+  ASSERT_TRUE(probe_rb.has_selection());
+  EXPECT_EQ(std::vector<int64_t>({0, 2}), *probe_rb.selection());
+  EXPECT_EQ(2, probe_source.RowsDroppedByRuntimeFilters());
+
+  tester.ConsumeNext(probe_rb, 1, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({10, 30})
+                          .AddColumn<types::Int64Value>({1, 3})
+                          .get(),
+                      true)
+      .Close();
+}
+
+TEST_F(JoinNodeTest, no_runtime_filter_for_outer_joins) {
+  RowDescriptor input_rd_0({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor input_rd_1({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  planpb::Operator op_pb;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      absl::Substitute(planpb::testutils::kOperatorProtoTmpl, "JOIN_OPERATOR", "join_op",
+                       kInnerJoinOnFirstColumnsProto),
+      &op_pb));
+  op_pb.mutable_join_op()->set_type(planpb::JoinOperator::FULL_OUTER);
+  auto plan_node = plan::JoinOperator::FromProto(op_pb, 1);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+  EXPECT_FALSE(tester.node()->HasRuntimeFilter());
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -22,8 +22,11 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "src/carnot/exec/agg_node.h"
+#include "src/carnot/exec/capture_sink_node.h"
 #include "src/carnot/exec/empty_source_node.h"
 #include "src/carnot/exec/equijoin_node.h"
 #include "src/carnot/exec/exec_node.h"
@@ -36,6 +39,8 @@
 #include "src/carnot/exec/memory_sink_node.h"
 #include "src/carnot/exec/memory_source_node.h"
 #include "src/carnot/exec/otel_export_sink_node.h"
+#include "src/carnot/exec/sort_node.h"
+#include "src/carnot/exec/topk_node.h"
 #include "src/carnot/exec/udtf_source_node.h"
 #include "src/carnot/exec/union_node.h"
 #include "src/carnot/plan/operators.h"
@@ -52,7 +57,8 @@ using table_store::schema::RowDescriptor;
 Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
                             ExecState* exec_state, plan::PlanFragment* pf,
                             bool collect_exec_node_stats,
-                            int32_t consecutive_generate_calls_per_source) {
+                            int32_t consecutive_generate_calls_per_source,
+                            int32_t exec_parallelism) {
   plan_state_ = plan_state;
   schema_ = schema;
   pf_ = pf;
@@ -62,53 +68,193 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
 
   std::unordered_map<int64_t, ExecNode*> nodes;
   std::unordered_map<int64_t, RowDescriptor> descriptors;
-  return plan::PlanFragmentWalker()
-      .OnMap([&](auto& node) {
-        return OnOperatorImpl<plan::MapOperator, MapNode>(node, &descriptors);
-      })
-      .OnMemorySink([&](auto& node) {
-        return OnOperatorImpl<plan::MemorySinkOperator, MemorySinkNode>(node, &descriptors);
-      })
-      .OnAggregate([&](auto& node) {
-        return OnOperatorImpl<plan::AggregateOperator, AggNode>(node, &descriptors);
-      })
-      .OnMemorySource([&](auto& node) {
-        return OnOperatorImpl<plan::MemorySourceOperator, MemorySourceNode>(node, &descriptors);
-      })
-      .OnFilter([&](auto& node) {
-        return OnOperatorImpl<plan::FilterOperator, FilterNode>(node, &descriptors);
-      })
-      .OnLimit([&](auto& node) {
-        return OnOperatorImpl<plan::LimitOperator, LimitNode>(node, &descriptors);
-      })
-      .OnUnion([&](auto& node) {
-        return OnOperatorImpl<plan::UnionOperator, UnionNode>(node, &descriptors);
-      })
-      .OnJoin([&](auto& node) {
-        return OnOperatorImpl<plan::JoinOperator, EquijoinNode>(node, &descriptors);
-      })
-      .OnGRPCSource([&](auto& node) {
-        auto s = OnOperatorImpl<plan::GRPCSourceOperator, GRPCSourceNode>(node, &descriptors);
-        PL_RETURN_IF_ERROR(s);
-        grpc_sources_.insert(node.id());
-        return exec_state->grpc_router()->AddGRPCSourceNode(
-            exec_state->query_id(), node.id(), static_cast<GRPCSourceNode*>(nodes_[node.id()]),
-            std::bind(&ExecutionGraph::Continue, this));
-      })
-      .OnGRPCSink([&](auto& node) {
-        grpc_sinks_.insert(node.id());
-        return OnOperatorImpl<plan::GRPCSinkOperator, GRPCSinkNode>(node, &descriptors);
-      })
-      .OnUDTFSource([&](auto& node) {
-        return OnOperatorImpl<plan::UDTFSourceOperator, UDTFSourceNode>(node, &descriptors);
-      })
-      .OnEmptySource([&](auto& node) {
-        return OnOperatorImpl<plan::EmptySourceOperator, EmptySourceNode>(node, &descriptors);
-      })
-      .OnOTelSink([&](auto& node) {
-        return OnOperatorImpl<plan::OTelExportSinkOperator, OTelExportSinkNode>(node, &descriptors);
-      })
-      .Walk(pf_);
+  auto walk_status =
+      plan::PlanFragmentWalker()
+          .OnMap([&](auto& node) {
+            return OnOperatorImpl<plan::MapOperator, MapNode>(node, &descriptors);
+          })
+          .OnMemorySink([&](auto& node) {
+            if (capture_sink_results_) {
+              return OnOperatorImpl<plan::MemorySinkOperator, CaptureSinkNode>(node, &descriptors);
+            }
+            return OnOperatorImpl<plan::MemorySinkOperator, MemorySinkNode>(node, &descriptors);
+          })
+          .OnAggregate([&](auto& node) {
+            return OnOperatorImpl<plan::AggregateOperator, AggNode>(node, &descriptors);
+          })
+          .OnMemorySource([&](auto& node) {
+            return OnOperatorImpl<plan::MemorySourceOperator, MemorySourceNode>(node, &descriptors);
+          })
+          .OnFilter([&](auto& node) {
+            return OnOperatorImpl<plan::FilterOperator, FilterNode>(node, &descriptors);
+          })
+          .OnLimit([&](auto& node) {
+            return OnOperatorImpl<plan::LimitOperator, LimitNode>(node, &descriptors);
+          })
+          .OnUnion([&](auto& node) {
+            return OnOperatorImpl<plan::UnionOperator, UnionNode>(node, &descriptors);
+          })
+          .OnJoin([&](auto& node) {
+            return OnOperatorImpl<plan::JoinOperator, EquijoinNode>(node, &descriptors);
+          })
+          .OnSort([&](auto& node) {
+            return OnOperatorImpl<plan::SortOperator, SortNode>(node, &descriptors);
+          })
+          .OnTopK([&](auto& node) {
+            return OnOperatorImpl<plan::TopKOperator, TopKNode>(node, &descriptors);
+          })
+          .OnGRPCSource([&](auto& node) {
+            auto s = OnOperatorImpl<plan::GRPCSourceOperator, GRPCSourceNode>(node, &descriptors);
+            PL_RETURN_IF_ERROR(s);
+            grpc_sources_.insert(node.id());
+            return exec_state->grpc_router()->AddGRPCSourceNode(
+                exec_state->query_id(), node.id(), static_cast<GRPCSourceNode*>(nodes_[node.id()]),
+                std::bind(&ExecutionGraph::Continue, this));
+          })
+          .OnGRPCSink([&](auto& node) {
+            if (capture_sink_results_) {
+              return OnOperatorImpl<plan::GRPCSinkOperator, CaptureSinkNode>(node, &descriptors);
+            }
+            grpc_sinks_.insert(node.id());
+            return OnOperatorImpl<plan::GRPCSinkOperator, GRPCSinkNode>(node, &descriptors);
+          })
+          .OnUDTFSource([&](auto& node) {
+            return OnOperatorImpl<plan::UDTFSourceOperator, UDTFSourceNode>(node, &descriptors);
+          })
+          .OnEmptySource([&](auto& node) {
+            return OnOperatorImpl<plan::EmptySourceOperator, EmptySourceNode>(node, &descriptors);
+          })
+          .OnOTelSink([&](auto& node) {
+            return OnOperatorImpl<plan::OTelExportSinkOperator, OTelExportSinkNode>(node,
+                                                                                    &descriptors);
+          })
+          .Walk(pf_);
+  PL_RETURN_IF_ERROR(walk_status);
+  AddRuntimeFilterTargets();
+
+  if (exec_parallelism > 1) {
+    PL_RETURN_IF_ERROR(CreateParallelPipelines(exec_parallelism));
+  }
+  return Status::OK();
+}
+
+StatusOr<ExecNode*> ExecutionGraph::CreateWorkerNode(int64_t node_id) {
+  const plan::Operator* op = pf_->nodes()[node_id].get();
+  ExecNode* node;
+  switch (op->op_type()) {
+    case planpb::OperatorType::MAP_OPERATOR:
+      node = pool_.Add(new MapNode());
+      break;
+    case planpb::OperatorType::FILTER_OPERATOR:
+      node = pool_.Add(new FilterNode());
+      break;
+    case planpb::OperatorType::AGGREGATE_OPERATOR:
+      node = pool_.Add(new AggNode());
+      break;
+    default:
+      return error::Internal("Operator $0 can't be part of a parallel pipeline", op->DebugString());
+  }
+
+  PL_ASSIGN_OR_RETURN(auto output_rel, schema_->GetRelation(node_id));
+  std::vector<RowDescriptor> input_descriptors;
+  for (int64_t parent_id : pf_->dag().ParentsOf(node_id)) {
+    PL_ASSIGN_OR_RETURN(auto input_rel, schema_->GetRelation(parent_id));
+    input_descriptors.emplace_back(input_rel.col_types());
+  }
+  PL_RETURN_IF_ERROR(node->Init(*op, RowDescriptor(output_rel.col_types()), input_descriptors,
+                                collect_exec_node_stats_));
+  worker_nodes_.push_back(node);
+  return node;
+}
+
+Status ExecutionGraph::CreateParallelPipelines(int32_t exec_parallelism) {
+  for (int64_t source_id : sources_) {
+    if (pf_->nodes()[source_id]->op_type() != planpb::OperatorType::MEMORY_SOURCE_OPERATOR) {
+      continue;
+    }
+    auto* source = static_cast<MemorySourceNode*>(nodes_[source_id]);
+    if (source->streaming()) {
+      continue;
+    }
+
+    // Follow the source's only child until the blocking aggregate.
+    std::vector<int64_t> pipeline;
+    bool ends_in_agg = false;
+    for (int64_t id = source_id;;) {
+      auto children = pf_->dag().DependenciesOf(id);
+      if (children.size() != 1 || pf_->dag().ParentsOf(children[0]).size() != 1) {
+        break;
+      }
+      id = children[0];
+      pipeline.push_back(id);
+      auto op_type = pf_->nodes()[id]->op_type();
+      if (op_type == planpb::OperatorType::AGGREGATE_OPERATOR) {
+        ends_in_agg = !static_cast<AggNode*>(nodes_[id])->windowed();
+        break;
+      }
+      if (op_type != planpb::OperatorType::MAP_OPERATOR &&
+          op_type != planpb::OperatorType::FILTER_OPERATOR) {
+        break;
+      }
+    }
+    if (!ends_in_agg) {
+      continue;
+    }
+
+    std::vector<ParallelPipeline::Worker> workers;
+    workers.push_back(ParallelPipeline::Worker{nodes_[pipeline.front()], /*parent_index*/ 0,
+                                               static_cast<AggNode*>(nodes_[pipeline.back()])});
+    for (int32_t i = 1; i < exec_parallelism; ++i) {
+      ExecNode* head = nullptr;
+      ExecNode* prev = nullptr;
+      for (int64_t node_id : pipeline) {
+        PL_ASSIGN_OR_RETURN(ExecNode * node, CreateWorkerNode(node_id));
+        if (prev == nullptr) {
+          head = node;
+        } else {
+          prev->AddChild(node, /*parent_index*/ 0);
+        }
+        prev = node;
+      }
+      workers.push_back(
+          ParallelPipeline::Worker{head, /*parent_index*/ 0, static_cast<AggNode*>(prev)});
+    }
+    parallel_pipelines_[source_id] = std::make_unique<ParallelPipeline>(source, std::move(workers));
+  }
+  return Status::OK();
+}
+
+void ExecutionGraph::AddRuntimeFilterTargets() {
+  for (const auto& [node_id, node] : nodes_) {
+    if (pf_->nodes()[node_id]->op_type() != planpb::OperatorType::JOIN_OPERATOR) {
+      continue;
+    }
+    auto* join = static_cast<EquijoinNode*>(node);
+    if (!join->HasRuntimeFilter()) {
+      continue;
+    }
+
+    int64_t id = pf_->dag().ParentsOf(node_id)[join->probe_parent_index()];
+    std::vector<int64_t> key_col_idxs = join->probe_key_indices();
+    // Dropping rows before a filter doesn't change its output, so follow the filters up to the
+    // source, mapping the key columns to the filters' input columns.
+    while (pf_->dag().DependenciesOf(id).size() == 1 &&
+           pf_->nodes()[id]->op_type() == planpb::OperatorType::FILTER_OPERATOR) {
+      auto* filter_op = static_cast<plan::FilterOperator*>(pf_->nodes()[id].get());
+      auto selected_cols = filter_op->selected_cols();
+      for (auto& col_idx : key_col_idxs) {
+        col_idx = selected_cols[col_idx];
+      }
+      id = pf_->dag().ParentsOf(id)[0];
+    }
+    auto op_type = pf_->nodes()[id]->op_type();
+    if (pf_->dag().DependenciesOf(id).size() != 1 ||
+        (op_type != planpb::OperatorType::MEMORY_SOURCE_OPERATOR &&
+         op_type != planpb::OperatorType::GRPC_SOURCE_OPERATOR)) {
+      continue;
+    }
+    join->AddRuntimeFilterTarget(static_cast<SourceNode*>(nodes_[id]), std::move(key_col_idxs));
+  }
 }
 
 bool ExecutionGraph::YieldWithTimeout() {
@@ -175,6 +321,13 @@ Status ExecutionGraph::CheckDownstreamGRPCConnectionsHealth() {
 }
 
 Status ExecutionGraph::ExecuteSources() {
+  // Parallel pipelines run to completion first. Their sources have sent end of stream afterwards,
+  // so the loop below only completes them.
+  for (const auto& [source_id, pipeline] : parallel_pipelines_) {
+    exec_state_->SetCurrentSource(source_id);
+    PL_RETURN_IF_ERROR(pipeline->Execute(exec_state_));
+  }
+
   absl::flat_hash_set<SourceNode*> running_sources;
 
   absl::flat_hash_map<SourceNode*, int64_t> source_to_id;
@@ -298,6 +451,7 @@ Status ExecutionGraph::Execute() {
   // Get vector of nodes.
   std::vector<ExecNode*> nodes(nodes_.size());
   transform(nodes_.begin(), nodes_.end(), nodes.begin(), [](auto pair) { return pair.second; });
+  nodes.insert(nodes.end(), worker_nodes_.begin(), worker_nodes_.end());
 
   for (auto node : nodes) {
     PL_RETURN_IF_ERROR(node->Prepare(exec_state_));
@@ -330,6 +484,69 @@ Status ExecutionGraph::Execute() {
   return close_status;
 }
 
+PlanResultCache::SinkResults ExecutionGraph::TakeSinkResults() {
+  PlanResultCache::SinkResults results;
+  if (!capture_sink_results_) {
+    return results;
+  }
+  for (const auto& [id, node] : nodes_) {
+    if (node->IsSink()) {
+      results[id] = std::move(*static_cast<CaptureSinkNode*>(node)->row_batches());
+    }
+  }
+  return results;
+}
+
+Status ExecutionGraph::ExecuteSinks(const PlanResultCache::SinkResults& results) {
+  std::vector<std::pair<int64_t, ExecNode*>> sinks;
+  for (const auto& [id, node] : nodes_) {
+    if (node->IsSink()) {
+      sinks.emplace_back(id, node);
+    }
+  }
+
+  for (const auto& [id, node] : sinks) {
+    PL_RETURN_IF_ERROR(node->Prepare(exec_state_));
+  }
+  for (const auto& [id, node] : sinks) {
+    PL_RETURN_IF_ERROR(node->Open(exec_state_));
+  }
+
+  Status consume_status = Status::OK();
+  for (const auto& [id, node] : sinks) {
+    auto it = results.find(id);
+    if (it == results.end()) {
+      consume_status = error::Internal("No results for sink $0", id);
+      break;
+    }
+    for (const auto& rb : it->second) {
+      consume_status = node->ConsumeNext(exec_state_, rb, 0);
+      if (!consume_status.ok()) {
+        break;
+      }
+    }
+    if (!consume_status.ok()) {
+      break;
+    }
+  }
+
+  Status close_status = Status::OK();
+  for (const auto& [id, node] : sinks) {
+    auto s = node->Close(exec_state_);
+    if (!s.ok()) {
+      LOG(ERROR) << absl::Substitute(
+          "Error in ExecutionGraph::ExecuteSinks() for query $0, could not close sink: $1",
+          exec_state_->query_id().str(), s.msg());
+      close_status = s;
+    }
+  }
+
+  if (!consume_status.ok()) {
+    return consume_status;
+  }
+  return close_status;
+}
+
 ExecutionStats ExecutionGraph::GetStats() const {
   int64_t bytes_processed = 0;
   int64_t rows_processed = 0;
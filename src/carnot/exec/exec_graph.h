@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <condition_variable>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -32,6 +33,8 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/memory_source_node.h"
+#include "src/carnot/exec/parallel_pipeline.h"
+#include "src/carnot/exec/plan_result_cache.h"
 #include "src/carnot/plan/plan_fragment.h"
 #include "src/carnot/plan/plan_state.h"
 #include "src/common/base/base.h"
@@ -83,11 +86,13 @@ class ExecutionGraph {
    * @param collect_exec_node_stats Whether or not to collect exec node stats.
    * @param consecutive_generate_calls_per_source how many times in a row to call GenerateNext
    * before switching to another available source.
+   * @param exec_parallelism the number of threads to execute parallel pipelines with, see
+   * ParallelPipeline. 1 executes the whole graph on the calling thread.
    * @return The status of whether initialization succeeded.
    */
   Status Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
               ExecState* exec_state, plan::PlanFragment* pf, bool collect_exec_node_stats,
-              int32_t consecutive_generate_calls_per_source);
+              int32_t consecutive_generate_calls_per_source, int32_t exec_parallelism = 1);
 
   Status Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
               ExecState* exec_state, plan::PlanFragment* pf, bool collect_exec_node_stats) {
@@ -111,6 +116,7 @@ class ExecutionGraph {
   }
 
   std::vector<int64_t> sources() { return sources_; }
+  size_t num_parallel_pipelines() const { return parallel_pipelines_.size(); }
   absl::flat_hash_set<int64_t> grpc_sources() { return grpc_sources_; }
 
   StatusOr<ExecNode*> node(int64_t id) {
@@ -126,6 +132,26 @@ class ExecutionGraph {
    */
   Status Execute();
 
+  /**
+   * Makes Init create CaptureSinkNodes in place of the sinks of the plan fragment, so that the
+   * graph keeps the results of its sinks instead of writing them out. Must be called before Init.
+   */
+  void set_capture_sink_results(bool capture_sink_results) {
+    capture_sink_results_ = capture_sink_results;
+  }
+
+  /**
+   * @return the row batches consumed by each sink, when the graph captures the results of its
+   * sinks.
+   */
+  PlanResultCache::SinkResults TakeSinkResults();
+
+  /**
+   * Executes only the sinks of the graph, which consume the given row batches, e.g. the results of
+   * other executions of the plan fragment that were captured.
+   */
+  Status ExecuteSinks(const PlanResultCache::SinkResults& results);
+
   /**
    * Re-awakens Execute() when there is more work available to do.
    */
@@ -209,6 +235,21 @@ class ExecutionGraph {
 
   Status ExecuteSources();
 
+  /**
+   * Finds the pipelines of the graph that can be executed by a ParallelPipeline: a non-streaming
+   * MemorySource followed by maps and filters that ends in a blocking aggregate, with no other
+   * branches. The nodes of each pipeline are replicated for every additional worker.
+   */
+  Status CreateParallelPipelines(int32_t exec_parallelism);
+  StatusOr<ExecNode*> CreateWorkerNode(int64_t node_id);
+
+  /**
+   * Connects every join that has a runtime filter to the sources of its probe side that it can be
+   * pushed down to: a MemorySource or GRPCSource that only feeds the join, directly or through
+   * filters.
+   */
+  void AddRuntimeFilterTargets();
+
   ExecState* exec_state_;
   ObjectPool pool_{"exec_graph_pool"};
   table_store::schema::Schema* schema_;
@@ -218,6 +259,10 @@ class ExecutionGraph {
   absl::flat_hash_set<int64_t> grpc_sources_;
   absl::flat_hash_set<int64_t> grpc_sinks_;
   std::unordered_map<int64_t, ExecNode*> nodes_;
+  // The parallel pipelines by the ID of their source, and the nodes of their additional workers,
+  // which aren't part of nodes_.
+  std::map<int64_t, std::unique_ptr<ParallelPipeline>> parallel_pipelines_;
+  std::vector<ExecNode*> worker_nodes_;
 
   SystemTimePoint query_start_time_;
 
@@ -240,6 +285,7 @@ class ExecutionGraph {
   std::condition_variable execution_cv_;
   // Whether to collect stats on exec nodes.
   bool collect_exec_node_stats_;
+  bool capture_sink_results_ = false;
 };
 
 }  // namespace exec
@@ -66,12 +66,23 @@ class MultiplyUDF : public udf::ScalarUDF {
   }
 };
 
+class SumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg) { sum_ = sum_.val + arg.val; }
+  void Merge(udf::FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+
+ protected:
+  types::Int64Value sum_ = 0;
+};
+
 class BaseExecGraphTest : public ::testing::Test {
  protected:
   void SetUpExecState() {
     func_registry_ = std::make_unique<udf::Registry>("test_registry");
     func_registry_->RegisterOrDie<AddUDF>("add");
     func_registry_->RegisterOrDie<MultiplyUDF>("multiply");
+    func_registry_->RegisterOrDie<SumUDA>("sum");
 
     auto table_store = std::make_shared<table_store::TableStore>();
     exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
@@ -208,6 +219,75 @@ std::vector<std::tuple<int32_t>> calls_to_execute = {
 INSTANTIATE_TEST_SUITE_P(ExecGraphExecuteTestSuite, ExecGraphExecuteTest,
                          ::testing::ValuesIn(calls_to_execute));
 
+class ParallelExecGraphTest : public ExecGraphTest,
+                              public ::testing::WithParamInterface<int32_t> {};
+
+TEST_P(ParallelExecGraphTest, blocking_agg) {
+  int32_t exec_parallelism = GetParam();
+
+  planpb::PlanFragment pf_pb;
+  ASSERT_TRUE(TextFormat::MergeFromString(planpb::testutils::kBlockingAggPlanFragment, &pf_pb));
+  auto plan_fragment = std::make_shared<plan::PlanFragment>(1);
+  ASSERT_OK(plan_fragment->Init(pf_pb));
+
+  auto plan_state = std::make_unique<plan::PlanState>(func_registry_.get());
+  auto schema = std::make_shared<table_store::schema::Schema>();
+  table_store::schema::Relation rel({types::DataType::INT64, types::DataType::INT64},
+                                    {"group", "value"});
+  schema->AddRelation(1, rel);
+
+  // Write enough batches that every worker gets some of them.
+  auto table = Table::Create("numbers", rel);
+  std::vector<int64_t> expected_sums(5, 0);
+  for (int64_t batch = 0; batch < 100; ++batch) {
+    std::vector<types::Int64Value> groups;
+    std::vector<types::Int64Value> values;
+    for (int64_t i = 0; i < 10; ++i) {
+      groups.push_back(i % 5);
+      values.push_back(batch * 10 + i);
+      expected_sums[i % 5] += batch * 10 + i;
+    }
+    auto rb = RowBatch(RowDescriptor(rel.col_types()), groups.size());
+    ASSERT_OK(rb.AddColumn(types::ToArrow(groups, arrow::default_memory_pool())));
+    ASSERT_OK(rb.AddColumn(types::ToArrow(values, arrow::default_memory_pool())));
+    ASSERT_OK(table->WriteRowBatch(rb));
+  }
+
+  auto table_store = std::make_shared<table_store::TableStore>();
+  table_store->AddTable("numbers", table);
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry_.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+      MockTraceStubGenerator, sole::uuid4(), nullptr);
+  ASSERT_OK(exec_state->AddUDA(0, "sum", {types::DataType::INT64}));
+
+  ExecutionGraph e;
+  ASSERT_OK(e.Init(schema.get(), plan_state.get(), exec_state.get(), plan_fragment.get(),
+                   /* collect_exec_node_stats */ false, kDefaultConsecutiveGenerateCallsPerSource,
+                   exec_parallelism));
+  EXPECT_EQ(exec_parallelism > 1 ? 1 : 0, e.num_parallel_pipelines());
+  ASSERT_OK(e.Execute());
+
+  auto stats = e.GetStats();
+  EXPECT_EQ(1000, stats.rows_processed);
+
+  std::vector<int64_t> sums(5, -1);
+  table_store::Table::Cursor cursor(exec_state->table_store()->GetTable("output"));
+  int64_t num_rows = 0;
+  while (!cursor.Done()) {
+    auto rb = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+    for (int64_t i = 0; i < rb->num_rows(); ++i) {
+      auto group = types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(0).get(), i);
+      sums[group] = types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(1).get(), i);
+      ++num_rows;
+    }
+  }
+  EXPECT_EQ(5, num_rows);
+  EXPECT_EQ(expected_sums, sums);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParallelExecGraphTestSuite, ParallelExecGraphTest,
+                         ::testing::Values(1, 2, 4));
+
 TEST_F(ExecGraphTest, execute_time) {
   planpb::PlanFragment pf_pb;
   ASSERT_TRUE(TextFormat::MergeFromString(planpb::testutils::kLinearPlanFragment, &pf_pb));
@@ -20,9 +20,11 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/runtime_join_filter.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/common/perf/perf.h"
@@ -46,7 +48,7 @@ struct ExecNodeStats {
     }
     ++batches_output;
     bytes_output += rb.NumBytes();
-    rows_output += rb.num_rows();
+    rows_output += rb.num_selected_rows();
   }
 
   void AddInputStats(const table_store::schema::RowBatch& rb) {
@@ -55,7 +57,7 @@ struct ExecNodeStats {
     }
     ++batches_input;
     bytes_input += rb.NumBytes();
-    rows_input += rb.num_rows();
+    rows_input += rb.num_selected_rows();
   }
 
   void ResumeChildTimer() {
@@ -220,7 +222,12 @@ class ExecNode {
     }
     stats_->AddInputStats(rb);
     stats_->ResumeTotalTimer();
-    PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, rb, parent_index));
+    if (rb.has_selection() && !ConsumesSelection()) {
+      PL_ASSIGN_OR_RETURN(auto compacted_rb, rb.Compact(exec_state->exec_mem_pool()));
+      PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, *compacted_rb, parent_index));
+    } else {
+      PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, rb, parent_index));
+    }
     stats_->StopTotalTimer();
     return Status::OK();
   }
@@ -313,6 +320,10 @@ class ExecNode {
   virtual Status ConsumeNextImpl(ExecState*, const table_store::schema::RowBatch&, size_t) {
     return error::Unimplemented("Implement in derived class (if sink or processing)");
   }
+
+  // Whether ConsumeNextImpl handles row batches with a selection vector. Row batches with a
+  // selection vector are compacted before they are passed to nodes that don't.
+  virtual bool ConsumesSelection() const { return false; }
   bool is_closed() { return is_closed_; }
 
   std::unique_ptr<table_store::schema::RowDescriptor> output_descriptor_;
@@ -367,9 +378,38 @@ class SourceNode : public ExecNode {
     return SendRowBatchToChildren(exec_state, *rb);
   }
 
+  /**
+   * Adds the runtime filter of a downstream join. Rows whose keys aren't in the filter are dropped
+   * from the row batches this node outputs.
+   * @param filter the filter.
+   * @param key_col_idxs the output columns of this node that hold the join keys, in key order.
+   */
+  void AddRuntimeFilter(std::shared_ptr<const RuntimeJoinFilter> filter,
+                        std::vector<int64_t> key_col_idxs) {
+    runtime_filters_.emplace_back(std::move(filter), std::move(key_col_idxs));
+  }
+
+  /**
+   * Applies the runtime filters to an output row batch, by setting its selection vector.
+   */
+  Status ApplyRuntimeFilters(table_store::schema::RowBatch* rb) {
+    for (const auto& [filter, key_col_idxs] : runtime_filters_) {
+      PL_ASSIGN_OR_RETURN(int64_t num_dropped, filter->Apply(key_col_idxs, rb));
+      rows_dropped_by_runtime_filters_ += num_dropped;
+    }
+    return Status::OK();
+  }
+
+  int64_t RowsDroppedByRuntimeFilters() const { return rows_dropped_by_runtime_filters_; }
+
  protected:
   int64_t rows_processed_ = 0;
   int64_t bytes_processed_ = 0;
+
+ private:
+  std::vector<std::pair<std::shared_ptr<const RuntimeJoinFilter>, std::vector<int64_t>>>
+      runtime_filters_;
+  int64_t rows_dropped_by_runtime_filters_ = 0;
 };
 
 /**
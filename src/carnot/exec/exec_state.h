@@ -30,7 +30,9 @@
 
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/exec/grpc_router.h"
+#include "src/carnot/exec/memory_tracker.h"
 #include "src/carnot/exec/ml/model_pool.h"
+#include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
 #include "src/shared/metadata/metadata_state.h"
@@ -91,6 +93,11 @@ class ExecState {
     return arrow::default_memory_pool();
   }
 
+  /**
+   * The tracker of the memory that the blocking operators of the query hold in their state.
+   */
+  MemoryTracker* memory_tracker() { return &memory_tracker_; }
+
   udf::Registry* func_registry() { return func_registry_; }
 
   table_store::TableStore* table_store() { return table_store_.get(); }
@@ -190,6 +197,12 @@ class ExecState {
     metadata_state_ = metadata_state;
   }
 
+  // The encoding of the row batches that GRPC sinks send to other Carnot instances.
+  planpb::RowBatchEncoding grpc_row_batch_encoding() const { return grpc_row_batch_encoding_; }
+  void set_grpc_row_batch_encoding(planpb::RowBatchEncoding encoding) {
+    grpc_row_batch_encoding_ = encoding;
+  }
+
   GRPCRouter* grpc_router() { return grpc_router_; }
 
   void AddAuthToGRPCClientContext(grpc::ClientContext* ctx) {
@@ -210,6 +223,8 @@ class ExecState {
   ml::ModelPool* model_pool_;
   GRPCRouter* grpc_router_ = nullptr;
   std::function<void(grpc::ClientContext*)> add_auth_to_grpc_client_context_func_;
+  MemoryTracker memory_tracker_{FLAGS_carnot_query_memory_limit};
+  planpb::RowBatchEncoding grpc_row_batch_encoding_ = planpb::ROW_BATCH_ENCODING_PROTO;
 
   int64_t current_source_ = 0;
   bool current_source_set_ = false;
@@ -22,6 +22,7 @@
 #include <arrow/array/builder_binary.h>
 #include <arrow/memory_pool.h>
 #include <arrow/status.h>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -29,6 +30,7 @@
 
 #include <absl/strings/substitute.h>
 
+#include "src/carnot/exec/row_batch_selection.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udf/udf_wrapper.h"
@@ -39,6 +41,10 @@
 #include "src/shared/types/types.h"
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
 
+DEFINE_bool(carnot_filter_selection, gflags::BoolFromEnv("PL_CARNOT_FILTER_SELECTION", true),
+            "Whether filters output a selection vector over their input columns, instead of "
+            "copying the rows that pass into new columns.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -62,6 +68,7 @@ Status FilterNode::PrepareImpl(ExecState* exec_state) {
   function_ctx_ = exec_state->CreateFunctionContext();
   evaluator_ = std::make_unique<VectorNativeScalarExpressionEvaluator>(
       plan::ConstScalarExpressionVector{plan_node_->expression()}, function_ctx_.get());
+  predicate_cols_ = ReferencedColumns({plan_node_->expression()});
   return Status::OK();
 }
 
@@ -130,6 +137,48 @@ Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& p
 }
 
 Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (!FLAGS_carnot_filter_selection) {
+    return CopyPassingRows(exec_state, rb);
+  }
+
+  // The predicate is only evaluated on the rows that are already selected.
+  const RowBatch* pred_input = &rb;
+  std::unique_ptr<RowBatch> compacted_rb;
+  if (rb.has_selection()) {
+    PL_ASSIGN_OR_RETURN(compacted_rb,
+                        CompactColumns(rb, predicate_cols_, exec_state->exec_mem_pool()));
+    pred_input = compacted_rb.get();
+  }
+  PL_ASSIGN_OR_RETURN(auto pred_col, evaluator_->EvaluateSingleExpression(
+                                         exec_state, *pred_input, *plan_node_->expression()));
+  DCHECK_EQ(pred_col->data_type(), types::BOOLEAN) << "Predicate expression must be a boolean";
+  const types::BoolValueColumnWrapper& pred_col_wrapper =
+      *static_cast<types::BoolValueColumnWrapper*>(pred_col.get());
+  DCHECK_EQ(static_cast<size_t>(rb.num_selected_rows()), pred_col_wrapper.Size());
+
+  auto selection = std::make_shared<std::vector<int64_t>>();
+  selection->reserve(pred_col_wrapper.Size());
+  for (size_t i = 0; i < pred_col_wrapper.Size(); ++i) {
+    if (pred_col_wrapper[i].val) {
+      selection->push_back(rb.has_selection() ? (*rb.selection())[i] : i);
+    }
+  }
+
+  // The output shares the input columns, and selects the rows that passed.
+  RowBatch output_rb(*output_descriptor_, rb.num_rows());
+  DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
+  for (int64_t input_col_idx : plan_node_->selected_cols()) {
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(input_col_idx)));
+  }
+  if (static_cast<int64_t>(selection->size()) != rb.num_rows()) {
+    output_rb.set_selection(std::move(selection));
+  }
+  output_rb.set_eow(rb.eow());
+  output_rb.set_eos(rb.eos());
+  return SendRowBatchToChildren(exec_state, output_rb);
+}
+
+Status FilterNode::CopyPassingRows(ExecState* exec_state, const RowBatch& rb) {
   // Current implementation does not merge across row batches, we should
   // consider this for cases where the filter has really low selectivity.
   PL_ASSIGN_OR_RETURN(auto pred_col, evaluator_->EvaluateSingleExpression(
@@ -23,6 +23,8 @@
 #include <string>
 #include <vector>
 
+#include <absl/container/flat_hash_set.h>
+
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
@@ -32,6 +34,8 @@
 #include "src/common/base/status.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_bool(carnot_filter_selection);
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -49,9 +53,15 @@ class FilterNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  bool ConsumesSelection() const override { return FLAGS_carnot_filter_selection; }
 
  private:
+  // Copies the rows that pass the predicate into the output row batch, instead of selecting them.
+  Status CopyPassingRows(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
+  // The input columns that the predicate reads.
+  absl::flat_hash_set<int64_t> predicate_cols_;
   std::unique_ptr<plan::FilterOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
 };
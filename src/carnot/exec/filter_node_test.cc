@@ -18,6 +18,9 @@
 
 #include "src/carnot/exec/filter_node.h"
 
+#include <memory>
+#include <vector>
+
 #include <sole.hpp>
 
 #include "src/carnot/exec/test_utils.h"
@@ -240,6 +243,34 @@ TEST_F(FilterNodeTest, child_fail) {
                                0, error::InvalidArgument("args"));
 }
 
+TEST_F(FilterNodeTest, selected_input_rows) {
+  auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+
+  // Row 0 passes the predicate, but was dropped by an earlier filter.
+  RowBatchBuilder input_builder(input_rd, 4, /*eow*/ true, /*eos*/ true);
+  auto& input_rb =
+      input_builder.AddColumn<types::Int64Value>({1, 1, 3, 1})
+          .AddColumn<types::Int64Value>({1, 3, 6, 9})
+          .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+          .get();
+  input_rb.set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 2, 3}));
+
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  tester.ConsumeNext(input_rb, 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 1})
+                          .AddColumn<types::Int64Value>({3, 9})
+                          .AddColumn<types::StringValue>({"DEF", "WORLD"})
+                          .get())
+      .Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/flow_control_window.h"
+
+#include <algorithm>
+
+DEFINE_int64(carnot_grpc_source_window_bytes,
+             gflags::Int64FromEnv("PL_CARNOT_GRPC_SOURCE_WINDOW_BYTES", 64 * 1024 * 1024),
+             "The number of bytes of received row batches that a GRPC source buffers before it "
+             "stops reading from the streams of its sinks. 0 means no limit.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+void FlowControlWindow::Add(int64_t bytes) {
+  absl::MutexLock lock(&lock_);
+  buffered_bytes_ += bytes;
+  max_buffered_bytes_ = std::max(max_buffered_bytes_, buffered_bytes_);
+}
+
+void FlowControlWindow::Release(int64_t bytes) {
+  absl::MutexLock lock(&lock_);
+  buffered_bytes_ -= bytes;
+  DCHECK_GE(buffered_bytes_, 0);
+  credits_cv_.SignalAll();
+}
+
+void FlowControlWindow::Close() {
+  absl::MutexLock lock(&lock_);
+  closed_ = true;
+  credits_cv_.SignalAll();
+}
+
+bool FlowControlWindow::WaitForCredits(absl::Duration timeout) {
+  absl::MutexLock lock(&lock_);
+  if (HasCredits()) {
+    return true;
+  }
+  absl::Time start = absl::Now();
+  absl::Time deadline = start + timeout;
+  while (!HasCredits()) {
+    // WaitWithDeadline returns true once the deadline has passed.
+    if (credits_cv_.WaitWithDeadline(&lock_, deadline)) {
+      break;
+    }
+  }
+  total_wait_time_ += absl::Now() - start;
+  return HasCredits();
+}
+
+int64_t FlowControlWindow::buffered_bytes() const {
+  absl::MutexLock lock(&lock_);
+  return buffered_bytes_;
+}
+
+int64_t FlowControlWindow::max_buffered_bytes() const {
+  absl::MutexLock lock(&lock_);
+  return max_buffered_bytes_;
+}
+
+absl::Duration FlowControlWindow::total_wait_time() const {
+  absl::MutexLock lock(&lock_);
+  return total_wait_time_;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
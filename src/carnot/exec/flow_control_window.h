@@ -0,0 +1,85 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <absl/synchronization/mutex.h>
+#include <absl/time/time.h>
+
+#include "src/common/base/base.h"
+
+DECLARE_int64(carnot_grpc_source_window_bytes);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * FlowControlWindow implements the credits that a GRPCSourceNode grants to the GRPC sinks that
+ * send it row batches. Each received batch takes credits for its size until the source consumes
+ * it. While the source has no credits left, the GRPCRouter stops reading from the streams of the
+ * source. gRPC flow control then pushes back on the sinks, whose writes block, so that sinks send
+ * at the rate the source consumes batches, and the source buffers a bounded number of bytes.
+ *
+ * The window is thread-safe: batches are added by the threads of the GRPCRouter, and released by
+ * the thread that executes the source.
+ */
+class FlowControlWindow {
+ public:
+  explicit FlowControlWindow(int64_t window_bytes = FLAGS_carnot_grpc_source_window_bytes)
+      : window_bytes_(window_bytes) {}
+
+  // Takes the credits for a received batch of the given size.
+  void Add(int64_t bytes);
+  // Returns the credits of a batch once it's consumed.
+  void Release(int64_t bytes);
+  // Closes the window, e.g. when its source node is done, after which credits are always available.
+  void Close();
+
+  /**
+   * Waits until credits are available, i.e. the buffered bytes are under the window, for at most
+   * the given timeout.
+   * @return whether credits are available.
+   */
+  bool WaitForCredits(absl::Duration timeout);
+
+  int64_t buffered_bytes() const;
+  int64_t max_buffered_bytes() const;
+  // The total time spent in WaitForCredits while no credits were available.
+  absl::Duration total_wait_time() const;
+
+ private:
+  bool HasCredits() const ABSL_SHARED_LOCKS_REQUIRED(lock_) {
+    return closed_ || window_bytes_ <= 0 || buffered_bytes_ < window_bytes_;
+  }
+
+  const int64_t window_bytes_;
+  mutable absl::Mutex lock_;
+  absl::CondVar credits_cv_;
+  int64_t buffered_bytes_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t max_buffered_bytes_ ABSL_GUARDED_BY(lock_) = 0;
+  absl::Duration total_wait_time_ ABSL_GUARDED_BY(lock_) = absl::ZeroDuration();
+  bool closed_ ABSL_GUARDED_BY(lock_) = false;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/flow_control_window.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+TEST(FlowControlWindowTest, credits) {
+  FlowControlWindow window(100);
+  EXPECT_TRUE(window.WaitForCredits(absl::ZeroDuration()));
+
+  window.Add(60);
+  EXPECT_TRUE(window.WaitForCredits(absl::ZeroDuration()));
+  window.Add(60);
+  EXPECT_EQ(120, window.buffered_bytes());
+  EXPECT_FALSE(window.WaitForCredits(absl::Milliseconds(1)));
+  EXPECT_GT(window.total_wait_time(), absl::ZeroDuration());
+
+  window.Release(60);
+  EXPECT_TRUE(window.WaitForCredits(absl::ZeroDuration()));
+  EXPECT_EQ(60, window.buffered_bytes());
+  EXPECT_EQ(120, window.max_buffered_bytes());
+}
+
+TEST(FlowControlWindowTest, release_wakes_waiter) {
+  FlowControlWindow window(100);
+  window.Add(100);
+
+  std::thread consumer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    window.Release(100);
+  });
+  EXPECT_TRUE(window.WaitForCredits(absl::Seconds(10)));
+  consumer.join();
+}
+
+TEST(FlowControlWindowTest, close_and_unlimited) {
+  FlowControlWindow window(100);
+  window.Add(200);
+  EXPECT_FALSE(window.WaitForCredits(absl::ZeroDuration()));
+  window.Close();
+  EXPECT_TRUE(window.WaitForCredits(absl::ZeroDuration()));
+
+  // A window of 0 bytes doesn't limit the buffered bytes.
+  FlowControlWindow unlimited(0);
+  unlimited.Add(1024 * 1024);
+  EXPECT_TRUE(unlimited.WaitForCredits(absl::ZeroDuration()));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -35,6 +35,18 @@ namespace px {
 namespace carnot {
 namespace exec {
 
+namespace {
+
+constexpr absl::Duration kCreditWaitInterval = absl::Milliseconds(100);
+
+bool HasRowBatch(const carnotpb::TransferResultChunkRequest& req) {
+  return req.has_query_result() &&
+         req.query_result().result_contents_case() !=
+             carnotpb::TransferResultChunkRequest_SinkResult::RESULT_CONTENTS_NOT_SET;
+}
+
+}  // namespace
+
 GRPCRouter::SourceNodeTracker* GRPCRouter::GetSourceNodeTracker(QueryTracker* query_tracker,
                                                                 int64_t source_id) {
   absl::base_internal::SpinLockHolder query_lock(&query_tracker->query_lock);
@@ -43,7 +55,7 @@ GRPCRouter::SourceNodeTracker* GRPCRouter::GetSourceNodeTracker(QueryTracker* qu
 
 Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
                                    std::unique_ptr<carnotpb::TransferResultChunkRequest> req) {
-  if (!req->has_query_result() || !req->query_result().has_row_batch() ||
+  if (!HasRowBatch(*req) ||
       req->query_result().destination_case() !=
           carnotpb::TransferResultChunkRequest_SinkResult::DestinationCase::kGrpcSourceId) {
     return error::Internal(
@@ -58,6 +70,7 @@ Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
     // solve this race, We store a backlog of all the pending batches.
     if (snt->source_node == nullptr) {
       snt->connection_initiated_by_sink = true;
+      snt->flow_control_window->Add(req->ByteSizeLong());
       snt->response_backlog.emplace_back(std::move(req));
       return Status::OK();
     }
@@ -138,9 +151,13 @@ void GRPCRouter::MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
     }
     return ::grpc::Status::OK;
   }
-  if (req->has_query_result() && req->query_result().has_row_batch()) {
+  if (HasRowBatch(*req)) {
     state->stream_has_query_results = true;
     state->source_node_id = req->query_result().grpc_source_id();
+    if (state->flow_control_window == nullptr) {
+      auto snt = GetSourceNodeTracker(state->query_tracker.get(), state->source_node_id);
+      state->flow_control_window = snt->flow_control_window;
+    }
     auto s = EnqueueRowBatch(state->query_tracker.get(), std::move(req));
     if (!s.ok()) {
       return ::grpc::Status(grpc::StatusCode::INTERNAL, "failed to enqueue batch");
@@ -154,6 +171,19 @@ void GRPCRouter::MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
   }
   return ::grpc::Status(grpc::StatusCode::INTERNAL, "unexpected TransferResultChunkRequest type");
 }
+void GRPCRouter::WaitForCredits(::grpc::ServerContext* context,
+                                const TransferResultChunkState& state) {
+  if (state.flow_control_window == nullptr) {
+    return;
+  }
+  // Wait in intervals, to notice when the stream is cancelled, e.g. because the query was deleted.
+  while (!state.flow_control_window->WaitForCredits(kCreditWaitInterval)) {
+    if (context->IsCancelled()) {
+      return;
+    }
+  }
+}
+
 std::vector<statuspb::Status> GRPCRouter::GetIncomingWorkerErrors(const sole::uuid& query_id) {
   std::shared_ptr<QueryTracker> query_tracker;
   {
@@ -179,6 +209,7 @@ std::vector<statuspb::Status> GRPCRouter::GetIncomingWorkerErrors(const sole::uu
     if (!result_status.ok()) {
       break;
     }
+    WaitForCredits(context, state);
     req = std::make_unique<carnotpb::TransferResultChunkRequest>();
   }
 
@@ -227,8 +258,11 @@ Status GRPCRouter::AddGRPCSourceNode(sole::uuid query_id, int64_t source_id,
   if (snt->connection_initiated_by_sink) {
     source_node->set_upstream_initiated_connection();
   }
+  source_node->set_flow_control_window(snt->flow_control_window);
   if (snt->response_backlog.size() > 0) {
     for (auto& rb : snt->response_backlog) {
+      // The source node takes the credits of the batch when it's enqueued.
+      snt->flow_control_window->Release(rb->ByteSizeLong());
       PL_RETURN_IF_ERROR(snt->source_node->EnqueueRowBatch(std::move(rb)));
     }
     snt->response_backlog.clear();
@@ -275,6 +309,8 @@ Status GRPCRouter::DeleteGRPCSourceNode(sole::uuid query_id, int64_t source_id)
     return error::Internal("Query map for query ID $0 does not contain GRPC source $1",
                            query_id.str(), source_id);
   }
+  // Don't block the streams of a source that's gone.
+  it->second.flow_control_window->Close();
   query_tracker->source_node_trackers.erase(it);
   return Status::OK();
 }
@@ -299,6 +335,9 @@ void GRPCRouter::DeleteQuery(sole::uuid query_id) {
   for (auto ctx : query_tracker->active_agent_contexts) {
     ctx->TryCancel();
   }
+  for (auto& [source_id, snt] : query_tracker->source_node_trackers) {
+    snt.flow_control_window->Close();
+  }
 }
 
 size_t GRPCRouter::NumQueriesTracking() const {
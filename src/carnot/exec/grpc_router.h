@@ -35,6 +35,7 @@
 
 #include "src/carnot/carnotpb/carnot.grpc.pb.h"
 #include "src/carnot/carnotpb/carnot.pb.h"
+#include "src/carnot/exec/flow_control_window.h"
 #include "src/common/base/base.h"
 #include "src/common/base/statuspb/status.pb.h"
 #include "src/common/uuid/uuid.h"
@@ -118,6 +119,9 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
     bool connection_closed_by_sink GUARDED_BY(node_lock) = false;
     std::vector<std::unique_ptr<::px::carnotpb::TransferResultChunkRequest>> response_backlog
         GUARDED_BY(node_lock);
+    // The credits of the source node, which the backlog also takes credits from.
+    const std::shared_ptr<FlowControlWindow> flow_control_window =
+        std::make_shared<FlowControlWindow>();
     absl::base_internal::SpinLock node_lock;
   };
 
@@ -166,11 +170,17 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
     // When true, the particular TransferResultChunk call has initiated the query stream.
     bool stream_has_query_results = false;
     std::shared_ptr<QueryTracker> query_tracker = nullptr;
+    // The credits of the source node that the stream sends row batches to.
+    std::shared_ptr<FlowControlWindow> flow_control_window = nullptr;
   };
   ::grpc::Status HandleTransferResultChunkMessage(
       std::unique_ptr<::px::carnotpb::TransferResultChunkRequest> req,
       ::grpc::ServerContext* context, TransferResultChunkState* state);
 
+  // Blocks until the source node of the stream has credits, or the stream is cancelled. While the
+  // router doesn't read from the stream, gRPC flow control blocks the sink from sending more.
+  void WaitForCredits(::grpc::ServerContext* context, const TransferResultChunkState& state);
+
   void MarkResultStreamClosed(QueryTracker* query_tracker, int64_t source_id);
   void RegisterResultStreamContext(QueryTracker* query_tracker, ::grpc::ServerContext* context);
   void MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
@@ -26,6 +26,7 @@
 
 #include <absl/strings/substitute.h>
 #include <absl/synchronization/barrier.h>
+#include <absl/synchronization/mutex.h>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/security/credentials.h>
 #include <grpcpp/security/server_credentials.h>
@@ -147,6 +148,99 @@ TEST_F(GRPCRouterTest, no_node_router_test) {
   EXPECT_TRUE(source_node.upstream_closed_connection());
 }
 
+// A source node that takes credits for the batches it receives, until they're consumed.
+class CreditTrackingSourceNode : public px::carnot::exec::GRPCSourceNode {
+ public:
+  Status EnqueueRowBatch(std::unique_ptr<px::carnotpb::TransferResultChunkRequest> row_batch) {
+    absl::MutexLock lock(&lock_);
+    flow_control_window()->Add(row_batch->ByteSizeLong());
+    row_batches_.emplace_back(std::move(row_batch));
+    return Status::OK();
+  }
+
+  void Consume(size_t idx) {
+    absl::MutexLock lock(&lock_);
+    flow_control_window()->Release(row_batches_.at(idx)->ByteSizeLong());
+  }
+
+  size_t num_row_batches() {
+    absl::MutexLock lock(&lock_);
+    return row_batches_.size();
+  }
+
+  // Waits for up to 10 seconds for the source to receive the given number of batches.
+  bool WaitForRowBatches(size_t num_row_batches) {
+    for (int i = 0; i < 1000; ++i) {
+      if (this->num_row_batches() >= num_row_batches) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+ private:
+  absl::Mutex lock_;
+  std::vector<std::unique_ptr<px::carnotpb::TransferResultChunkRequest>> row_batches_
+      ABSL_GUARDED_BY(lock_);
+};
+
+TEST_F(GRPCRouterTest, flow_control_router_test) {
+  gflags::FlagSaver flag_saver;
+  // Every batch uses up all of the credits of the source.
+  FLAGS_carnot_grpc_source_window_bytes = 1;
+
+  int64_t grpc_source_node_id = 1;
+  auto query_uuid = sole::uuid4();
+  RowDescriptor input_rd({types::DataType::INT64});
+
+  auto op_proto = planpb::testutils::CreateTestGRPCSource1PB();
+  std::unique_ptr<px::carnot::plan::Operator> plan_node =
+      plan::GRPCSourceOperator::FromProto(op_proto, grpc_source_node_id);
+  CreditTrackingSourceNode source_node;
+  ASSERT_OK(source_node.Init(*plan_node, input_rd, {}));
+  ASSERT_OK(
+      service_->AddGRPCSourceNode(query_uuid, grpc_source_node_id, &source_node, [&] {}));
+
+  carnotpb::TransferResultChunkRequest initiate_stream_req;
+  ToProto(query_uuid, initiate_stream_req.mutable_query_id());
+  *initiate_stream_req.mutable_initiate_conn() =
+      carnotpb::TransferResultChunkRequest::InitiateConnection();
+
+  std::vector<carnotpb::TransferResultChunkRequest> rb_reqs(3);
+  for (auto& rb_req : rb_reqs) {
+    auto rb = RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                  .AddColumn<types::Int64Value>({1, 2})
+                  .get();
+    EXPECT_OK(rb.ToProto(rb_req.mutable_query_result()->mutable_row_batch()));
+    rb_req.mutable_query_result()->set_grpc_source_id(grpc_source_node_id);
+    ToProto(query_uuid, rb_req.mutable_query_id());
+  }
+
+  px::carnotpb::TransferResultChunkResponse response;
+  grpc::ClientContext context;
+  auto writer = stub_->TransferResultChunk(&context, &response);
+  ASSERT_TRUE(writer->Write(initiate_stream_req));
+  // The batches are small enough to be buffered by gRPC, so the writes don't block.
+  for (const auto& rb_req : rb_reqs) {
+    ASSERT_TRUE(writer->Write(rb_req));
+  }
+
+  // The router doesn't read the next batch until the source consumes the previous one.
+  for (size_t i = 0; i < rb_reqs.size(); ++i) {
+    ASSERT_TRUE(source_node.WaitForRowBatches(i + 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(i + 1, source_node.num_row_batches());
+    source_node.Consume(i);
+  }
+  writer->WritesDone();
+  EXPECT_TRUE(writer->Finish().ok());
+
+  EXPECT_EQ(0, source_node.flow_control_window()->buffered_bytes());
+  EXPECT_EQ(rb_reqs[0].ByteSizeLong(), source_node.flow_control_window()->max_buffered_bytes());
+  EXPECT_GT(source_node.flow_control_window()->total_wait_time(), absl::ZeroDuration());
+}
+
 TEST_F(GRPCRouterTest, basic_router_test) {
   int64_t grpc_source_node_id = 1;
   uint64_t ab = 0xea8aa095697f49f1, cd = 0xb127d50e5b6e2645;
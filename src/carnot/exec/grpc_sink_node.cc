@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/grpc_sink_node.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -67,6 +68,26 @@ StatusOr<carnotpb::TransferResultChunkRequest> RequestWithMetadata(
   return req;
 }
 
+Status GRPCSinkNode::SerializeRowBatch(ExecState* exec_state, const RowBatch& rb,
+                                       carnotpb::TransferResultChunkRequest* req) {
+  auto* query_result = req->mutable_query_result();
+  // Only Carnot instances decode columnar row batches, so results sent to the query broker always
+  // use RowBatchData.
+  if (!plan_node_->has_grpc_source_id()) {
+    return rb.ToProto(query_result->mutable_row_batch());
+  }
+  switch (exec_state->grpc_row_batch_encoding()) {
+    case planpb::ROW_BATCH_ENCODING_COLUMNAR:
+      return rb.ToColumnarProto(query_result->mutable_columnar_row_batch(),
+                                table_store::schemapb::ColumnarRowBatchData::COMPRESSION_NONE);
+    case planpb::ROW_BATCH_ENCODING_COLUMNAR_GZIP:
+      return rb.ToColumnarProto(query_result->mutable_columnar_row_batch(),
+                                table_store::schemapb::ColumnarRowBatchData::COMPRESSION_GZIP);
+    default:
+      return rb.ToProto(query_result->mutable_row_batch());
+  }
+}
+
 Status GRPCSinkNode::OptionallyCheckConnection(ExecState* exec_state) {
   if (sent_eos_ || cancelled_) {
     return Status::OK();
@@ -153,9 +174,21 @@ Status GRPCSinkNode::CancelledByServer(ExecState* exec_state) {
       plan_node_->id(), exec_state->query_id().str(), plan_node_->address());
 }
 
+bool GRPCSinkNode::Write(const carnotpb::TransferResultChunkRequest& req) {
+  // Writes block while the destination has no credits for the stream (see FlowControlWindow), so
+  // the time spent in writes is the time the sink was held back by its destination.
+  auto start = std::chrono::steady_clock::now();
+  bool ok = writer_->Write(req);
+  auto write_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  total_write_time_ += write_time;
+  max_write_time_ = std::max(max_write_time_, write_time);
+  return ok;
+}
+
 Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
                                      const carnotpb::TransferResultChunkRequest& req) {
-  if (writer_->Write(req)) {
+  if (Write(req)) {
     last_send_time_ = std::chrono::system_clock::now();
     return Status::OK();
   }
@@ -176,7 +209,7 @@ Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
   PL_RETURN_IF_ERROR(StartConnection(exec_state));
 
   // Try again to write the request on the new connection.
-  if (!writer_->Write(req)) {
+  if (!Write(req)) {
     return CancelledByServer(exec_state);
   }
   last_send_time_ = std::chrono::system_clock::now();
@@ -200,6 +233,8 @@ Status GRPCSinkNode::CloseWriter(ExecState* exec_state) {
 }
 
 Status GRPCSinkNode::CloseImpl(ExecState* exec_state) {
+  stats()->AddExtraInfo("total_write_time", PrettyDuration(total_write_time_.count()));
+  stats()->AddExtraInfo("max_write_time", PrettyDuration(max_write_time_.count()));
   if (sent_eos_ || cancelled_) {
     return Status::OK();
   }
@@ -312,7 +347,7 @@ Status GRPCSinkNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb,
 Status GRPCSinkNode::ConsumeNextImplNoSplit(ExecState* exec_state, const RowBatch& rb, size_t) {
   PL_ASSIGN_OR_RETURN(auto req, RequestWithMetadata(plan_node_.get(), exec_state));
   // Serialize the RowBatch.
-  PL_RETURN_IF_ERROR(rb.ToProto(req.mutable_query_result()->mutable_row_batch()));
+  PL_RETURN_IF_ERROR(SerializeRowBatch(exec_state, rb, &req));
 
   PL_RETURN_IF_ERROR(TryWriteRequest(exec_state, req));
 
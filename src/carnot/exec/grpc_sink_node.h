@@ -90,6 +90,12 @@ class GRPCSinkNode : public SinkNode {
   Status StartConnectionWithRetries(ExecState* exec_state, size_t n_retries);
   Status CancelledByServer(ExecState* exec_state);
   Status TryWriteRequest(ExecState* exec_state, const carnotpb::TransferResultChunkRequest& req);
+  // Writes the request to the stream, and tracks how long the write took.
+  bool Write(const carnotpb::TransferResultChunkRequest& req);
+  // Serializes the row batch into the request, in the encoding of the query (see
+  // planpb::RowBatchEncoding).
+  Status SerializeRowBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                           carnotpb::TransferResultChunkRequest* req);
 
   bool cancelled_ = false;
 
@@ -107,6 +113,9 @@ class GRPCSinkNode : public SinkNode {
 
   size_t max_batch_size_;
   float batch_size_factor_;
+
+  std::chrono::nanoseconds total_write_time_{0};
+  std::chrono::nanoseconds max_write_time_{0};
 };
 
 }  // namespace exec
@@ -16,9 +16,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <benchmark/benchmark.h>
 #include <grpcpp/test/mock_stream.h>
 #include <gtest/gtest.h>
@@ -49,20 +52,25 @@ using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Return;
 using ::testing::SetArgPointee;
-// NOLINTNEXTLINE : runtime/references.
-void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
-  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
-  auto table_store = std::make_shared<px::table_store::TableStore>();
+using px::carnot::planpb::RowBatchEncoding;
+
+namespace {
 
+// Creates an ExecState whose result sink stub accepts every request.
+std::unique_ptr<px::carnot::exec::ExecState> CreateExecState(
+    px::carnot::udf::Registry* func_registry,
+    std::shared_ptr<px::table_store::TableStore> table_store) {
   auto mock_unique = std::make_unique<::testing::NiceMock<MockResultSinkServiceStub>>();
   auto mock = mock_unique.get();
+  auto mock_holder =
+      std::make_shared<std::unique_ptr<ResultSinkService::StubInterface>>(std::move(mock_unique));
 
   auto exec_state = std::make_unique<px::carnot::exec::ExecState>(
-      func_registry.get(), table_store,
-      [&](const std::string&, const std::string&)
-          -> std::unique_ptr<ResultSinkService::StubInterface> { return std::move(mock_unique); },
+      func_registry, table_store,
+      [mock_holder](const std::string&, const std::string&)
+          -> std::unique_ptr<ResultSinkService::StubInterface> { return std::move(*mock_holder); },
       MockMetricsStubGenerator, MockTraceStubGenerator, sole::uuid4(), nullptr, nullptr,
-      [&](grpc::ClientContext*) {});
+      [](grpc::ClientContext*) {});
   TransferResultChunkResponse resp;
   resp.set_success(true);
   auto writer =
@@ -72,6 +80,37 @@ void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
   ON_CALL(*writer, Finish()).WillByDefault(Return(grpc::Status::OK));
   ON_CALL(*mock, TransferResultChunkRaw(_, _))
       .WillByDefault(DoAll(SetArgPointee<1>(resp), Return(writer)));
+  return exec_state;
+}
+
+// Creates a row batch with the column types of a typical PEM to Kelvin transfer.
+px::carnot::exec::RowBatchBuilder CreateMixedRowBatch(int64_t num_rows) {
+  RowDescriptor rd({DataType::TIME64NS, DataType::INT64, DataType::FLOAT64, DataType::STRING});
+  std::vector<px::types::Time64NSValue> times(num_rows);
+  std::vector<px::types::Int64Value> ints(num_rows);
+  std::vector<px::types::Float64Value> floats(num_rows);
+  std::vector<px::types::StringValue> strings(num_rows);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    times[i] = 1600000000000000000 + i * 1000;
+    ints[i] = i % 100;
+    floats[i] = i * 0.5;
+    strings[i] = absl::StrCat("/api/v1/service/", i % 17, "/endpoint");
+  }
+  auto builder = px::carnot::exec::RowBatchBuilder(rd, num_rows, /*eow*/ false, /*eos*/ false);
+  builder.AddColumn<px::types::Time64NSValue>(times)
+      .AddColumn<px::types::Int64Value>(ints)
+      .AddColumn<px::types::Float64Value>(floats)
+      .AddColumn<px::types::StringValue>(strings);
+  return builder;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE : runtime/references.
+void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
+  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+  auto exec_state = CreateExecState(func_registry.get(), table_store);
 
   px::carnot::exec::GRPCSinkNode node;
   auto op_proto = px::carnot::planpb::testutils::CreateTestGRPCSink2PB();
@@ -103,4 +142,80 @@ void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
   }
 }
 
+// Sends row batches to another Carnot instance with each row batch encoding.
+// NOLINTNEXTLINE : runtime/references.
+void BM_GRPCSinkNodeEncoding(benchmark::State& state) {
+  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+  auto exec_state = CreateExecState(func_registry.get(), table_store);
+  exec_state->set_grpc_row_batch_encoding(static_cast<RowBatchEncoding>(state.range(0)));
+
+  px::carnot::exec::GRPCSinkNode node;
+  auto op_proto = px::carnot::planpb::testutils::CreateTestGRPCSink1PB();
+  auto plan_node = std::make_unique<px::carnot::plan::GRPCSinkOperator>(1);
+  PL_CHECK_OK(plan_node->Init(op_proto.grpc_sink_op()));
+
+  auto row_batch_builder = CreateMixedRowBatch(/* num_rows */ 8 * 1024);
+  auto rb = row_batch_builder.get();
+  PL_CHECK_OK(node.Init(*plan_node, rb.desc(), {rb.desc()}));
+  PL_CHECK_OK(node.Prepare(exec_state.get()));
+  PL_CHECK_OK(node.Open(exec_state.get()));
+
+  for (auto _ : state) {
+    PL_CHECK_OK(node.ConsumeNext(exec_state.get(), rb, 0));
+  }
+  state.SetBytesProcessed(state.iterations() * rb.NumBytes());
+}
+
+// Parses and decodes the row batches received by a GRPCSourceNode with each row batch encoding.
+// The wire_bytes counter is the size of the serialized request.
+// NOLINTNEXTLINE : runtime/references.
+void BM_GRPCSourceRowBatchDecoding(benchmark::State& state) {
+  auto encoding = static_cast<RowBatchEncoding>(state.range(0));
+  auto row_batch_builder = CreateMixedRowBatch(/* num_rows */ 8 * 1024);
+  auto rb = row_batch_builder.get();
+
+  TransferResultChunkRequest req;
+  auto* query_result = req.mutable_query_result();
+  switch (encoding) {
+    case px::carnot::planpb::ROW_BATCH_ENCODING_COLUMNAR:
+      PL_CHECK_OK(rb.ToColumnarProto(query_result->mutable_columnar_row_batch()));
+      break;
+    case px::carnot::planpb::ROW_BATCH_ENCODING_COLUMNAR_GZIP:
+      PL_CHECK_OK(rb.ToColumnarProto(
+          query_result->mutable_columnar_row_batch(),
+          px::table_store::schemapb::ColumnarRowBatchData::COMPRESSION_GZIP));
+      break;
+    default:
+      PL_CHECK_OK(rb.ToProto(query_result->mutable_row_batch()));
+  }
+  std::string wire = req.SerializeAsString();
+
+  for (auto _ : state) {
+    auto received = std::make_shared<TransferResultChunkRequest>();
+    CHECK(received->ParseFromString(wire));
+    std::unique_ptr<RowBatch> output_rb;
+    if (received->query_result().has_columnar_row_batch()) {
+      output_rb = RowBatch::FromColumnarProto(received->query_result().columnar_row_batch(),
+                                              received)
+                      .ConsumeValueOrDie();
+    } else {
+      output_rb = RowBatch::FromProto(received->query_result().row_batch()).ConsumeValueOrDie();
+    }
+    benchmark::DoNotOptimize(output_rb);
+  }
+  state.counters["wire_bytes"] = wire.size();
+  state.SetBytesProcessed(state.iterations() * rb.NumBytes());
+}
+
 BENCHMARK(BM_GRPCSinkNodeSplitting)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GRPCSinkNodeEncoding)
+    ->Arg(px::carnot::planpb::ROW_BATCH_ENCODING_PROTO)
+    ->Arg(px::carnot::planpb::ROW_BATCH_ENCODING_COLUMNAR)
+    ->Arg(px::carnot::planpb::ROW_BATCH_ENCODING_COLUMNAR_GZIP)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GRPCSourceRowBatchDecoding)
+    ->Arg(px::carnot::planpb::ROW_BATCH_ENCODING_PROTO)
+    ->Arg(px::carnot::planpb::ROW_BATCH_ENCODING_COLUMNAR)
+    ->Arg(px::carnot::planpb::ROW_BATCH_ENCODING_COLUMNAR_GZIP)
+    ->Unit(benchmark::kMillisecond);
@@ -217,6 +217,51 @@ TEST_F(GRPCSinkNodeTest, internal_result) {
   EXPECT_FALSE(add_metadata_called_);
 }
 
+TEST_F(GRPCSinkNodeTest, internal_columnar_result) {
+  exec_state_->set_grpc_row_batch_encoding(planpb::ROW_BATCH_ENCODING_COLUMNAR_GZIP);
+  auto op_proto = planpb::testutils::CreateTestGRPCSink1PB();
+  auto plan_node = std::make_unique<plan::GRPCSinkOperator>(1);
+  auto s = plan_node->Init(op_proto.grpc_sink_op());
+  RowDescriptor input_rd({types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  TransferResultChunkResponse resp;
+  resp.set_success(true);
+
+  std::vector<TransferResultChunkRequest> actual_protos(2);
+  auto writer = new grpc::testing::MockClientWriter<TransferResultChunkRequest>();
+  EXPECT_CALL(*writer, Write(_, _))
+      .Times(2)
+      .WillOnce(DoAll(SaveArg<0>(&actual_protos[0]), Return(true)))
+      .WillOnce(DoAll(SaveArg<0>(&actual_protos[1]), Return(true)));
+  EXPECT_CALL(*writer, WritesDone());
+  EXPECT_CALL(*writer, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*mock_, TransferResultChunkRaw(_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(resp), Return(writer)));
+
+  auto tester = exec::ExecNodeTester<GRPCSinkNode, plan::GRPCSinkOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+  std::vector<types::Int64Value> data(100, 7);
+  auto rb = RowBatchBuilder(output_rd, 100, /*eow*/ true, /*eos*/ true)
+                .AddColumn<types::Int64Value>(data)
+                .get();
+  tester.ConsumeNext(rb, 5, 0);
+  tester.Close();
+
+  // The connection is still initiated with an empty RowBatchData.
+  EXPECT_TRUE(actual_protos[0].query_result().has_row_batch());
+  ASSERT_TRUE(actual_protos[1].query_result().has_columnar_row_batch());
+  const auto& columnar_rb = actual_protos[1].query_result().columnar_row_batch();
+  EXPECT_EQ(table_store::schemapb::ColumnarRowBatchData::COMPRESSION_GZIP,
+            columnar_rb.compression());
+  // The repeated values compress.
+  EXPECT_GT(columnar_rb.cols(0).data().uncompressed_size(), 0);
+
+  ASSERT_OK_AND_ASSIGN(auto output_rb,
+                       RowBatch::FromColumnarProto(columnar_rb, /* owner */ nullptr));
+  EXPECT_EQ(rb.DebugString(), output_rb->DebugString());
+}
+
 constexpr char kExpectedExternal0RowResult[] = R"proto(
 address: "localhost:1234"
 query_id {
@@ -18,10 +18,12 @@
 
 #include "src/carnot/exec/grpc_source_node.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/planpb/plan.pb.h"
@@ -47,32 +49,60 @@ Status GRPCSourceNode::PrepareImpl(ExecState*) { return Status::OK(); }
 
 Status GRPCSourceNode::OpenImpl(ExecState*) { return Status::OK(); }
 
-Status GRPCSourceNode::CloseImpl(ExecState*) { return Status::OK(); }
+Status GRPCSourceNode::CloseImpl(ExecState*) {
+  // Batches that are still sent to the source aren't consumed anymore, so they shouldn't wait for
+  // credits.
+  flow_control_window_->Close();
+  stats()->AddExtraInfo("max_buffered_bytes",
+                        absl::StrCat(flow_control_window_->max_buffered_bytes()));
+  stats()->AddExtraInfo(
+      "credit_wait_time",
+      PrettyDuration(absl::ToInt64Nanoseconds(flow_control_window_->total_wait_time())));
+  return Status::OK();
+}
 
 Status GRPCSourceNode::GenerateNextImpl(ExecState* exec_state) {
   PL_RETURN_IF_ERROR(PopRowBatch());
+  PL_RETURN_IF_ERROR(ApplyRuntimeFilters(rb_.get()));
   PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *rb_));
   return Status::OK();
 }
 
 Status GRPCSourceNode::EnqueueRowBatch(
     std::unique_ptr<carnotpb::TransferResultChunkRequest> row_batch) {
-  if (!row_batch_queue_.enqueue(std::move(row_batch))) {
+  int64_t bytes = row_batch->ByteSizeLong();
+  if (!row_batch_queue_.enqueue({std::move(row_batch), bytes})) {
     return error::Internal("Failed to enqueue RowBatch");
   }
+  flow_control_window_->Add(bytes);
   return Status::OK();
 }
 
 Status GRPCSourceNode::PopRowBatch() {
   DCHECK(NextBatchReady());
-  std::unique_ptr<carnotpb::TransferResultChunkRequest> rb_request;
-  bool got_one = row_batch_queue_.try_dequeue(rb_request);
+  QueuedRowBatch queued;
+  bool got_one = row_batch_queue_.try_dequeue(queued);
   if (!got_one) {
     return error::Internal(
         "Called GRPCSourceNode::OptionallyPopRowBatch but there was no available row batch in the "
         "queue.");
   }
-  if (!rb_request->has_query_result() || !rb_request->query_result().has_row_batch()) {
+  flow_control_window_->Release(queued.bytes);
+  std::unique_ptr<carnotpb::TransferResultChunkRequest> rb_request = std::move(queued.request);
+  if (!rb_request->has_query_result()) {
+    return error::Internal(
+        "GRPCSourceNode::PopRowBatch expected TransferResultChunkRequest to have RowBatch "
+        "message.");
+  }
+
+  if (rb_request->query_result().has_columnar_row_batch()) {
+    // The columns of the row batch point into the request, so the batch shares its ownership.
+    std::shared_ptr<const carnotpb::TransferResultChunkRequest> request = std::move(rb_request);
+    PL_ASSIGN_OR_RETURN(
+        rb_, RowBatch::FromColumnarProto(request->query_result().columnar_row_batch(), request));
+    return Status::OK();
+  }
+  if (!rb_request->query_result().has_row_batch()) {
     return error::Internal(
         "GRPCSourceNode::PopRowBatch expected TransferResultChunkRequest to have RowBatch "
         "message.");
@@ -21,11 +21,13 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/flow_control_window.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/table_store/table_store.h"
@@ -56,6 +58,13 @@ class GRPCSourceNode : public SourceNode {
   void set_upstream_closed_connection() { upstream_closed_connection_ = true; }
   bool upstream_closed_connection() const { return upstream_closed_connection_; }
 
+  // The credits of the source, shared with the GRPCRouter, which takes credits for the batches it
+  // holds for the source before the source is added to the router.
+  void set_flow_control_window(std::shared_ptr<FlowControlWindow> window) {
+    flow_control_window_ = std::move(window);
+  }
+  FlowControlWindow* flow_control_window() const { return flow_control_window_.get(); }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -67,9 +76,15 @@ class GRPCSourceNode : public SourceNode {
  private:
   Status PopRowBatch();
 
+  struct QueuedRowBatch {
+    std::unique_ptr<carnotpb::TransferResultChunkRequest> request;
+    // The serialized size of the request, which is the number of credits it takes.
+    int64_t bytes = 0;
+  };
+
   std::unique_ptr<table_store::schema::RowBatch> rb_;
-  moodycamel::BlockingConcurrentQueue<std::unique_ptr<carnotpb::TransferResultChunkRequest>>
-      row_batch_queue_;
+  moodycamel::BlockingConcurrentQueue<QueuedRowBatch> row_batch_queue_;
+  std::shared_ptr<FlowControlWindow> flow_control_window_ = std::make_shared<FlowControlWindow>();
 
   std::unique_ptr<plan::GRPCSourceOperator> plan_node_;
   bool upstream_initiated_connection_ = false;
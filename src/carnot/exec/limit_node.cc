@@ -19,6 +19,7 @@
 #include "src/carnot/exec/limit_node.h"
 
 #include <arrow/array.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -66,28 +67,45 @@ Status LimitNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, siz
   }
 
   // Check if the entire row batch will fit.
-  if (remainder_records > rb.num_rows()) {
+  if (remainder_records > rb.num_selected_rows()) {
     RowBatch output_rb(*output_descriptor_, rb.num_rows());
     DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
     // If so we just need to convert to output descriptor and transfer it.
     for (int64_t input_col_idx : plan_node_->selected_cols()) {
       PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(input_col_idx)));
     }
-    records_processed_ += rb.num_rows();
+    output_rb.set_selection(rb.selection());
+    records_processed_ += rb.num_selected_rows();
     output_rb.set_eos(rb.eos());
     output_rb.set_eow(rb.eow());
     return SendRowBatchToChildren(exec_state, output_rb);
   }
 
+  if (rb.has_selection()) {
+    // Keep the first selected rows, rather than slicing the columns.
+    RowBatch output_rb(*output_descriptor_, rb.num_rows());
+    for (int64_t input_col_idx : plan_node_->selected_cols()) {
+      PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(input_col_idx)));
+    }
+    output_rb.set_selection(std::make_shared<std::vector<int64_t>>(
+        rb.selection()->begin(), rb.selection()->begin() + remainder_records));
+    return SendLastRowBatch(exec_state, remainder_records, &output_rb);
+  }
+
   RowBatch output_rb(*output_descriptor_, remainder_records);
   DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
   for (int64_t input_col_idx : plan_node_->selected_cols()) {
     auto col = rb.ColumnAt(input_col_idx);
     PL_RETURN_IF_ERROR(output_rb.AddColumn(col->Slice(0, remainder_records)));
   }
-  output_rb.set_eow(true);
-  output_rb.set_eos(true);
-  records_processed_ += remainder_records;
+  return SendLastRowBatch(exec_state, remainder_records, &output_rb);
+}
+
+Status LimitNode::SendLastRowBatch(ExecState* exec_state, int64_t num_records,
+                                   RowBatch* output_rb) {
+  output_rb->set_eow(true);
+  output_rb->set_eos(true);
+  records_processed_ += num_records;
   limit_reached_ = true;
 
   // Terminate execution.
@@ -95,7 +113,7 @@ Status LimitNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, siz
     exec_state->StopSource(src_id);
   }
 
-  return SendRowBatchToChildren(exec_state, output_rb);
+  return SendRowBatchToChildren(exec_state, *output_rb);
 }
 
 }  // namespace exec
@@ -48,8 +48,13 @@ class LimitNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  bool ConsumesSelection() const override { return true; }
 
  private:
+  // Sends the row batch that reaches the limit, and stops the sources.
+  Status SendLastRowBatch(ExecState* exec_state, int64_t num_records,
+                          table_store::schema::RowBatch* output_rb);
+
   size_t records_processed_ = 0;
   bool limit_reached_ = false;
   std::unique_ptr<plan::LimitOperator> plan_node_;
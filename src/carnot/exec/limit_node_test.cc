@@ -281,6 +281,29 @@ TEST_F(LimitNodeTest, drop_input_columns_fewer_than_limit) {
       .Close();
 }
 
+TEST_F(LimitNodeTest, selected_input_rows) {
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowBatchBuilder input_builder(input_rd, 12, /*eow*/ true, /*eos*/ true);
+  auto& input_rb =
+      input_builder.AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6, 1, 2, 3, 4, 5, 6})
+          .AddColumn<types::Int64Value>({1, 3, 6, 9, 12, 15, 1, 3, 6, 9, 12, 15})
+          .get();
+  input_rb.set_selection(std::make_shared<std::vector<int64_t>>(
+      std::vector<int64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+
+  auto tester = exec::ExecNodeTester<LimitNode, plan::LimitOperator>(*plan_node_, output_rd,
+                                                                     {input_rd}, exec_state_.get());
+  // The limit keeps the first 10 selected rows.
+  tester.ConsumeNext(input_rb, 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 10, true, true)
+                          .AddColumn<types::Int64Value>({2, 3, 4, 5, 6, 1, 2, 3, 4, 5})
+                          .AddColumn<types::Int64Value>({3, 6, 9, 12, 15, 1, 3, 6, 9, 12})
+                          .get())
+      .Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
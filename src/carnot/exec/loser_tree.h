@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * LoserTree is a tournament tree for k-way merges. It tracks which of k inputs has the smallest
+ * current key: every inner node holds the loser of the match played at that node, and the overall
+ * winner is kept separately. When the key of the winner changes, only the matches on the path from
+ * its leaf to the root are replayed, which takes one comparison per level of the tree.
+ *
+ * The tree doesn't store the keys. less(a, b) compares the current keys of inputs a and b, and must
+ * be a strict total order, e.g. by breaking ties on the input index. Inputs that are exhausted
+ * should compare greater than all others.
+ */
+template <typename TLess>
+class LoserTree {
+ public:
+  static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+  explicit LoserTree(TLess less) : less_(std::move(less)) {}
+
+  /**
+   * Plays all of the matches between inputs [0, num_inputs), which takes num_inputs - 1
+   * comparisons. Must be called again whenever the key of an input other than the winner changes.
+   */
+  void Reset(size_t num_inputs) {
+    num_inputs_ = num_inputs;
+    // The inner nodes are [1, num_inputs), and the leaves are [num_inputs, 2 * num_inputs).
+    losers_.assign(num_inputs, kNone);
+    winner_ = num_inputs == 0 ? kNone : Play(1);
+  }
+
+  /**
+   * Replays the matches of the winner after its key changed.
+   */
+  void ReplayWinner() {
+    size_t winner = winner_;
+    for (size_t node = (winner + num_inputs_) / 2; node > 0; node /= 2) {
+      if (less_(losers_[node], winner)) {
+        std::swap(losers_[node], winner);
+      }
+    }
+    winner_ = winner;
+  }
+
+  /**
+   * @return the input with the smallest key.
+   */
+  size_t winner() const { return winner_; }
+
+  /**
+   * @return the input with the second smallest key, or kNone if there is only one input. The
+   * runner up must have lost its match against the winner, so it's one of the losers on the path
+   * of the winner.
+   */
+  size_t runner_up() const {
+    size_t runner_up = kNone;
+    for (size_t node = (winner_ + num_inputs_) / 2; node > 0; node /= 2) {
+      if (runner_up == kNone || less_(losers_[node], runner_up)) {
+        runner_up = losers_[node];
+      }
+    }
+    return runner_up;
+  }
+
+ private:
+  // Plays the matches of the subtree rooted at node, and returns its winner.
+  size_t Play(size_t node) {
+    if (node >= num_inputs_) {
+      return node - num_inputs_;
+    }
+    size_t left = Play(2 * node);
+    size_t right = Play(2 * node + 1);
+    if (less_(right, left)) {
+      losers_[node] = left;
+      return right;
+    }
+    losers_[node] = right;
+    return left;
+  }
+
+  TLess less_;
+  size_t num_inputs_ = 0;
+  size_t winner_ = kNone;
+  std::vector<size_t> losers_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
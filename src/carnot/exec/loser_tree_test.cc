@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/loser_tree.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using LessFn = std::function<bool(size_t, size_t)>;
+
+// Merges the sorted inputs with a LoserTree, advancing the winner one element at a time.
+std::vector<int> Merge(const std::vector<std::vector<int>>& inputs) {
+  std::vector<size_t> cursors(inputs.size());
+  auto exhausted = [&](size_t i) { return cursors[i] == inputs[i].size(); };
+  LoserTree<LessFn> tree([&](size_t a, size_t b) {
+    if (exhausted(a) || exhausted(b)) {
+      return exhausted(b) && (!exhausted(a) || a < b);
+    }
+    int val_a = inputs[a][cursors[a]];
+    int val_b = inputs[b][cursors[b]];
+    return val_a < val_b || (val_a == val_b && a < b);
+  });
+  tree.Reset(inputs.size());
+
+  std::vector<int> out;
+  while (!exhausted(tree.winner())) {
+    out.push_back(inputs[tree.winner()][cursors[tree.winner()]++]);
+    tree.ReplayWinner();
+  }
+  return out;
+}
+
+TEST(LoserTreeTest, merges_sorted_inputs) {
+  std::mt19937 gen(0);
+  for (size_t num_inputs : {1, 2, 3, 7, 16, 33}) {
+    std::vector<std::vector<int>> inputs(num_inputs);
+    std::vector<int> expected;
+    for (auto& input : inputs) {
+      input.resize(gen() % 20);
+      for (auto& val : input) {
+        val = gen() % 50;
+      }
+      std::sort(input.begin(), input.end());
+      expected.insert(expected.end(), input.begin(), input.end());
+    }
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, Merge(inputs)) << num_inputs;
+  }
+}
+
+TEST(LoserTreeTest, runner_up) {
+  std::vector<int> keys = {5, 3, 9, 1, 7};
+  LoserTree<LessFn> tree([&](size_t a, size_t b) { return keys[a] < keys[b]; });
+  tree.Reset(keys.size());
+  EXPECT_EQ(3, tree.winner());
+  EXPECT_EQ(1, tree.runner_up());
+
+  keys[3] = 8;
+  tree.ReplayWinner();
+  EXPECT_EQ(1, tree.winner());
+  EXPECT_EQ(0, tree.runner_up());
+
+  LoserTree<LessFn> single([&](size_t a, size_t b) { return keys[a] < keys[b]; });
+  single.Reset(1);
+  EXPECT_EQ(0, single.winner());
+  EXPECT_EQ(LoserTree<LessFn>::kNone, single.runner_up());
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
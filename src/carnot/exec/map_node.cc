@@ -18,11 +18,13 @@
 
 #include "src/carnot/exec/map_node.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include <absl/strings/substitute.h>
 
+#include "src/carnot/exec/row_batch_selection.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
 
@@ -48,6 +50,10 @@ Status MapNode::PrepareImpl(ExecState* exec_state) {
   function_ctx_ = exec_state->CreateFunctionContext();
   evaluator_ = ScalarExpressionEvaluator::Create(
       plan_node_->expressions(), ScalarExpressionEvaluatorType::kArrowNative, function_ctx_.get());
+  input_cols_ = ReferencedColumns(plan_node_->expressions());
+  projection_only_ = std::all_of(
+      plan_node_->expressions().begin(), plan_node_->expressions().end(),
+      [](const auto& expr) { return expr->ExpressionType() == plan::Expression::kColumn; });
   return Status::OK();
 }
 
@@ -62,6 +68,24 @@ Status MapNode::CloseImpl(ExecState* exec_state) {
   return Status::OK();
 }
 Status MapNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (rb.has_selection() && projection_only_) {
+    RowBatch output_rb(*output_descriptor_, rb.num_rows());
+    for (const auto& expr : plan_node_->expressions()) {
+      auto col_idx = static_cast<const plan::Column*>(expr.get())->Index();
+      PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(col_idx)));
+    }
+    output_rb.set_selection(rb.selection());
+    output_rb.set_eow(rb.eow());
+    output_rb.set_eos(rb.eos());
+    return SendRowBatchToChildren(exec_state, output_rb);
+  }
+  if (rb.has_selection()) {
+    // Only the columns that the expressions read are compacted.
+    PL_ASSIGN_OR_RETURN(auto compacted_rb,
+                        CompactColumns(rb, input_cols_, exec_state->exec_mem_pool()));
+    return ConsumeNextImpl(exec_state, *compacted_rb, 0);
+  }
+
   RowBatch output_rb(*output_descriptor_, rb.num_rows());
   PL_RETURN_IF_ERROR(evaluator_->Evaluate(exec_state, rb, &output_rb));
   output_rb.set_eow(rb.eow());
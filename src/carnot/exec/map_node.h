@@ -23,6 +23,8 @@
 #include <string>
 #include <vector>
 
+#include <absl/container/flat_hash_set.h>
+
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
@@ -49,10 +51,16 @@ class MapNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  bool ConsumesSelection() const override { return true; }
 
  private:
   std::unique_ptr<ExpressionEvaluator> evaluator_;
   std::unique_ptr<plan::MapOperator> plan_node_;
+  // The input columns that the expressions read.
+  absl::flat_hash_set<int64_t> input_cols_;
+  // Set if every expression is a column, in which case the map keeps the selection vector of its
+  // input instead of compacting it.
+  bool projection_only_ = false;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
 };
 
@@ -144,6 +144,25 @@ TEST_F(MapNodeTest, child_fail) {
                                0, error::InvalidArgument("args"));
 }
 
+TEST_F(MapNodeTest, selected_input_rows) {
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  RowBatchBuilder input_builder(input_rd, 4, /*eow*/ true, /*eos*/ true);
+  auto& input_rb =
+      input_builder.AddColumn<types::Int64Value>({1, 2, 3, 4})
+          .AddColumn<types::Int64Value>({1, 3, 6, 9})
+          .get();
+  input_rb.set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2}));
+
+  auto tester = exec::ExecNodeTester<MapNode, plan::MapOperator>(*plan_node_, output_rd, {},
+                                                                 exec_state_.get());
+  tester.ConsumeNext(input_rb, 0)
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd, 2, true, true).AddColumn<types::Int64Value>({2, 9}).get())
+      .Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
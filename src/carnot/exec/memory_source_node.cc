@@ -19,8 +19,12 @@
 #include "src/carnot/exec/memory_source_node.h"
 #include "src/table_store/table/table.h"
 
+#include <algorithm>
 #include <limits>
+#include <numeric>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <absl/strings/substitute.h>
@@ -28,12 +32,143 @@
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
 
+DEFINE_bool(carnot_late_materialization,
+            gflags::BoolFromEnv("PL_CARNOT_LATE_MATERIALIZATION", true),
+            "Whether memory sources with predicate columns read those first, and only read their "
+            "other columns for the rows that satisfy the predicates.");
+
 namespace px {
 namespace carnot {
 namespace exec {
 
 using StartSpec = Table::Cursor::StartSpec;
 using StopSpec = Table::Cursor::StopSpec;
+using PredicateSpec = Table::Cursor::PredicateSpec;
+using ColumnPredicate = Table::ColumnPredicate;
+
+namespace {
+
+std::optional<ColumnPredicate::Op> PredicateOpFromProto(planpb::SourceColumnPredicate::Op op) {
+  switch (op) {
+    case planpb::SourceColumnPredicate::EQUAL:
+      return ColumnPredicate::Op::kEqual;
+    case planpb::SourceColumnPredicate::NOT_EQUAL:
+      return ColumnPredicate::Op::kNotEqual;
+    case planpb::SourceColumnPredicate::LESS_THAN:
+      return ColumnPredicate::Op::kLessThan;
+    case planpb::SourceColumnPredicate::LESS_THAN_EQUAL:
+      return ColumnPredicate::Op::kLessThanEqual;
+    case planpb::SourceColumnPredicate::GREATER_THAN:
+      return ColumnPredicate::Op::kGreaterThan;
+    case planpb::SourceColumnPredicate::GREATER_THAN_EQUAL:
+      return ColumnPredicate::Op::kGreaterThanEqual;
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<ColumnPredicate::Value> PredicateValueFromProto(const planpb::ScalarValue& value) {
+  switch (value.value_case()) {
+    case planpb::ScalarValue::kInt64Value:
+      return value.int64_value();
+    case planpb::ScalarValue::kTime64NsValue:
+      return value.time64_ns_value();
+    case planpb::ScalarValue::kFloat64Value:
+      return value.float64_value();
+    case planpb::ScalarValue::kStringValue:
+      return value.string_value();
+    default:
+      return std::nullopt;
+  }
+}
+
+// Predicates are only used to skip batches, so any predicate that can't be converted is dropped
+// rather than failing the query.
+PredicateSpec PredicateSpecFromPlan(const plan::MemorySourceOperator& plan_node) {
+  PredicateSpec spec;
+  for (const auto& pred : plan_node.predicates()) {
+    auto op = PredicateOpFromProto(pred.op());
+    auto value = PredicateValueFromProto(pred.value());
+    if (!op.has_value() || !value.has_value()) {
+      continue;
+    }
+    spec.predicates.push_back(ColumnPredicate{pred.column_idx(), op.value(), value.value()});
+  }
+  return spec;
+}
+
+template <typename T>
+bool Compare(ColumnPredicate::Op op, const T& lhs, const T& rhs) {
+  switch (op) {
+    case ColumnPredicate::Op::kEqual:
+      return lhs == rhs;
+    case ColumnPredicate::Op::kNotEqual:
+      return lhs != rhs;
+    case ColumnPredicate::Op::kLessThan:
+      return lhs < rhs;
+    case ColumnPredicate::Op::kLessThanEqual:
+      return lhs <= rhs;
+    case ColumnPredicate::Op::kGreaterThan:
+      return lhs > rhs;
+    case ColumnPredicate::Op::kGreaterThanEqual:
+      return lhs >= rhs;
+  }
+  return true;
+}
+
+// Removes the rows that don't satisfy the predicate from `rows`. The value types that the planner
+// pushes down for each column type are the same as for zone maps, predicates with other types are
+// ignored.
+void FilterRows(const ColumnPredicate& pred, const arrow::Array* col, types::DataType data_type,
+                std::vector<int64_t>* rows) {
+  auto filter = [rows](auto matches) {
+    rows->erase(
+        std::remove_if(rows->begin(), rows->end(), [&](int64_t row) { return !matches(row); }),
+        rows->end());
+  };
+  switch (data_type) {
+    case types::DataType::INT64:
+    case types::DataType::TIME64NS: {
+      const auto* value = std::get_if<int64_t>(&pred.value);
+      if (value == nullptr) {
+        return;
+      }
+      const auto* values = static_cast<const arrow::Int64Array*>(col)->raw_values();
+      filter([&](int64_t row) { return Compare(pred.op, values[row], *value); });
+      return;
+    }
+    case types::DataType::FLOAT64: {
+      std::optional<double> value;
+      if (const auto* v = std::get_if<double>(&pred.value)) {
+        value = *v;
+      } else if (const auto* v = std::get_if<int64_t>(&pred.value)) {
+        value = static_cast<double>(*v);
+      } else {
+        return;
+      }
+      const auto* values = static_cast<const arrow::DoubleArray*>(col)->raw_values();
+      filter([&](int64_t row) { return Compare(pred.op, values[row], *value); });
+      return;
+    }
+    case types::DataType::STRING: {
+      const auto* value = std::get_if<std::string>(&pred.value);
+      if (value == nullptr) {
+        return;
+      }
+      const auto* strings = static_cast<const arrow::StringArray*>(col);
+      std::string_view value_view = *value;
+      filter([&](int64_t row) {
+        auto str = strings->GetView(row);
+        return Compare(pred.op, std::string_view(str.data(), str.size()), value_view);
+      });
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+}  // namespace
 
 std::string MemorySourceNode::DebugStringImpl() {
   return absl::Substitute("Exec::MemorySourceNode: <name: $0, output: $1>", plan_node_->TableName(),
@@ -85,16 +220,58 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
       stop_spec.type = StopSpec::StopType::CurrentEndOfTable;
     }
   }
-  cursor_ = std::make_unique<Table::Cursor>(table_, start_spec, stop_spec);
+  auto predicate_spec = PredicateSpecFromPlan(*plan_node_);
+  auto predicate_cols = plan_node_->PredicateColumns();
+  late_materialization_ = FLAGS_carnot_late_materialization && !predicate_cols.empty() &&
+                          !predicate_spec.predicates.empty();
+  std::vector<ColumnPredicate> predicates = predicate_spec.predicates;
+  cursor_ = std::make_unique<Table::Cursor>(table_, start_spec, stop_spec,
+                                           std::move(predicate_spec));
+  if (late_materialization_) {
+    cursor_->SetLateMaterialization(Table::LateMaterialization{
+        predicate_cols, [this, predicates, predicate_cols](const RowBatch& predicate_rb) {
+          return SelectRows(predicates, predicate_cols, predicate_rb);
+        }});
+  }
 
   return Status::OK();
 }
 
 Status MemorySourceNode::CloseImpl(ExecState*) {
   stats()->AddExtraInfo("streaming", streaming_ ? "true" : "false");
+  if (cursor_ != nullptr && !plan_node_->predicates().empty()) {
+    stats()->AddExtraInfo("batches_skipped", absl::StrCat(cursor_->BatchesSkipped()));
+  }
+  if (late_materialization_) {
+    stats()->AddExtraInfo("rows_dropped_by_predicates", absl::StrCat(rows_dropped_by_predicates_));
+  }
+  if (RowsDroppedByRuntimeFilters() > 0) {
+    stats()->AddExtraInfo("rows_dropped_by_runtime_filters",
+                          absl::StrCat(RowsDroppedByRuntimeFilters()));
+  }
   return Status::OK();
 }
 
+StatusOr<std::vector<int64_t>> MemorySourceNode::SelectRows(
+    const std::vector<ColumnPredicate>& predicates, const std::vector<int64_t>& predicate_cols,
+    const RowBatch& predicate_rb) {
+  std::vector<int64_t> rows(predicate_rb.num_rows());
+  std::iota(rows.begin(), rows.end(), 0);
+  for (const auto& pred : predicates) {
+    auto it = std::find(predicate_cols.begin(), predicate_cols.end(), pred.col_idx);
+    if (it == predicate_cols.end()) {
+      continue;
+    }
+    int64_t rb_col_idx = it - predicate_cols.begin();
+    FilterRows(pred, predicate_rb.ColumnAt(rb_col_idx).get(), predicate_rb.desc().type(rb_col_idx),
+               &rows);
+  }
+  // The dropped rows are still processed, even though their other columns are never read.
+  rows_dropped_by_predicates_ += predicate_rb.num_rows() - rows.size();
+  rows_processed_ += predicate_rb.num_rows() - rows.size();
+  return rows;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*) {
   DCHECK(table_ != nullptr);
 
@@ -123,8 +300,21 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
   return row_batch;
 }
 
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::NextMorsel() {
+  DCHECK(!streaming_);
+  absl::MutexLock lock(&morsel_lock_);
+  if (cursor_->Done()) {
+    return std::unique_ptr<RowBatch>(nullptr);
+  }
+  PL_ASSIGN_OR_RETURN(auto row_batch, cursor_->GetNextRowBatch(plan_node_->Columns()));
+  rows_processed_ += row_batch->num_rows();
+  bytes_processed_ += row_batch->NumBytes();
+  return row_batch;
+}
+
 Status MemorySourceNode::GenerateNextImpl(ExecState* exec_state) {
   PL_ASSIGN_OR_RETURN(auto row_batch, GetNextRowBatch(exec_state));
+  PL_RETURN_IF_ERROR(ApplyRuntimeFilters(row_batch.get()));
   PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *row_batch));
   return Status::OK();
 }
@@ -23,6 +23,8 @@
 #include <string>
 #include <vector>
 
+#include <absl/synchronization/mutex.h>
+
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/plan/operators.h"
@@ -32,6 +34,8 @@
 #include "src/table_store/table/table.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_bool(carnot_late_materialization);
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -46,6 +50,16 @@ class MemorySourceNode : public SourceNode {
 
   bool NextBatchReady() override;
 
+  /**
+   * Returns the next batch of the table (a morsel) for a parallel pipeline, or nullptr when the
+   * table is exhausted. Unlike GenerateNext, the batch isn't sent to the children and never has
+   * eow/eos set: the ParallelPipeline sends end of stream once all of its workers are done. This
+   * function is thread-safe, but can't be mixed with GenerateNext.
+   */
+  StatusOr<std::unique_ptr<RowBatch>> NextMorsel();
+
+  bool streaming() const { return plan_node_->streaming(); }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -57,13 +71,26 @@ class MemorySourceNode : public SourceNode {
  private:
   StatusOr<std::unique_ptr<RowBatch>> GetNextRowBatch(ExecState* exec_state);
   bool InfiniteStreamNextBatchReady();
+  // Returns the rows of a batch of the predicate columns that satisfy every predicate.
+  StatusOr<std::vector<int64_t>> SelectRows(const std::vector<Table::ColumnPredicate>& predicates,
+                                            const std::vector<int64_t>& predicate_cols,
+                                            const RowBatch& predicate_rb);
   // Whether this memory source will stream future results.
   bool streaming_ = false;
 
   std::unique_ptr<Table::Cursor> cursor_;
+  // Serializes NextMorsel calls, which share the cursor.
+  absl::Mutex morsel_lock_;
 
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
   table_store::Table* table_ = nullptr;
+
+  // Whether batches are read with late materialization, i.e. the columns of the predicates are
+  // read first, and the remaining columns only for the rows that satisfy them.
+  bool late_materialization_ = false;
+  // The number of rows that were dropped, without reading their other columns, because they don't
+  // satisfy the predicates.
+  int64_t rows_dropped_by_predicates_ = 0;
 };
 
 }  // namespace exec
@@ -416,6 +416,90 @@ TEST_F(MemorySourceNodeTest, table_compact_between_open_and_exec) {
   tester.Close();
 }
 
+TEST_F(MemorySourceNodeTest, predicates_skip_cold_batches) {
+  // Compacts the table into cold batches with times {1, 2} and {3, 5}, leaving {6} hot.
+  EXPECT_OK(cpu_table_->CompactHotToCold(arrow::default_memory_pool()));
+
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto* pred = op_proto.mutable_mem_source_op()->add_predicates();
+  pred->set_column_idx(1);
+  pred->set_op(planpb::SourceColumnPredicate::GREATER_THAN);
+  pred->mutable_value()->set_data_type(types::DataType::TIME64NS);
+  pred->mutable_value()->set_time64_ns_value(5);
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  EXPECT_TRUE(tester.node()->HasBatchesRemaining());
+  // Both cold batches are skipped.
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 0, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({})
+          .get());
+  EXPECT_TRUE(tester.node()->HasBatchesRemaining());
+  // The hot store doesn't have zone maps, so its batches are always returned.
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({6})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+  EXPECT_EQ(1, tester.node()->RowsProcessed());
+}
+
+TEST_F(MemorySourceNodeTest, late_materialization) {
+  // Compacts the table into cold batches with times {1, 2} and {3, 5}, leaving {6} hot.
+  EXPECT_OK(cpu_table_->CompactHotToCold(arrow::default_memory_pool()));
+
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto* mem_source_op = op_proto.mutable_mem_source_op();
+  mem_source_op->clear_column_idxs();
+  mem_source_op->clear_column_types();
+  mem_source_op->clear_column_names();
+  mem_source_op->add_column_idxs(0);
+  mem_source_op->add_column_types(types::DataType::BOOLEAN);
+  mem_source_op->add_column_names("col1");
+  mem_source_op->add_column_idxs(1);
+  mem_source_op->add_column_types(types::DataType::TIME64NS);
+  mem_source_op->add_column_names("time_");
+  for (const auto& [op, value] : std::vector<std::pair<planpb::SourceColumnPredicate::Op, int64_t>>{
+           {planpb::SourceColumnPredicate::GREATER_THAN, 1},
+           {planpb::SourceColumnPredicate::NOT_EQUAL, 5}}) {
+    auto* pred = mem_source_op->add_predicates();
+    pred->set_column_idx(1);
+    pred->set_op(op);
+    pred->mutable_value()->set_data_type(types::DataType::TIME64NS);
+    pred->mutable_value()->set_time64_ns_value(value);
+  }
+  // col1 is only read for the rows that satisfy the predicates on time_.
+  mem_source_op->add_predicate_column_idxs(1);
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::BOOLEAN, types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::BoolValue>({false})
+          .AddColumn<types::Time64NSValue>({2})
+          .get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::BoolValue>({true})
+          .AddColumn<types::Time64NSValue>({3})
+          .get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::BoolValue>({false})
+          .AddColumn<types::Time64NSValue>({6})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+  // The dropped rows were still scanned.
+  EXPECT_EQ(5, tester.node()->RowsProcessed());
+}
+
 struct MemorySourceTestCase {
   std::string name;
   std::vector<std::vector<int64_t>> initial_time_batches;
@@ -0,0 +1,23 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/memory_tracker.h"
+
+DEFINE_int64(carnot_query_memory_limit, gflags::Int64FromEnv("PL_CARNOT_QUERY_MEMORY_LIMIT", 0),
+             "The number of bytes that the aggregates and joins of a query may hold in memory, "
+             "before they spill their state to disk. 0 means no limit.");
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "src/common/base/base.h"
+
+DECLARE_int64(carnot_query_memory_limit);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * MemoryTracker tracks the memory that the blocking operators of a query hold in their state, such
+ * as the groups of an aggregate or the build side of a join, against the query's memory limit.
+ * Operators report estimates of their state size, and spill their state to disk (see SpillFile)
+ * while the limit is exceeded. It's shared by the nodes of all of the threads of a query.
+ */
+class MemoryTracker {
+ public:
+  /**
+   * @param limit_bytes the memory limit of the query, or 0 if it has no limit.
+   */
+  explicit MemoryTracker(int64_t limit_bytes) : limit_bytes_(limit_bytes) {}
+
+  /**
+   * Updates the tracked size of an operator's state.
+   * @param tracked_bytes the size of the state that is currently tracked, which is updated.
+   * @param bytes the new size of the state.
+   */
+  void Track(int64_t* tracked_bytes, int64_t bytes) {
+    bytes_used_ += bytes - *tracked_bytes;
+    *tracked_bytes = bytes;
+  }
+
+  bool LimitExceeded() const {
+    int64_t limit = limit_bytes_;
+    return limit > 0 && bytes_used_ > limit;
+  }
+
+  int64_t bytes_used() const { return bytes_used_; }
+  int64_t limit_bytes() const { return limit_bytes_; }
+  void set_limit_bytes(int64_t limit_bytes) { limit_bytes_ = limit_bytes; }
+
+ private:
+  std::atomic<int64_t> bytes_used_ = 0;
+  std::atomic<int64_t> limit_bytes_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
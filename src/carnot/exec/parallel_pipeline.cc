@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/parallel_pipeline.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+Status ParallelPipeline::RunWorker(ExecState* exec_state, const Worker& worker) {
+  while (!failed_) {
+    PL_ASSIGN_OR_RETURN(auto rb, source_->NextMorsel());
+    if (rb == nullptr) {
+      return Status::OK();
+    }
+    PL_RETURN_IF_ERROR(worker.head->ConsumeNext(exec_state, *rb, worker.parent_index));
+  }
+  return Status::OK();
+}
+
+Status ParallelPipeline::Execute(ExecState* exec_state) {
+  std::vector<Status> statuses(workers_.size());
+  std::vector<std::thread> threads;
+  threads.reserve(workers_.size());
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    threads.emplace_back([this, exec_state, i, &statuses] {
+      statuses[i] = RunWorker(exec_state, workers_[i]);
+      if (!statuses[i].ok()) {
+        failed_ = true;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& s : statuses) {
+    PL_RETURN_IF_ERROR(s);
+  }
+
+  AggNode* agg = workers_[0].agg;
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    PL_RETURN_IF_ERROR(agg->MergeFrom(exec_state, workers_[i].agg));
+  }
+  return source_->SendEndOfStream(exec_state);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "src/carnot/exec/agg_node.h"
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/memory_source_node.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * ParallelPipeline executes a pipeline from a MemorySourceNode to a blocking AggNode on multiple
+ * threads, using morsel-driven parallelism.
+ *
+ * Each worker thread has its own copy of the nodes of the pipeline, ending in its own AggNode
+ * that keeps the worker's partial aggregates. Workers repeatedly take the next batch of the
+ * source's cursor (a morsel) and push it through their pipeline, until the source is exhausted.
+ * Since morsels are handed out on demand, a worker that gets cheap morsels (e.g. ones that are
+ * mostly filtered out) simply takes more of them, and no worker is left idle while there is work
+ * left. Once all workers are done, the partial aggregates are merged into the AggNode of the
+ * first worker, which is the AggNode of the execution graph, and end of stream is sent through
+ * the graph's pipeline so that the aggregate emits its results as usual.
+ */
+class ParallelPipeline {
+ public:
+  struct Worker {
+    // The first node after the source in this worker's pipeline.
+    ExecNode* head;
+    // The parent index of the source for `head`.
+    size_t parent_index;
+    // The aggregate at the end of this worker's pipeline.
+    AggNode* agg;
+  };
+
+  /**
+   * @param source the source of the pipeline.
+   * @param workers the pipelines of the workers. The first worker must be the pipeline of the
+   * execution graph, i.e. the one that the source sends its end of stream to.
+   */
+  ParallelPipeline(MemorySourceNode* source, std::vector<Worker> workers)
+      : source_(source), workers_(std::move(workers)) {
+    DCHECK(!workers_.empty());
+  }
+
+  /**
+   * Runs the pipeline to completion. The nodes must be opened, and are not closed.
+   */
+  Status Execute(ExecState* exec_state);
+
+  MemorySourceNode* source() const { return source_; }
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  Status RunWorker(ExecState* exec_state, const Worker& worker);
+
+  MemorySourceNode* source_;
+  std::vector<Worker> workers_;
+  // Set when a worker fails, so that the others stop early.
+  std::atomic<bool> failed_{false};
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
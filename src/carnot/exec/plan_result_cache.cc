@@ -0,0 +1,319 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/plan_result_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+DEFINE_int64(carnot_result_cache_max_bytes,
+             gflags::Int64FromEnv("PL_CARNOT_RESULT_CACHE_MAX_BYTES", 0),
+             "The maximum number of bytes of plan results to cache, see PlanResultCache. 0 "
+             "disables the cache.");
+DEFINE_int64(carnot_result_cache_ttl_seconds,
+             gflags::Int64FromEnv("PL_CARNOT_RESULT_CACHE_TTL_SECONDS", 60),
+             "How long cached plan results are valid for.");
+DEFINE_int64(carnot_result_cache_bucket_ns,
+             gflags::Int64FromEnv("PL_CARNOT_RESULT_CACHE_BUCKET_NS", 1000 * 1000 * 1000),
+             "The minimum size of the time buckets whose plan results are cached.");
+DEFINE_int64(carnot_result_cache_settle_seconds,
+             gflags::Int64FromEnv("PL_CARNOT_RESULT_CACHE_SETTLE_SECONDS", 10),
+             "How long after the end of a time bucket its plan results are cached. Rows that are "
+             "written to a table later than this after their time are missing from cached "
+             "results.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+namespace {
+
+// The number of plans whose last execution is tracked, before expired ones are forgotten.
+constexpr size_t kMaxTrackedPlans = 1024;
+
+bool IsSink(planpb::OperatorType op_type) {
+  return op_type == planpb::MEMORY_SINK_OPERATOR || op_type == planpb::GRPC_SINK_OPERATOR;
+}
+
+planpb::MemorySourceOperator* MutableMemorySource(planpb::Plan* plan) {
+  for (auto& node : *plan->mutable_nodes(0)->mutable_nodes()) {
+    if (node.op().op_type() == planpb::MEMORY_SOURCE_OPERATOR) {
+      return node.mutable_op()->mutable_mem_source_op();
+    }
+  }
+  return nullptr;
+}
+
+bool IsDeterministic(const planpb::ScalarExpression& expr, const udf::Registry& registry) {
+  if (!expr.has_func()) {
+    return true;
+  }
+  const auto& func = expr.func();
+  std::vector<types::DataType> registry_arg_types;
+  for (const auto& init_arg : func.init_args()) {
+    registry_arg_types.push_back(init_arg.data_type());
+  }
+  for (const auto& data_type : func.args_data_types()) {
+    registry_arg_types.push_back(static_cast<types::DataType>(data_type));
+  }
+  auto def_or_s = registry.GetScalarUDFDefinition(func.name(), registry_arg_types);
+  if (!def_or_s.ok() || !def_or_s.ConsumeValueOrDie()->deterministic()) {
+    return false;
+  }
+  for (const auto& arg : func.args()) {
+    if (!IsDeterministic(arg, registry)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::optional<PlanResultCache::CacheablePlan> PlanResultCache::GetCacheablePlan(
+    const planpb::Plan& plan, const udf::Registry& registry) {
+  if (plan.nodes_size() != 1 || plan.incoming_agent_ids_size() > 0) {
+    return std::nullopt;
+  }
+  const auto& pf = plan.nodes(0);
+  absl::flat_hash_map<uint64_t, planpb::OperatorType> op_types;
+  for (const auto& node : pf.nodes()) {
+    op_types[node.id()] = node.op().op_type();
+  }
+
+  const planpb::MemorySourceOperator* source = nullptr;
+  for (const auto& node : pf.nodes()) {
+    const auto& op = node.op();
+    switch (op.op_type()) {
+      case planpb::MEMORY_SOURCE_OPERATOR:
+        if (source != nullptr) {
+          return std::nullopt;
+        }
+        source = &op.mem_source_op();
+        break;
+      case planpb::MAP_OPERATOR:
+        for (const auto& expr : op.map_op().expressions()) {
+          if (!IsDeterministic(expr, registry)) {
+            return std::nullopt;
+          }
+        }
+        break;
+      case planpb::FILTER_OPERATOR:
+        if (!IsDeterministic(op.filter_op().expression(), registry)) {
+          return std::nullopt;
+        }
+        break;
+      case planpb::MEMORY_SINK_OPERATOR:
+      case planpb::GRPC_SINK_OPERATOR:
+        break;
+      case planpb::AGGREGATE_OPERATOR: {
+        // The partial states of the buckets are merged by the aggregate that finalizes them, so the
+        // state has to go straight to the sinks.
+        const auto& agg = op.agg_op();
+        if (!agg.partial_agg() || agg.finalize_results() || agg.windowed()) {
+          return std::nullopt;
+        }
+        break;
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+  for (const auto& dag_node : pf.dag().nodes()) {
+    if (op_types[dag_node.id()] != planpb::AGGREGATE_OPERATOR) {
+      continue;
+    }
+    for (uint64_t child : dag_node.sorted_children()) {
+      if (!IsSink(op_types[child])) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  if (source == nullptr || source->streaming() || !source->has_start_time() ||
+      !source->has_stop_time()) {
+    return std::nullopt;
+  }
+  int64_t start_time = source->start_time().value();
+  int64_t stop_time = source->stop_time().value();
+  if (start_time < 0 || stop_time < start_time ||
+      stop_time > std::numeric_limits<int64_t>::max() / 2) {
+    return std::nullopt;
+  }
+
+  // The options that don't change the results aren't part of the key.
+  planpb::Plan normalized = plan;
+  auto* source_pb = MutableMemorySource(&normalized);
+  source_pb->clear_start_time();
+  source_pb->clear_stop_time();
+  auto* options = normalized.mutable_plan_options();
+  options->clear_explain();
+  options->clear_analyze();
+  options->clear_exec_parallelism();
+  options->clear_grpc_row_batch_encoding();
+
+  CacheablePlan cacheable_plan{"", start_time, stop_time, source->name(), source->tablet()};
+  {
+    google::protobuf::io::StringOutputStream string_stream(&cacheable_plan.key);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    normalized.SerializeToCodedStream(&coded_stream);
+  }
+  return cacheable_plan;
+}
+
+std::vector<PlanResultCache::Segment> PlanResultCache::SplitWindow(int64_t start_time,
+                                                                   int64_t stop_time,
+                                                                   int64_t min_bucket_ns,
+                                                                   int64_t settled_time) {
+  int64_t bucket_ns = std::max<int64_t>(1, min_bucket_ns);
+  while ((stop_time - start_time + 1) / bucket_ns > kMaxBucketsPerWindow) {
+    bucket_ns *= 2;
+  }
+
+  std::vector<Segment> segments;
+  for (int64_t bucket_start = start_time - start_time % bucket_ns; bucket_start <= stop_time;
+       bucket_start += bucket_ns) {
+    int64_t bucket_stop = bucket_start + bucket_ns - 1;
+    bool cacheable =
+        bucket_start >= start_time && bucket_stop <= stop_time && bucket_stop < settled_time;
+    int64_t segment_start = std::max(start_time, bucket_start);
+    int64_t segment_stop = std::min(stop_time, bucket_stop);
+    if (!cacheable && !segments.empty() && !segments.back().cacheable) {
+      segments.back().stop_time = segment_stop;
+      continue;
+    }
+    segments.push_back({segment_start, segment_stop, cacheable});
+  }
+  return segments;
+}
+
+bool PlanResultCache::TableHoldsSegment(const table_store::Table& table, const Segment& segment) {
+  return table.FindRowIDFromTimeFirstGreaterThanOrEqual(segment.start_time) > table.FirstRowID();
+}
+
+planpb::Plan PlanResultCache::WithTimeRange(const planpb::Plan& plan, int64_t start_time,
+                                            int64_t stop_time) {
+  planpb::Plan segment_plan = plan;
+  auto* source = MutableMemorySource(&segment_plan);
+  DCHECK(source != nullptr);
+  source->mutable_start_time()->set_value(start_time);
+  source->mutable_stop_time()->set_value(stop_time);
+  return segment_plan;
+}
+
+bool PlanResultCache::RecordExecution(const std::string& key, absl::Time now) {
+  absl::MutexLock lock(&lock_);
+  if (executions_.size() >= kMaxTrackedPlans) {
+    for (auto it = executions_.begin(); it != executions_.end();) {
+      if (now - it->second > ttl_) {
+        executions_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+  auto [it, inserted] = executions_.try_emplace(key, now);
+  bool executed_before = !inserted && now - it->second <= ttl_;
+  it->second = now;
+  return executed_before;
+}
+
+std::shared_ptr<const PlanResultCache::SinkResults> PlanResultCache::Get(const std::string& key,
+                                                                         const Segment& segment,
+                                                                         absl::Time now) {
+  absl::MutexLock lock(&lock_);
+  auto it = entries_.find(EntryKey{key, segment.start_time, segment.stop_time});
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  if (now >= it->second.expiry) {
+    Erase(it->first);
+    ++misses_;
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  ++hits_;
+  return it->second.results;
+}
+
+void PlanResultCache::Put(const std::string& key, const Segment& segment, SinkResults results,
+                          absl::Time now) {
+  int64_t bytes = 0;
+  for (const auto& [sink_id, row_batches] : results) {
+    for (const auto& rb : row_batches) {
+      bytes += rb.NumBytes();
+    }
+  }
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  absl::MutexLock lock(&lock_);
+  EntryKey entry_key{key, segment.start_time, segment.stop_time};
+  if (entries_.contains(entry_key)) {
+    Erase(entry_key);
+  }
+  lru_.push_front(entry_key);
+  entries_[entry_key] = Entry{std::make_shared<const SinkResults>(std::move(results)), bytes,
+                              now + ttl_, lru_.begin()};
+  bytes_ += bytes;
+  while (bytes_ > max_bytes_ ||
+         (lru_.size() > 1 && entries_.find(lru_.back())->second.expiry <= now)) {
+    Erase(lru_.back());
+  }
+}
+
+void PlanResultCache::Erase(const EntryKey& key) {
+  // The key can belong to lru_, so it's not used after the entry is removed from lru_.
+  auto it = entries_.find(key);
+  DCHECK(it != entries_.end());
+  bytes_ -= it->second.bytes;
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
+
+int64_t PlanResultCache::bytes() const {
+  absl::MutexLock lock(&lock_);
+  return bytes_;
+}
+
+int64_t PlanResultCache::num_entries() const {
+  absl::MutexLock lock(&lock_);
+  return entries_.size();
+}
+
+int64_t PlanResultCache::hits() const {
+  absl::MutexLock lock(&lock_);
+  return hits_;
+}
+
+int64_t PlanResultCache::misses() const {
+  absl::MutexLock lock(&lock_);
+  return misses_;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
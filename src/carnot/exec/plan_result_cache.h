@@ -0,0 +1,177 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/time/time.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/table/table.h"
+
+DECLARE_int64(carnot_result_cache_max_bytes);
+DECLARE_int64(carnot_result_cache_ttl_seconds);
+DECLARE_int64(carnot_result_cache_bucket_ns);
+DECLARE_int64(carnot_result_cache_settle_seconds);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * PlanResultCache caches the results of plans that are executed repeatedly over sliding time
+ * windows, e.g. the scripts of dashboards that refresh every few seconds.
+ *
+ * A plan is cacheable if its results over a time window can be assembled from its results over the
+ * parts of the window: a single plan fragment that reads one MemorySource over a bounded time
+ * range, whose sinks consume either the rows of the source, through maps and filters, or the state
+ * of a partial aggregate that is merged downstream. The window of such a plan is split into time
+ * buckets that are aligned to multiples of the bucket size, and the row batches that reach the
+ * sinks of the plan for each full bucket are cached. A later query with the same plan only
+ * executes the buckets that aren't cached, as well as the partial buckets at the edges of its
+ * window, and its sinks consume the results of every bucket in time order. Plans that call UDFs
+ * which aren't deterministic, such as the metadata UDFs, aren't cacheable.
+ *
+ * Buckets are only cached once they end carnot_result_cache_settle_seconds before the query, since
+ * rows that are written to the table later than that are missing from the cached results until
+ * they expire. Cached results are keyed by the plan without the time range of its source, and the
+ * time range of the bucket. Entries expire after a TTL, and the least recently used entries are
+ * evicted over the byte limit. A cached bucket is also not used once the table may have expired
+ * some of its rows. Row batches that are passed through from the table share its buffers, and are
+ * accounted at their size.
+ *
+ * The cache is disabled by default, since results can be stale by up to the TTL.
+ */
+class PlanResultCache {
+ public:
+  // The row batches consumed by each sink of a plan fragment, by the ID of the sink.
+  using SinkResults = absl::flat_hash_map<int64_t, std::vector<table_store::schema::RowBatch>>;
+
+  // Windows are split into at most this many full buckets, by doubling the bucket size.
+  static constexpr int64_t kMaxBucketsPerWindow = 16;
+
+  struct CacheablePlan {
+    // The plan, without the time range of its source.
+    std::string key;
+    int64_t start_time;
+    int64_t stop_time;
+    // The table that the source reads.
+    std::string table_name;
+    types::TabletID tablet;
+  };
+
+  /**
+   * A part of the time window of a plan that is executed on its own. Times are inclusive, like the
+   * time range of a MemorySource.
+   */
+  struct Segment {
+    int64_t start_time;
+    int64_t stop_time;
+    // Whether the segment is a full bucket whose results can be cached.
+    bool cacheable;
+  };
+
+  /**
+   * @return the key and time window of the plan, or nullopt if its results can't be cached.
+   * @param registry the registry that the scalar functions of the plan are looked up in.
+   */
+  static std::optional<CacheablePlan> GetCacheablePlan(const planpb::Plan& plan,
+                                                       const udf::Registry& registry);
+
+  /**
+   * @return whether the table still holds all of the rows of the segment. Rows are expired oldest
+   * first, so this is the case if the table holds a row that is older than the segment.
+   */
+  static bool TableHoldsSegment(const table_store::Table& table, const Segment& segment);
+
+  /**
+   * Splits the window [start_time, stop_time] into segments. Full buckets that end before
+   * settled_time are cacheable, and consecutive segments that aren't are merged.
+   */
+  static std::vector<Segment> SplitWindow(int64_t start_time, int64_t stop_time,
+                                          int64_t min_bucket_ns, int64_t settled_time);
+
+  /**
+   * @return a copy of the plan whose source reads the given time range.
+   */
+  static planpb::Plan WithTimeRange(const planpb::Plan& plan, int64_t start_time,
+                                    int64_t stop_time);
+
+  PlanResultCache(int64_t max_bytes, absl::Duration ttl) : max_bytes_(max_bytes), ttl_(ttl) {}
+
+  /**
+   * Records that a plan is executed. Plans are only split into buckets once they are executed again
+   * within the TTL, so that one-off queries don't pay for executing each bucket separately.
+   * @return whether the plan was executed before, within the TTL.
+   */
+  bool RecordExecution(const std::string& key, absl::Time now);
+
+  /**
+   * @return the results of the plan for the given segment, or nullptr if they aren't cached.
+   */
+  std::shared_ptr<const SinkResults> Get(const std::string& key, const Segment& segment,
+                                         absl::Time now);
+  void Put(const std::string& key, const Segment& segment, SinkResults results, absl::Time now);
+
+  int64_t bytes() const;
+  int64_t num_entries() const;
+  int64_t hits() const;
+  int64_t misses() const;
+
+ private:
+  using EntryKey = std::tuple<std::string, int64_t, int64_t>;
+  struct Entry {
+    std::shared_ptr<const SinkResults> results;
+    int64_t bytes;
+    absl::Time expiry;
+    // The position of the entry in lru_.
+    std::list<EntryKey>::iterator lru_it;
+  };
+
+  void Erase(const EntryKey& key) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const int64_t max_bytes_;
+  const absl::Duration ttl_;
+
+  mutable absl::Mutex lock_;
+  absl::flat_hash_map<EntryKey, Entry> entries_ ABSL_GUARDED_BY(lock_);
+  // The keys of the entries, from the most to the least recently used.
+  std::list<EntryKey> lru_ ABSL_GUARDED_BY(lock_);
+  // The time that each plan was last executed.
+  absl::flat_hash_map<std::string, absl::Time> executions_ ABSL_GUARDED_BY(lock_);
+  int64_t bytes_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t hits_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t misses_ ABSL_GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
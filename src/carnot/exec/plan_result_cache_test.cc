@@ -0,0 +1,286 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/plan_result_cache.h"
+
+#include <google/protobuf/text_format.h>
+
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/udf/registry.h"
+#include "src/carnot/udf/udf.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using google::protobuf::TextFormat;
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using udf::FunctionContext;
+
+class ScaleUDF : public udf::ScalarUDF {
+ public:
+  types::Float64Value Exec(FunctionContext*, types::Float64Value v) { return v.val * 2; }
+};
+
+class NowUDF : public udf::ScalarUDF {
+ public:
+  types::Float64Value Exec(FunctionContext*, types::Float64Value v) {
+    return v.val + absl::ToUnixSeconds(absl::Now());
+  }
+  static constexpr bool Deterministic() { return false; }
+};
+
+namespace {
+
+constexpr char kPlanTmpl[] = R"(
+nodes {
+  id: 1
+  dag {
+    nodes { id: 1 sorted_children: 2 }
+    nodes { id: 2 sorted_parents: 1 }
+  }
+  nodes {
+    id: 1
+    op {
+      op_type: MEMORY_SOURCE_OPERATOR
+      mem_source_op {
+        name: "cpu"
+        start_time { value: $0 }
+        stop_time { value: $1 }
+        column_idxs: 1
+        column_types: FLOAT64
+        column_names: "usage"
+      }
+    }
+  }
+  nodes {
+    id: 2
+    op {
+      op_type: $2
+      $3
+    }
+  }
+}
+)";
+
+constexpr char kMemSinkOp[] = R"(mem_sink_op { name: "out" })";
+
+constexpr char kMapOpTmpl[] = R"(
+map_op {
+  expressions {
+    func {
+      name: "$0"
+      args { column { node: 1 index: 0 } }
+      args_data_types: FLOAT64
+    }
+  }
+  column_names: "usage"
+})";
+
+planpb::Plan MakePlan(int64_t start_time, int64_t stop_time, std::string op_type = "",
+                      std::string op = kMemSinkOp) {
+  if (op_type.empty()) {
+    op_type = "MEMORY_SINK_OPERATOR";
+  }
+  planpb::Plan plan;
+  CHECK(TextFormat::MergeFromString(
+      absl::Substitute(kPlanTmpl, start_time, stop_time, op_type, op), &plan));
+  return plan;
+}
+
+PlanResultCache::SinkResults MakeResults(int64_t num_rows) {
+  PlanResultCache::SinkResults results;
+  auto rb = RowBatchBuilder(RowDescriptor({types::DataType::INT64}), num_rows, /*eow*/ true,
+                            /*eos*/ true)
+                .AddColumn<types::Int64Value>(std::vector<types::Int64Value>(num_rows, 1))
+                .get();
+  results[2].push_back(rb);
+  return results;
+}
+
+class PlanResultCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    registry_ = std::make_unique<udf::Registry>("test_registry");
+    EXPECT_OK(registry_->Register<ScaleUDF>("scale"));
+    EXPECT_OK(registry_->Register<NowUDF>("now"));
+  }
+
+  std::optional<PlanResultCache::CacheablePlan> GetCacheablePlan(const planpb::Plan& plan) {
+    return PlanResultCache::GetCacheablePlan(plan, *registry_);
+  }
+
+  std::unique_ptr<udf::Registry> registry_;
+};
+
+}  // namespace
+
+TEST_F(PlanResultCacheTest, key_ignores_time_range) {
+  auto plan1 = GetCacheablePlan(MakePlan(10, 20));
+  auto plan2 = GetCacheablePlan(MakePlan(15, 30));
+  ASSERT_TRUE(plan1.has_value());
+  ASSERT_TRUE(plan2.has_value());
+  EXPECT_EQ(plan1->key, plan2->key);
+  EXPECT_EQ(10, plan1->start_time);
+  EXPECT_EQ(20, plan1->stop_time);
+  EXPECT_EQ("cpu", plan1->table_name);
+
+  auto with_range = PlanResultCache::WithTimeRange(MakePlan(10, 20), 15, 30);
+  const auto& source = with_range.nodes(0).nodes(0).op().mem_source_op();
+  EXPECT_EQ(15, source.start_time().value());
+  EXPECT_EQ(30, source.stop_time().value());
+}
+
+TEST_F(PlanResultCacheTest, rejects_plans_that_cant_be_split) {
+  // A finalized aggregate can't be assembled from the results of the buckets.
+  EXPECT_FALSE(
+      GetCacheablePlan(MakePlan(10, 20, "AGGREGATE_OPERATOR", "agg_op { finalize_results: true }"))
+          .has_value());
+  // Neither can a limit.
+  EXPECT_FALSE(
+      GetCacheablePlan(MakePlan(10, 20, "LIMIT_OPERATOR", "limit_op { limit: 10 }")).has_value());
+  EXPECT_TRUE(
+      GetCacheablePlan(MakePlan(10, 20, "AGGREGATE_OPERATOR", "agg_op { partial_agg: true }"))
+          .has_value());
+
+  auto unbounded = MakePlan(10, 20);
+  unbounded.mutable_nodes(0)->mutable_nodes(0)->mutable_op()->mutable_mem_source_op()
+      ->clear_stop_time();
+  EXPECT_FALSE(GetCacheablePlan(unbounded).has_value());
+}
+
+TEST_F(PlanResultCacheTest, rejects_non_deterministic_udfs) {
+  EXPECT_TRUE(GetCacheablePlan(
+                  MakePlan(10, 20, "MAP_OPERATOR", absl::Substitute(kMapOpTmpl, "scale")))
+                  .has_value());
+  EXPECT_FALSE(
+      GetCacheablePlan(MakePlan(10, 20, "MAP_OPERATOR", absl::Substitute(kMapOpTmpl, "now")))
+          .has_value());
+  // Functions that aren't in the registry aren't known to be deterministic.
+  EXPECT_FALSE(
+      GetCacheablePlan(MakePlan(10, 20, "MAP_OPERATOR", absl::Substitute(kMapOpTmpl, "missing")))
+          .has_value());
+}
+
+TEST(PlanResultCacheTableTest, table_holds_segment) {
+  table_store::schema::Relation rel({types::DataType::TIME64NS}, {"time_"});
+  auto table = table_store::Table::Create("cpu", rel);
+  auto rb = RowBatchBuilder(RowDescriptor(rel.col_types()), 3, /*eow*/ false, /*eos*/ false)
+                .AddColumn<types::Time64NSValue>({10, 20, 30})
+                .get();
+  EXPECT_OK(table->WriteRowBatch(rb));
+
+  EXPECT_TRUE(PlanResultCache::TableHoldsSegment(*table, {15, 24, true}));
+  EXPECT_TRUE(PlanResultCache::TableHoldsSegment(*table, {11, 20, true}));
+  // The table may have expired the rows of segments that start at or before its oldest row.
+  EXPECT_FALSE(PlanResultCache::TableHoldsSegment(*table, {10, 19, true}));
+  EXPECT_FALSE(PlanResultCache::TableHoldsSegment(*table, {0, 9, true}));
+}
+
+TEST(PlanResultCacheTest, split_window) {
+  // Buckets of size 10: a partial bucket at each edge, and the last full bucket isn't settled.
+  auto segments = PlanResultCache::SplitWindow(5, 44, 10, /*settled_time*/ 35);
+  ASSERT_EQ(4, segments.size());
+  EXPECT_EQ(5, segments[0].start_time);
+  EXPECT_EQ(9, segments[0].stop_time);
+  EXPECT_FALSE(segments[0].cacheable);
+  EXPECT_EQ(10, segments[1].start_time);
+  EXPECT_EQ(19, segments[1].stop_time);
+  EXPECT_TRUE(segments[1].cacheable);
+  EXPECT_EQ(20, segments[2].start_time);
+  EXPECT_EQ(29, segments[2].stop_time);
+  EXPECT_TRUE(segments[2].cacheable);
+  EXPECT_EQ(30, segments[3].start_time);
+  EXPECT_EQ(44, segments[3].stop_time);
+  EXPECT_FALSE(segments[3].cacheable);
+
+  // Long windows use larger buckets.
+  segments = PlanResultCache::SplitWindow(0, 999, 10, /*settled_time*/ 1000);
+  EXPECT_LE(segments.size(), PlanResultCache::kMaxBucketsPerWindow);
+  EXPECT_EQ(0, segments.front().start_time);
+  EXPECT_EQ(999, segments.back().stop_time);
+  for (size_t i = 1; i < segments.size(); ++i) {
+    EXPECT_EQ(segments[i - 1].stop_time + 1, segments[i].start_time);
+  }
+}
+
+TEST(PlanResultCacheTest, get_put) {
+  PlanResultCache cache(/*max_bytes*/ 1024 * 1024, absl::Seconds(60));
+  auto now = absl::Now();
+  PlanResultCache::Segment segment{10, 19, true};
+  EXPECT_EQ(nullptr, cache.Get("plan", segment, now));
+
+  cache.Put("plan", segment, MakeResults(10), now);
+  auto results = cache.Get("plan", segment, now);
+  ASSERT_NE(nullptr, results);
+  ASSERT_EQ(1, results->at(2).size());
+  EXPECT_EQ(10, results->at(2)[0].num_rows());
+  EXPECT_EQ(nullptr, cache.Get("other_plan", segment, now));
+  EXPECT_EQ(nullptr, cache.Get("plan", PlanResultCache::Segment{20, 29, true}, now));
+  EXPECT_EQ(1, cache.hits());
+  EXPECT_EQ(3, cache.misses());
+
+  // Entries expire after the TTL.
+  EXPECT_EQ(nullptr, cache.Get("plan", segment, now + absl::Seconds(61)));
+  EXPECT_EQ(0, cache.num_entries());
+  EXPECT_EQ(0, cache.bytes());
+}
+
+TEST(PlanResultCacheTest, evicts_least_recently_used) {
+  auto entry_bytes = [] {
+    PlanResultCache cache(1024 * 1024, absl::Seconds(60));
+    cache.Put("plan", {0, 9, true}, MakeResults(100), absl::Now());
+    return cache.bytes();
+  }();
+  PlanResultCache cache(2 * entry_bytes, absl::Seconds(60));
+  auto now = absl::Now();
+  cache.Put("plan", {0, 9, true}, MakeResults(100), now);
+  cache.Put("plan", {10, 19, true}, MakeResults(100), now);
+  EXPECT_NE(nullptr, cache.Get("plan", {0, 9, true}, now));
+  cache.Put("plan", {20, 29, true}, MakeResults(100), now);
+
+  EXPECT_EQ(2, cache.num_entries());
+  EXPECT_NE(nullptr, cache.Get("plan", {0, 9, true}, now));
+  EXPECT_EQ(nullptr, cache.Get("plan", {10, 19, true}, now));
+  EXPECT_NE(nullptr, cache.Get("plan", {20, 29, true}, now));
+
+  // Results over the limit aren't cached.
+  cache.Put("plan", {30, 39, true}, MakeResults(1000), now);
+  EXPECT_EQ(nullptr, cache.Get("plan", {30, 39, true}, now));
+}
+
+TEST(PlanResultCacheTest, record_execution) {
+  PlanResultCache cache(1024 * 1024, absl::Seconds(60));
+  auto now = absl::Now();
+  EXPECT_FALSE(cache.RecordExecution("plan", now));
+  EXPECT_TRUE(cache.RecordExecution("plan", now + absl::Seconds(5)));
+  EXPECT_FALSE(cache.RecordExecution("plan", now + absl::Seconds(100)));
+  EXPECT_FALSE(cache.RecordExecution("other_plan", now));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,480 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/rollup_table.h"
+
+#include <arrow/array.h>
+#include <arrow/array/builder_base.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <absl/strings/match.h>
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+#include <absl/strings/strip.h>
+#include <absl/time/time.h>
+
+#include "src/carnot/udf/udf_wrapper.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::Relation;
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+namespace {
+
+constexpr char kTimeColName[] = "time_";
+constexpr char kPartialColSuffix[] = "_partial";
+
+template <types::DataType DT>
+void AppendToBuilder(arrow::ArrayBuilder* builder, const RowTuple& rt, size_t rt_idx) {
+  using ArrowBuilder = typename types::DataTypeTraits<DT>::arrow_builder_type;
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  auto status =
+      static_cast<ArrowBuilder*>(builder)->Append(udf::UnWrap(rt.GetValue<ValueType>(rt_idx)));
+  PL_DCHECK_OK(status);
+  PL_UNUSED(status);
+}
+
+int64_t BucketStart(int64_t time, int64_t bucket_size) {
+  int64_t rem = time % bucket_size;
+  // Round towards negative infinity, so that negative times land in the right bucket.
+  return rem < 0 ? time - rem - bucket_size : time - rem;
+}
+
+}  // namespace
+
+StatusOr<std::shared_ptr<RollupTable>> RollupTable::Create(const RollupSpec& spec,
+                                                           table_store::TableStore* table_store,
+                                                           const udf::Registry* registry) {
+  if (spec.bucket_size.count() <= 0) {
+    return error::InvalidArgument("Rollup $0 must have a positive bucket size",
+                                  spec.rollup_table);
+  }
+  if (spec.aggregates.empty()) {
+    return error::InvalidArgument("Rollup $0 must have at least one aggregate", spec.rollup_table);
+  }
+  auto* source = table_store->GetTable(spec.source_table);
+  if (source == nullptr) {
+    return error::NotFound("Source table $0 of rollup $1 does not exist", spec.source_table,
+                           spec.rollup_table);
+  }
+  if (table_store->GetTable(spec.rollup_table) != nullptr) {
+    return error::AlreadyExists("Table $0 already exists", spec.rollup_table);
+  }
+
+  auto source_rel = source->GetRelation();
+  if (!source_rel.HasColumn(kTimeColName) ||
+      source_rel.GetColumnType(kTimeColName) != types::DataType::TIME64NS) {
+    return error::InvalidArgument("Source table $0 of rollup $1 must have a TIME64NS $2 column",
+                                  spec.source_table, spec.rollup_table, kTimeColName);
+  }
+
+  Relation relation;
+  relation.AddColumn(types::DataType::TIME64NS, kTimeColName);
+  std::vector<int64_t> group_col_idxs;
+  for (const auto& col : spec.group_by) {
+    if (!source_rel.HasColumn(col) || relation.HasColumn(col)) {
+      return error::InvalidArgument("Invalid group by column $0 in rollup $1", col,
+                                    spec.rollup_table);
+    }
+    group_col_idxs.push_back(source_rel.GetColumnIndex(col));
+    relation.AddColumn(source_rel.GetColumnType(col), col);
+  }
+
+  std::vector<AggregateInfo> aggregates;
+  for (const auto& agg : spec.aggregates) {
+    if (relation.HasColumn(agg.output_name)) {
+      return error::InvalidArgument("Duplicate column $0 in rollup $1", agg.output_name,
+                                    spec.rollup_table);
+    }
+    AggregateInfo info;
+    std::vector<types::DataType> arg_types;
+    for (const auto& arg : agg.args) {
+      if (!source_rel.HasColumn(arg)) {
+        return error::InvalidArgument("Argument $0 of $1 in rollup $2 does not exist", arg,
+                                      agg.uda_name, spec.rollup_table);
+      }
+      info.arg_col_idxs.push_back(source_rel.GetColumnIndex(arg));
+      arg_types.push_back(source_rel.GetColumnType(arg));
+    }
+    PL_ASSIGN_OR_RETURN(info.def, registry->GetUDADefinition(agg.uda_name, arg_types));
+    if (!info.def->init_arguments().empty()) {
+      return error::InvalidArgument("UDA $0 with init arguments can't be used in rollup $1",
+                                    agg.uda_name, spec.rollup_table);
+    }
+    if (spec.store_partials && !info.def->supports_partial()) {
+      return error::InvalidArgument(
+          "UDA $0 doesn't support partial aggregation, so rollup $1 can't store its partial state",
+          agg.uda_name, spec.rollup_table);
+    }
+    relation.AddColumn(info.def->finalize_return_type(), agg.output_name);
+    aggregates.push_back(std::move(info));
+  }
+  if (spec.store_partials) {
+    for (const auto& agg : spec.aggregates) {
+      auto col = absl::StrCat(agg.output_name, kPartialColSuffix);
+      if (relation.HasColumn(col)) {
+        return error::InvalidArgument("Duplicate column $0 in rollup $1", col, spec.rollup_table);
+      }
+      relation.AddColumn(types::DataType::STRING, col);
+    }
+  }
+
+  auto rollup = std::shared_ptr<RollupTable>(new RollupTable(
+      spec, std::move(relation), source_rel.GetColumnIndex(kTimeColName),
+      std::move(group_col_idxs), std::move(aggregates), /*merge_partials*/ false));
+  table_store->AddTable(rollup->table_, spec.rollup_table);
+  source->AddCompactionObserver(rollup);
+  return rollup;
+}
+
+StatusOr<std::shared_ptr<RollupTable>> RollupTable::CreateCoarser(
+    const RollupSpec& spec, table_store::TableStore* table_store) const {
+  if (!store_partials_) {
+    return error::InvalidArgument(
+        "Rollup $0 doesn't store partial states, so it can't be rolled up into $1", name_,
+        spec.rollup_table);
+  }
+  if (spec.source_table != name_) {
+    return error::InvalidArgument("Rollup $0 doesn't roll up $1", spec.rollup_table, name_);
+  }
+  if (!spec.group_by.empty() || !spec.aggregates.empty()) {
+    return error::InvalidArgument(
+        "Rollup $0 of rollup $1 must not have its own group by columns or aggregates",
+        spec.rollup_table, name_);
+  }
+  if (spec.bucket_size.count() <= 0 || spec.bucket_size.count() % bucket_size_ns_ != 0) {
+    return error::InvalidArgument(
+        "The bucket size of rollup $0 must be a multiple of the bucket size of rollup $1",
+        spec.rollup_table, name_);
+  }
+  if (table_store->GetTable(spec.rollup_table) != nullptr) {
+    return error::AlreadyExists("Table $0 already exists", spec.rollup_table);
+  }
+
+  // This rollup's relation is (time_, <group_by columns>, <aggregate columns>, <partial columns>),
+  // which is also the relation of the coarser rollup.
+  std::vector<int64_t> group_col_idxs(group_col_idxs_.size());
+  std::iota(group_col_idxs.begin(), group_col_idxs.end(), 1);
+  int64_t first_partial_col = 1 + group_col_idxs_.size() + aggregates_.size();
+  std::vector<AggregateInfo> aggregates;
+  for (const auto& [i, agg] : Enumerate(aggregates_)) {
+    aggregates.push_back({agg.def, {first_partial_col + static_cast<int64_t>(i)}});
+  }
+  auto coarser_spec = spec;
+  coarser_spec.store_partials = true;
+  auto rollup = std::shared_ptr<RollupTable>(
+      new RollupTable(coarser_spec, relation_, /*time_col_idx*/ 0, std::move(group_col_idxs),
+                      std::move(aggregates), /*merge_partials*/ true));
+  table_store->AddTable(rollup->table_, spec.rollup_table);
+  table_->AddCompactionObserver(rollup);
+  return rollup;
+}
+
+RollupTable::RollupTable(const RollupSpec& spec, Relation relation, int64_t time_col_idx,
+                         std::vector<int64_t> group_col_idxs,
+                         std::vector<AggregateInfo> aggregates, bool merge_partials)
+    : name_(spec.rollup_table),
+      bucket_size_ns_(spec.bucket_size.count()),
+      allowed_lateness_ns_(spec.allowed_lateness.count()),
+      relation_(std::move(relation)),
+      time_col_idx_(time_col_idx),
+      group_col_idxs_(std::move(group_col_idxs)),
+      aggregates_(std::move(aggregates)),
+      store_partials_(spec.store_partials),
+      merge_partials_(merge_partials) {
+  // The group columns follow time_ in the rollup's relation.
+  for (size_t i = 0; i < group_col_idxs_.size(); ++i) {
+    group_data_types_.push_back(relation_.GetColumnType(i + 1));
+  }
+  if (!merge_partials_) {
+    for (const auto& agg : aggregates_) {
+      arg_data_types_.insert(arg_data_types_.end(), agg.def->update_arguments().begin(),
+                             agg.def->update_arguments().end());
+    }
+  }
+  table_ = std::make_shared<table_store::Table>(spec.rollup_table, relation_, spec.max_table_size,
+                                                spec.compacted_batch_size);
+  scratch_key_ = std::make_unique<RowTuple>(&group_data_types_);
+}
+
+int64_t RollupTable::num_late_rows() const {
+  absl::MutexLock lock(&lock_);
+  return num_late_rows_;
+}
+
+RollupTable::Group* RollupTable::GetOrCreateGroup(Bucket* bucket) {
+  auto it = bucket->find(scratch_key_.get());
+  if (it != bucket->end()) {
+    return it->second.get();
+  }
+  auto group = std::make_unique<Group>();
+  for (const auto& agg : aggregates_) {
+    group->udas.push_back(agg.def->Make());
+  }
+  for (const auto& dt : arg_data_types_) {
+    group->pending_args.push_back(types::ColumnWrapper::Make(dt, 0));
+  }
+  group->key = std::move(scratch_key_);
+  scratch_key_ = std::make_unique<RowTuple>(&group_data_types_);
+  auto* group_ptr = group.get();
+  bucket->emplace(group_ptr->key.get(), std::move(group));
+  return group_ptr;
+}
+
+Status RollupTable::OnCompactedBatch(const RowBatch& rb) {
+  absl::MutexLock lock(&lock_);
+  auto* time_col = rb.ColumnAt(time_col_idx_).get();
+
+  // Find the group of each row.
+  std::vector<Group*> row_groups(rb.num_rows(), nullptr);
+  for (int64_t row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    int64_t time = types::GetValueFromArrowArray<types::DataType::TIME64NS>(time_col, row_idx);
+    int64_t bucket_start = BucketStart(time, bucket_size_ns_);
+    if (bucket_start < closed_until_) {
+      ++num_late_rows_;
+      continue;
+    }
+    max_time_ = std::max(max_time_, time);
+
+    scratch_key_->Reset();
+    for (const auto& [i, col_idx] : Enumerate(group_col_idxs_)) {
+      auto* col = rb.ColumnAt(col_idx).get();
+#define TYPE_CASE(_dt_) ExtractIntoRowTuple<_dt_>(scratch_key_.get(), col, i, row_idx);
+      PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    row_groups[row_idx] = GetOrCreateGroup(&buckets_[bucket_start]);
+  }
+
+  PL_RETURN_IF_ERROR(merge_partials_ ? MergePartials(rb, row_groups)
+                                     : UpdateGroups(rb, row_groups));
+  return CloseBuckets(max_time_ - allowed_lateness_ns_);
+}
+
+Status RollupTable::UpdateGroups(const RowBatch& rb, const std::vector<Group*>& row_groups) {
+  size_t arg_idx = 0;
+  for (const auto& agg : aggregates_) {
+    for (auto col_idx : agg.arg_col_idxs) {
+      auto* col = rb.ColumnAt(col_idx).get();
+      for (const auto& [row_idx, group] : Enumerate(row_groups)) {
+        if (group == nullptr) {
+          continue;
+        }
+#define TYPE_CASE(_dt_) \
+  types::ExtractValueToColumnWrapper<_dt_>(group->pending_args[arg_idx].get(), col, row_idx);
+        PL_SWITCH_FOREACH_DATATYPE(arg_data_types_[arg_idx], TYPE_CASE);
+#undef TYPE_CASE
+      }
+      ++arg_idx;
+    }
+  }
+
+  absl::flat_hash_set<Group*> updated_groups(row_groups.begin(), row_groups.end());
+  updated_groups.erase(nullptr);
+  for (auto* group : updated_groups) {
+    arg_idx = 0;
+    for (const auto& [i, agg] : Enumerate(aggregates_)) {
+      std::vector<const types::ColumnWrapper*> args;
+      for (size_t j = 0; j < agg.arg_col_idxs.size(); ++j) {
+        args.push_back(group->pending_args[arg_idx++].get());
+      }
+      PL_RETURN_IF_ERROR(agg.def->ExecBatchUpdate(group->udas[i].get(), nullptr /* ctx */, args));
+    }
+    for (auto& col : group->pending_args) {
+      // Clear the values, so we don't aggregate them twice.
+      col->Clear();
+    }
+  }
+  return Status::OK();
+}
+
+Status RollupTable::MergePartials(const RowBatch& rb, const std::vector<Group*>& row_groups) {
+  for (const auto& [i, agg] : Enumerate(aggregates_)) {
+    auto* col = rb.ColumnAt(agg.arg_col_idxs[0]).get();
+    for (const auto& [row_idx, group] : Enumerate(row_groups)) {
+      if (group == nullptr) {
+        continue;
+      }
+      auto partial = agg.def->Make();
+      PL_RETURN_IF_ERROR(agg.def->Deserialize(
+          partial.get(), nullptr /* ctx */,
+          types::GetValueFromArrowArray<types::DataType::STRING>(col, row_idx)));
+      PL_RETURN_IF_ERROR(agg.def->Merge(group->udas[i].get(), partial.get(), nullptr /* ctx */));
+    }
+  }
+  return Status::OK();
+}
+
+Status RollupTable::Flush() {
+  absl::MutexLock lock(&lock_);
+  if (buckets_.empty()) {
+    return Status::OK();
+  }
+  return CloseBuckets(buckets_.rbegin()->first + bucket_size_ns_);
+}
+
+Status RollupTable::CloseBuckets(int64_t end_time) {
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders;
+  for (const auto& dt : relation_.col_types()) {
+    builders.push_back(types::MakeArrowBuilder(dt, arrow::default_memory_pool()));
+  }
+  auto* time_builder = static_cast<arrow::Time64Builder*>(builders[0].get());
+
+  int64_t num_rows = 0;
+  while (!buckets_.empty() && buckets_.begin()->first + bucket_size_ns_ <= end_time) {
+    auto bucket_node = buckets_.extract(buckets_.begin());
+    for (const auto& [key, group] : bucket_node.mapped()) {
+      PL_RETURN_IF_ERROR(time_builder->Append(bucket_node.key()));
+      for (const auto& [i, dt] : Enumerate(group_data_types_)) {
+#define TYPE_CASE(_dt_) AppendToBuilder<_dt_>(builders[i + 1].get(), *key, i);
+        PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
+#undef TYPE_CASE
+      }
+      size_t first_agg_col = 1 + group_data_types_.size();
+      for (const auto& [i, agg] : Enumerate(aggregates_)) {
+        // The partial state is serialized before the UDA is finalized.
+        if (store_partials_) {
+          PL_RETURN_IF_ERROR(agg.def->SerializeArrow(
+              group->udas[i].get(), nullptr /* ctx */,
+              builders[first_agg_col + aggregates_.size() + i].get()));
+        }
+        PL_RETURN_IF_ERROR(agg.def->FinalizeArrow(group->udas[i].get(), nullptr /* ctx */,
+                                                  builders[first_agg_col + i].get()));
+      }
+      ++num_rows;
+    }
+  }
+  closed_until_ = std::max(closed_until_, BucketStart(end_time, bucket_size_ns_));
+
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+  RowBatch rb(RowDescriptor(relation_.col_types()), num_rows);
+  for (const auto& builder : builders) {
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(rb.AddColumn(arr));
+  }
+  return table_->WriteRowBatch(rb);
+}
+
+namespace {
+
+StatusOr<std::chrono::nanoseconds> ParseRollupDuration(std::string_view text) {
+  absl::Duration duration;
+  if (!absl::ParseDuration(text, &duration) || duration < absl::ZeroDuration()) {
+    return error::InvalidArgument("Invalid rollup duration '$0'", text);
+  }
+  return absl::ToChronoNanoseconds(duration);
+}
+
+// Parses aggregates of the form <output_name>=<uda>(<arg>,...), separated by commas.
+StatusOr<std::vector<RollupSpec::Aggregate>> ParseRollupAggregates(std::string_view text) {
+  if (!absl::EndsWith(text, ")")) {
+    return error::InvalidArgument("Invalid rollup aggregates '$0'", text);
+  }
+  std::vector<RollupSpec::Aggregate> aggregates;
+  for (std::string_view agg : absl::StrSplit(text, ')', absl::SkipEmpty())) {
+    absl::ConsumePrefix(&agg, ",");
+    std::vector<std::string_view> parts = absl::StrSplit(agg, absl::MaxSplits('=', 1));
+    if (parts.size() != 2 || parts[0].empty()) {
+      return error::InvalidArgument("Invalid rollup aggregate '$0'", agg);
+    }
+    std::vector<std::string_view> call = absl::StrSplit(parts[1], absl::MaxSplits('(', 1));
+    if (call.size() != 2 || call[0].empty()) {
+      return error::InvalidArgument("Invalid rollup aggregate '$0'", agg);
+    }
+    std::vector<std::string> args = absl::StrSplit(call[1], ',', absl::SkipEmpty());
+    aggregates.push_back({std::string(call[0]), std::move(args), std::string(parts[0])});
+  }
+  return aggregates;
+}
+
+}  // namespace
+
+StatusOr<std::vector<RollupSpec>> ParseRollupSpecs(std::string_view text, int64_t max_table_size) {
+  std::vector<RollupSpec> specs;
+  absl::flat_hash_map<std::string, size_t> spec_idxs;
+  for (std::string_view spec_text : absl::StrSplit(text, ';', absl::SkipWhitespace())) {
+    std::vector<std::string_view> fields =
+        absl::StrSplit(absl::StripAsciiWhitespace(spec_text), ':');
+    if (fields.size() != 4 && fields.size() != 6) {
+      return error::InvalidArgument("Invalid rollup spec '$0'", spec_text);
+    }
+    RollupSpec spec;
+    spec.rollup_table = std::string(fields[0]);
+    spec.source_table = std::string(fields[1]);
+    PL_ASSIGN_OR_RETURN(spec.bucket_size, ParseRollupDuration(fields[2]));
+    PL_ASSIGN_OR_RETURN(spec.allowed_lateness, ParseRollupDuration(fields[3]));
+    spec.max_table_size = max_table_size;
+    if (fields.size() == 6) {
+      std::vector<std::string> group_by = absl::StrSplit(fields[4], ',', absl::SkipEmpty());
+      spec.group_by = std::move(group_by);
+      PL_ASSIGN_OR_RETURN(spec.aggregates, ParseRollupAggregates(fields[5]));
+      if (spec.aggregates.empty()) {
+        return error::InvalidArgument("Rollup spec '$0' has no aggregates", spec_text);
+      }
+    } else {
+      // A rollup of an earlier rollup, which has to store its partial states to be merged.
+      auto it = spec_idxs.find(spec.source_table);
+      if (it == spec_idxs.end()) {
+        return error::InvalidArgument("Rollup $0 rolls up $1, which is not an earlier rollup",
+                                      spec.rollup_table, spec.source_table);
+      }
+      specs[it->second].store_partials = true;
+    }
+    spec_idxs[spec.rollup_table] = specs.size();
+    specs.push_back(std::move(spec));
+  }
+  return specs;
+}
+
+StatusOr<std::vector<std::shared_ptr<RollupTable>>> CreateRollupTables(
+    const std::vector<RollupSpec>& specs, table_store::TableStore* table_store,
+    const udf::Registry* registry) {
+  std::vector<std::shared_ptr<RollupTable>> rollups;
+  absl::flat_hash_map<std::string, RollupTable*> rollups_by_name;
+  for (const auto& spec : specs) {
+    std::shared_ptr<RollupTable> rollup;
+    auto it = rollups_by_name.find(spec.source_table);
+    if (spec.aggregates.empty() && it != rollups_by_name.end()) {
+      PL_ASSIGN_OR_RETURN(rollup, it->second->CreateCoarser(spec, table_store));
+    } else {
+      PL_ASSIGN_OR_RETURN(rollup, RollupTable::Create(spec, table_store, registry));
+    }
+    rollups_by_name[spec.rollup_table] = rollup.get();
+    rollups.push_back(std::move(rollup));
+  }
+  return rollups;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <absl/synchronization/mutex.h>
+
+#include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/column_wrapper.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * RollupSpec declares a rollup table: the rows of a source table aggregated per time bucket and
+ * group.
+ */
+struct RollupSpec {
+  struct Aggregate {
+    // The name of the UDA, as registered in the udf::Registry.
+    std::string uda_name;
+    // The source columns passed to the UDA's Update function.
+    std::vector<std::string> args;
+    // The name of the aggregate's column in the rollup table.
+    std::string output_name;
+  };
+
+  // The name of the table to roll up. It must have a TIME64NS "time_" column.
+  std::string source_table;
+  // The name the rollup table is added to the TableStore under.
+  std::string rollup_table;
+  std::chrono::nanoseconds bucket_size;
+  // How far behind the latest compacted time a bucket is kept open for rows that arrive late.
+  std::chrono::nanoseconds allowed_lateness = std::chrono::seconds(0);
+  // The source columns to group by, in addition to the time bucket.
+  std::vector<std::string> group_by;
+  std::vector<Aggregate> aggregates;
+  int64_t max_table_size;
+  int64_t compacted_batch_size = table_store::Table::kDefaultColdBatchMinSize;
+  // Whether to also store the serialized partial state of every aggregate, in a STRING column
+  // named <output_name>_partial, so that the rollup can be rolled up into coarser buckets (see
+  // RollupTable::CreateCoarser). Every UDA must support partial aggregation.
+  bool store_partials = false;
+};
+
+/**
+ * RollupTable incrementally maintains a rollup of a source table. It observes the batches the
+ * source table compacts (see table_store::CompactionObserver), and updates the UDAs of the time
+ * bucket and group of each row. Once the latest compacted time has passed the end of a bucket by
+ * more than the allowed lateness, the bucket is closed: its UDAs are finalized and written as one
+ * row per group to the rollup table, ordered by bucket. Rows that arrive for a bucket that is
+ * already closed are dropped and counted (see `num_late_rows`).
+ *
+ * The rollup table has the relation (time_, <group_by columns>, <aggregate columns>), where time_
+ * is the start of the bucket, followed by the partial state columns if the spec stores them. It is
+ * a regular table, so queries can read it instead of re-aggregating the raw rows, and the source
+ * table can keep less history.
+ */
+class RollupTable : public table_store::CompactionObserver {
+ public:
+  /**
+   * Creates a rollup table for the spec, adds it to the table store, and starts observing the
+   * compactions of the source table.
+   * @param spec the rollup to maintain.
+   * @param table_store the table store of the source table.
+   * @param registry the registry to look up the UDAs in.
+   * @return error if the source table doesn't exist, or the spec doesn't match its relation.
+   */
+  static StatusOr<std::shared_ptr<RollupTable>> Create(const RollupSpec& spec,
+                                                       table_store::TableStore* table_store,
+                                                       const udf::Registry* registry);
+
+  /**
+   * Creates a rollup of this rollup's table into coarser buckets, with the same groups and
+   * aggregates. The UDAs of its buckets are merged from the partial states this rollup stores, and
+   * it stores their partial states as well.
+   * @param spec the coarser rollup. Its source table must be this rollup's table, its bucket size a
+   * multiple of this rollup's, and its group by columns and aggregates empty, since they are taken
+   * from this rollup.
+   * @param table_store the table store of this rollup's table.
+   * @return error if this rollup doesn't store partial states, or the spec is invalid.
+   */
+  StatusOr<std::shared_ptr<RollupTable>> CreateCoarser(const RollupSpec& spec,
+                                                       table_store::TableStore* table_store) const;
+
+  Status OnCompactedBatch(const table_store::schema::RowBatch& rb) override;
+
+  /**
+   * Closes every open bucket, regardless of the allowed lateness.
+   */
+  Status Flush();
+
+  std::shared_ptr<table_store::Table> table() const { return table_; }
+  const table_store::schema::Relation& relation() const { return relation_; }
+  int64_t num_late_rows() const;
+
+ private:
+  struct AggregateInfo {
+    udf::UDADefinition* def;
+    // The source columns of the UDA's arguments, or the column of its partial states if the rollup
+    // merges partial states.
+    std::vector<int64_t> arg_col_idxs;
+  };
+
+  // The running state of one group within a bucket.
+  struct Group {
+    std::unique_ptr<RowTuple> key;
+    std::vector<std::unique_ptr<udf::UDA>> udas;
+    // The arguments of the rows added since the UDAs were last updated, one ColumnWrapper per
+    // argument of every aggregate.
+    std::vector<types::SharedColumnWrapper> pending_args;
+  };
+  using Bucket = AbslRowTupleHashMap<std::unique_ptr<Group>>;
+
+  RollupTable(const RollupSpec& spec, table_store::schema::Relation relation,
+              int64_t time_col_idx, std::vector<int64_t> group_col_idxs,
+              std::vector<AggregateInfo> aggregates, bool merge_partials);
+
+  Group* GetOrCreateGroup(Bucket* bucket) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Adds the arguments of each row to its group, and updates the UDAs of the groups.
+  Status UpdateGroups(const table_store::schema::RowBatch& rb,
+                      const std::vector<Group*>& row_groups) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Merges the partial states of each row into the UDAs of its group.
+  Status MergePartials(const table_store::schema::RowBatch& rb,
+                       const std::vector<Group*>& row_groups) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Status CloseBuckets(int64_t end_time) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const std::string name_;
+  const int64_t bucket_size_ns_;
+  const int64_t allowed_lateness_ns_;
+  const table_store::schema::Relation relation_;
+  const int64_t time_col_idx_;
+  const std::vector<int64_t> group_col_idxs_;
+  std::vector<types::DataType> group_data_types_;
+  std::vector<types::DataType> arg_data_types_;
+  const std::vector<AggregateInfo> aggregates_;
+  const bool store_partials_;
+  // Whether the source rows hold partial states of the UDAs, which are merged instead of updated.
+  const bool merge_partials_;
+  std::shared_ptr<table_store::Table> table_;
+
+  mutable absl::Mutex lock_;
+  // Open buckets by their start time.
+  std::map<int64_t, Bucket> buckets_ ABSL_GUARDED_BY(lock_);
+  // Buckets that start before this time are closed.
+  int64_t closed_until_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t max_time_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t num_late_rows_ ABSL_GUARDED_BY(lock_) = 0;
+  // Scratch key, which is moved into the bucket if its group is new.
+  std::unique_ptr<RowTuple> scratch_key_ ABSL_GUARDED_BY(lock_);
+};
+
+/**
+ * Parses rollup specs from their text form, as used by the PEM's --table_store_rollups flag. Specs
+ * are separated by ';', and each has the form
+ *
+ *   <rollup_table>:<source_table>:<bucket_size>:<allowed_lateness>[:<group_by>:<aggregates>]
+ *
+ * where the sizes are durations such as 10s, group_by is a comma separated list of columns, and
+ * aggregates is a comma separated list of <output_name>=<uda>(<arg>,...). A spec without group by
+ * columns and aggregates rolls up an earlier rollup of the list into coarser buckets, which makes
+ * the earlier rollup store its partial states.
+ *
+ * For example, "http_events_10s:http_events:10s:5s:service:n=count(latency);
+ * http_events_1m:http_events_10s:1m:0s".
+ */
+StatusOr<std::vector<RollupSpec>> ParseRollupSpecs(std::string_view text, int64_t max_table_size);
+
+/**
+ * Creates the rollups of the specs, in order. Specs without aggregates are created with
+ * RollupTable::CreateCoarser from the earlier rollup of their source table.
+ */
+StatusOr<std::vector<std::shared_ptr<RollupTable>>> CreateRollupTables(
+    const std::vector<RollupSpec>& specs, table_store::TableStore* table_store,
+    const udf::Registry* registry);
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/rollup_table.h"
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/funcs/builtins/builtins.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::Relation;
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using ::testing::UnorderedElementsAre;
+
+class SumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg) { sum_ = sum_.val + arg.val; }
+  void Merge(udf::FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+  types::StringValue Serialize(udf::FunctionContext*) { return std::to_string(sum_.val); }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    sum_ = std::stoll(data);
+    return Status::OK();
+  }
+
+ protected:
+  types::Int64Value sum_ = 0;
+};
+
+class CountUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value) { count_ = count_.val + 1; }
+  void Merge(udf::FunctionContext*, const CountUDA& other) {
+    count_ = count_.val + other.count_.val;
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return count_; }
+  types::StringValue Serialize(udf::FunctionContext*) { return std::to_string(count_.val); }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    count_ = std::stoll(data);
+    return Status::OK();
+  }
+
+ protected:
+  types::Int64Value count_ = 0;
+};
+
+using RollupRow = std::tuple<int64_t, std::string, int64_t, int64_t>;
+
+class RollupTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    registry_ = std::make_unique<udf::Registry>("test");
+    EXPECT_OK(registry_->Register<SumUDA>("sum"));
+    EXPECT_OK(registry_->Register<CountUDA>("count"));
+
+    Relation rel({types::DataType::TIME64NS, types::DataType::STRING, types::DataType::INT64},
+                 {"time_", "service", "latency"});
+    // Every row is compacted into a cold batch of its own.
+    source_ = std::make_shared<table_store::Table>("http_events", rel, 1024 * 1024,
+                                                   /*compacted_batch_size*/ 1);
+    table_store_.AddTable(source_, "http_events");
+
+    spec_.source_table = "http_events";
+    spec_.rollup_table = "http_events_10ns";
+    spec_.bucket_size = std::chrono::nanoseconds(10);
+    spec_.group_by = {"service"};
+    spec_.aggregates = {{"sum", {"latency"}, "latency_sum"}, {"count", {"latency"}, "count"}};
+    spec_.max_table_size = 1024 * 1024;
+  }
+
+  void Write(const std::vector<types::Time64NSValue>& times,
+             const std::vector<types::StringValue>& services,
+             const std::vector<types::Int64Value>& latencies) {
+    RowBatch rb(RowDescriptor(source_->GetRelation().col_types()), times.size());
+    PL_CHECK_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    PL_CHECK_OK(rb.AddColumn(types::ToArrow(services, arrow::default_memory_pool())));
+    PL_CHECK_OK(rb.AddColumn(types::ToArrow(latencies, arrow::default_memory_pool())));
+    PL_CHECK_OK(source_->WriteRowBatch(rb));
+    PL_CHECK_OK(source_->CompactHotToCold(arrow::default_memory_pool()));
+  }
+
+  std::vector<RollupRow> ReadRollup(const table_store::Table* table) {
+    std::vector<RollupRow> rows;
+    table_store::Table::Cursor cursor(table);
+    while (!cursor.Done()) {
+      auto rb = cursor.GetNextRowBatch({0, 1, 2, 3}).ConsumeValueOrDie();
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        rows.emplace_back(
+            types::GetValueFromArrowArray<types::DataType::TIME64NS>(rb->ColumnAt(0).get(), i),
+            types::GetValueFromArrowArray<types::DataType::STRING>(rb->ColumnAt(1).get(), i),
+            types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(2).get(), i),
+            types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(3).get(), i));
+      }
+    }
+    return rows;
+  }
+
+  std::unique_ptr<udf::Registry> registry_;
+  table_store::TableStore table_store_;
+  std::shared_ptr<table_store::Table> source_;
+  RollupSpec spec_;
+};
+
+TEST_F(RollupTableTest, closed_buckets_are_written) {
+  ASSERT_OK_AND_ASSIGN(auto rollup, RollupTable::Create(spec_, &table_store_, registry_.get()));
+  EXPECT_EQ(rollup->table().get(), table_store_.GetTable("http_events_10ns"));
+  EXPECT_EQ(std::vector<std::string>({"time_", "service", "latency_sum", "count"}),
+            rollup->relation().col_names());
+
+  Write({1, 2, 5}, {"a", "b", "a"}, {10, 20, 30});
+  // Nothing is written until the first bucket is closed.
+  EXPECT_EQ(0, ReadRollup(rollup->table().get()).size());
+
+  Write({12, 15}, {"a", "a"}, {40, 50});
+  EXPECT_THAT(ReadRollup(rollup->table().get()),
+              UnorderedElementsAre(RollupRow{0, "a", 40, 2}, RollupRow{0, "b", 20, 1}));
+
+  // Rows for a closed bucket are dropped.
+  Write({3, 16}, {"b", "b"}, {100, 60});
+  EXPECT_EQ(1, rollup->num_late_rows());
+
+  ASSERT_OK(rollup->Flush());
+  EXPECT_THAT(ReadRollup(rollup->table().get()),
+              UnorderedElementsAre(RollupRow{0, "a", 40, 2}, RollupRow{0, "b", 20, 1},
+                                   RollupRow{10, "a", 90, 2}, RollupRow{10, "b", 60, 1}));
+}
+
+TEST_F(RollupTableTest, allowed_lateness_keeps_buckets_open) {
+  spec_.allowed_lateness = std::chrono::nanoseconds(10);
+  ASSERT_OK_AND_ASSIGN(auto rollup, RollupTable::Create(spec_, &table_store_, registry_.get()));
+
+  Write({1, 12}, {"a", "a"}, {10, 40});
+  Write({3}, {"a"}, {20});
+  EXPECT_EQ(0, ReadRollup(rollup->table().get()).size());
+  EXPECT_EQ(0, rollup->num_late_rows());
+
+  Write({25}, {"a"}, {50});
+  EXPECT_THAT(ReadRollup(rollup->table().get()), UnorderedElementsAre(RollupRow{0, "a", 30, 2}));
+}
+
+TEST_F(RollupTableTest, coarser_rollup_merges_partial_states) {
+  spec_.store_partials = true;
+  // Every closed bucket is compacted into a cold batch of its own.
+  spec_.compacted_batch_size = 1;
+  ASSERT_OK_AND_ASSIGN(auto rollup, RollupTable::Create(spec_, &table_store_, registry_.get()));
+  EXPECT_EQ(std::vector<std::string>({"time_", "service", "latency_sum", "count",
+                                      "latency_sum_partial", "count_partial"}),
+            rollup->relation().col_names());
+
+  RollupSpec coarser_spec;
+  coarser_spec.source_table = "http_events_10ns";
+  coarser_spec.rollup_table = "http_events_20ns";
+  coarser_spec.bucket_size = std::chrono::nanoseconds(20);
+  coarser_spec.max_table_size = 1024 * 1024;
+  ASSERT_OK_AND_ASSIGN(auto coarser, rollup->CreateCoarser(coarser_spec, &table_store_));
+  EXPECT_EQ(rollup->relation().col_names(), coarser->relation().col_names());
+
+  Write({1, 5, 12}, {"a", "a", "a"}, {10, 30, 40});
+  Write({25}, {"a"}, {50});
+  ASSERT_OK(rollup->Flush());
+  EXPECT_THAT(ReadRollup(rollup->table().get()),
+              UnorderedElementsAre(RollupRow{0, "a", 40, 2}, RollupRow{10, "a", 40, 1},
+                                   RollupRow{20, "a", 50, 1}));
+
+  // The 10ns buckets are merged into 20ns buckets as the rollup table is compacted.
+  ASSERT_OK(rollup->table()->CompactHotToCold(arrow::default_memory_pool()));
+  ASSERT_OK(coarser->Flush());
+  EXPECT_THAT(ReadRollup(coarser->table().get()),
+              UnorderedElementsAre(RollupRow{0, "a", 80, 3}, RollupRow{20, "a", 50, 1}));
+}
+
+TEST_F(RollupTableTest, rollups_from_flag) {
+  // The PEM creates the rollups of --table_store_rollups this way, with carnot's registry.
+  auto registry = std::make_unique<udf::Registry>("builtins");
+  builtins::RegisterBuiltinsOrDie(registry.get());
+  ASSERT_OK_AND_ASSIGN(
+      auto specs,
+      ParseRollupSpecs("http_events_10ns:http_events:10ns:0s:service:latency_sum=sum(latency),"
+                       "count=count(latency); http_events_20ns:http_events_10ns:20ns:0s",
+                       1024 * 1024));
+  ASSERT_EQ(2, specs.size());
+  EXPECT_EQ("http_events", specs[0].source_table);
+  EXPECT_EQ(std::chrono::nanoseconds(10), specs[0].bucket_size);
+  EXPECT_EQ(std::vector<std::string>({"service"}), specs[0].group_by);
+  ASSERT_EQ(2, specs[0].aggregates.size());
+  EXPECT_EQ("sum", specs[0].aggregates[0].uda_name);
+  EXPECT_EQ(std::vector<std::string>({"latency"}), specs[0].aggregates[0].args);
+  EXPECT_EQ("latency_sum", specs[0].aggregates[0].output_name);
+  // The first rollup is rolled up by the second one, so it has to store its partial states.
+  EXPECT_TRUE(specs[0].store_partials);
+  EXPECT_EQ("http_events_10ns", specs[1].source_table);
+  EXPECT_TRUE(specs[1].aggregates.empty());
+
+  specs[0].compacted_batch_size = 1;
+  ASSERT_OK_AND_ASSIGN(auto rollups, CreateRollupTables(specs, &table_store_, registry.get()));
+  ASSERT_EQ(2, rollups.size());
+  EXPECT_EQ(rollups[1]->table().get(), table_store_.GetTable("http_events_20ns"));
+
+  Write({1, 5, 12, 25}, {"a", "b", "a", "a"}, {10, 30, 40, 50});
+  ASSERT_OK(rollups[0]->Flush());
+  ASSERT_OK(rollups[0]->table()->CompactHotToCold(arrow::default_memory_pool()));
+  ASSERT_OK(rollups[1]->Flush());
+  EXPECT_THAT(ReadRollup(rollups[1]->table().get()),
+              UnorderedElementsAre(RollupRow{0, "a", 50, 2}, RollupRow{0, "b", 30, 1},
+                                   RollupRow{20, "a", 50, 1}));
+}
+
+TEST_F(RollupTableTest, invalid_rollup_flags) {
+  EXPECT_NOT_OK(ParseRollupSpecs("http_events_10ns:http_events:10ns", 1024));
+  EXPECT_NOT_OK(ParseRollupSpecs("http_events_10ns:http_events:10x:0s:service:n=count(latency)",
+                                 1024));
+  EXPECT_NOT_OK(ParseRollupSpecs("http_events_10ns:http_events:10ns:0s:service:count(latency)",
+                                 1024));
+  EXPECT_NOT_OK(ParseRollupSpecs("http_events_10ns:http_events:10ns:0s:service:n=count(latency",
+                                 1024));
+  EXPECT_NOT_OK(ParseRollupSpecs("http_events_10ns:http_events:10ns:0s:service:", 1024));
+  // A coarser rollup must roll up an earlier rollup.
+  EXPECT_NOT_OK(ParseRollupSpecs("http_events_20ns:http_events:20ns:0s", 1024));
+}
+
+TEST_F(RollupTableTest, invalid_specs) {
+  auto spec = spec_;
+  spec.source_table = "does_not_exist";
+  EXPECT_NOT_OK(RollupTable::Create(spec, &table_store_, registry_.get()));
+
+  spec = spec_;
+  spec.group_by = {"does_not_exist"};
+  EXPECT_NOT_OK(RollupTable::Create(spec, &table_store_, registry_.get()));
+
+  spec = spec_;
+  spec.aggregates = {{"sum", {"service"}, "latency_sum"}};
+  EXPECT_NOT_OK(RollupTable::Create(spec, &table_store_, registry_.get()));
+
+  spec = spec_;
+  spec.rollup_table = "http_events";
+  EXPECT_NOT_OK(RollupTable::Create(spec, &table_store_, registry_.get()));
+
+  // A rollup without partial states can't be rolled up into coarser buckets.
+  ASSERT_OK_AND_ASSIGN(auto rollup, RollupTable::Create(spec_, &table_store_, registry_.get()));
+  spec = RollupSpec{};
+  spec.source_table = "http_events_10ns";
+  spec.rollup_table = "http_events_20ns";
+  spec.bucket_size = std::chrono::nanoseconds(20);
+  spec.max_table_size = 1024 * 1024;
+  EXPECT_NOT_OK(rollup->CreateCoarser(spec, &table_store_));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/carnot/exec/row_batch_selection.h"
+
+#include <vector>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+absl::flat_hash_set<int64_t> ReferencedColumns(const plan::ConstScalarExpressionVector& exprs) {
+  absl::flat_hash_set<int64_t> col_idxs;
+  for (const auto& expr : exprs) {
+    plan::ExpressionWalker<int>()
+        .OnColumn([&](const plan::Column& col, const std::vector<int>&) {
+          col_idxs.insert(col.Index());
+          return 0;
+        })
+        .Walk(*expr);
+  }
+  return col_idxs;
+}
+
+StatusOr<std::unique_ptr<RowBatch>> CompactColumns(
+    const RowBatch& rb, const absl::flat_hash_set<int64_t>& col_idxs, arrow::MemoryPool* mem_pool) {
+  DCHECK(rb.has_selection());
+  const auto& selection = *rb.selection();
+  auto output_rb = std::make_unique<RowBatch>(rb.desc(), selection.size());
+  output_rb->set_eow(rb.eow());
+  output_rb->set_eos(rb.eos());
+  for (int64_t col_idx = 0; col_idx < rb.num_columns(); ++col_idx) {
+    auto col = rb.ColumnAt(col_idx);
+    if (!col_idxs.contains(col_idx)) {
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(col->Slice(0, selection.size())));
+      continue;
+    }
+    PL_ASSIGN_OR_RETURN(auto output_col,
+                        table_store::schema::SelectRows(col.get(), selection, mem_pool));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(output_col));
+  }
+  return output_rb;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
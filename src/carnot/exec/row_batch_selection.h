@@ -0,0 +1,55 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <memory>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "src/carnot/plan/scalar_expression.h"
+#include "src/common/base/base.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * Returns the indices of the input columns that the expressions read.
+ */
+absl::flat_hash_set<int64_t> ReferencedColumns(const plan::ConstScalarExpressionVector& exprs);
+
+/**
+ * Returns a dense row batch with the selected rows of `rb`, for evaluating expressions that only
+ * read the columns in `col_idxs`. Only those columns are copied. The other columns are zero copy
+ * slices of the input columns, which have the right type and length, but not the selected values.
+ *
+ * Expressions are evaluated on the selected rows only, rather than on every row of the input
+ * columns, since the rows that a filter dropped can be invalid arguments to later expressions
+ * (e.g. a zero divisor).
+ */
+StatusOr<std::unique_ptr<table_store::schema::RowBatch>> CompactColumns(
+    const table_store::schema::RowBatch& rb, const absl::flat_hash_set<int64_t>& col_idxs,
+    arrow::MemoryPool* mem_pool);
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
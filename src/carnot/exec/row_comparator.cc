@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/row_comparator.h"
+
+#include <string_view>
+#include <utility>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+namespace {
+
+template <types::DataType T>
+int CompareValues(const arrow::Array* a, int64_t a_row, const arrow::Array* b, int64_t b_row) {
+  if constexpr (T == types::DataType::STRING) {
+    return types::GetStringViewFromArrowArray(a, a_row)
+        .compare(types::GetStringViewFromArrowArray(b, b_row));
+  } else {
+    auto a_val = types::GetValueFromArrowArray<T>(a, a_row);
+    auto b_val = types::GetValueFromArrowArray<T>(b, b_row);
+    return static_cast<int>(b_val < a_val) - static_cast<int>(a_val < b_val);
+  }
+}
+
+template <types::DataType T>
+Status GatherColumn(const std::vector<RowBatch>& batches, int64_t col,
+                    absl::Span<const RowRef> rows, arrow::ArrayBuilder* builder) {
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder);
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(rows.size()));
+  // Raw pointers to the columns, so that the shared_ptrs aren't copied for every row.
+  std::vector<const arrow::Array*> arrays;
+  arrays.reserve(batches.size());
+  for (const auto& rb : batches) {
+    arrays.push_back(rb.ColumnAt(col).get());
+  }
+  if constexpr (T == types::DataType::STRING) {
+    int64_t data_size = 0;
+    for (const auto& ref : rows) {
+      data_size += static_cast<const arrow::StringArray*>(arrays[ref.batch])->value_length(ref.row);
+    }
+    PL_RETURN_IF_ERROR(typed_builder->ReserveData(data_size));
+    for (const auto& ref : rows) {
+      std::string_view value = types::GetStringViewFromArrowArray(arrays[ref.batch], ref.row);
+      typed_builder->UnsafeAppend(value.data(), value.size());
+    }
+  } else {
+    for (const auto& ref : rows) {
+      typed_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(arrays[ref.batch], ref.row));
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+RowComparator::RowComparator(const std::vector<planpb::SortKey>& sort_keys,
+                             const RowDescriptor& input_desc) {
+  for (const auto& key : sort_keys) {
+    key_cols_.push_back(key.index());
+    descending_.push_back(key.descending());
+#define TYPE_CASE(_dt_) compare_fns_.push_back(&CompareValues<_dt_>);
+    PL_SWITCH_FOREACH_DATATYPE(input_desc.type(key.index()), TYPE_CASE);
+#undef TYPE_CASE
+  }
+}
+
+void RowComparator::AddBatch(const RowBatch& rb) {
+  std::vector<const arrow::Array*> keys;
+  keys.reserve(key_cols_.size());
+  for (int64_t col : key_cols_) {
+    keys.push_back(rb.ColumnAt(col).get());
+  }
+  batch_keys_.push_back(std::move(keys));
+}
+
+void RowComparator::SetBatch(int64_t batch, const RowBatch& rb) {
+  auto& keys = batch_keys_[batch];
+  for (size_t i = 0; i < key_cols_.size(); ++i) {
+    keys[i] = rb.ColumnAt(key_cols_[i]).get();
+  }
+}
+
+StatusOr<std::unique_ptr<RowBatch>> GatherRows(const RowDescriptor& output_desc,
+                                               const std::vector<RowBatch>& batches,
+                                               const std::vector<int64_t>& cols,
+                                               absl::Span<const RowRef> rows,
+                                               arrow::MemoryPool* mem_pool) {
+  DCHECK_EQ(output_desc.size(), cols.size());
+  auto output_rb = std::make_unique<RowBatch>(output_desc, rows.size());
+  for (size_t i = 0; i < cols.size(); ++i) {
+    auto builder = types::MakeArrowBuilder(output_desc.type(i), mem_pool);
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(GatherColumn<_dt_>(batches, cols[i], rows, builder.get()));
+    PL_SWITCH_FOREACH_DATATYPE(output_desc.type(i), TYPE_CASE);
+#undef TYPE_CASE
+    std::shared_ptr<arrow::Array> col;
+    PL_RETURN_IF_ERROR(builder->Finish(&col));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(col));
+  }
+  return output_rb;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
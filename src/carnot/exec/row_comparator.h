@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+#include <memory>
+#include <vector>
+
+#include <absl/types/span.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+// A row of one of the row batches held on to by a sorting node.
+struct RowRef {
+  int64_t batch;
+  int64_t row;
+};
+
+/**
+ * RowComparator orders the rows of a set of row batches by a list of sort keys, for the Sort and
+ * TopK nodes. The key columns of every batch are registered with AddBatch, after which rows are
+ * referred to by the index of their batch.
+ */
+class RowComparator {
+ public:
+  RowComparator(const std::vector<planpb::SortKey>& sort_keys,
+                const table_store::schema::RowDescriptor& input_desc);
+
+  void AddBatch(const table_store::schema::RowBatch& rb);
+  // Replaces the keys of a batch with those of another batch, which rows then refer to.
+  void SetBatch(int64_t batch, const table_store::schema::RowBatch& rb);
+  void RemoveLastBatch() { batch_keys_.pop_back(); }
+  void Clear() { batch_keys_.clear(); }
+  int64_t num_batches() const { return batch_keys_.size(); }
+
+  // Returns true if row a is ordered strictly before row b.
+  bool Less(const RowRef& a, const RowRef& b) const {
+    const auto& a_keys = batch_keys_[a.batch];
+    const auto& b_keys = batch_keys_[b.batch];
+    for (size_t i = 0; i < compare_fns_.size(); ++i) {
+      int cmp = compare_fns_[i](a_keys[i], a.row, b_keys[i], b.row);
+      if (cmp != 0) {
+        return descending_[i] ? cmp > 0 : cmp < 0;
+      }
+    }
+    return false;
+  }
+
+ private:
+  using CompareFn = int (*)(const arrow::Array*, int64_t, const arrow::Array*, int64_t);
+
+  std::vector<int64_t> key_cols_;
+  std::vector<CompareFn> compare_fns_;
+  std::vector<bool> descending_;
+  // The key columns of every batch. The batches own the arrays.
+  std::vector<std::vector<const arrow::Array*>> batch_keys_;
+};
+
+/**
+ * Creates a row batch out of the given rows of the batches, in order. The output has the columns
+ * `cols` of the input batches.
+ */
+StatusOr<std::unique_ptr<table_store::schema::RowBatch>> GatherRows(
+    const table_store::schema::RowDescriptor& output_desc,
+    const std::vector<table_store::schema::RowBatch>& batches, const std::vector<int64_t>& cols,
+    absl::Span<const RowRef> rows, arrow::MemoryPool* mem_pool);
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/runtime_join_filter.h"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+std::string_view HashView(const size_t& key_hash) {
+  return std::string_view(reinterpret_cast<const char*>(&key_hash), sizeof(key_hash));
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<RuntimeJoinFilter>> RuntimeJoinFilter::Create(
+    const std::vector<types::DataType>& key_types, int64_t num_keys) {
+  PL_ASSIGN_OR_RETURN(auto bloom_filter, bloomfilter::XXHash64BloomFilter::Create(
+                                             std::max<int64_t>(num_keys, 1), kErrorRate));
+  return std::unique_ptr<RuntimeJoinFilter>(
+      new RuntimeJoinFilter(key_types, std::move(bloom_filter)));
+}
+
+void RuntimeJoinFilter::Insert(size_t key_hash) { bloom_filter_->Insert(HashView(key_hash)); }
+
+bool RuntimeJoinFilter::MayContain(size_t key_hash) const {
+  return bloom_filter_->Contains(HashView(key_hash));
+}
+
+StatusOr<int64_t> RuntimeJoinFilter::Apply(const std::vector<int64_t>& key_col_idxs,
+                                           RowBatch* rb) const {
+  DCHECK_EQ(key_col_idxs.size(), key_types_.size());
+  int64_t num_selected = rb->num_selected_rows();
+  if (num_selected == 0) {
+    return 0;
+  }
+
+  std::vector<arrow::Array*> key_cols;
+  for (int64_t col_idx : key_col_idxs) {
+    key_cols.push_back(rb->ColumnAt(col_idx).get());
+  }
+
+  RowTuple key(&key_types_);
+  auto selection = std::make_shared<std::vector<int64_t>>();
+  selection->reserve(num_selected);
+  for (int64_t i = 0; i < num_selected; ++i) {
+    int64_t row_idx = rb->has_selection() ? (*rb->selection())[i] : i;
+    key.Reset();
+    for (size_t key_idx = 0; key_idx < key_cols.size(); ++key_idx) {
+#define TYPE_CASE(_dt_) ExtractIntoRowTuple<_dt_>(&key, key_cols[key_idx], key_idx, row_idx);
+      PL_SWITCH_FOREACH_DATATYPE(key_types_[key_idx], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    if (MayContain(key.Hash())) {
+      selection->push_back(row_idx);
+    }
+  }
+
+  int64_t num_dropped = num_selected - static_cast<int64_t>(selection->size());
+  if (num_dropped > 0) {
+    rb->set_selection(std::move(selection));
+  }
+  return num_dropped;
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
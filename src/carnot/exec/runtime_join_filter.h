@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "src/carnot/exec/row_tuple.h"
+#include "src/common/base/base.h"
+#include "src/shared/bloomfilter/bloomfilter.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * RuntimeJoinFilter is a bloom filter over the join keys of the build side of an equijoin. Once the
+ * build side is complete, the join pushes the filter down to the sources of its probe side, which
+ * drop the rows whose keys can't match any build row before they are sent through the rest of the
+ * plan. The filter may keep rows that don't match, but never drops a row that does.
+ *
+ * Keys are inserted and looked up by their RowTuple hash, so the filter only applies to the key
+ * types it was created for.
+ */
+class RuntimeJoinFilter {
+ public:
+  // The false positive rate the bloom filter is sized for.
+  static constexpr double kErrorRate = 0.01;
+
+  /**
+   * @param key_types the types of the join keys.
+   * @param num_keys the number of distinct keys that are inserted.
+   */
+  static StatusOr<std::unique_ptr<RuntimeJoinFilter>> Create(
+      const std::vector<types::DataType>& key_types, int64_t num_keys);
+
+  void Insert(size_t key_hash);
+  bool MayContain(size_t key_hash) const;
+
+  /**
+   * Apply sets the selection vector of the row batch to the rows whose keys may be in the filter.
+   * If the batch already has a selection, only the selected rows are kept. If no row is dropped,
+   * the batch is left as is.
+   * @param key_col_idxs the columns of the row batch that hold the keys, in key order.
+   * @param rb the row batch to filter.
+   * @return the number of rows that were dropped.
+   */
+  StatusOr<int64_t> Apply(const std::vector<int64_t>& key_col_idxs,
+                          table_store::schema::RowBatch* rb) const;
+
+  const std::vector<types::DataType>& key_types() const { return key_types_; }
+
+ private:
+  RuntimeJoinFilter(const std::vector<types::DataType>& key_types,
+                    std::unique_ptr<bloomfilter::XXHash64BloomFilter> bloom_filter)
+      : key_types_(key_types), bloom_filter_(std::move(bloom_filter)) {}
+
+  const std::vector<types::DataType> key_types_;
+  std::unique_ptr<bloomfilter::XXHash64BloomFilter> bloom_filter_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
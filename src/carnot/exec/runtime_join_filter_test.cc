@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/runtime_join_filter.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowDescriptor;
+
+class RuntimeJoinFilterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Sized for many more keys than are inserted, so that false positives are unlikely.
+    ASSERT_OK_AND_ASSIGN(filter_, RuntimeJoinFilter::Create(key_types_, 1000));
+    Insert(1, "a");
+    Insert(2, "b");
+  }
+
+  void Insert(int64_t i, const std::string& s) {
+    RowTuple key(&key_types_);
+    key.SetValue(0, types::Int64Value(i));
+    key.SetValue(1, types::StringValue(s));
+    filter_->Insert(key.Hash());
+  }
+
+  std::vector<types::DataType> key_types_ = {types::DataType::INT64, types::DataType::STRING};
+  std::unique_ptr<RuntimeJoinFilter> filter_;
+};
+
+TEST_F(RuntimeJoinFilterTest, drops_rows_that_cant_match) {
+  // The keys are the first and third columns of the batch.
+  RowDescriptor rd({types::DataType::INT64, types::DataType::FLOAT64, types::DataType::STRING});
+  RowBatchBuilder builder(rd, 4, /*eow*/ false, /*eos*/ false);
+  auto& rb = builder.AddColumn<types::Int64Value>({1, 1, 2, 3})
+                 .AddColumn<types::Float64Value>({0.1, 0.2, 0.3, 0.4})
+                 .AddColumn<types::StringValue>({"a", "b", "b", "c"})
+                 .get();
+
+  ASSERT_OK_AND_ASSIGN(auto num_dropped, filter_->Apply({0, 2}, &rb));
+  EXPECT_EQ(2, num_dropped);
+  ASSERT_TRUE(rb.has_selection());
+  EXPECT_EQ(std::vector<int64_t>({0, 2}), *rb.selection());
+}
+
+TEST_F(RuntimeJoinFilterTest, keeps_existing_selection) {
+  RowDescriptor rd({types::DataType::INT64, types::DataType::STRING});
+  RowBatchBuilder builder(rd, 4, /*eow*/ false, /*eos*/ false);
+  auto& rb = builder.AddColumn<types::Int64Value>({1, 2, 3, 2})
+                 .AddColumn<types::StringValue>({"a", "b", "c", "b"})
+                 .get();
+  rb.set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 2}));
+
+  ASSERT_OK_AND_ASSIGN(auto num_dropped, filter_->Apply({0, 1}, &rb));
+  EXPECT_EQ(1, num_dropped);
+  EXPECT_EQ(std::vector<int64_t>({1}), *rb.selection());
+}
+
+TEST_F(RuntimeJoinFilterTest, no_selection_if_all_rows_match) {
+  RowDescriptor rd({types::DataType::INT64, types::DataType::STRING});
+  RowBatchBuilder builder(rd, 2, /*eow*/ true, /*eos*/ true);
+  auto& rb =
+      builder.AddColumn<types::Int64Value>({2, 1}).AddColumn<types::StringValue>({"b", "a"}).get();
+
+  ASSERT_OK_AND_ASSIGN(auto num_dropped, filter_->Apply({0, 1}, &rb));
+  EXPECT_EQ(0, num_dropped);
+  EXPECT_FALSE(rb.has_selection());
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/sort_node.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+std::string SortNode::DebugStringImpl() {
+  return absl::Substitute("Exec::SortNode<$0>", plan_node_->DebugString());
+}
+
+Status SortNode::InitImpl(const plan::Operator& plan_node) {
+  CHECK(plan_node.op_type() == planpb::OperatorType::SORT_OPERATOR);
+  const auto* sort_plan_node = static_cast<const plan::SortOperator*>(&plan_node);
+  // copy the plan node to local object;
+  plan_node_ = std::make_unique<plan::SortOperator>(*sort_plan_node);
+  if (input_descriptors_.size() != 1) {
+    return error::InvalidArgument("Sort operator expects a single input relation, got $0",
+                                  input_descriptors_.size());
+  }
+  comparator_ = std::make_unique<RowComparator>(plan_node_->sort_keys(), input_descriptors_[0]);
+  for (size_t i = 0; i < input_descriptors_[0].size(); ++i) {
+    input_cols_.push_back(i);
+  }
+  return Status::OK();
+}
+
+Status SortNode::PrepareImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status SortNode::OpenImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status SortNode::CloseImpl(ExecState* exec_state) {
+  ClearBatches(exec_state);
+  runs_.clear();
+  if (num_spills_ > 0) {
+    stats()->AddExtraInfo("num_spills", absl::StrCat(num_spills_));
+  }
+  return Status::OK();
+}
+
+void SortNode::ClearBatches(ExecState* exec_state) {
+  batches_.clear();
+  comparator_->Clear();
+  num_rows_ = 0;
+  batch_bytes_ = 0;
+  exec_state->memory_tracker()->Track(&tracked_bytes_, 0);
+}
+
+std::vector<RowRef> SortNode::SortedRows() const {
+  std::vector<RowRef> rows;
+  rows.reserve(num_rows_);
+  for (int64_t batch = 0; batch < static_cast<int64_t>(batches_.size()); ++batch) {
+    for (int64_t row = 0; row < batches_[batch].num_rows(); ++row) {
+      rows.push_back({batch, row});
+    }
+  }
+  std::stable_sort(rows.begin(), rows.end(), [this](const RowRef& a, const RowRef& b) {
+    return comparator_->Less(a, b);
+  });
+  return rows;
+}
+
+Status SortNode::SendRows(ExecState* exec_state, absl::Span<const RowRef> rows, bool eow,
+                          bool eos) {
+  PL_ASSIGN_OR_RETURN(auto output_rb,
+                      GatherRows(*output_descriptor_, batches_, plan_node_->selected_cols(), rows,
+                                 exec_state->exec_mem_pool()));
+  output_rb->set_eow(eow);
+  output_rb->set_eos(eos);
+  return SendRowBatchToChildren(exec_state, *output_rb);
+}
+
+Status SortNode::SendSortedRows(ExecState* exec_state, bool eow, bool eos) {
+  if (num_rows_ == 0) {
+    PL_ASSIGN_OR_RETURN(auto output_rb, RowBatch::WithZeroRows(*output_descriptor_, eow, eos));
+    return SendRowBatchToChildren(exec_state, *output_rb);
+  }
+  auto rows = SortedRows();
+  absl::Span<const RowRef> sorted(rows);
+  for (int64_t offset = 0; offset < num_rows_; offset += kDefaultSortRowBatchSize) {
+    auto chunk = sorted.subspan(offset, kDefaultSortRowBatchSize);
+    bool last = offset + static_cast<int64_t>(chunk.size()) == num_rows_;
+    PL_RETURN_IF_ERROR(SendRows(exec_state, chunk, last && eow, last && eos));
+  }
+  return Status::OK();
+}
+
+Status SortNode::TrackMemory(ExecState* exec_state) {
+  auto* tracker = exec_state->memory_tracker();
+  tracker->Track(&tracked_bytes_, batch_bytes_);
+  if (tracker->LimitExceeded()) {
+    return SpillRun(exec_state);
+  }
+  return Status::OK();
+}
+
+Status SortNode::SpillRun(ExecState* exec_state) {
+  PL_ASSIGN_OR_RETURN(auto run, SpillFile::Create());
+  auto rows = SortedRows();
+  absl::Span<const RowRef> sorted(rows);
+  for (int64_t offset = 0; offset < num_rows_; offset += kDefaultSortRowBatchSize) {
+    PL_ASSIGN_OR_RETURN(auto run_rb,
+                        GatherRows(input_descriptors_[0], batches_, input_cols_,
+                                   sorted.subspan(offset, kDefaultSortRowBatchSize),
+                                   exec_state->exec_mem_pool()));
+    PL_RETURN_IF_ERROR(run->Write(*run_rb));
+  }
+  runs_.push_back(std::move(run));
+  ++num_spills_;
+  ClearBatches(exec_state);
+  return Status::OK();
+}
+
+Status SortNode::MergeRuns(ExecState* exec_state, bool eow, bool eos) {
+  if (num_rows_ > 0) {
+    PL_RETURN_IF_ERROR(SpillRun(exec_state));
+  }
+  // batches_ holds the current batch of each run, so that the rows of run i are in batch i.
+  std::vector<int64_t> next_rows(runs_.size(), 0);
+  for (const auto& run : runs_) {
+    PL_ASSIGN_OR_RETURN(auto run_rb, run->ReadNext());
+    DCHECK(run_rb != nullptr);
+    batches_.push_back(std::move(*run_rb));
+    comparator_->AddBatch(batches_.back());
+  }
+  // A min heap of the runs by their next row. Rows with equal keys are taken from the earlier run
+  // first, which keeps the sort stable.
+  auto greater = [&](int64_t a, int64_t b) {
+    RowRef a_ref{a, next_rows[a]};
+    RowRef b_ref{b, next_rows[b]};
+    if (comparator_->Less(b_ref, a_ref)) {
+      return true;
+    }
+    if (comparator_->Less(a_ref, b_ref)) {
+      return false;
+    }
+    return a > b;
+  };
+  std::vector<int64_t> heap(runs_.size());
+  std::iota(heap.begin(), heap.end(), 0);
+  std::make_heap(heap.begin(), heap.end(), greater);
+
+  std::vector<RowRef> output_rows;
+  output_rows.reserve(kDefaultSortRowBatchSize);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    int64_t run = heap.back();
+    output_rows.push_back({run, next_rows[run]++});
+    if (next_rows[run] < batches_[run].num_rows()) {
+      std::push_heap(heap.begin(), heap.end(), greater);
+      if (static_cast<int64_t>(output_rows.size()) == kDefaultSortRowBatchSize) {
+        PL_RETURN_IF_ERROR(SendRows(exec_state, output_rows, false, false));
+        output_rows.clear();
+      }
+      continue;
+    }
+    // The current batch of the run is used up. The output rows may point into it, so they are sent
+    // before it's replaced by the next batch of the run.
+    heap.pop_back();
+    PL_ASSIGN_OR_RETURN(auto run_rb, runs_[run]->ReadNext());
+    bool last = run_rb == nullptr && heap.empty();
+    PL_RETURN_IF_ERROR(SendRows(exec_state, output_rows, last && eow, last && eos));
+    output_rows.clear();
+    if (run_rb != nullptr) {
+      batches_[run] = std::move(*run_rb);
+      comparator_->SetBatch(run, batches_[run]);
+      next_rows[run] = 0;
+      heap.push_back(run);
+      std::push_heap(heap.begin(), heap.end(), greater);
+    }
+  }
+  runs_.clear();
+  ClearBatches(exec_state);
+  return Status::OK();
+}
+
+Status SortNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (rb.num_rows() > 0) {
+    batches_.push_back(rb);
+    comparator_->AddBatch(rb);
+    num_rows_ += rb.num_rows();
+    batch_bytes_ += rb.NumBytes();
+    PL_RETURN_IF_ERROR(TrackMemory(exec_state));
+  }
+  if (!rb.eow() && !rb.eos()) {
+    return Status::OK();
+  }
+  // Each window is sorted on its own.
+  if (runs_.empty()) {
+    PL_RETURN_IF_ERROR(SendSortedRows(exec_state, rb.eow(), rb.eos()));
+    ClearBatches(exec_state);
+    return Status::OK();
+  }
+  return MergeRuns(exec_state, rb.eow(), rb.eos());
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/row_comparator.h"
+#include "src/carnot/exec/spill_file.h"
+#include "src/carnot/plan/operators.h"
+#include "src/common/base/base.h"
+#include "src/common/base/status.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+constexpr int64_t kDefaultSortRowBatchSize = 1024;
+
+/**
+ * SortNode orders the rows of its input by the sort keys. It holds on to every input batch until
+ * the end of the window (or stream), then sends the sorted rows of the window in batches of at
+ * most kDefaultSortRowBatchSize rows. The sort is stable, so rows with equal keys keep the order
+ * they were received in.
+ *
+ * The held batches are reported to the query's MemoryTracker. When the query exceeds its memory
+ * limit, the held rows are sorted and written to a SpillFile as a sorted run, and at the end of
+ * the window the runs are merged.
+ */
+class SortNode : public ProcessingNode {
+ public:
+  SortNode() = default;
+  virtual ~SortNode() = default;
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  // Returns the rows of the held batches in sorted order.
+  std::vector<RowRef> SortedRows() const;
+  // Sends the selected columns of the given rows of the held batches as one row batch.
+  Status SendRows(ExecState* exec_state, absl::Span<const RowRef> rows, bool eow, bool eos);
+  Status SendSortedRows(ExecState* exec_state, bool eow, bool eos);
+  Status TrackMemory(ExecState* exec_state);
+  // Writes the held rows to a new spill file as a sorted run, and releases the held batches.
+  Status SpillRun(ExecState* exec_state);
+  // Merges the sorted runs of the window and sends the merged rows.
+  Status MergeRuns(ExecState* exec_state, bool eow, bool eos);
+  void ClearBatches(ExecState* exec_state);
+
+  std::unique_ptr<plan::SortOperator> plan_node_;
+  std::unique_ptr<RowComparator> comparator_;
+  // The indices of all of the input columns, which are written to the sorted runs.
+  std::vector<int64_t> input_cols_;
+  std::vector<table_store::schema::RowBatch> batches_;
+  int64_t num_rows_ = 0;
+  int64_t batch_bytes_ = 0;
+  // The bytes reported to the memory tracker.
+  int64_t tracked_bytes_ = 0;
+  // The sorted runs of the current window that were spilled, in the order they were written.
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+  int64_t num_spills_ = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/sort_node.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowDescriptor;
+
+class SortNodeTest : public ::testing::Test {
+ public:
+  SortNodeTest() {
+    auto op_proto = planpb::testutils::CreateTestSort1PB();
+    plan_node_ = plan::SortOperator::FromProto(op_proto, 1);
+
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, MockMetricsStubGenerator,
+                                              MockTraceStubGenerator, sole::uuid4(), nullptr);
+  }
+
+ protected:
+  std::unique_ptr<plan::Operator> plan_node_;
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+  RowDescriptor input_rd_{
+      {types::DataType::INT64, types::DataType::FLOAT64, types::DataType::STRING}};
+  RowDescriptor output_rd_{{types::DataType::INT64, types::DataType::STRING}};
+};
+
+TEST_F(SortNodeTest, sorts_across_batches) {
+  auto tester = exec::ExecNodeTester<SortNode, plan::SortOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3})
+                       .AddColumn<types::Float64Value>({0.5, 2.0, 1.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c"})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({4, 5, 6})
+                       .AddColumn<types::Float64Value>({2.0, 0.1, 1.0})
+                       .AddColumn<types::StringValue>({"d", "e", "f"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 6, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({2, 4, 3, 6, 1, 5})
+                          .AddColumn<types::StringValue>({"b", "d", "c", "f", "a", "e"})
+                          .get())
+      .Close();
+}
+
+TEST_F(SortNodeTest, sorts_each_window) {
+  auto tester = exec::ExecNodeTester<SortNode, plan::SortOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3})
+                       .AddColumn<types::Float64Value>({0.5, 2.0, 1.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ false)
+                          .AddColumn<types::Int64Value>({2, 3, 1})
+                          .AddColumn<types::StringValue>({"b", "c", "a"})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({4, 5, 6})
+                       .AddColumn<types::Float64Value>({2.0, 0.1, 1.0})
+                       .AddColumn<types::StringValue>({"d", "e", "f"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({4, 6, 5})
+                          .AddColumn<types::StringValue>({"d", "f", "e"})
+                          .get())
+      .Close();
+}
+
+TEST_F(SortNodeTest, merges_spilled_runs) {
+  // Every batch exceeds the memory limit, so each one is spilled as a sorted run, and the runs are
+  // merged at the end of the stream. A batch is output each time the current batch of a run is
+  // used up.
+  exec_state_->memory_tracker()->set_limit_bytes(1);
+  auto tester = exec::ExecNodeTester<SortNode, plan::SortOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2})
+                       .AddColumn<types::Float64Value>({0.5, 2.0})
+                       .AddColumn<types::StringValue>({"a", "b"})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({3, 4})
+                       .AddColumn<types::Float64Value>({1.0, 2.0})
+                       .AddColumn<types::StringValue>({"c", "d"})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({5, 6})
+                       .AddColumn<types::Float64Value>({0.1, 1.0})
+                       .AddColumn<types::StringValue>({"e", "f"})
+                       .get(),
+                   0, 3)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ false, /*eos*/ false)
+                          .AddColumn<types::Int64Value>({2, 4, 3})
+                          .AddColumn<types::StringValue>({"b", "d", "c"})
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 2, /*eow*/ false, /*eos*/ false)
+                          .AddColumn<types::Int64Value>({6, 1})
+                          .AddColumn<types::StringValue>({"f", "a"})
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 1, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({5})
+                          .AddColumn<types::StringValue>({"e"})
+                          .get())
+      .Close();
+  EXPECT_EQ(0, exec_state_->memory_tracker()->bytes_used());
+}
+
+TEST_F(SortNodeTest, splits_output_into_batches) {
+  int64_t num_rows = kDefaultSortRowBatchSize + 10;
+  std::vector<types::Int64Value> col0;
+  std::vector<types::Float64Value> col1;
+  std::vector<types::StringValue> col2;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    col0.push_back(i);
+    col1.push_back(static_cast<double>(i));
+    col2.push_back("abc");
+  }
+  auto tester = exec::ExecNodeTester<SortNode, plan::SortOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester.ConsumeNext(RowBatchBuilder(input_rd_, num_rows, /*eow*/ true, /*eos*/ true)
+                         .AddColumn<types::Int64Value>(col0)
+                         .AddColumn<types::Float64Value>(col1)
+                         .AddColumn<types::StringValue>(col2)
+                         .get(),
+                     0, 2);
+
+  // Sorted by the second column descending.
+  std::vector<types::Int64Value> first_batch;
+  for (int64_t i = 0; i < kDefaultSortRowBatchSize; ++i) {
+    first_batch.push_back(num_rows - 1 - i);
+  }
+  tester
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, kDefaultSortRowBatchSize, false, false)
+                          .AddColumn<types::Int64Value>(first_batch)
+                          .AddColumn<types::StringValue>(std::vector<types::StringValue>(
+                              kDefaultSortRowBatchSize, "abc"))
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 10, true, true)
+                          .AddColumn<types::Int64Value>({9, 8, 7, 6, 5, 4, 3, 2, 1, 0})
+                          .AddColumn<types::StringValue>(std::vector<types::StringValue>(10, "abc"))
+                          .get())
+      .Close();
+}
+
+TEST_F(SortNodeTest, empty_input) {
+  auto tester = exec::ExecNodeTester<SortNode, plan::SortOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 0, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({})
+                       .AddColumn<types::Float64Value>({})
+                       .AddColumn<types::StringValue>({})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 0, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({})
+                          .AddColumn<types::StringValue>({})
+                          .get())
+      .Close();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/spill_file.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+
+DEFINE_string(carnot_spill_dir, gflags::StringFromEnv("PL_CARNOT_SPILL_DIR", "/tmp"),
+              "The directory that aggregates and joins spill their state to when a query exceeds "
+              "its memory limit.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+StatusOr<std::unique_ptr<SpillFile>> SpillFile::Create(const std::string& dir) {
+  std::string path = absl::StrCat(dir, "/carnot_spill_XXXXXX");
+  std::vector<char> path_buf(path.begin(), path.end());
+  path_buf.push_back('\0');
+  int fd = mkstemp(path_buf.data());
+  if (fd < 0) {
+    return error::Internal("Failed to create spill file in $0: $1", dir, std::strerror(errno));
+  }
+  unlink(path_buf.data());
+  std::FILE* file = fdopen(fd, "w+b");
+  if (file == nullptr) {
+    close(fd);
+    return error::Internal("Failed to open spill file in $0: $1", dir, std::strerror(errno));
+  }
+  return std::unique_ptr<SpillFile>(new SpillFile(file));
+}
+
+SpillFile::~SpillFile() { std::fclose(file_); }
+
+Status SpillFile::Write(const RowBatch& rb) {
+  DCHECK(!reading_);
+  table_store::schemapb::RowBatchData proto;
+  PL_RETURN_IF_ERROR(rb.ToProto(&proto));
+  std::string data = proto.SerializeAsString();
+  uint64_t size = data.size();
+  if (std::fwrite(&size, sizeof(size), 1, file_) != 1 ||
+      std::fwrite(data.data(), 1, data.size(), file_) != data.size()) {
+    return error::Internal("Failed to write to spill file: $0", std::strerror(errno));
+  }
+  ++num_batches_;
+  bytes_written_ += sizeof(size) + data.size();
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<RowBatch>> SpillFile::ReadNext() {
+  if (!reading_) {
+    reading_ = true;
+    if (std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0) {
+      return error::Internal("Failed to rewind spill file: $0", std::strerror(errno));
+    }
+  }
+  uint64_t size;
+  if (std::fread(&size, sizeof(size), 1, file_) != 1) {
+    if (std::feof(file_)) {
+      return std::unique_ptr<RowBatch>(nullptr);
+    }
+    return error::Internal("Failed to read from spill file: $0", std::strerror(errno));
+  }
+  std::string data(size, '\0');
+  if (std::fread(data.data(), 1, size, file_) != size) {
+    return error::Internal("Spill file is truncated");
+  }
+  table_store::schemapb::RowBatchData proto;
+  if (!proto.ParseFromString(data)) {
+    return error::Internal("Failed to parse row batch from spill file");
+  }
+  return RowBatch::FromProto(proto);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/row_batch.h"
+
+DECLARE_string(carnot_spill_dir);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * SpillFile is a temporary file that an operator writes row batches to when its state exceeds the
+ * memory limit of the query (see MemoryTracker), and later reads them back from. Batches are
+ * written as length prefixed RowBatchData protos, and read back in the order they were written.
+ *
+ * The file is unlinked as soon as it's created, so that it's removed even if the process crashes;
+ * its space is freed when the SpillFile is destroyed.
+ */
+class SpillFile {
+ public:
+  /**
+   * @param dir the directory to create the file in.
+   */
+  static StatusOr<std::unique_ptr<SpillFile>> Create(
+      const std::string& dir = FLAGS_carnot_spill_dir);
+
+  ~SpillFile();
+
+  /**
+   * Appends a row batch to the file. Only the selected rows are written if it has a selection.
+   */
+  Status Write(const table_store::schema::RowBatch& rb);
+
+  /**
+   * Reads the next row batch from the file. Once reading has started, no more batches may be
+   * written.
+   * @return the row batch, or nullptr if all of the batches have been read.
+   */
+  StatusOr<std::unique_ptr<table_store::schema::RowBatch>> ReadNext();
+
+  int64_t num_batches() const { return num_batches_; }
+  int64_t bytes_written() const { return bytes_written_; }
+
+ private:
+  explicit SpillFile(std::FILE* file) : file_(file) {}
+
+  std::FILE* file_;
+  bool reading_ = false;
+  int64_t num_batches_ = 0;
+  int64_t bytes_written_ = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/spill_file.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+TEST(SpillFileTest, read_back_in_order) {
+  ASSERT_OK_AND_ASSIGN(auto file, SpillFile::Create());
+  RowDescriptor rd({types::DataType::INT64, types::DataType::STRING});
+
+  RowBatchBuilder builder1(rd, 3, /*eow*/ false, /*eos*/ false);
+  auto& rb1 = builder1.AddColumn<types::Int64Value>({1, 2, 3})
+                  .AddColumn<types::StringValue>({"a", "b", "c"})
+                  .get();
+  // Only the selected rows are spilled.
+  rb1.set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2}));
+  RowBatchBuilder builder2(rd, 1, /*eow*/ true, /*eos*/ true);
+  auto& rb2 = builder2.AddColumn<types::Int64Value>({4}).AddColumn<types::StringValue>({"d"}).get();
+
+  ASSERT_OK(file->Write(rb1));
+  ASSERT_OK(file->Write(rb2));
+  EXPECT_EQ(2, file->num_batches());
+  EXPECT_GT(file->bytes_written(), 0);
+
+  ASSERT_OK_AND_ASSIGN(auto read1, file->ReadNext());
+  ASSERT_NE(nullptr, read1);
+  EXPECT_TRUE(read1->ColumnAt(0)->Equals(types::ToArrow(std::vector<types::Int64Value>{1, 3},
+                                                        arrow::default_memory_pool())));
+  EXPECT_TRUE(read1->ColumnAt(1)->Equals(types::ToArrow(std::vector<types::StringValue>{"a", "c"},
+                                                        arrow::default_memory_pool())));
+  EXPECT_FALSE(read1->eos());
+
+  ASSERT_OK_AND_ASSIGN(auto read2, file->ReadNext());
+  ASSERT_NE(nullptr, read2);
+  EXPECT_EQ(1, read2->num_rows());
+  EXPECT_TRUE(read2->eos());
+
+  ASSERT_OK_AND_ASSIGN(auto done, file->ReadNext());
+  EXPECT_EQ(nullptr, done);
+}
+
+TEST(SpillFileTest, create_fails_for_missing_dir) {
+  EXPECT_NOT_OK(SpillFile::Create("/does/not/exist"));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
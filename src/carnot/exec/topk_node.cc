@@ -0,0 +1,163 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/topk_node.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/exec/sort_node.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+std::string TopKNode::DebugStringImpl() {
+  return absl::Substitute("Exec::TopKNode<$0>", plan_node_->DebugString());
+}
+
+Status TopKNode::InitImpl(const plan::Operator& plan_node) {
+  CHECK(plan_node.op_type() == planpb::OperatorType::TOPK_OPERATOR);
+  const auto* topk_plan_node = static_cast<const plan::TopKOperator*>(&plan_node);
+  // copy the plan node to local object;
+  plan_node_ = std::make_unique<plan::TopKOperator>(*topk_plan_node);
+  if (input_descriptors_.size() != 1) {
+    return error::InvalidArgument("TopK operator expects a single input relation, got $0",
+                                  input_descriptors_.size());
+  }
+  comparator_ = std::make_unique<RowComparator>(plan_node_->sort_keys(), input_descriptors_[0]);
+  for (size_t i = 0; i < input_descriptors_[0].size(); ++i) {
+    input_cols_.push_back(i);
+  }
+  return Status::OK();
+}
+
+Status TopKNode::PrepareImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status TopKNode::OpenImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status TopKNode::CloseImpl(ExecState* /*exec_state*/) {
+  stats()->AddExtraInfo("num_compactions", absl::StrCat(num_compactions_));
+  batches_.clear();
+  comparator_->Clear();
+  heap_.clear();
+  return Status::OK();
+}
+
+void TopKNode::AddBatch(const RowBatch& rb) {
+  auto k = static_cast<size_t>(plan_node_->k());
+  auto less = [this](const RowRef& a, const RowRef& b) { return Less(a, b); };
+  RowRef ref{static_cast<int64_t>(batches_.size()), 0};
+  comparator_->AddBatch(rb);
+  bool kept_rows = false;
+  for (; ref.row < rb.num_rows(); ++ref.row) {
+    if (heap_.size() < k) {
+      heap_.push_back(ref);
+      std::push_heap(heap_.begin(), heap_.end(), less);
+      kept_rows = true;
+    } else if (Less(ref, heap_.front())) {
+      std::pop_heap(heap_.begin(), heap_.end(), less);
+      heap_.back() = ref;
+      std::push_heap(heap_.begin(), heap_.end(), less);
+      kept_rows = true;
+    }
+  }
+  if (!kept_rows) {
+    // None of the rows made it into the top k, so there's no need to hold on to the batch.
+    comparator_->RemoveLastBatch();
+    return;
+  }
+  batches_.push_back(rb);
+  num_batch_rows_ += rb.num_rows();
+}
+
+Status TopKNode::CompactBatches(ExecState* exec_state) {
+  std::sort(heap_.begin(), heap_.end(),
+            [this](const RowRef& a, const RowRef& b) { return Less(a, b); });
+  PL_ASSIGN_OR_RETURN(auto compacted_rb, GatherRows(input_descriptors_[0], batches_, input_cols_,
+                                                    heap_, exec_state->exec_mem_pool()));
+  batches_.clear();
+  comparator_->Clear();
+  batches_.push_back(*compacted_rb);
+  comparator_->AddBatch(batches_.back());
+  num_batch_rows_ = compacted_rb->num_rows();
+  // The rows are sorted, and stay in the same order in the compacted batch, so the heap is the
+  // same rows in reverse.
+  for (size_t i = 0; i < heap_.size(); ++i) {
+    heap_[i] = RowRef{0, static_cast<int64_t>(heap_.size() - 1 - i)};
+  }
+  ++num_compactions_;
+  return Status::OK();
+}
+
+Status TopKNode::SendTopK(ExecState* exec_state, bool eow, bool eos) {
+  if (heap_.empty()) {
+    PL_ASSIGN_OR_RETURN(auto output_rb, RowBatch::WithZeroRows(*output_descriptor_, eow, eos));
+    return SendRowBatchToChildren(exec_state, *output_rb);
+  }
+  std::sort_heap(heap_.begin(), heap_.end(),
+                 [this](const RowRef& a, const RowRef& b) { return Less(a, b); });
+  absl::Span<const RowRef> sorted(heap_);
+  auto num_rows = static_cast<int64_t>(heap_.size());
+  for (int64_t offset = 0; offset < num_rows; offset += kDefaultSortRowBatchSize) {
+    auto chunk = sorted.subspan(offset, kDefaultSortRowBatchSize);
+    PL_ASSIGN_OR_RETURN(auto output_rb,
+                        GatherRows(*output_descriptor_, batches_, plan_node_->selected_cols(),
+                                   chunk, exec_state->exec_mem_pool()));
+    bool last = offset + static_cast<int64_t>(chunk.size()) == num_rows;
+    output_rb->set_eow(last && eow);
+    output_rb->set_eos(last && eos);
+    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *output_rb));
+  }
+  return Status::OK();
+}
+
+Status TopKNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (plan_node_->k() > 0 && rb.num_rows() > 0) {
+    AddBatch(rb);
+    int64_t max_batch_rows = std::max(2 * plan_node_->k(), kDefaultSortRowBatchSize);
+    if (num_batch_rows_ > max_batch_rows) {
+      PL_RETURN_IF_ERROR(CompactBatches(exec_state));
+    }
+  }
+  if (!rb.eow() && !rb.eos()) {
+    return Status::OK();
+  }
+  // Each window has its own top k.
+  PL_RETURN_IF_ERROR(SendTopK(exec_state, rb.eow(), rb.eos()));
+  batches_.clear();
+  comparator_->Clear();
+  num_batch_rows_ = 0;
+  heap_.clear();
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/row_comparator.h"
+#include "src/carnot/plan/operators.h"
+#include "src/common/base/base.h"
+#include "src/common/base/status.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * TopKNode outputs the first k rows of each window of its input in the order of the sort keys,
+ * i.e. a Sort followed by a Limit, without holding on to the whole input.
+ *
+ * The current top k rows are kept in a bounded max heap, so that each input row is compared
+ * against the worst of them. Input batches are only kept while some of their rows are in the heap,
+ * and once the kept batches add up to more than max(2k, kDefaultSortRowBatchSize) rows, the rows of
+ * the heap are copied into a single batch, so the memory used stays proportional to k. Rows with
+ * equal keys are ordered by their position in the input.
+ */
+class TopKNode : public ProcessingNode {
+ public:
+  TopKNode() = default;
+  virtual ~TopKNode() = default;
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  // Orders rows by their keys, and then by their position in the input.
+  bool Less(const RowRef& a, const RowRef& b) const {
+    if (comparator_->Less(a, b)) {
+      return true;
+    }
+    if (comparator_->Less(b, a)) {
+      return false;
+    }
+    return a.batch < b.batch || (a.batch == b.batch && a.row < b.row);
+  }
+  // Adds the rows of the batch that belong in the top k to the heap.
+  void AddBatch(const table_store::schema::RowBatch& rb);
+  // Copies the rows of the heap into a single batch, and releases the other batches.
+  Status CompactBatches(ExecState* exec_state);
+  Status SendTopK(ExecState* exec_state, bool eow, bool eos);
+
+  std::unique_ptr<plan::TopKOperator> plan_node_;
+  std::unique_ptr<RowComparator> comparator_;
+  // The indices of all of the input columns, which are kept when compacting batches.
+  std::vector<int64_t> input_cols_;
+  // The row batches that have rows in the heap. Rows of the heap point into these by index.
+  std::vector<table_store::schema::RowBatch> batches_;
+  int64_t num_batch_rows_ = 0;
+  // A max heap of the top k rows so far, with the last of them at the front.
+  std::vector<RowRef> heap_;
+  int64_t num_compactions_ = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/topk_node.h"
+
+#include <memory>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/sort_node.h"
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowDescriptor;
+
+class TopKNodeTest : public ::testing::Test {
+ public:
+  TopKNodeTest() {
+    auto op_proto = planpb::testutils::CreateTestTopK1PB();
+    plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, MockMetricsStubGenerator,
+                                              MockTraceStubGenerator, sole::uuid4(), nullptr);
+  }
+
+ protected:
+  std::unique_ptr<plan::Operator> plan_node_;
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+  RowDescriptor input_rd_{
+      {types::DataType::INT64, types::DataType::FLOAT64, types::DataType::STRING}};
+  RowDescriptor output_rd_{{types::DataType::INT64, types::DataType::STRING}};
+};
+
+TEST_F(TopKNodeTest, top_rows_across_batches) {
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3})
+                       .AddColumn<types::Float64Value>({0.5, 2.0, 1.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c"})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({4, 5, 6})
+                       .AddColumn<types::Float64Value>({2.0, 0.1, 1.0})
+                       .AddColumn<types::StringValue>({"d", "e", "f"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({2, 4, 3})
+                          .AddColumn<types::StringValue>({"b", "d", "c"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, top_rows_of_each_window) {
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ true, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({0.5, 2.0, 1.0, 3.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c", "d"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ false)
+                          .AddColumn<types::Int64Value>({4, 2, 3})
+                          .AddColumn<types::StringValue>({"d", "b", "c"})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({5, 6})
+                       .AddColumn<types::Float64Value>({0.1, 0.2})
+                       .AddColumn<types::StringValue>({"e", "f"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 2, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({6, 5})
+                          .AddColumn<types::StringValue>({"f", "e"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, equal_keys_keep_input_order) {
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({7, 7, 7, 7})
+                       .AddColumn<types::Float64Value>({1.0, 1.0, 1.0, 1.0})
+                       .AddColumn<types::StringValue>({"w", "x", "y", "z"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({7, 7, 7})
+                          .AddColumn<types::StringValue>({"w", "x", "y"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, compacts_large_batches) {
+  // The first batch is larger than the rows kept before compacting, so only its top 3 rows are
+  // kept once it has been consumed.
+  int64_t num_rows = 2 * kDefaultSortRowBatchSize;
+  std::vector<types::Int64Value> col0;
+  std::vector<types::Float64Value> col1;
+  std::vector<types::StringValue> col2;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    col0.push_back(i);
+    col1.push_back(static_cast<double>(i % 100));
+    col2.push_back(absl::StrCat("row", i));
+  }
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, num_rows, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>(col0)
+                       .AddColumn<types::Float64Value>(col1)
+                       .AddColumn<types::StringValue>(col2)
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({-1, -2})
+                       .AddColumn<types::Float64Value>({99.0, 50.0})
+                       .AddColumn<types::StringValue>({"new1", "new2"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({-1, 99, 199})
+                          .AddColumn<types::StringValue>({"new1", "row99", "row199"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, k_zero) {
+  auto op_proto = planpb::testutils::CreateTestTopK1PB();
+  op_proto.mutable_topk_op()->set_k(0);
+  plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 2})
+                       .AddColumn<types::Float64Value>({1.0, 2.0})
+                       .AddColumn<types::StringValue>({"a", "b"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 0, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({})
+                          .AddColumn<types::StringValue>({})
+                          .get())
+      .Close();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
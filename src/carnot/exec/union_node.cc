@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/union_node.h"
 
+#include <arrow/array/concatenate.h>
 #include <arrow/memory_pool.h>
 #include <arrow/status.h>
 #include <algorithm>
@@ -25,6 +26,7 @@
 #include <string>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <absl/strings/str_join.h>
 #include <absl/strings/substitute.h>
 
@@ -41,6 +43,26 @@ namespace exec {
 using table_store::schema::RowBatch;
 using table_store::schema::RowDescriptor;
 
+namespace {
+
+// Concatenates the slices of an output column. A column made of a single slice isn't copied.
+StatusOr<std::shared_ptr<arrow::Array>> ConcatenateSlices(types::DataType data_type,
+                                                          const arrow::ArrayVector& slices) {
+  if (slices.size() == 1) {
+    return slices[0];
+  }
+  std::shared_ptr<arrow::Array> out;
+  if (slices.empty()) {
+    auto builder = MakeArrowBuilder(data_type, arrow::default_memory_pool());
+    PL_RETURN_IF_ERROR(builder->Finish(&out));
+    return out;
+  }
+  PL_RETURN_IF_ERROR(arrow::Concatenate(slices, arrow::default_memory_pool(), &out));
+  return out;
+}
+
+}  // namespace
+
 std::string UnionNode::DebugStringImpl() {
   return absl::Substitute("Exec::UnionNode<$0>", absl::StrJoin(plan_node_->column_names(), ","));
 }
@@ -56,15 +78,6 @@ Status UnionNode::InitImpl(const plan::Operator& plan_node) {
   return Status::OK();
 }
 
-Status UnionNode::InitializeColumnBuilders() {
-  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
-    column_builders_[i] =
-        MakeArrowBuilder(output_descriptor_->type(i), arrow::default_memory_pool());
-    PL_RETURN_IF_ERROR(column_builders_[i]->Reserve(output_rows_per_batch_));
-  }
-  return Status::OK();
-}
-
 Status UnionNode::PrepareImpl(ExecState*) {
   size_t num_output_cols = output_descriptor_->size();
 
@@ -77,8 +90,7 @@ Status UnionNode::PrepareImpl(ExecState*) {
     time_columns_.resize(num_parents_);
     data_columns_.resize(num_parents_, std::vector<arrow::Array*>(num_output_cols));
 
-    column_builders_.resize(num_output_cols);
-    PL_RETURN_IF_ERROR(InitializeColumnBuilders());
+    output_columns_.resize(num_output_cols);
   }
 
   return Status::OK();
@@ -86,7 +98,12 @@ Status UnionNode::PrepareImpl(ExecState*) {
 
 Status UnionNode::OpenImpl(ExecState*) { return Status::OK(); }
 
-Status UnionNode::CloseImpl(ExecState*) { return Status::OK(); }
+Status UnionNode::CloseImpl(ExecState*) {
+  if (plan_node_->order_by_time()) {
+    stats()->AddExtraInfo("merge_runs", absl::StrCat(num_merge_runs_));
+  }
+  return Status::OK();
+}
 
 bool UnionNode::InputsComplete() {
   for (bool parent_eos : flushed_parent_eoses_) {
@@ -111,17 +128,54 @@ types::Time64NSValue UnionNode::GetTimeAtParentCursor(size_t parent_index) const
                                                         row_cursors_[parent_index]);
 }
 
-Status UnionNode::AppendRow(size_t parent) {
-  auto row = row_cursors_[parent];
-  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
-    auto input_col = data_columns_[parent][i];
-#define TYPE_CASE(_dt_)                                    \
-  PL_RETURN_IF_ERROR(table_store::schema::CopyValue<_dt_>( \
-      column_builders_[i].get(), types::GetValueFromArrowArray<_dt_>(input_col, row)));
-    PL_SWITCH_FOREACH_DATATYPE(output_descriptor_->type(i), TYPE_CASE);
-#undef TYPE_CASE
+bool UnionNode::ParentCursorLess::operator()(size_t parent_a, size_t parent_b) const {
+  const auto& eoses = node->flushed_parent_eoses_;
+  if (eoses[parent_a] || eoses[parent_b]) {
+    return eoses[parent_b] && (!eoses[parent_a] || parent_a < parent_b);
   }
-  return Status::OK();
+  auto time_a = node->GetTimeAtParentCursor(parent_a);
+  auto time_b = node->GetTimeAtParentCursor(parent_b);
+  return time_a < time_b || (time_a == time_b && parent_a < parent_b);
+}
+
+int64_t UnionNode::RunEnd(size_t parent, size_t next_parent) const {
+  int64_t end = parent_row_batches_[parent].front().num_rows();
+  if (next_parent == decltype(merge_tree_)::kNone || flushed_parent_eoses_[next_parent]) {
+    return end;
+  }
+  // A row at the same time as the limit only belongs to the run if its parent comes first.
+  auto limit = GetTimeAtParentCursor(next_parent);
+  bool include_limit = parent < next_parent;
+  auto in_run = [&](int64_t row) {
+    auto time = types::GetValueFromArrowArray<types::TIME64NS>(time_columns_[parent], row);
+    return time < limit || (include_limit && time == limit);
+  };
+
+  // Runs are short when the parents interleave, so gallop ahead of the cursor before searching.
+  // The row at the cursor is always part of the run, and hi is either the end or not in the run.
+  int64_t lo = row_cursors_[parent];
+  int64_t hi = lo + 1;
+  for (int64_t step = 1; hi < end && in_run(hi); step *= 2) {
+    lo = hi;
+    hi = std::min(end, hi + step);
+  }
+  while (hi - lo > 1) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (in_run(mid)) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return hi;
+}
+
+void UnionNode::AppendRows(size_t parent, int64_t offset, int64_t length) {
+  for (size_t i = 0; i < output_columns_.size(); ++i) {
+    output_columns_[i].push_back(data_columns_[parent][i]->Slice(offset, length));
+  }
+  output_rows_ += length;
+  ++num_merge_runs_;
 }
 
 // Flush the row batch if we have waited too long between row batches.
@@ -139,8 +193,7 @@ Status UnionNode::OptionallyFlushRowBatchIfTimeout(ExecState* exec_state) {
     return Status::OK();
   }
 
-  DCHECK_GT(column_builders_.size(), 0);
-  if (column_builders_[0]->length()) {
+  if (output_rows_) {
     return FlushBatch(exec_state);
   }
   return Status::OK();
@@ -149,9 +202,7 @@ Status UnionNode::OptionallyFlushRowBatchIfTimeout(ExecState* exec_state) {
 // Flush the row batch if we have reached a certain number of records.
 Status UnionNode::OptionallyFlushRowBatchIfMaxRowsOrEOS(ExecState* exec_state) {
   bool eos = InputsComplete();
-  int64_t output_rows = column_builders_[0]->length();
-
-  if (output_rows < static_cast<int64_t>(output_rows_per_batch_) && !eos) {
+  if (output_rows_ < static_cast<int64_t>(output_rows_per_batch_) && !eos) {
     return Status::OK();
   }
 
@@ -162,78 +213,62 @@ Status UnionNode::FlushBatch(ExecState* exec_state) {
   DCHECK(!sent_eos_);
 
   bool eos = InputsComplete();
-  PL_ASSIGN_OR_RETURN(auto rb, RowBatch::FromColumnBuilders(*output_descriptor_, /*eow*/ eos,
-                                                            /*eos*/ eos, &column_builders_));
-  PL_RETURN_IF_ERROR(InitializeColumnBuilders());
+  RowBatch output_rb(*output_descriptor_, output_rows_);
+  for (size_t i = 0; i < output_columns_.size(); ++i) {
+    PL_ASSIGN_OR_RETURN(auto col,
+                        ConcatenateSlices(output_descriptor_->type(i), output_columns_[i]));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(col));
+    output_columns_[i].clear();
+  }
+  output_rb.set_eow(eos);
+  output_rb.set_eos(eos);
+  output_rows_ = 0;
   last_data_flush_time_ = std::chrono::system_clock::now();
-  return SendRowBatchToChildren(exec_state, *rb);
+  return SendRowBatchToChildren(exec_state, output_rb);
 }
 
 Status UnionNode::MergeData(ExecState* exec_state) {
-  while (!sent_eos_) {
-    // Get the smallest time out of all of the current streams.
-    std::vector<size_t> parent_streams;
-    parent_streams.reserve(row_cursors_.size());
-
-    for (size_t parent = 0; parent < row_cursors_.size(); ++parent) {
-      if (flushed_parent_eoses_[parent]) {
-        continue;
-      }
-      // If we lack necessary data, we can't merge anymore.
-      if (!parent_row_batches_[parent].size()) {
-        return Status::OK();
-      }
-      parent_streams.push_back(parent);
+  for (size_t parent = 0; parent < num_parents_; ++parent) {
+    // If we lack necessary data, we can't merge anymore.
+    if (!flushed_parent_eoses_[parent] && parent_row_batches_[parent].empty()) {
+      return Status::OK();
     }
+  }
 
+  merge_tree_.Reset(num_parents_);
+  while (!sent_eos_) {
+    size_t parent = merge_tree_.winner();
     // If we have reached end of stream for all of our inputs, flush the queue.
-    if (!parent_streams.size()) {
+    if (flushed_parent_eoses_[parent]) {
       return OptionallyFlushRowBatchIfMaxRowsOrEOS(exec_state);
     }
 
-    std::sort(parent_streams.begin(), parent_streams.end(),
-              [this](size_t parent_a, size_t parent_b) {
-                auto time_a = GetTimeAtParentCursor(parent_a);
-                auto time_b = GetTimeAtParentCursor(parent_b);
-                return time_a < time_b || (time_a == time_b && parent_a < parent_b);
-              });
-
-    bool has_limit = parent_streams.size() > 1;
-    size_t parent = parent_streams[0];
-
-    while (parent_row_batches_[parent].size()) {
-      if (has_limit) {
-        size_t next_parent = parent_streams[1];
-        // If this time is greater than another parent stream's earliest time,
-        // or if they are the same but the first parent is at a smaller index, stop merging.
-        // This way rows are always stable with respect to input parent index.
-        if (GetTimeAtParentCursor(parent) > GetTimeAtParentCursor(next_parent) ||
-            (GetTimeAtParentCursor(parent) == GetTimeAtParentCursor(next_parent) &&
-             parent > next_parent)) {
-          break;
-        }
-      }
-
-      PL_RETURN_IF_ERROR(AppendRow(parent));
-
-      // Mark whether or not we hit the eos for this stream, and whether the row batch needs to be
-      // popped.
-      const auto& rb = parent_row_batches_[parent][0];
-      bool pop_row_batch = ++row_cursors_[parent] == static_cast<size_t>(rb.num_rows());
-      if (pop_row_batch && rb.eos()) {
-        flushed_parent_eoses_[parent] = true;
-      }
-
-      if (pop_row_batch) {
-        // Delete the top row batch from our buffer and update the cursor.
-        parent_row_batches_[parent].erase(parent_row_batches_[parent].begin());
-        row_cursors_[parent] = 0;
-        CacheNextRowBatch(parent);
-      }
-
-      // Flush the current RowBatch if necessary.
-      PL_RETURN_IF_ERROR(OptionallyFlushRowBatchIfMaxRowsOrEOS(exec_state));
+    // Copy the rows of the parent up to the earliest row of any other parent, or until the output
+    // batch is full.
+    auto& row_batches = parent_row_batches_[parent];
+    int64_t num_rows = row_batches.front().num_rows();
+    bool eos = row_batches.front().eos();
+    int64_t begin = row_cursors_[parent];
+    int64_t end = std::min(RunEnd(parent, merge_tree_.runner_up()),
+                           begin + static_cast<int64_t>(output_rows_per_batch_) - output_rows_);
+    AppendRows(parent, begin, end - begin);
+    row_cursors_[parent] = end;
+
+    if (end == num_rows) {
+      // Delete the top row batch from our buffer and update the cursor.
+      flushed_parent_eoses_[parent] = eos;
+      row_batches.pop_front();
+      row_cursors_[parent] = 0;
+      CacheNextRowBatch(parent);
+    }
+
+    // Flush the current RowBatch if necessary.
+    PL_RETURN_IF_ERROR(OptionallyFlushRowBatchIfMaxRowsOrEOS(exec_state));
+
+    if (!flushed_parent_eoses_[parent] && row_batches.empty()) {
+      return Status::OK();
     }
+    merge_tree_.ReplayWinner();
   }
   return Status::OK();
 }
@@ -244,7 +279,7 @@ void UnionNode::CacheNextRowBatch(size_t parent) {
     if (parent_row_batches_[parent][0].eos()) {
       flushed_parent_eoses_[parent] = true;
     }
-    parent_row_batches_[parent].erase(parent_row_batches_[parent].begin());
+    parent_row_batches_[parent].pop_front();
   }
   if (!parent_row_batches_[parent].size()) {
     return;
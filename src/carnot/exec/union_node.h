@@ -19,8 +19,8 @@
 #pragma once
 
 #include <arrow/array.h>
-#include <arrow/array/builder_base.h>
 #include <stddef.h>
+#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
@@ -28,6 +28,7 @@
 
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/loser_tree.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
@@ -48,15 +49,6 @@ class UnionNode : public ProcessingNode {
   UnionNode() = default;
   virtual ~UnionNode() = default;
 
-  // For the time ordered case: A MergeRow represents a row in an input row batch.
-  struct MergeRow {
-    size_t parent_index;
-    size_t row_batch_id;
-    size_t row_number;
-    types::Time64NSValue time;
-    bool end_of_row_batch;
-  };
-
   void disable_data_flush_timeout() { enable_data_flush_timeout_ = false; }
   void set_data_flush_timeout(const std::chrono::milliseconds& data_flush_timeout) {
     enable_data_flush_timeout_ = true;
@@ -88,10 +80,19 @@ class UnionNode : public ProcessingNode {
 
   // The items below are all for the time-ordered case.
 
+  // Orders parents by the time at their cursor. Ties are broken by the parent index, so that rows
+  // are stable with respect to the parent index. Parents that reached eos come last.
+  struct ParentCursorLess {
+    bool operator()(size_t parent_a, size_t parent_b) const;
+    const UnionNode* node;
+  };
+
   void CacheNextRowBatch(size_t parent);
-  Status InitializeColumnBuilders();
   types::Time64NSValue GetTimeAtParentCursor(size_t parent_index) const;
-  Status AppendRow(size_t parent);
+  // Returns the end of the run of rows of the parent, starting at its cursor, that come before the
+  // row at the cursor of next_parent in the output. The run ends at the end of the current batch.
+  int64_t RunEnd(size_t parent, size_t next_parent) const;
+  void AppendRows(size_t parent, int64_t offset, int64_t length);
   Status OptionallyFlushRowBatchIfMaxRowsOrEOS(ExecState* exec_state);
   Status OptionallyFlushRowBatchIfTimeout(ExecState* exec_state);
   Status FlushBatch(ExecState* exec_state);
@@ -101,11 +102,18 @@ class UnionNode : public ProcessingNode {
   // we just maintain the original row count to avoid copying the data.
   size_t output_rows_per_batch_;
 
-  // Column builders will flush a batch once they hit output_rows_per_batch_ rows.
-  std::vector<std::unique_ptr<arrow::ArrayBuilder>> column_builders_;
+  // The slices of the input columns that make up each column of the next output batch. They are
+  // concatenated when the batch is flushed, once it has output_rows_per_batch_ rows.
+  std::vector<arrow::ArrayVector> output_columns_;
+  int64_t output_rows_ = 0;
+
+  // Merges the parents k ways. Only valid during MergeData, while every parent that hasn't
+  // reached eos has a row batch.
+  LoserTree<ParentCursorLess> merge_tree_{ParentCursorLess{this}};
+  int64_t num_merge_runs_ = 0;
 
   // Hold onto the input row batches for every parent until we copy all of their data.
-  std::vector<std::vector<table_store::schema::RowBatch>> parent_row_batches_;
+  std::vector<std::deque<table_store::schema::RowBatch>> parent_row_batches_;
   // Keep track of where we are in the stream for each parent.
   // The row is always relative to the 'top' row batch that we have for each parent.
   std::vector<size_t> row_cursors_;
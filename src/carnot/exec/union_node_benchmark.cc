@@ -0,0 +1,114 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+#include <sole.hpp>
+
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/exec/union_node.h"
+#include "src/carnot/plan/operators.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/table_store.h"
+
+using px::carnot::exec::ExecState;
+using px::carnot::exec::MockMetricsStubGenerator;
+using px::carnot::exec::MockResultSinkStubGenerator;
+using px::carnot::exec::MockTraceStubGenerator;
+using px::table_store::schema::RowBatch;
+using px::table_store::schema::RowDescriptor;
+using px::types::DataType;
+
+// Merges one row batch from each input of a time ordered union, e.g. the streams of every PEM on
+// Kelvin. The rows of the inputs interleave in runs of state.range(1) rows. The same batches are
+// sent every iteration, since the merge doesn't depend on the times increasing across batches.
+// NOLINTNEXTLINE : runtime/references.
+void BM_UnionNodeOrderedMerge(benchmark::State& state) {
+  int64_t num_inputs = state.range(0);
+  int64_t run_length = state.range(1);
+  int64_t num_rows = 1024;
+
+  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+  auto exec_state = std::make_unique<ExecState>(func_registry.get(), table_store,
+                                                MockResultSinkStubGenerator,
+                                                MockMetricsStubGenerator, MockTraceStubGenerator,
+                                                sole::uuid4(), nullptr);
+
+  px::carnot::planpb::UnionOperator op_proto;
+  op_proto.add_column_names("time_");
+  op_proto.add_column_names("value");
+  op_proto.add_column_names("service");
+  op_proto.set_rows_per_batch(num_rows);
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    auto* mapping = op_proto.add_column_mappings();
+    for (int64_t col = 0; col < op_proto.column_names_size(); ++col) {
+      mapping->add_column_indexes(col);
+    }
+  }
+  auto plan_node = std::make_unique<px::carnot::plan::UnionOperator>(1);
+  PL_CHECK_OK(plan_node->Init(op_proto));
+
+  RowDescriptor rd({DataType::TIME64NS, DataType::INT64, DataType::STRING});
+  std::vector<RowBatch> input_rbs;
+  for (int64_t input = 0; input < num_inputs; ++input) {
+    std::vector<px::types::Time64NSValue> times(num_rows);
+    std::vector<px::types::Int64Value> values(num_rows);
+    std::vector<px::types::StringValue> services(num_rows);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      times[i] = ((i / run_length) * num_inputs + input) * run_length + i % run_length;
+      values[i] = i;
+      services[i] = "px-sock-shop/carts";
+    }
+    input_rbs.push_back(px::carnot::exec::RowBatchBuilder(rd, num_rows, /*eow*/ false,
+                                                          /*eos*/ false)
+                            .AddColumn<px::types::Time64NSValue>(times)
+                            .AddColumn<px::types::Int64Value>(values)
+                            .AddColumn<px::types::StringValue>(services)
+                            .get());
+  }
+
+  px::carnot::exec::UnionNode node;
+  node.disable_data_flush_timeout();
+  PL_CHECK_OK(node.Init(*plan_node, rd, std::vector<RowDescriptor>(num_inputs, rd)));
+  PL_CHECK_OK(node.Prepare(exec_state.get()));
+  PL_CHECK_OK(node.Open(exec_state.get()));
+
+  for (auto _ : state) {
+    for (int64_t input = 0; input < num_inputs; ++input) {
+      PL_CHECK_OK(node.ConsumeNext(exec_state.get(), input_rbs[input], input));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_inputs * num_rows);
+}
+
+BENCHMARK(BM_UnionNodeOrderedMerge)
+    ->Args({10, 1})
+    ->Args({10, 64})
+    ->Args({100, 1})
+    ->Args({100, 64})
+    ->Args({500, 1})
+    ->Args({500, 64})
+    ->Unit(benchmark::kMillisecond);
@@ -276,6 +276,51 @@ TEST_F(UnionNodeTest, ordered_full_overlap) {
       .Close();
 }
 
+// Runs of rows from the same parent are copied together, and ties go to the lower parent index.
+TEST_F(UnionNodeTest, ordered_runs) {
+  auto op_proto = planpb::testutils::CreateTestUnionOrderedPB();
+  plan_node_ = plan::UnionOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd_0({types::DataType::STRING, types::DataType::TIME64NS});
+  RowDescriptor input_rd_1({types::DataType::TIME64NS, types::DataType::STRING});
+
+  RowDescriptor output_rd({types::DataType::STRING, types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<UnionNode, plan::UnionOperator>(
+      *plan_node_, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+  tester.node()->disable_data_flush_timeout();
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 8, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({"A", "B", "C", "D", "E", "F", "G", "H"})
+                       .AddColumn<types::Time64NSValue>({0, 1, 2, 3, 4, 5, 6, 7})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 3, true, true)
+                       .AddColumn<types::Time64NSValue>({3, 3, 9})
+                       .AddColumn<types::StringValue>({"x", "y", "z"})
+                       .get(),
+                   1, 2)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, false, false)
+                          .AddColumn<types::StringValue>({"A", "B", "C", "D", "x"})
+                          .AddColumn<types::Time64NSValue>({0, 1, 2, 3, 3})
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, false, false)
+                          .AddColumn<types::StringValue>({"y", "E", "F", "G", "H"})
+                          .AddColumn<types::Time64NSValue>({3, 4, 5, 6, 7})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 2, true, true)
+                       .AddColumn<types::StringValue>({"I", "J"})
+                       .AddColumn<types::Time64NSValue>({9, 10})
+                       .get(),
+                   0, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<types::StringValue>({"I", "z", "J"})
+                          .AddColumn<types::Time64NSValue>({9, 9, 10})
+                          .get())
+      .Close();
+}
+
 TEST_F(UnionNodeTest, no_rows_parent) {
   auto op_proto = planpb::testutils::CreateTestUnionOrderedPB();
   plan_node_ = plan::UnionOperator::FromProto(op_proto, /*id*/ 1);
@@ -18,14 +18,188 @@
 
 #include "src/carnot/funcs/builtins/json_ops.h"
 
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+
+#include <limits>
+
 #include "src/carnot/udf/registry.h"
 
+DEFINE_bool(carnot_pluck_stop_at_key,
+            gflags::BoolFromEnv("PL_CARNOT_PLUCK_STOP_AT_KEY", false),
+            "Whether the pluck UDFs stop scanning the JSON input once they read the value of the "
+            "key, rather than validating the rest of it. Faster for large inputs, but malformed "
+            "JSON after the key is plucked from.");
+
 namespace px {
 namespace carnot {
 namespace builtins {
 
 using types::StringValue;
 
+namespace internal {
+namespace {
+
+// A rapidjson SAX handler that looks for a key of the root object. Returning false from a handler
+// stops the parse, which it does once the input turns out not to be an object, and, with
+// stop_at_value, as soon as the value of the key has been read.
+class PluckHandler {
+ public:
+  PluckHandler(std::string_view key, bool serialize, bool stop_at_value)
+      : key_(key), serialize_(serialize), stop_at_value_(stop_at_value), writer_(buffer_) {}
+
+  std::optional<JSONValue> Result() {
+    if (!done_) {
+      return std::nullopt;
+    }
+    if (serialize_ && value_.type != JSONValue::kString) {
+      value_.str.assign(buffer_.GetString(), buffer_.GetSize());
+    }
+    return std::move(value_);
+  }
+
+  bool Null() {
+    return Value(JSONValue::kNull, [this] { return writer_.Null(); });
+  }
+  bool Bool(bool b) {
+    return Value(JSONValue::kOther, [this, b] { return writer_.Bool(b); });
+  }
+  bool Int(int i) {
+    value_.int64_value = i;
+    return Value(JSONValue::kInt64, [this, i] { return writer_.Int(i); });
+  }
+  bool Uint(unsigned u) {
+    value_.int64_value = u;
+    return Value(JSONValue::kInt64, [this, u] { return writer_.Uint(u); });
+  }
+  bool Int64(int64_t i) {
+    value_.int64_value = i;
+    return Value(JSONValue::kInt64, [this, i] { return writer_.Int64(i); });
+  }
+  bool Uint64(uint64_t u) {
+    value_.int64_value = static_cast<int64_t>(u);
+    bool fits = u <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    return Value(fits ? JSONValue::kInt64 : JSONValue::kOther,
+                 [this, u] { return writer_.Uint64(u); });
+  }
+  bool Double(double d) {
+    value_.double_value = d;
+    return Value(JSONValue::kDouble, [this, d] { return writer_.Double(d); });
+  }
+  // Only used with kParseNumbersAsStringsFlag.
+  bool RawNumber(const char*, rapidjson::SizeType, bool) { return false; }
+  bool String(const char* str, rapidjson::SizeType length, bool) {
+    if (in_value_ && depth_ == 1) {
+      value_.str.assign(str, length);
+    }
+    return Value(JSONValue::kString, [this, str, length] { return writer_.String(str, length); });
+  }
+
+  bool StartObject() {
+    if (in_value_ && serialize_ && !writer_.StartObject()) {
+      return false;
+    }
+    ++depth_;
+    return true;
+  }
+  bool Key(const char* str, rapidjson::SizeType length, bool) {
+    if (in_value_) {
+      return !serialize_ || writer_.Key(str, length);
+    }
+    // The first of duplicate keys wins.
+    in_value_ = !done_ && depth_ == 1 && std::string_view(str, length) == key_;
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType) {
+    return EndContainer([this] { return writer_.EndObject(); });
+  }
+  bool StartArray() {
+    // The root must be an object.
+    if (depth_ == 0) {
+      return false;
+    }
+    if (in_value_ && serialize_ && !writer_.StartArray()) {
+      return false;
+    }
+    ++depth_;
+    return true;
+  }
+  bool EndArray(rapidjson::SizeType) {
+    return EndContainer([this] { return writer_.EndArray(); });
+  }
+
+ private:
+  template <typename TWriteFn>
+  bool Value(JSONValue::Type type, TWriteFn write_fn) {
+    if (!in_value_) {
+      // A scalar at the root isn't an object.
+      return depth_ > 0;
+    }
+    if (depth_ == 1) {
+      // The value of the key. Strings are kept unescaped rather than serialized.
+      if (serialize_ && type != JSONValue::kString && !write_fn()) {
+        return false;
+      }
+      value_.type = type;
+      return Found();
+    }
+    return !serialize_ || write_fn();
+  }
+
+  template <typename TWriteFn>
+  bool EndContainer(TWriteFn write_fn) {
+    --depth_;
+    if (!in_value_) {
+      return true;
+    }
+    if (serialize_ && !write_fn()) {
+      return false;
+    }
+    if (depth_ == 1) {
+      value_.type = JSONValue::kOther;
+      return Found();
+    }
+    return true;
+  }
+
+  bool Found() {
+    done_ = true;
+    in_value_ = false;
+    return !stop_at_value_;
+  }
+
+  const std::string_view key_;
+  const bool serialize_;
+  const bool stop_at_value_;
+  rapidjson::StringBuffer buffer_;
+  rapidjson::Writer<rapidjson::StringBuffer> writer_;
+
+  // The nesting depth of the current event, where the root object is at depth 1.
+  int depth_ = 0;
+  // Whether the events are part of the value of the key.
+  bool in_value_ = false;
+  bool done_ = false;
+  JSONValue value_;
+};
+
+}  // namespace
+
+std::optional<JSONValue> PluckJSON(std::string_view json, std::string_view key, bool serialize) {
+  bool stop_at_value = FLAGS_carnot_pluck_stop_at_key;
+  PluckHandler handler(key, serialize, stop_at_value);
+  rapidjson::MemoryStream stream(json.data(), json.size());
+  rapidjson::Reader reader;
+  auto result = reader.Parse(stream, handler);
+  // The parse fails with kParseErrorTermination when the handler stops it at the value, so then
+  // the status of the parse is ignored in favor of whether the handler found the value.
+  if (!stop_at_value && result.IsError()) {
+    return std::nullopt;
+  }
+  return handler.Result();
+}
+
+}  // namespace internal
+
 void RegisterJSONOpsOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<PluckUDF>("pluck");
   registry->RegisterOrDie<PluckAsInt64UDF>("pluck_int64");
@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -29,40 +31,53 @@
 #include "src/carnot/udf/registry.h"
 #include "src/carnot/udf/udf.h"
 
+DECLARE_bool(carnot_pluck_stop_at_key);
+
 namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+/**
+ * The value of a key of a JSON object, as found by PluckJSON.
+ */
+struct JSONValue {
+  enum Type { kNull, kString, kInt64, kDouble, kOther };
+  Type type = kNull;
+  // The unescaped string of kString values. For other types, the value serialized as JSON, if it
+  // was requested.
+  std::string str;
+  int64_t int64_value = 0;
+  double double_value = 0.0;
+};
+
+/**
+ * Finds the value of a key of a JSON object. Rather than parsing the input into a document, this
+ * scans it with a SAX reader, and nothing but the value of the key is materialized. The rest of the
+ * input is still scanned, so that malformed JSON isn't plucked from, unless
+ * --carnot_pluck_stop_at_key is set, in which case the scan stops as soon as the value has been
+ * read, and malformed JSON after the value isn't detected.
+ *
+ * @param serialize whether to serialize values that aren't strings into JSONValue::str.
+ * @return the value, or nullopt if the input isn't a JSON object or doesn't have the key.
+ */
+std::optional<JSONValue> PluckJSON(std::string_view json, std::string_view key, bool serialize);
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 To have proper support for JSON we need structs and nullable types.
 // Revisit when we have them.
 class PluckUDF : public udf::ScalarUDF {
  public:
-  StringValue Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+  StringValue Exec(FunctionContext*, StringViewValue in, StringViewValue key) {
+    auto value = internal::PluckJSON(in, key, /* serialize */ true);
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return "";
-    }
-    if (!d.IsObject()) {
+    if (!value.has_value() || value->type == internal::JSONValue::kNull) {
       return "";
     }
-    if (!d.HasMember(key.data())) {
-      return "";
-    }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return "";
-    }
-    if (plucked_value.IsString()) {
-      return plucked_value.GetString();
-    }
-
-    // This is robust to nested JSON.
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-    plucked_value.Accept(writer);
-    return sb.GetString();
+    // Values that aren't strings are serialized, which is robust to nested JSON.
+    return std::move(value->str);
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -86,27 +101,13 @@ class PluckUDF : public udf::ScalarUDF {
 
 class PluckAsInt64UDF : public udf::ScalarUDF {
  public:
-  Int64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+  Int64Value Exec(FunctionContext*, StringViewValue in, StringViewValue key) {
+    auto value = internal::PluckJSON(in, key, /* serialize */ false);
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return 0;
-    }
-    if (!d.IsObject()) {
-      return 0;
-    }
-    if (!d.HasMember(key.data())) {
-      return 0;
-    }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
+    if (!value.has_value() || value->type != internal::JSONValue::kInt64) {
       return 0;
     }
-    if (plucked_value.IsInt64()) {
-      return plucked_value.GetInt64();
-    }
-    return 0;
+    return value->int64_value;
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -130,27 +131,13 @@ class PluckAsInt64UDF : public udf::ScalarUDF {
 
 class PluckAsFloat64UDF : public udf::ScalarUDF {
  public:
-  Float64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+  Float64Value Exec(FunctionContext*, StringViewValue in, StringViewValue key) {
+    auto value = internal::PluckJSON(in, key, /* serialize */ false);
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return 0.0;
-    }
-    if (!d.IsObject()) {
+    if (!value.has_value() || value->type != internal::JSONValue::kDouble) {
       return 0.0;
     }
-    if (!d.HasMember(key.data())) {
-      return 0.0;
-    }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return 0.0;
-    }
-    if (plucked_value.IsDouble()) {
-      return plucked_value.GetDouble();
-    }
-    return 0.0;
+    return value->double_value;
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -60,6 +60,38 @@ TEST(JSONOps, PluckUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "str_key").Expect("");
 }
 
+TEST(JSONOps, PluckUDF_only_root_keys) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  constexpr char kJSON[] = R"({"a": {"b": 1, "c": [1, {"b": 2}]}, "b": [true, null], "c": null})";
+  udf_tester.ForInput(kJSON, "a").Expect(R"({"b":1,"c":[1,{"b":2}]})");
+  udf_tester.ForInput(kJSON, "b").Expect("[true,null]");
+  udf_tester.ForInput(kJSON, "c").Expect("");
+  udf_tester.ForInput(kJSON, "d").Expect("");
+  // Keys are matched after unescaping, and the first of duplicate keys wins.
+  udf_tester.ForInput(R"({"k\u0065y": "v1", "key": "v2"})", "key").Expect("v1");
+}
+
+TEST(JSONOps, PluckUDF_malformed_after_key) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  // By default the whole input is validated, so nothing is plucked from malformed JSON.
+  udf_tester.ForInput(R"({"a": "b\"c", "d": )", "a").Expect("");
+  udf_tester.ForInput(R"({"a": {"b": 1}, "d": )", "a").Expect("");
+  udf_tester.ForInput(R"({"a": "b\"c"} trailing)", "a").Expect("");
+  udf_tester.ForInput(R"({"a": "b\"c", "d": 1})", "a").Expect("b\"c");
+}
+
+TEST(JSONOps, PluckUDF_stops_at_key) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_carnot_pluck_stop_at_key = true;
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  // The input is only scanned up to the value of the key.
+  udf_tester.ForInput(R"({"a": "b\"c", "d": )", "a").Expect("b\"c");
+  udf_tester.ForInput(R"({"a": {"b": 1}, "d": )", "a").Expect(R"({"b":1})");
+  udf_tester.ForInput(R"({"a": "b\"c", "d": )", "d").Expect("");
+  // The first of duplicate keys still wins.
+  udf_tester.ForInput(R"({"key": "v1", "key": "v2"})", "key").Expect("v1");
+}
+
 TEST(JSONOps, PluckAsInt64UDF) {
   auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
   udf_tester.ForInput(kTestJSONStr, "str_key").Expect(0);
@@ -68,6 +100,16 @@ TEST(JSONOps, PluckAsInt64UDF) {
   udf_tester.ForInput(kTestJSONStr, "str_plain").Expect(0);
 }
 
+TEST(JSONOps, PluckAsInt64UDF_integer_types) {
+  auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
+  constexpr char kJSON[] =
+      R"({"neg": -5, "small": 5, "large": 9223372036854775807, "too_large": 18446744073709551615})";
+  udf_tester.ForInput(kJSON, "neg").Expect(-5);
+  udf_tester.ForInput(kJSON, "small").Expect(5);
+  udf_tester.ForInput(kJSON, "large").Expect(9223372036854775807);
+  udf_tester.ForInput(kJSON, "too_large").Expect(0);
+}
+
 TEST(JSONOps, PluckAsInt64UDF_bad_input_return_empty) {
   auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
   udf_tester.ForInput("sdasdsa", "int64_key").Expect(0);
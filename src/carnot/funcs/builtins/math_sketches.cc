@@ -18,13 +18,160 @@
 
 #include "src/carnot/funcs/builtins/math_sketches.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
 namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+namespace {
+constexpr uint8_t kTDigestFormatVersion = 1;
+constexpr size_t kCentroidSize = 2 * sizeof(double);
+
+Status ValidateSerializedTDigest(std::string_view data) {
+  if (data.empty() || static_cast<uint8_t>(data[0]) != kTDigestFormatVersion ||
+      (data.size() - 1) % kCentroidSize != 0) {
+    return error::InvalidArgument("Invalid serialized t-digest of size $0", data.size());
+  }
+  return Status::OK();
+}
+
+// The mean and weight of the i-th centroid of a valid serialized t-digest.
+std::pair<double, double> CentroidAt(std::string_view data, size_t i) {
+  const char* pos = data.data() + 1 + i * kCentroidSize;
+  double mean;
+  double weight;
+  std::memcpy(&mean, pos, sizeof(double));
+  std::memcpy(&weight, pos + sizeof(double), sizeof(double));
+  return {mean, weight};
+}
+}  // namespace
+
+std::string SerializeTDigest(tdigest::TDigest* digest) {
+  // Compressing merges the unprocessed values into the centroids.
+  digest->compress();
+  const auto& centroids = digest->processed();
+  std::string data(1 + centroids.size() * kCentroidSize, '\0');
+  data[0] = static_cast<char>(kTDigestFormatVersion);
+  char* pos = data.data() + 1;
+  for (const auto& centroid : centroids) {
+    double mean = centroid.mean();
+    double weight = centroid.weight();
+    std::memcpy(pos, &mean, sizeof(double));
+    std::memcpy(pos + sizeof(double), &weight, sizeof(double));
+    pos += kCentroidSize;
+  }
+  return data;
+}
+
+Status DeserializeTDigest(std::string_view data, tdigest::TDigest* digest) {
+  PL_RETURN_IF_ERROR(ValidateSerializedTDigest(data));
+  size_t num_centroids = (data.size() - 1) / kCentroidSize;
+  for (size_t i = 0; i < num_centroids; ++i) {
+    auto [mean, weight] = CentroidAt(data, i);
+    digest->add(mean, weight);
+  }
+  return Status::OK();
+}
+
+StatusOr<double> SerializedTDigestQuantile(std::string_view data, double q) {
+  PL_RETURN_IF_ERROR(ValidateSerializedTDigest(data));
+  size_t num_centroids = (data.size() - 1) / kCentroidSize;
+  if (num_centroids == 0 || q < 0 || q > 1) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  double total_weight = 0;
+  for (size_t i = 0; i < num_centroids; ++i) {
+    total_weight += CentroidAt(data, i).second;
+  }
+
+  // The centroids are serialized in the order of their means. Each centroid's weight is centered
+  // on its mean, and the quantile is interpolated between the means of the two centroids whose
+  // centers are around the index. Below the center of the first centroid and above the center of
+  // the last one, it's the mean of that centroid, which is the minimum or maximum value that the
+  // t-digest was given once it was serialized.
+  double index = q * total_weight;
+  auto [mean, weight] = CentroidAt(data, 0);
+  double center = weight / 2;
+  if (index <= center) {
+    return mean;
+  }
+  for (size_t i = 1; i < num_centroids; ++i) {
+    auto [next_mean, next_weight] = CentroidAt(data, i);
+    double next_center = center + weight / 2 + next_weight / 2;
+    if (index <= next_center) {
+      double x = (mean * (next_center - index) + next_mean * (index - center)) /
+                 (next_center - center);
+      return std::clamp(x, std::min(mean, next_mean), std::max(mean, next_mean));
+    }
+    mean = next_mean;
+    weight = next_weight;
+    center = next_center;
+  }
+  return mean;
+}
+
+int64_t HyperLogLog::Estimate() const {
+  constexpr double m = kNumRegisters;
+  double inverse_sum = 0;
+  int num_zeros = 0;
+  for (uint8_t reg : registers_) {
+    inverse_sum += std::ldexp(1.0, -reg);
+    num_zeros += reg == 0;
+  }
+  constexpr double alpha = 0.7213 / (1 + 1.079 / m);
+  double estimate = alpha * m * m / inverse_sum;
+  // For small cardinalities many registers are still empty, and linear counting is more accurate.
+  // The hashes are 64 bits, so there's no need for a large range correction.
+  if (estimate <= 2.5 * m && num_zeros > 0) {
+    estimate = m * std::log(m / num_zeros);
+  }
+  return std::llround(estimate);
+}
+
+namespace {
+constexpr uint8_t kHyperLogLogFormatVersion = 1;
+}  // namespace
+
+std::string HyperLogLog::Serialize() const {
+  std::string data(1 + kNumRegisters, '\0');
+  data[0] = static_cast<char>(kHyperLogLogFormatVersion);
+  std::memcpy(data.data() + 1, registers_.data(), kNumRegisters);
+  return data;
+}
+
+Status HyperLogLog::MergeSerialized(std::string_view data) {
+  if (data.size() != 1 + kNumRegisters ||
+      static_cast<uint8_t>(data[0]) != kHyperLogLogFormatVersion) {
+    return error::InvalidArgument("Invalid serialized HyperLogLog of size $0", data.size());
+  }
+  for (size_t i = 0; i < kNumRegisters; ++i) {
+    registers_[i] = std::max(registers_[i], static_cast<uint8_t>(data[1 + i]));
+  }
+  return Status::OK();
+}
+
+}  // namespace internal
+
 void RegisterMathSketchesOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<QuantilesUDA<types::Int64Value>>("quantiles");
   registry->RegisterOrDie<QuantilesUDA<types::Float64Value>>("quantiles");
+  registry->RegisterOrDie<QuantilesSketchUDA<types::Int64Value>>("quantiles_sketch");
+  registry->RegisterOrDie<QuantilesSketchUDA<types::Float64Value>>("quantiles_sketch");
+  registry->RegisterOrDie<QuantileUDF>("quantile");
+
+  registry->RegisterOrDie<ApproxCountDistinctUDA<types::BoolValue>>("approx_count_distinct");
+  registry->RegisterOrDie<ApproxCountDistinctUDA<types::Int64Value>>("approx_count_distinct");
+  registry->RegisterOrDie<ApproxCountDistinctUDA<types::UInt128Value>>("approx_count_distinct");
+  registry->RegisterOrDie<ApproxCountDistinctUDA<types::Float64Value>>("approx_count_distinct");
+  registry->RegisterOrDie<ApproxCountDistinctUDA<types::Time64NSValue>>("approx_count_distinct");
+  registry->RegisterOrDie<ApproxCountDistinctUDA<types::StringViewValue>>("approx_count_distinct");
 }
 
 }  // namespace builtins
@@ -17,10 +17,17 @@
  */
 
 #pragma once
+#include <farmhash.h>
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
 #include "src/carnot/udf/registry.h"
 #include "src/shared/types/types.h"
 #include "tdigest/tdigest.h"
@@ -29,14 +36,53 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+constexpr double kQuantilesCompression = 1000;
+
+/**
+ * Serializes a t-digest into a compact binary form: a version byte, followed by the mean and
+ * weight of each of its centroids, as doubles.
+ */
+std::string SerializeTDigest(tdigest::TDigest* digest);
+
+/**
+ * Adds the centroids of a t-digest serialized by SerializeTDigest to the given digest.
+ */
+Status DeserializeTDigest(std::string_view data, tdigest::TDigest* digest);
+
+/**
+ * Reads the given quantile of a t-digest serialized by SerializeTDigest directly from its
+ * centroids, the same way as tdigest::TDigest::quantile. This avoids building a t-digest, which
+ * allocates buffers for all of its potential centroids.
+ * @return the quantile, or NaN if q isn't between 0 and 1 or the t-digest is empty.
+ */
+StatusOr<double> SerializedTDigestQuantile(std::string_view data, double q);
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 Replace this when we add support for structs.
 template <typename TArg>
 class QuantilesUDA : public udf::UDA {
  public:
-  QuantilesUDA() : digest_(1000) {}
+  QuantilesUDA() : digest_(internal::kQuantilesCompression) {}
   void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
   void Merge(FunctionContext*, const QuantilesUDA& other) { digest_.merge(&other.digest_); }
 
+  // The digest is serialized so that the aggregate can be split into partial aggregates on each
+  // PEM, which are merged on Kelvin.
+  StringValue Serialize(FunctionContext*) { return internal::SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    return internal::DeserializeTDigest(data, &digest_);
+  }
+
+  // The t-digest reserves room for 2 * compression merged and 8 * compression unmerged centroids,
+  // of two doubles each, up front.
+  static constexpr int64_t StateBytesEstimate() {
+    return 10 * static_cast<int64_t>(internal::kQuantilesCompression) * 2 * sizeof(double);
+  }
+
   StringValue Finalize(FunctionContext*) {
     rapidjson::Document d;
     d.SetObject();
@@ -81,6 +127,149 @@ class QuantilesUDA : public udf::UDA {
   tdigest::TDigest digest_;
 };
 
+/**
+ * QuantilesSketchUDA returns the t-digest itself, rather than a fixed set of quantiles, so that
+ * any quantile can be read from it with QuantileUDF, without a round trip through JSON.
+ */
+template <typename TArg>
+class QuantilesSketchUDA : public QuantilesUDA<TArg> {
+ public:
+  StringValue Finalize(FunctionContext* ctx) { return this->Serialize(ctx); }
+
+  void Merge(FunctionContext* ctx, const QuantilesSketchUDA& other) {
+    QuantilesUDA<TArg>::Merge(ctx, other);
+  }
+
+  static udf::InfRuleVec SemanticInferenceRules() { return {}; }
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder("Approximates the distribution of the aggregated data as a sketch.")
+        .Details(
+            "Computes a [tdigest](https://github.com/tdunning/t-digest) of the aggregated data, "
+            "which can be passed to `px.quantile` to get any quantile of the data. Unlike "
+            "`px.quantiles`, this doesn't serialize a fixed set of quantiles to JSON.")
+        .Example(R"doc(
+        | df = df.agg(latency_sketch=('latency_ms', px.quantiles_sketch))
+        | df.p99 = px.quantile(df.latency_sketch, 0.99)
+        )doc")
+        .Arg("val", "The data to calculate the quantiles distribution.")
+        .Returns("The sketch of the distribution, in a binary format.");
+  }
+};
+
+class QuantileUDF : public udf::ScalarUDF {
+ public:
+  Float64Value Exec(FunctionContext*, StringViewValue sketch, Float64Value q) {
+    auto quantile_or_s = internal::SerializedTDigestQuantile(sketch, q.val);
+    // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
+    if (!quantile_or_s.ok()) {
+      return 0.0;
+    }
+    return quantile_or_s.ConsumeValueOrDie();
+  }
+
+  static udf::ScalarUDFDocBuilder Doc() {
+    return udf::ScalarUDFDocBuilder("Gets a quantile from a quantiles sketch.")
+        .Details(
+            "Approximates the given quantile of the data aggregated by `px.quantiles_sketch`. "
+            "Returns 0.0 if the sketch is invalid.")
+        .Example(R"doc(
+        | df = df.agg(latency_sketch=('latency_ms', px.quantiles_sketch))
+        | df.p99 = px.quantile(df.latency_sketch, 0.99)
+        )doc")
+        .Arg("sketch", "The sketch returned by `px.quantiles_sketch`.")
+        .Arg("q", "The quantile to get, between 0 and 1.")
+        .Returns("The approximate value of the quantile.");
+  }
+};
+
+namespace internal {
+
+/**
+ * HyperLogLog estimates the number of distinct values it was given, from the maximum number of
+ * leading zeros of their hashes. The hash selects one of 2^kPrecision registers, and the register
+ * keeps the maximum rank (leading zeros + 1) of the rest of the hash. The state is a fixed
+ * kNumRegisters bytes regardless of the number of values, and merging is a register-wise max, so
+ * it can be computed in parts and merged. The standard error is 1.04 / sqrt(kNumRegisters), i.e.
+ * 1.6%.
+ */
+class HyperLogLog {
+ public:
+  static constexpr int kPrecision = 12;
+  static constexpr size_t kNumRegisters = size_t{1} << kPrecision;
+
+  void AddHash(uint64_t hash) {
+    size_t idx = hash >> (64 - kPrecision);
+    uint64_t rest = hash << kPrecision;
+    auto rank = static_cast<uint8_t>(rest == 0 ? 64 - kPrecision + 1 : __builtin_clzll(rest) + 1);
+    registers_[idx] = std::max(registers_[idx], rank);
+  }
+
+  void Merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+      registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+  }
+
+  int64_t Estimate() const;
+
+  /**
+   * Serializes the HyperLogLog as a version byte followed by the registers.
+   */
+  std::string Serialize() const;
+
+  /**
+   * Merges a HyperLogLog serialized by Serialize into this one.
+   */
+  Status MergeSerialized(std::string_view data);
+
+ private:
+  std::array<uint8_t, kNumRegisters> registers_ = {};
+};
+
+}  // namespace internal
+
+template <typename TArg>
+class ApproxCountDistinctUDA : public udf::UDA {
+ public:
+  void Update(FunctionContext*, TArg val) { hll_.AddHash(Hash(val)); }
+  void Merge(FunctionContext*, const ApproxCountDistinctUDA& other) { hll_.Merge(other.hll_); }
+  Int64Value Finalize(FunctionContext*) { return hll_.Estimate(); }
+  static constexpr int64_t StateBytesEstimate() { return sizeof(internal::HyperLogLog); }
+
+  StringValue Serialize(FunctionContext*) { return hll_.Serialize(); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    return hll_.MergeSerialized(data);
+  }
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder("Approximates the number of distinct values in the aggregate group.")
+        .Details(
+            "Estimates the number of distinct values using "
+            "[HyperLogLog](https://en.wikipedia.org/wiki/HyperLogLog), with a standard error of "
+            "about 1.6%. Unlike grouping by the values and counting the groups, it uses a few KB "
+            "of memory per group regardless of the number of distinct values, and can be "
+            "partially computed on each PEM.")
+        .Example("df = df.agg(num_remote_addrs=('remote_addr', px.approx_count_distinct))")
+        .Arg("arg", "The values to count the distinct values of.")
+        .Returns("The approximate number of distinct values.");
+  }
+
+ private:
+  // The hash must be the same on every agent, since partial aggregates are merged across them.
+  static uint64_t Hash(const TArg& val) {
+    if constexpr (std::is_same_v<TArg, types::StringViewValue>) {
+      return ::util::Hash64(val.data(), val.size());
+    } else {
+      auto native_val = val.val;
+      return ::util::Hash64(reinterpret_cast<const char*>(&native_val), sizeof(native_val));
+    }
+  }
+
+  internal::HyperLogLog hll_;
+};
+
 void RegisterMathSketchesOrDie(udf::Registry* registry);
 
 }  // namespace builtins
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "src/carnot/funcs/builtins/json_ops.h"
+#include "src/carnot/funcs/builtins/math_sketches.h"
+#include "src/common/benchmark/benchmark.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+// Adds range(0) random latencies to the UDA.
+template <typename TUDA>
+// NOLINTNEXTLINE : runtime/references.
+void AddLatencies(benchmark::State& state, TUDA* uda) {
+  std::mt19937 gen(0);
+  std::lognormal_distribution<double> dist(3.0, 1.0);
+  for (int i = 0; i < state.range(0); ++i) {
+    uda->Update(nullptr, dist(gen));
+  }
+}
+
+// The cost of the partial aggregate that a PEM sends to Kelvin, and of merging it there.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_QuantilesSerializeMerge(benchmark::State& state) {
+  QuantilesUDA<types::Float64Value> partial;
+  AddLatencies(state, &partial);
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    auto data = partial.Serialize(nullptr);
+    QuantilesUDA<types::Float64Value> merged;
+    PL_CHECK_OK(merged.Deserialize(nullptr, data));
+    benchmark::DoNotOptimize(merged);
+    bytes = data.size();
+  }
+  state.counters["serialized_bytes"] = bytes;
+}
+
+// Reads p99 from the JSON quantiles, as px.pluck_float64(px.quantiles(...), 'p99') does.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_QuantilesJSONPluck(benchmark::State& state) {
+  QuantilesUDA<types::Float64Value> uda;
+  AddLatencies(state, &uda);
+  PluckAsFloat64UDF pluck;
+  for (auto _ : state) {
+    auto json = uda.Finalize(nullptr);
+    benchmark::DoNotOptimize(pluck.Exec(nullptr, json, "p99"));
+  }
+}
+
+// Reads p99 from the sketch, as px.quantile(px.quantiles_sketch(...), 0.99) does.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_QuantilesSketch(benchmark::State& state) {
+  QuantilesSketchUDA<types::Float64Value> uda;
+  AddLatencies(state, &uda);
+  QuantileUDF quantile;
+  for (auto _ : state) {
+    auto sketch = uda.Finalize(nullptr);
+    benchmark::DoNotOptimize(quantile.Exec(nullptr, sketch, 0.99));
+  }
+}
+
+BENCHMARK(BM_QuantilesSerializeMerge)->RangeMultiplier(8)->Range(8, 1 << 18);
+BENCHMARK(BM_QuantilesJSONPluck)->RangeMultiplier(8)->Range(8, 1 << 18);
+BENCHMARK(BM_QuantilesSketch)->RangeMultiplier(8)->Range(8, 1 << 18);
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
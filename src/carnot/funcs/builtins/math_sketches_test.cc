@@ -19,9 +19,13 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 
+#include <cmath>
+#include <random>
+
 #include "src/carnot/funcs/builtins/math_sketches.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/common/testing/testing.h"
 
 namespace px {
 namespace carnot {
@@ -69,6 +73,111 @@ TEST(MathSketches, quantiles_int64) {
   EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6);
 }
 
+TEST(MathSketches, quantiles_serialize) {
+  auto uda_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  uda_tester.ForInput(1.234).ForInput(2.442).ForInput(1.04);
+  auto other_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  other_tester.ForInput(5.322).ForInput(6.333);
+
+  // Merging the serialized partial aggregate is the same as aggregating all of the inputs.
+  ASSERT_OK(uda_tester.Deserialize(other_tester.Serialize()));
+  auto res = uda_tester.Result();
+  rapidjson::Document d;
+  d.Parse(res.data());
+  EXPECT_DOUBLE_EQ(d["p01"].GetDouble(), 1.04);
+  EXPECT_DOUBLE_EQ(d["p50"].GetDouble(), 2.442);
+  EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6.333);
+}
+
+TEST(MathSketches, quantiles_deserialize_invalid) {
+  auto uda_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  EXPECT_NOT_OK(uda_tester.Deserialize(""));
+  EXPECT_NOT_OK(uda_tester.Deserialize(std::string(1, '\x7f')));
+  EXPECT_NOT_OK(uda_tester.Deserialize(std::string(4, '\x01')));
+}
+
+TEST(MathSketches, quantile_of_sketch) {
+  auto uda_tester = udf::UDATester<QuantilesSketchUDA<types::Int64Value>>();
+  auto sketch = uda_tester.ForInput(1)
+                    .ForInput(2)
+                    .ForInput(2)
+                    .ForInput(1)
+                    .ForInput(1)
+                    .ForInput(5)
+                    .ForInput(6)
+                    .Result();
+
+  auto udf_tester = udf::UDFTester<QuantileUDF>();
+  udf_tester.ForInput(sketch, 0.01).Expect(1);
+  udf_tester.ForInput(sketch, 0.5).Expect(2);
+  udf_tester.ForInput(sketch, 0.9).Expect(5.7999999999999998);
+  udf_tester.ForInput(sketch, 0.99).Expect(6);
+  udf_tester.ForInput("not a sketch", 0.5).Expect(0.0);
+}
+
+TEST(MathSketches, serialized_tdigest_quantile) {
+  tdigest::TDigest digest(internal::kQuantilesCompression);
+  std::mt19937 gen(0);
+  std::exponential_distribution<double> dist(1.0);
+  for (int i = 0; i < 100000; ++i) {
+    digest.add(dist(gen));
+  }
+  auto data = internal::SerializeTDigest(&digest);
+
+  // Reading the serialized centroids gives the same quantiles as the t-digest.
+  for (double q : {0.0, 0.001, 0.01, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+    ASSERT_OK_AND_ASSIGN(double quantile, internal::SerializedTDigestQuantile(data, q));
+    EXPECT_NEAR(digest.quantile(q), quantile, 1e-9) << q;
+  }
+  ASSERT_OK_AND_ASSIGN(double quantile, internal::SerializedTDigestQuantile(data, 1.5));
+  EXPECT_TRUE(std::isnan(quantile));
+  EXPECT_NOT_OK(internal::SerializedTDigestQuantile("not a sketch", 0.5));
+}
+
+// The UDAs are used directly rather than with UDATester, which keeps a copy of the UDA per input.
+TEST(MathSketches, approx_count_distinct) {
+  ApproxCountDistinctUDA<types::Int64Value> uda;
+  EXPECT_EQ(0, uda.Finalize(nullptr).val);
+  for (int i = 0; i < 100; ++i) {
+    // Duplicates don't change the estimate.
+    uda.Update(nullptr, i);
+    uda.Update(nullptr, i);
+  }
+  // Small cardinalities are counted exactly, or almost.
+  EXPECT_NEAR(100, uda.Finalize(nullptr).val, 1);
+
+  for (int i = 100; i < 100000; ++i) {
+    uda.Update(nullptr, i);
+  }
+  EXPECT_NEAR(100000, uda.Finalize(nullptr).val, 100000 * 0.05);
+}
+
+TEST(MathSketches, approx_count_distinct_string) {
+  ApproxCountDistinctUDA<types::StringViewValue> uda;
+  for (int i = 0; i < 10000; ++i) {
+    uda.Update(nullptr, absl::StrCat("10.0.", i % 5000));
+  }
+  EXPECT_NEAR(5000, uda.Finalize(nullptr).val, 5000 * 0.05);
+}
+
+TEST(MathSketches, approx_count_distinct_partial) {
+  ApproxCountDistinctUDA<types::Int64Value> uda;
+  ApproxCountDistinctUDA<types::Int64Value> other;
+  for (int i = 0; i < 20000; ++i) {
+    uda.Update(nullptr, i);
+    // Half of the values overlap with the first partial aggregate.
+    other.Update(nullptr, i + 10000);
+  }
+  auto data = other.Serialize(nullptr);
+  EXPECT_EQ(1 + internal::HyperLogLog::kNumRegisters, data.size());
+
+  ApproxCountDistinctUDA<types::Int64Value> merged;
+  ASSERT_OK(merged.Deserialize(nullptr, data));
+  merged.Merge(nullptr, uda);
+  EXPECT_NEAR(30000, merged.Finalize(nullptr).val, 30000 * 0.05);
+  EXPECT_NOT_OK(merged.Deserialize(nullptr, "abc"));
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -17,6 +17,7 @@
  */
 #include <algorithm>
 #include <map>
+#include <numeric>
 #include <vector>
 
 #include <absl/strings/numbers.h>
@@ -321,19 +322,39 @@ static std::map<Tag::Type, std::string_view> type_to_sub_str_ = {
     SUB_STR(Tag::Type::IMEISV),   SUB_STR(Tag::Type::IBAN),      SUB_STR(Tag::Type::SSN),
 };
 
+// The prefilter DFA holds the states of all of the patterns at once, so it gets a larger budget
+// than the default used by the individual taggers.
+static constexpr int64_t kPrefilterMaxMem = 32 << 20;
+
+template <Tag::Type TTag>
+Status RedactPIIUDF::AddRegexTagger() {
+  std::string error;
+  if (prefilter_->Add(TagTypeTraits<TTag>::BuildRegexPattern(), &error) < 0) {
+    return error::InvalidArgument("Invalid PII regex: $0", error);
+  }
+  taggers_.push_back(std::make_unique<RegexTagger<TTag>>());
+  return Status::OK();
+}
+
 Status RedactPIIUDF::Init(FunctionContext*) {
+  RE2::Options options;
+  options.set_max_mem(kPrefilterMaxMem);
+  prefilter_ = std::make_unique<RE2::Set>(options, RE2::UNANCHORED);
   // Order is important here. For example, IPv6 has to go before IPv4 to support IPv6 addresses with
   // the lowest 32 bits written like IPv4. Also Email has to go before IP since IP addresses can be
   // part of valid emails.
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IBAN>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::EMAIL_ADDR>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IPv6>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IPv4>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::MAC_ADDR>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IMEI>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IMEISV>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::CC_NUMBER>>());
-  taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::SSN>>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::IBAN>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::EMAIL_ADDR>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::IPv6>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::IPv4>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::MAC_ADDR>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::IMEI>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::IMEISV>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::CC_NUMBER>());
+  PL_RETURN_IF_ERROR(AddRegexTagger<Tag::Type::SSN>());
+  if (!prefilter_->Compile()) {
+    return error::Internal("Failed to compile the PII prefilter.");
+  }
   return Status::OK();
 }
 
@@ -393,9 +414,25 @@ static inline std::string ReplaceTagsWithSubs(std::string input, std::vector<Tag
 }
 
 StringValue RedactPIIUDF::Exec(FunctionContext*, StringValue input) {
+  // Scan the input once for all of the patterns, and only run the taggers (and their validators)
+  // whose pattern occurs in it. Most inputs contain no PII at all, and are returned as is.
+  std::vector<int> matched;
+  RE2::Set::ErrorInfo error_info;
+  if (!prefilter_->Match(input, &matched, &error_info)) {
+    if (error_info.kind == RE2::Set::kNoError) {
+      return input;
+    }
+    // The DFA ran out of memory on this input, so fall back to running every tagger.
+    matched.resize(taggers_.size());
+    std::iota(matched.begin(), matched.end(), 0);
+  }
+  // The taggers run in their original order, so that the tags (and the choice between overlapping
+  // tags of the same size) are the same as without the prefilter.
+  std::sort(matched.begin(), matched.end());
+
   std::vector<Tag> tags;
-  for (const auto& tagger : taggers_) {
-    auto s = tagger->AddTags(&input, &tags);
+  for (int idx : matched) {
+    auto s = taggers_[idx]->AddTags(&input, &tags);
     if (!s.ok()) {
       return "Invalid regex: " + s.msg();
     }
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/utils.h"
 #include "src/shared/types/types.h"
@@ -93,7 +94,13 @@ class RedactPIIUDF : public udf::ScalarUDF {
   }
 
  private:
+  template <Tag::Type TTag>
+  Status AddRegexTagger();
+
   std::vector<std::unique_ptr<Tagger>> taggers_;
+  // Matches the patterns of all of the taggers in a single scan of the input. The i-th pattern of
+  // the set is the pattern of taggers_[i].
+  std::unique_ptr<RE2::Set> prefilter_;
 };
 
 void RegisterPIIOpsOrDie(udf::Registry* registry);
@@ -51,7 +51,30 @@ static void BM_RedactPII(benchmark::State& state) {
                           static_cast<int64_t>(state.iterations()));
 }
 
+static constexpr std::string_view no_pii_chunk = R"input(
+        {"method": "GET", "path": "/api/v1/users", "status": "ok", "latency_ms": 12},
+        {"method": "POST", "path": "/api/v1/orders", "status": "created", "items": 3},
+)input";
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_RedactPIINoPII(benchmark::State& state) {
+  RedactPIIUDF udf;
+  PL_UNUSED(udf.Init(nullptr));
+
+  std::string text_chunk(no_pii_chunk);
+  std::string text;
+  for (int i = 0; i < state.range(0); i++) {
+    text += text_chunk;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, text));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(text.length()) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
 BENCHMARK(BM_RedactPII)->RangeMultiplier(2)->Range(1, 12);
+BENCHMARK(BM_RedactPIINoPII)->RangeMultiplier(2)->Range(1, 12);
 
 }  // namespace builtins
 }  // namespace carnot
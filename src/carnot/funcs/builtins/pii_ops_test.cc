@@ -262,6 +262,18 @@ TEST_P(RedactionTest, basic) {
   udf::UDFTester<RedactPIIUDF>().Init().ForInput(test_case.first).Expect(test_case.second);
 }
 
+TEST(RedactPIIUDF, only_matching_taggers_run) {
+  auto udf_tester = udf::UDFTester<RedactPIIUDF>();
+  udf_tester.Init();
+  // No pattern matches, so the input is returned as is.
+  udf_tester.ForInput("GET /api/v1/users?limit=10 HTTP/1.1")
+      .Expect("GET /api/v1/users?limit=10 HTTP/1.1");
+  // The card number pattern matches, but the number fails the Luhn check.
+  udf_tester.ForInput("card: 4111 1111 1111 1112").Expect("card: 4111 1111 1111 1112");
+  udf_tester.ForInput("card: 4111 1111 1111 1112, ip: 10.0.0.1")
+      .Expect("card: 4111 1111 1111 1112, ip: <REDACTED_IPV4>");
+}
+
 INSTANTIATE_TEST_SUITE_P(TemplatedRedactionTest, RedactionTest,
                          ::testing::ValuesIn(TestCaseGen({IBANGen(), IPv4Gen(), IPv6Gen(),
                                                           EmailGen(), CCGen(), IMEIGen(), SSNGen(),
@@ -46,11 +46,11 @@ class RegexMatchUDF : public udf::ScalarUDF {
     regex_ = std::make_unique<re2::RE2>(regex, opts);
     return Status::OK();
   }
-  BoolValue Exec(FunctionContext*, StringValue input) {
+  BoolValue Exec(FunctionContext*, StringViewValue input) {
     if (regex_->error_code() != RE2::NoError) {
       return false;
     }
-    return RE2::FullMatch(input, *regex_);
+    return RE2::FullMatch(re2::StringPiece(input.data(), input.size()), *regex_);
   }
 
   static udf::ScalarUDFDocBuilder Doc() {
@@ -31,7 +31,7 @@ namespace builtins {
 
 class ContainsUDF : public udf::ScalarUDF {
  public:
-  BoolValue Exec(FunctionContext*, StringValue b1, StringValue b2) {
+  BoolValue Exec(FunctionContext*, StringViewValue b1, StringViewValue b2) {
     return absl::StrContains(b1, b2);
   }
 
@@ -46,7 +46,7 @@ class ContainsUDF : public udf::ScalarUDF {
 
 class LengthUDF : public udf::ScalarUDF {
  public:
-  Int64Value Exec(FunctionContext*, StringValue b1) { return b1.length(); }
+  Int64Value Exec(FunctionContext*, StringViewValue b1) { return b1.length(); }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns the length of the string")
         .Example(R"doc(df.service = 'checkout'
@@ -59,7 +59,7 @@ class LengthUDF : public udf::ScalarUDF {
 
 class FindUDF : public udf::ScalarUDF {
  public:
-  Int64Value Exec(FunctionContext*, StringValue src, StringValue substr) {
+  Int64Value Exec(FunctionContext*, StringViewValue src, StringViewValue substr) {
     return src.find(substr);
   }
 
@@ -78,12 +78,12 @@ class FindUDF : public udf::ScalarUDF {
 
 class SubstringUDF : public udf::ScalarUDF {
  public:
-  StringValue Exec(FunctionContext*, StringValue b1, Int64Value pos, Int64Value length) {
+  StringValue Exec(FunctionContext*, StringViewValue b1, Int64Value pos, Int64Value length) {
     // If the pos is "erroneous" then just return empty string.
     if (pos < 0 || pos > static_cast<int64_t>(b1.length()) || length < 0) {
       return "";
     }
-    return b1.substr(static_cast<size_t>(pos.val), static_cast<size_t>(length.val));
+    return StringValue(b1.substr(static_cast<size_t>(pos.val), static_cast<size_t>(length.val)));
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns the specified substring from the string")
@@ -159,7 +159,7 @@ class TrimUDF : public udf::ScalarUDF {
 
 class StripPrefixUDF : public udf::ScalarUDF {
  public:
-  StringValue Exec(FunctionContext*, StringValue prefix, StringValue s) {
+  StringValue Exec(FunctionContext*, StringViewValue prefix, StringViewValue s) {
     return StringValue(absl::StripPrefix(s, prefix));
   }
   static udf::ScalarUDFDocBuilder Doc() {
@@ -201,7 +201,9 @@ class HexToASCII : public udf::ScalarUDF {
 
 class BytesToHex : public udf::ScalarUDF {
  public:
-  StringValue Exec(FunctionContext*, StringValue h) { return BytesToString<bytes_format::Hex>(h); }
+  StringValue Exec(FunctionContext*, StringViewValue h) {
+    return BytesToString<bytes_format::Hex>(h);
+  }
 
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Convert an input bytes in hex string.")
@@ -214,7 +216,7 @@ class BytesToHex : public udf::ScalarUDF {
 
 class StringToIntUDF : public udf::ScalarUDF {
  public:
-  Int64Value Exec(FunctionContext*, StringValue input, Int64Value default_val) {
+  Int64Value Exec(FunctionContext*, StringViewValue input, Int64Value default_val) {
     int64_t val;
     if (!absl::SimpleAtoi(input, &val)) {
       return default_val;
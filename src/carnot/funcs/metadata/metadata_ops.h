@@ -28,6 +28,8 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/carnot/udf/registry.h"
 #include "src/carnot/udf/type_inference.h"
 #include "src/shared/metadata/metadata_state.h"
@@ -63,7 +65,59 @@ inline const px::md::AgentMetadataState* GetMetadataState(px::carnot::udf::Funct
   return md;
 }
 
-class ASIDUDF : public ScalarUDF {
+/**
+ * MetadataUDF is the base of the UDFs that read the metadata state. Their result for a given
+ * argument changes as the metadata state is updated, so they are not deterministic.
+ */
+class MetadataUDF : public ScalarUDF {
+ public:
+  static constexpr bool Deterministic() { return false; }
+};
+
+namespace internal {
+
+/**
+ * MetadataCache memoizes the result of a metadata UDF by its argument. The UDF instance lives for
+ * the duration of a query, and the rows of a batch usually only have a few dozen distinct UPIDs
+ * (or pod/service IDs), so all but the first row of each key skip the metadata lookups and the
+ * formatting of the result. The cache is cleared whenever the metadata state changes (its epoch
+ * increments on every update), and when it reaches kMaxEntries.
+ */
+template <typename TKey>
+class MetadataCache {
+ public:
+  static constexpr size_t kMaxEntries = 4096;
+
+  /**
+   * Returns the cached result for the key, or computes it with `lookup_fn` if there's none.
+   */
+  template <typename TLookupFn>
+  const types::StringValue& Get(const px::md::AgentMetadataState* md, const TKey& key,
+                                TLookupFn lookup_fn) {
+    if (md != md_ || md->epoch_id() != epoch_id_) {
+      values_.clear();
+      md_ = md;
+      epoch_id_ = md->epoch_id();
+    }
+    auto it = values_.find(key);
+    if (it != values_.end()) {
+      return it->second;
+    }
+    if (values_.size() >= kMaxEntries) {
+      values_.clear();
+    }
+    return values_.emplace(key, lookup_fn()).first->second;
+  }
+
+ private:
+  const px::md::AgentMetadataState* md_ = nullptr;
+  uint64_t epoch_id_ = 0;
+  absl::flat_hash_map<TKey, types::StringValue> values_;
+};
+
+}  // namespace internal
+
+class ASIDUDF : public MetadataUDF {
  public:
   Int64Value Exec(FunctionContext* ctx) {
     auto md = GetMetadataState(ctx);
@@ -98,17 +152,18 @@ class UPIDToASIDUDF : public ScalarUDF {
   }
 };
 
-class PodIDToPodNameUDF : public ScalarUDF {
+class PodIDToPodNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
+    return cache_.Get(md, pod_id, [&]() -> StringValue {
+      const auto* pod_info = md->k8s_metadata_state().PodInfoByID(pod_id);
+      if (pod_info != nullptr) {
+        return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
+      }
 
-    const auto* pod_info = md->k8s_metadata_state().PodInfoByID(pod_id);
-    if (pod_info != nullptr) {
-      return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
-    }
-
-    return "";
+      return "";
+    });
   }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<PodIDToPodNameUDF>(types::ST_POD_NAME, {types::ST_NONE})};
@@ -120,9 +175,12 @@ class PodIDToPodNameUDF : public ScalarUDF {
         .Arg("pod_id", "The pod ID of the pod to get the name for.")
         .Returns("The k8s pod name for the pod ID passed in.");
   }
+
+ private:
+  internal::MetadataCache<std::string> cache_;
 };
 
-class PodIDToPodLabelsUDF : public ScalarUDF {
+class PodIDToPodLabelsUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -143,7 +201,7 @@ class PodIDToPodLabelsUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodIDUDF : public ScalarUDF {
+class PodNameToPodIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -166,7 +224,7 @@ class PodNameToPodIDUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodIPUDF : public ScalarUDF {
+class PodNameToPodIPUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -187,17 +245,18 @@ class PodNameToPodIPUDF : public ScalarUDF {
   }
 };
 
-class PodIDToNamespaceUDF : public ScalarUDF {
+class PodIDToNamespaceUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
+    return cache_.Get(md, pod_id, [&]() -> StringValue {
+      const auto* pod_info = md->k8s_metadata_state().PodInfoByID(pod_id);
+      if (pod_info != nullptr) {
+        return pod_info->ns();
+      }
 
-    const auto* pod_info = md->k8s_metadata_state().PodInfoByID(pod_id);
-    if (pod_info != nullptr) {
-      return pod_info->ns();
-    }
-
-    return "";
+      return "";
+    });
   }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
@@ -210,6 +269,9 @@ class PodIDToNamespaceUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get the namespace for.")
         .Returns("The k8s namespace for the Pod ID passed in.");
   }
+
+ private:
+  internal::MetadataCache<std::string> cache_;
 };
 
 class PodNameToNamespaceUDF : public ScalarUDF {
@@ -233,18 +295,19 @@ class PodNameToNamespaceUDF : public ScalarUDF {
   }
 };
 
-class UPIDToContainerIDUDF : public ScalarUDF {
+class UPIDToContainerIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-
-    auto upid_uint128 = absl::MakeUint128(upid_value.High64(), upid_value.Low64());
-    auto upid = md::UPID(upid_uint128);
-    auto pid = md->GetPIDByUPID(upid);
-    if (pid == nullptr) {
-      return "";
-    }
-    return pid->cid();
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto upid_uint128 = absl::MakeUint128(upid_value.High64(), upid_value.Low64());
+      auto upid = md::UPID(upid_uint128);
+      auto pid = md->GetPIDByUPID(upid);
+      if (pid == nullptr) {
+        return "";
+      }
+      return pid->cid();
+    });
   }
 
   static udf::ScalarUDFDocBuilder Doc() {
@@ -261,6 +324,9 @@ class UPIDToContainerIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
 inline const md::ContainerInfo* UPIDToContainer(const px::md::AgentMetadataState* md,
@@ -274,15 +340,17 @@ inline const md::ContainerInfo* UPIDToContainer(const px::md::AgentMetadataState
   return md->k8s_metadata_state().ContainerInfoByID(pid->cid());
 }
 
-class UPIDToContainerNameUDF : public ScalarUDF {
+class UPIDToContainerNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto container_info = UPIDToContainer(md, upid_value);
-    if (container_info == nullptr) {
-      return "";
-    }
-    return std::string(container_info->name());
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto container_info = UPIDToContainer(md, upid_value);
+      if (container_info == nullptr) {
+        return "";
+      }
+      return std::string(container_info->name());
+    });
   }
 
   static udf::InfRuleVec SemanticInferenceRules() {
@@ -304,6 +372,9 @@ class UPIDToContainerNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
 inline const px::md::PodInfo* UPIDtoPod(const px::md::AgentMetadataState* md,
@@ -339,15 +410,17 @@ inline types::StringValue StringifyVector(const std::vector<std::string>& vec) {
   return "";
 }
 
-class UPIDToNamespaceUDF : public ScalarUDF {
+class UPIDToNamespaceUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr) {
-      return "";
-    }
-    return pod_info->ns();
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto pod_info = UPIDtoPod(md, upid_value);
+      if (pod_info == nullptr) {
+        return "";
+      }
+      return pod_info->ns();
+    });
   }
 
   static udf::InfRuleVec SemanticInferenceRules() {
@@ -369,17 +442,22 @@ class UPIDToNamespaceUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
-class UPIDToPodIDUDF : public ScalarUDF {
+class UPIDToPodIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto container_info = UPIDToContainer(md, upid_value);
-    if (container_info == nullptr) {
-      return "";
-    }
-    return std::string(container_info->pod_id());
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto container_info = UPIDToContainer(md, upid_value);
+      if (container_info == nullptr) {
+        return "";
+      }
+      return std::string(container_info->pod_id());
+    });
   }
 
   static udf::ScalarUDFDocBuilder Doc() {
@@ -396,17 +474,22 @@ class UPIDToPodIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
-class UPIDToPodNameUDF : public ScalarUDF {
+class UPIDToPodNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr) {
-      return "";
-    }
-    return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto pod_info = UPIDtoPod(md, upid_value);
+      if (pod_info == nullptr) {
+        return "";
+      }
+      return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
+    });
   }
 
   static udf::InfRuleVec SemanticInferenceRules() {
@@ -427,19 +510,23 @@ class UPIDToPodNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
-class ServiceIDToServiceNameUDF : public ScalarUDF {
+class ServiceIDToServiceNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue service_id) {
     auto md = GetMetadataState(ctx);
+    return cache_.Get(md, service_id, [&]() -> StringValue {
+      const auto* service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
+      if (service_info != nullptr) {
+        return absl::Substitute("$0/$1", service_info->ns(), service_info->name());
+      }
 
-    const auto* service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
-    if (service_info != nullptr) {
-      return absl::Substitute("$0/$1", service_info->ns(), service_info->name());
-    }
-
-    return "";
+      return "";
+    });
   }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<ServiceIDToServiceNameUDF>(types::ST_SERVICE_NAME,
@@ -455,9 +542,12 @@ class ServiceIDToServiceNameUDF : public ScalarUDF {
         .Arg("service_id", "The service ID to get the service name for.")
         .Returns("The service name or an empty string if service_id not found.");
   }
+
+ private:
+  internal::MetadataCache<std::string> cache_;
 };
 
-class ServiceIDToClusterIPUDF : public ScalarUDF {
+class ServiceIDToClusterIPUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue service_id) {
     auto md = GetMetadataState(ctx);
@@ -482,7 +572,7 @@ class ServiceIDToClusterIPUDF : public ScalarUDF {
   }
 };
 
-class ServiceIDToExternalIPsUDF : public ScalarUDF {
+class ServiceIDToExternalIPsUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue service_id) {
     auto md = GetMetadataState(ctx);
@@ -505,7 +595,7 @@ class ServiceIDToExternalIPsUDF : public ScalarUDF {
   }
 };
 
-class ServiceNameToServiceIDUDF : public ScalarUDF {
+class ServiceNameToServiceIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue service_name) {
     auto md = GetMetadataState(ctx);
@@ -557,26 +647,28 @@ class ServiceNameToNamespaceUDF : public ScalarUDF {
 /**
  * @brief Returns the service ids for services that are currently running.
  */
-class UPIDToServiceIDUDF : public ScalarUDF {
+class UPIDToServiceIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr || pod_info->services().size() == 0) {
-      return "";
-    }
-    std::vector<std::string> running_service_ids;
-    for (const auto& service_id : pod_info->services()) {
-      auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
-      if (service_info == nullptr) {
-        continue;
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto pod_info = UPIDtoPod(md, upid_value);
+      if (pod_info == nullptr || pod_info->services().size() == 0) {
+        return "";
       }
-      if (service_info->stop_time_ns() == 0) {
-        running_service_ids.push_back(service_id);
+      std::vector<std::string> running_service_ids;
+      for (const auto& service_id : pod_info->services()) {
+        auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
+        if (service_info == nullptr) {
+          continue;
+        }
+        if (service_info->stop_time_ns() == 0) {
+          running_service_ids.push_back(service_id);
+        }
       }
-    }
 
-    return StringifyVector(running_service_ids);
+      return StringifyVector(running_service_ids);
+    });
   }
 
   static udf::ScalarUDFDocBuilder Doc() {
@@ -594,31 +686,36 @@ class UPIDToServiceIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
 /**
  * @brief Returns the service names for services that are currently running.
  */
-class UPIDToServiceNameUDF : public ScalarUDF {
+class UPIDToServiceNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr || pod_info->services().size() == 0) {
-      return "";
-    }
-    std::vector<std::string> running_service_names;
-    for (const auto& service_id : pod_info->services()) {
-      auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
-      if (service_info == nullptr) {
-        continue;
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto pod_info = UPIDtoPod(md, upid_value);
+      if (pod_info == nullptr || pod_info->services().size() == 0) {
+        return "";
       }
-      if (service_info->stop_time_ns() == 0) {
-        running_service_names.push_back(
-            absl::Substitute("$0/$1", service_info->ns(), service_info->name()));
+      std::vector<std::string> running_service_names;
+      for (const auto& service_id : pod_info->services()) {
+        auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
+        if (service_info == nullptr) {
+          continue;
+        }
+        if (service_info->stop_time_ns() == 0) {
+          running_service_names.push_back(
+              absl::Substitute("$0/$1", service_info->ns(), service_info->name()));
+        }
       }
-    }
-    return StringifyVector(running_service_names);
+      return StringifyVector(running_service_names);
+    });
   }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
@@ -640,21 +737,26 @@ class UPIDToServiceNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
 /**
  * @brief Returns the node name for the pod associated with the input upid.
  */
-class UPIDToNodeNameUDF : public ScalarUDF {
+class UPIDToNodeNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr) {
-      return "";
-    }
-    std::string foo = std::string(pod_info->node_name());
-    return foo;
+    return cache_.Get(md, upid_value.val, [&]() -> StringValue {
+      auto pod_info = UPIDtoPod(md, upid_value);
+      if (pod_info == nullptr) {
+        return "";
+      }
+      std::string foo = std::string(pod_info->node_name());
+      return foo;
+    });
   }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<UPIDToNodeNameUDF>(types::ST_NODE_NAME, {types::ST_NONE})};
@@ -672,6 +774,9 @@ class UPIDToNodeNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  internal::MetadataCache<absl::uint128> cache_;
 };
 
 /**
@@ -854,7 +959,7 @@ inline std::vector<const px::md::K8sMetadataObject*> GetOwnerReferenceInfosFromM
 /**
  * @brief Returns the replica set id for the given replica set name.
  */
-class ReplicaSetIDToReplicaSetNameUDF : public ScalarUDF {
+class ReplicaSetIDToReplicaSetNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -882,7 +987,7 @@ class ReplicaSetIDToReplicaSetNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set start time for Replica Set ID.
  */
-class ReplicaSetIDToStartTimeUDF : public ScalarUDF {
+class ReplicaSetIDToStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -906,7 +1011,7 @@ class ReplicaSetIDToStartTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set stop time for Replica Set ID.
  */
-class ReplicaSetIDToStopTimeUDF : public ScalarUDF {
+class ReplicaSetIDToStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -930,7 +1035,7 @@ class ReplicaSetIDToStopTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set namespace for Replica Set ID.
  */
-class ReplicaSetIDToNamespaceUDF : public ScalarUDF {
+class ReplicaSetIDToNamespaceUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -953,7 +1058,7 @@ class ReplicaSetIDToNamespaceUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set owner references for Replica Sets ID.
  */
-class ReplicaSetIDToOwnerReferencesUDF : public ScalarUDF {
+class ReplicaSetIDToOwnerReferencesUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -983,7 +1088,7 @@ class ReplicaSetIDToOwnerReferencesUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set status for Replica Set ID.
  */
-class ReplicaSetIDToStatusUDF : public ScalarUDF {
+class ReplicaSetIDToStatusUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -1007,7 +1112,7 @@ class ReplicaSetIDToStatusUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment name for Replica Set ID.
  */
-class ReplicaSetIDToDeploymentNameUDF : public ScalarUDF {
+class ReplicaSetIDToDeploymentNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -1037,7 +1142,7 @@ class ReplicaSetIDToDeploymentNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment ID for Replica Set ID.
  */
-class ReplicaSetIDToDeploymentIDUDF : public ScalarUDF {
+class ReplicaSetIDToDeploymentIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_id) {
     auto md = GetMetadataState(ctx);
@@ -1067,7 +1172,7 @@ class ReplicaSetIDToDeploymentIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set name from Replica Set ID.
  */
-class ReplicaSetNameToReplicaSetIDUDF : public ScalarUDF {
+class ReplicaSetNameToReplicaSetIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1097,7 +1202,7 @@ class ReplicaSetNameToReplicaSetIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set start time for Replica Set name.
  */
-class ReplicaSetNameToStartTimeUDF : public ScalarUDF {
+class ReplicaSetNameToStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1128,7 +1233,7 @@ class ReplicaSetNameToStartTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set stop time for Replica Set name.
  */
-class ReplicaSetNameToStopTimeUDF : public ScalarUDF {
+class ReplicaSetNameToStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1159,7 +1264,7 @@ class ReplicaSetNameToStopTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set namespace for Replica Set name.
  */
-class ReplicaSetNameToNamespaceUDF : public ScalarUDF {
+class ReplicaSetNameToNamespaceUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1189,7 +1294,7 @@ class ReplicaSetNameToNamespaceUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set owner references for Replica Set name.
  */
-class ReplicaSetNameToOwnerReferencesUDF : public ScalarUDF {
+class ReplicaSetNameToOwnerReferencesUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1225,7 +1330,7 @@ class ReplicaSetNameToOwnerReferencesUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set status for Replica Set name.
  */
-class ReplicaSetNameToStatusUDF : public ScalarUDF {
+class ReplicaSetNameToStatusUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1256,7 +1361,7 @@ class ReplicaSetNameToStatusUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment name for Replica Set name.
  */
-class ReplicaSetNameToDeploymentNameUDF : public ScalarUDF {
+class ReplicaSetNameToDeploymentNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1291,7 +1396,7 @@ class ReplicaSetNameToDeploymentNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment ID for Replica Set ID.
  */
-class ReplicaSetNameToDeploymentIDUDF : public ScalarUDF {
+class ReplicaSetNameToDeploymentIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue replica_set_name) {
     auto md = GetMetadataState(ctx);
@@ -1326,7 +1431,7 @@ class ReplicaSetNameToDeploymentIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment name for the given Deployment ID.
  */
-class DeploymentIDToDeploymentNameUDF : public ScalarUDF {
+class DeploymentIDToDeploymentNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue deployment_id) {
     auto md = GetMetadataState(ctx);
@@ -1354,7 +1459,7 @@ class DeploymentIDToDeploymentNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment start time for Deployment ID.
  */
-class DeploymentIDToStartTimeUDF : public ScalarUDF {
+class DeploymentIDToStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue deployment_id) {
     auto md = GetMetadataState(ctx);
@@ -1378,7 +1483,7 @@ class DeploymentIDToStartTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment stop time for Deployment ID.
  */
-class DeploymentIDToStopTimeUDF : public ScalarUDF {
+class DeploymentIDToStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue deployment_id) {
     auto md = GetMetadataState(ctx);
@@ -1401,7 +1506,7 @@ class DeploymentIDToStopTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment namespace for Deployment ID.
  */
-class DeploymentIDToNamespaceUDF : public ScalarUDF {
+class DeploymentIDToNamespaceUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue deployment_id) {
     auto md = GetMetadataState(ctx);
@@ -1424,7 +1529,7 @@ class DeploymentIDToNamespaceUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment status for Deployment ID.
  */
-class DeploymentIDToStatusUDF : public ScalarUDF {
+class DeploymentIDToStatusUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue deployment_id) {
     auto md = GetMetadataState(ctx);
@@ -1448,7 +1553,7 @@ class DeploymentIDToStatusUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment ID from Deployment name.
  */
-class DeploymentNameToDeploymentIDUDF : public ScalarUDF {
+class DeploymentNameToDeploymentIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue deployment_name) {
     auto md = GetMetadataState(ctx);
@@ -1478,7 +1583,7 @@ class DeploymentNameToDeploymentIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment start time for Deployment name.
  */
-class DeploymentNameToStartTimeUDF : public ScalarUDF {
+class DeploymentNameToStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue deployment_name) {
     auto md = GetMetadataState(ctx);
@@ -1509,7 +1614,7 @@ class DeploymentNameToStartTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment stop time for Deployment name.
  */
-class DeploymentNameToStopTimeUDF : public ScalarUDF {
+class DeploymentNameToStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue deployment_name) {
     auto md = GetMetadataState(ctx);
@@ -1540,7 +1645,7 @@ class DeploymentNameToStopTimeUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment namespace for Deployment name.
  */
-class DeploymentNameToNamespaceUDF : public ScalarUDF {
+class DeploymentNameToNamespaceUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue deployment_name) {
     auto md = GetMetadataState(ctx);
@@ -1570,7 +1675,7 @@ class DeploymentNameToNamespaceUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment status for Deployment name.
  */
-class DeploymentNameToStatusUDF : public ScalarUDF {
+class DeploymentNameToStatusUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue deployment_name) {
     auto md = GetMetadataState(ctx);
@@ -1601,7 +1706,7 @@ class DeploymentNameToStatusUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set names for Replica Sets that are currently running.
  */
-class UPIDToReplicaSetNameUDF : public ScalarUDF {
+class UPIDToReplicaSetNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
@@ -1646,7 +1751,7 @@ class UPIDToReplicaSetNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set IDs for Replica Sets that are currently running.
  */
-class UPIDToReplicaSetIDUDF : public ScalarUDF {
+class UPIDToReplicaSetIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
@@ -1687,7 +1792,7 @@ class UPIDToReplicaSetIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Replica Set status for Replica Sets that are currently running.
  */
-class UPIDToReplicaSetStatusUDF : public ScalarUDF {
+class UPIDToReplicaSetStatusUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
@@ -1727,7 +1832,7 @@ class UPIDToReplicaSetStatusUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment name for processes which are currently running.
  */
-class UPIDToDeploymentNameUDF : public ScalarUDF {
+class UPIDToDeploymentNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
@@ -1775,7 +1880,7 @@ class UPIDToDeploymentNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment ID for process which is currently running.
  */
-class UPIDToDeploymentIDUDF : public ScalarUDF {
+class UPIDToDeploymentIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
@@ -1822,7 +1927,7 @@ class UPIDToDeploymentIDUDF : public ScalarUDF {
 /**
  * @brief Returns the hostname for the pod associated with the input upid.
  */
-class UPIDToHostnameUDF : public ScalarUDF {
+class UPIDToHostnameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
@@ -1850,7 +1955,7 @@ class UPIDToHostnameUDF : public ScalarUDF {
 /**
  * @brief Returns the service names for the given pod ID.
  */
-class PodIDToServiceNameUDF : public ScalarUDF {
+class PodIDToServiceNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -1892,7 +1997,7 @@ class PodIDToServiceNameUDF : public ScalarUDF {
 /**
  * @brief Returns the service ids for the given pod ID.
  */
-class PodIDToServiceIDUDF : public ScalarUDF {
+class PodIDToServiceIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -1928,7 +2033,7 @@ class PodIDToServiceIDUDF : public ScalarUDF {
 /**
  * @brief Returns the owner references for the given pod ID.
  */
-class PodIDToOwnerReferencesUDF : public ScalarUDF {
+class PodIDToOwnerReferencesUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -1958,7 +2063,7 @@ class PodIDToOwnerReferencesUDF : public ScalarUDF {
 /**
  * @brief Returns the owner references for the given pod name.
  */
-class PodNameToOwnerReferencesUDF : public ScalarUDF {
+class PodNameToOwnerReferencesUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -1989,7 +2094,7 @@ class PodNameToOwnerReferencesUDF : public ScalarUDF {
 /**
  * @brief Returns the Node Name of a pod ID passed in.
  */
-class PodIDToNodeNameUDF : public ScalarUDF {
+class PodIDToNodeNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2018,7 +2123,7 @@ class PodIDToNodeNameUDF : public ScalarUDF {
 /**
  * @brief Returns the ReplicaSet name of a pod ID passed in.
  */
-class PodIDToReplicaSetNameUDF : public ScalarUDF {
+class PodIDToReplicaSetNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2053,7 +2158,7 @@ class PodIDToReplicaSetNameUDF : public ScalarUDF {
 /**
  * @brief Returns the ReplicaSet ID of a pod ID passed in.
  */
-class PodIDToReplicaSetIDUDF : public ScalarUDF {
+class PodIDToReplicaSetIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2088,7 +2193,7 @@ class PodIDToReplicaSetIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment name of a pod ID passed in.
  */
-class PodIDToDeploymentNameUDF : public ScalarUDF {
+class PodIDToDeploymentNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2127,7 +2232,7 @@ class PodIDToDeploymentNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment ID of a pod ID passed in.
  */
-class PodIDToDeploymentIDUDF : public ScalarUDF {
+class PodIDToDeploymentIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2166,7 +2271,7 @@ class PodIDToDeploymentIDUDF : public ScalarUDF {
 /**
  * @brief Returns the ReplicaSet name of a pod name passed in.
  */
-class PodNameToReplicaSetNameUDF : public ScalarUDF {
+class PodNameToReplicaSetNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2206,7 +2311,7 @@ class PodNameToReplicaSetNameUDF : public ScalarUDF {
 /**
  * @brief Returns the ReplicaSet ID of a Pod name passed in.
  */
-class PodNameToReplicaSetIDUDF : public ScalarUDF {
+class PodNameToReplicaSetIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2246,7 +2351,7 @@ class PodNameToReplicaSetIDUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment name of a pod name passed in.
  */
-class PodNameToDeploymentNameUDF : public ScalarUDF {
+class PodNameToDeploymentNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2290,7 +2395,7 @@ class PodNameToDeploymentNameUDF : public ScalarUDF {
 /**
  * @brief Returns the Deployment ID of a Pod name passed in.
  */
-class PodNameToDeploymentIDUDF : public ScalarUDF {
+class PodNameToDeploymentIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2334,7 +2439,7 @@ class PodNameToDeploymentIDUDF : public ScalarUDF {
 /**
  * @brief Returns the service names for the given pod name.
  */
-class PodNameToServiceNameUDF : public ScalarUDF {
+class PodNameToServiceNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2380,7 +2485,7 @@ class PodNameToServiceNameUDF : public ScalarUDF {
 /**
  * @brief Returns the service ids for the given pod name.
  */
-class PodNameToServiceIDUDF : public ScalarUDF {
+class PodNameToServiceIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2459,7 +2564,7 @@ class UPIDToPIDUDF : public ScalarUDF {
   }
 };
 
-class PodIDToPodStartTimeUDF : public ScalarUDF {
+class PodIDToPodStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2478,7 +2583,7 @@ class PodIDToPodStartTimeUDF : public ScalarUDF {
   }
 };
 
-class PodIDToPodStopTimeUDF : public ScalarUDF {
+class PodIDToPodStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
@@ -2497,7 +2602,7 @@ class PodIDToPodStopTimeUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodStartTimeUDF : public ScalarUDF {
+class PodNameToPodStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2517,7 +2622,7 @@ class PodNameToPodStartTimeUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodStopTimeUDF : public ScalarUDF {
+class PodNameToPodStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2537,7 +2642,7 @@ class PodNameToPodStopTimeUDF : public ScalarUDF {
   }
 };
 
-class ContainerNameToContainerIDUDF : public ScalarUDF {
+class ContainerNameToContainerIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue container_name) {
     auto md = GetMetadataState(ctx);
@@ -2553,7 +2658,7 @@ class ContainerNameToContainerIDUDF : public ScalarUDF {
   }
 };
 
-class ContainerIDToContainerStartTimeUDF : public ScalarUDF {
+class ContainerIDToContainerStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue container_id) {
     auto md = GetMetadataState(ctx);
@@ -2575,7 +2680,7 @@ class ContainerIDToContainerStartTimeUDF : public ScalarUDF {
   }
 };
 
-class ContainerIDToContainerStopTimeUDF : public ScalarUDF {
+class ContainerIDToContainerStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue container_id) {
     auto md = GetMetadataState(ctx);
@@ -2597,7 +2702,7 @@ class ContainerIDToContainerStopTimeUDF : public ScalarUDF {
   }
 };
 
-class ContainerNameToContainerStartTimeUDF : public ScalarUDF {
+class ContainerNameToContainerStartTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue container_name) {
     auto md = GetMetadataState(ctx);
@@ -2619,7 +2724,7 @@ class ContainerNameToContainerStartTimeUDF : public ScalarUDF {
   }
 };
 
-class ContainerNameToContainerStopTimeUDF : public ScalarUDF {
+class ContainerNameToContainerStopTimeUDF : public MetadataUDF {
  public:
   Time64NSValue Exec(FunctionContext* ctx, StringValue container_name) {
     auto md = GetMetadataState(ctx);
@@ -2688,7 +2793,7 @@ inline types::StringValue PodInfoToPodStatus(const px::md::PodInfo* pod_info) {
   return sb.GetString();
 }
 
-class PodNameToPodStatusUDF : public ScalarUDF {
+class PodNameToPodStatusUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the Pod status for a passed in pod.
@@ -2724,7 +2829,7 @@ class PodNameToPodStatusUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodReadyUDF : public ScalarUDF {
+class PodNameToPodReadyUDF : public MetadataUDF {
  public:
   BoolValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
@@ -2757,7 +2862,7 @@ class PodNameToPodReadyUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodStatusMessageUDF : public ScalarUDF {
+class PodNameToPodStatusMessageUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the Pod status message for a passed in pod.
@@ -2777,7 +2882,7 @@ class PodNameToPodStatusMessageUDF : public ScalarUDF {
   }
 };
 
-class PodNameToPodStatusReasonUDF : public ScalarUDF {
+class PodNameToPodStatusReasonUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the Pod status reason for a passed in pod.
@@ -2811,7 +2916,7 @@ inline std::string ContainerStateToString(const px::md::ContainerState& containe
   }
 }
 
-class ContainerIDToContainerStatusUDF : public ScalarUDF {
+class ContainerIDToContainerStatusUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the Container status for a passed in container.
@@ -2861,7 +2966,7 @@ class ContainerIDToContainerStatusUDF : public ScalarUDF {
   }
 };
 
-class UPIDToPodStatusUDF : public ScalarUDF {
+class UPIDToPodStatusUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the Pod status for a passed in UPID.
@@ -2900,7 +3005,7 @@ class UPIDToPodStatusUDF : public ScalarUDF {
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
 };
 
-class UPIDToCmdLineUDF : public ScalarUDF {
+class UPIDToCmdLineUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the cmdline for the upid.
@@ -2941,7 +3046,7 @@ inline std::string PodInfoToPodQoS(const px::md::PodInfo* pod_info) {
   return std::string(magic_enum::enum_name(pod_info->qos_class()));
 }
 
-class UPIDToPodQoSUDF : public ScalarUDF {
+class UPIDToPodQoSUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the qos for the upid's pod.
@@ -2971,7 +3076,7 @@ class UPIDToPodQoSUDF : public ScalarUDF {
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
 };
 
-class HostnameUDF : public ScalarUDF {
+class HostnameUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the hostname of the machine.
@@ -3008,7 +3113,7 @@ class HostNumCPUsUDF : public ScalarUDF {
   }
 };
 
-class IPToPodIDUDF : public ScalarUDF {
+class IPToPodIDUDF : public MetadataUDF {
  public:
   /**
    * @brief Gets the pod id of pod with given pod_ip
@@ -3041,7 +3146,7 @@ class IPToPodIDUDF : public ScalarUDF {
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_KELVIN; }
 };
 
-class IPToServiceIDUDF : public ScalarUDF {
+class IPToServiceIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx, StringValue ip) {
     auto md = GetMetadataState(ctx);
@@ -3154,7 +3259,7 @@ class HasValueUDF : public ScalarUDF {
   }
 };
 
-class VizierIDUDF : public ScalarUDF {
+class VizierIDUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx) {
     auto md = GetMetadataState(ctx);
@@ -3169,7 +3274,7 @@ class VizierIDUDF : public ScalarUDF {
   }
 };
 
-class VizierNameUDF : public ScalarUDF {
+class VizierNameUDF : public MetadataUDF {
  public:
   StringValue Exec(FunctionContext* ctx) {
     auto md = GetMetadataState(ctx);
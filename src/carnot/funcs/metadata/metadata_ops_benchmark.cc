@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "src/carnot/funcs/metadata/metadata_ops.h"
+#include "src/carnot/udf/udf_wrapper.h"
+#include "src/common/benchmark/benchmark.h"
+#include "src/shared/k8s/metadatapb/test_proto.h"
+#include "src/shared/metadata/state_manager.h"
+#include "src/shared/metadata/test_utils.h"
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace carnot {
+namespace funcs {
+namespace metadata {
+
+using ResourceUpdate = px::shared::k8s::metadatapb::ResourceUpdate;
+
+// UPIDToPodNameUDF without the MetadataCache, i.e. a lookup per row.
+class UncachedUPIDToPodNameUDF : public ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
+    auto pod_info = UPIDtoPod(GetMetadataState(ctx), upid_value);
+    if (pod_info == nullptr) {
+      return "";
+    }
+    return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
+  }
+};
+
+// Creates a metadata state with a pod, and num_upids processes in one of its containers.
+std::shared_ptr<px::md::AgentMetadataState> CreateMetadataState(int num_upids) {
+  auto md = std::make_shared<px::md::AgentMetadataState>(
+      /* hostname */ "myhost", /* asid */ 1, /* pid */ 123, sole::uuid4(), "mypod", sole::uuid4(),
+      "myvizier");
+  moodycamel::BlockingConcurrentQueue<std::unique_ptr<ResourceUpdate>> updates;
+  updates.enqueue(px::metadatapb::testutils::CreateRunningContainerUpdatePB());
+  updates.enqueue(px::metadatapb::testutils::CreateRunningPodUpdatePB());
+  px::md::TestAgentMetadataFilter md_filter;
+  PL_CHECK_OK(px::md::ApplyK8sUpdates(10, md.get(), &md_filter, &updates));
+
+  for (int i = 0; i < num_upids; ++i) {
+    auto upid = md::UPID(123, 1000 + i, 89101);
+    md->AddUPID(upid, std::make_unique<md::PIDInfo>(upid, "exe", "cmdline", "pod1_container_1"));
+  }
+  return md;
+}
+
+// Applies a UPID metadata UDF to a batch of range(0) rows with range(1) distinct UPIDs.
+template <typename TUDF>
+// NOLINTNEXTLINE : runtime/references.
+static void BM_UPIDToPodName(benchmark::State& state) {
+  int num_rows = state.range(0);
+  int num_upids = state.range(1);
+  auto md = CreateMetadataState(num_upids);
+  FunctionContext ctx(md, nullptr);
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> dist(0, num_upids - 1);
+  std::vector<types::UInt128Value> upids(num_rows);
+  for (auto& upid : upids) {
+    upid = md::UPID(123, 1000 + dist(gen), 89101).value();
+  }
+  auto upids_arr = types::ToArrow(upids, arrow::default_memory_pool());
+
+  TUDF udf;
+  // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
+  for (auto _ : state) {
+    arrow::StringBuilder builder;
+    PL_CHECK_OK(udf::ScalarUDFWrapper<TUDF>::ExecBatchArrow(&udf, &ctx, {upids_arr.get()},
+                                                              &builder, num_rows));
+    std::shared_ptr<arrow::Array> out;
+    CHECK(builder.Finish(&out).ok());
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * num_rows);
+}
+
+BENCHMARK_TEMPLATE(BM_UPIDToPodName, UncachedUPIDToPodNameUDF)
+    ->RangeMultiplier(16)
+    ->Ranges({{1024, 16384}, {1, 1024}});
+BENCHMARK_TEMPLATE(BM_UPIDToPodName, UPIDToPodNameUDF)
+    ->RangeMultiplier(16)
+    ->Ranges({{1024, 16384}, {1, 1024}});
+
+}  // namespace metadata
+}  // namespace funcs
+}  // namespace carnot
+}  // namespace px
@@ -147,6 +147,38 @@ TEST_F(MetadataOpsTest, upid_to_pod_name_test) {
   udf_tester.ForInput(upid3).Expect("");
 }
 
+TEST_F(MetadataOpsTest, metadata_cache) {
+  internal::MetadataCache<std::string> cache;
+  int num_lookups = 0;
+  auto lookup = [&]() -> types::StringValue { return absl::StrCat("value", ++num_lookups); };
+
+  EXPECT_EQ("value1", cache.Get(metadata_state_.get(), "a", lookup));
+  EXPECT_EQ("value1", cache.Get(metadata_state_.get(), "a", lookup));
+  EXPECT_EQ("value2", cache.Get(metadata_state_.get(), "b", lookup));
+  EXPECT_EQ(2, num_lookups);
+
+  // A new epoch of the metadata state invalidates the cached values.
+  metadata_state_->set_epoch_id(metadata_state_->epoch_id() + 1);
+  EXPECT_EQ("value3", cache.Get(metadata_state_.get(), "a", lookup));
+  EXPECT_EQ("value3", cache.Get(metadata_state_.get(), "a", lookup));
+  EXPECT_EQ(3, num_lookups);
+}
+
+TEST_F(MetadataOpsTest, upid_to_pod_name_cached_across_updates) {
+  auto function_ctx = std::make_unique<FunctionContext>(metadata_state_, nullptr);
+  auto udf_tester = px::carnot::udf::UDFTester<UPIDToPodNameUDF>(std::move(function_ctx));
+  auto upid1 = types::UInt128Value(528280977975, 89101);
+  udf_tester.ForInput(upid1).Expect("pl/running_pod");
+
+  // The UPID moves to the other pod's container in the next epoch of the metadata state.
+  auto upid = md::UPID(123, 567, 89101);
+  metadata_state_->AddUPID(
+      upid, std::make_unique<md::PIDInfo>(upid, "exe", "test", "pod2_container_1"));
+  udf_tester.ForInput(upid1).Expect("pl/running_pod");
+  metadata_state_->set_epoch_id(metadata_state_->epoch_id() + 1);
+  udf_tester.ForInput(upid1).Expect("pl/terminating_pod");
+}
+
 TEST_F(MetadataOpsTest, upid_to_namespace_test) {
   auto function_ctx = std::make_unique<FunctionContext>(metadata_state_, nullptr);
   auto udf_tester = px::carnot::udf::UDFTester<UPIDToNamespaceUDF>(std::move(function_ctx));
@@ -44,6 +44,8 @@ using ScalarUDF = px::carnot::udf::ScalarUDF;
 class NSLookupUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue addr) { return cache_.Lookup(addr); }
+  // The resolved name changes with the DNS records.
+  static constexpr bool Deterministic() { return false; }
 
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Perform a DNS lookup for the value (experimental).")
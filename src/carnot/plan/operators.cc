@@ -26,6 +26,7 @@
 #include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <absl/strings/str_join.h>
 #include <absl/strings/substitute.h>
 #include <magic_enum.hpp>
@@ -78,6 +79,10 @@ std::unique_ptr<Operator> Operator::FromProto(const planpb::Operator& pb, int64_
       return CreateOperator<UnionOperator>(id, pb.union_op());
     case planpb::JOIN_OPERATOR:
       return CreateOperator<JoinOperator>(id, pb.join_op());
+    case planpb::SORT_OPERATOR:
+      return CreateOperator<SortOperator>(id, pb.sort_op());
+    case planpb::TOPK_OPERATOR:
+      return CreateOperator<TopKOperator>(id, pb.topk_op());
     case planpb::UDTF_SOURCE_OPERATOR:
       return CreateOperator<UDTFSourceOperator>(id, pb.udtf_source_op());
     case planpb::EMPTY_SOURCE_OPERATOR:
@@ -548,6 +553,110 @@ int64_t UnionOperator::time_column_index(int64_t parent_index) const {
   return column_mappings_.at(parent_index).at(output_idx);
 }
 
+/**
+ * Sort and TopK Operator Implementation.
+ */
+namespace {
+
+std::string SortKeysDebugString(const std::vector<planpb::SortKey>& sort_keys) {
+  return absl::StrJoin(sort_keys, ",", [](std::string* out, const planpb::SortKey& key) {
+    absl::StrAppend(out, key.index(), key.descending() ? " desc" : " asc");
+  });
+}
+
+Status CheckSortKeys(const std::vector<planpb::SortKey>& sort_keys) {
+  if (sort_keys.empty()) {
+    return error::InvalidArgument("Sort must have at least one sort key");
+  }
+  return Status::OK();
+}
+
+StatusOr<table_store::schema::Relation> SelectedColumnsRelation(
+    const table_store::schema::Schema& schema, const std::vector<int64_t>& input_ids,
+    const std::vector<planpb::SortKey>& sort_keys, const std::vector<int64_t>& selected_cols,
+    std::string_view op_name) {
+  if (input_ids.size() != 1) {
+    return error::InvalidArgument("$0 operator must have exactly one input", op_name);
+  }
+  if (!schema.HasRelation(input_ids[0])) {
+    return error::NotFound("Missing relation ($0) for input of $1", input_ids[0], op_name);
+  }
+
+  PL_ASSIGN_OR_RETURN(const table_store::schema::Relation& input_relation,
+                      schema.GetRelation(input_ids[0]));
+  auto num_columns = static_cast<int64_t>(input_relation.NumColumns());
+  for (const auto& key : sort_keys) {
+    if (key.index() < 0 || key.index() >= num_columns) {
+      return error::InvalidArgument("Sort key $0 is out of bounds, number of columns is $1",
+                                    key.index(), num_columns);
+    }
+  }
+  table_store::schema::Relation output_relation;
+  for (auto selected_col_idx : selected_cols) {
+    if (selected_col_idx < 0 || selected_col_idx >= num_columns) {
+      return error::InvalidArgument("Column index $0 is out of bounds, number of columns is $1",
+                                    selected_col_idx, num_columns);
+    }
+    output_relation.AddColumn(input_relation.GetColumnType(selected_col_idx),
+                              input_relation.GetColumnName(selected_col_idx),
+                              input_relation.GetColumnDesc(selected_col_idx));
+  }
+  return output_relation;
+}
+
+}  // namespace
+
+std::string SortOperator::DebugString() const {
+  return absl::Substitute("Op:Sort(keys: [$0], cols: [$1])", SortKeysDebugString(sort_keys_),
+                          absl::StrJoin(selected_cols_, ","));
+}
+
+Status SortOperator::Init(const planpb::SortOperator& pb) {
+  pb_ = pb;
+  sort_keys_ = std::vector<planpb::SortKey>(pb_.sort_keys().begin(), pb_.sort_keys().end());
+  PL_RETURN_IF_ERROR(CheckSortKeys(sort_keys_));
+  selected_cols_.reserve(pb_.columns_size());
+  for (const auto& col : pb_.columns()) {
+    selected_cols_.push_back(col.index());
+  }
+  is_initialized_ = true;
+  return Status::OK();
+}
+
+StatusOr<table_store::schema::Relation> SortOperator::OutputRelation(
+    const table_store::schema::Schema& schema, const PlanState& /*state*/,
+    const std::vector<int64_t>& input_ids) const {
+  DCHECK(is_initialized_) << "Not initialized";
+  return SelectedColumnsRelation(schema, input_ids, sort_keys_, selected_cols_, "Sort");
+}
+
+std::string TopKOperator::DebugString() const {
+  return absl::Substitute("Op:TopK(k: $0, keys: [$1], cols: [$2])", pb_.k(),
+                          SortKeysDebugString(sort_keys_), absl::StrJoin(selected_cols_, ","));
+}
+
+Status TopKOperator::Init(const planpb::TopKOperator& pb) {
+  pb_ = pb;
+  sort_keys_ = std::vector<planpb::SortKey>(pb_.sort_keys().begin(), pb_.sort_keys().end());
+  PL_RETURN_IF_ERROR(CheckSortKeys(sort_keys_));
+  if (pb_.k() < 0) {
+    return error::InvalidArgument("TopK expects a non-negative k, got $0", pb_.k());
+  }
+  selected_cols_.reserve(pb_.columns_size());
+  for (const auto& col : pb_.columns()) {
+    selected_cols_.push_back(col.index());
+  }
+  is_initialized_ = true;
+  return Status::OK();
+}
+
+StatusOr<table_store::schema::Relation> TopKOperator::OutputRelation(
+    const table_store::schema::Schema& schema, const PlanState& /*state*/,
+    const std::vector<int64_t>& input_ids) const {
+  DCHECK(is_initialized_) << "Not initialized";
+  return SelectedColumnsRelation(schema, input_ids, sort_keys_, selected_cols_, "TopK");
+}
+
 /**
  * Join Operator Implementation.
  */
@@ -97,6 +97,12 @@ class MemorySourceOperator : public Operator {
   std::vector<int64_t> Columns() const { return column_idxs_; }
   const types::TabletID& Tablet() const { return pb_.tablet(); }
   bool streaming() const { return pb_.streaming(); }
+  const google::protobuf::RepeatedPtrField<planpb::SourceColumnPredicate>& predicates() const {
+    return pb_.predicates();
+  }
+  std::vector<int64_t> PredicateColumns() const {
+    return {pb_.predicate_column_idxs().begin(), pb_.predicate_column_idxs().end()};
+  }
 
  private:
   planpb::MemorySourceOperator pb_;
@@ -325,6 +331,47 @@ class JoinOperator : public Operator {
   planpb::JoinOperator pb_;
 };
 
+class SortOperator : public Operator {
+ public:
+  explicit SortOperator(int64_t id) : Operator(id, planpb::SORT_OPERATOR) {}
+  ~SortOperator() override = default;
+
+  StatusOr<table_store::schema::Relation> OutputRelation(
+      const table_store::schema::Schema& schema, const PlanState& state,
+      const std::vector<int64_t>& input_ids) const override;
+  Status Init(const planpb::SortOperator& pb);
+  std::string DebugString() const override;
+
+  const std::vector<planpb::SortKey>& sort_keys() const { return sort_keys_; }
+  const std::vector<int64_t>& selected_cols() const { return selected_cols_; }
+
+ private:
+  std::vector<planpb::SortKey> sort_keys_;
+  std::vector<int64_t> selected_cols_;
+  planpb::SortOperator pb_;
+};
+
+class TopKOperator : public Operator {
+ public:
+  explicit TopKOperator(int64_t id) : Operator(id, planpb::TOPK_OPERATOR) {}
+  ~TopKOperator() override = default;
+
+  StatusOr<table_store::schema::Relation> OutputRelation(
+      const table_store::schema::Schema& schema, const PlanState& state,
+      const std::vector<int64_t>& input_ids) const override;
+  Status Init(const planpb::TopKOperator& pb);
+  std::string DebugString() const override;
+
+  const std::vector<planpb::SortKey>& sort_keys() const { return sort_keys_; }
+  const std::vector<int64_t>& selected_cols() const { return selected_cols_; }
+  int64_t k() const { return pb_.k(); }
+
+ private:
+  std::vector<planpb::SortKey> sort_keys_;
+  std::vector<int64_t> selected_cols_;
+  planpb::TopKOperator pb_;
+};
+
 class UDTFSourceOperator : public Operator {
  public:
   explicit UDTFSourceOperator(int64_t id) : Operator(id, planpb::UDTF_SOURCE_OPERATOR) {}
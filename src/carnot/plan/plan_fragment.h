@@ -71,6 +71,8 @@ class PlanFragmentWalker {
   using LimitWalkFn = std::function<Status(const LimitOperator&)>;
   using UnionWalkFn = std::function<Status(const UnionOperator&)>;
   using JoinWalkFn = std::function<Status(const JoinOperator&)>;
+  using SortWalkFn = std::function<Status(const SortOperator&)>;
+  using TopKWalkFn = std::function<Status(const TopKOperator&)>;
   using GRPCSinkWalkFn = std::function<Status(const GRPCSinkOperator&)>;
   using GRPCSourceWalkFn = std::function<Status(const GRPCSourceOperator&)>;
   using UDTFSourceWalkFn = std::function<Status(const UDTFSourceOperator&)>;
@@ -157,6 +159,26 @@ class PlanFragmentWalker {
     return *this;
   }
 
+  /**
+   * Register callback for when a sort operator is encountered.
+   * @param fn The function to call when a SortOperator is encountered.
+   * @return self to allow chaining
+   */
+  PlanFragmentWalker& OnSort(const SortWalkFn& fn) {
+    on_sort_walk_fn_ = fn;
+    return *this;
+  }
+
+  /**
+   * Register callback for when a top k operator is encountered.
+   * @param fn The function to call when a TopKOperator is encountered.
+   * @return self to allow chaining
+   */
+  PlanFragmentWalker& OnTopK(const TopKWalkFn& fn) {
+    on_topk_walk_fn_ = fn;
+    return *this;
+  }
+
   PlanFragmentWalker& OnGRPCSource(const GRPCSourceWalkFn& fn) {
     on_grpc_source_walk_fn_ = fn;
     return *this;
@@ -201,6 +223,8 @@ class PlanFragmentWalker {
   LimitWalkFn on_limit_walk_fn_;
   UnionWalkFn on_union_walk_fn_;
   JoinWalkFn on_join_walk_fn_;
+  SortWalkFn on_sort_walk_fn_;
+  TopKWalkFn on_topk_walk_fn_;
   GRPCSinkWalkFn on_grpc_sink_walk_fn_;
   GRPCSourceWalkFn on_grpc_source_walk_fn_;
   UDTFSourceWalkFn on_udtf_source_walk_fn_;
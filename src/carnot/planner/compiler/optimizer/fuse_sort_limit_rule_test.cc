@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/compiler/optimizer/fuse_sort_limit_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using ::testing::ElementsAre;
+
+using FuseSortLimitRuleTest = RulesTest;
+
+TEST_F(FuseSortLimitRuleTest, fuses_limit_into_sort) {
+  MemorySourceIR* mem_src = MakeMemSource(MakeRelation());
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  SortIR* sort = MakeSort(mem_src, {"cpu0", "count"}, {false, true});
+  LimitIR* limit = MakeLimit(sort, 10);
+  auto limit_id = limit->id();
+  MemorySinkIR* sink = MakeMemSink(limit, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  FuseSortLimitRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_FALSE(graph->HasNode(limit_id));
+  EXPECT_THAT(sink->parents(), ElementsAre(sort));
+  EXPECT_TRUE(sort->limit_value_set());
+  EXPECT_EQ(10, sort->limit_value());
+
+  planpb::Operator pb;
+  ASSERT_OK(sort->ToProto(&pb));
+  EXPECT_EQ(planpb::TOPK_OPERATOR, pb.op_type());
+  EXPECT_EQ(10, pb.topk_op().k());
+  ASSERT_EQ(2, pb.topk_op().sort_keys_size());
+  EXPECT_EQ(1, pb.topk_op().sort_keys(0).index());
+  EXPECT_TRUE(pb.topk_op().sort_keys(0).descending());
+  EXPECT_EQ(0, pb.topk_op().sort_keys(1).index());
+  EXPECT_FALSE(pb.topk_op().sort_keys(1).descending());
+  EXPECT_EQ(4, pb.topk_op().columns_size());
+}
+
+TEST_F(FuseSortLimitRuleTest, sort_with_other_children_not_fused) {
+  MemorySourceIR* mem_src = MakeMemSource(MakeRelation());
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  SortIR* sort = MakeSort(mem_src, {"cpu0"}, {true});
+  LimitIR* limit = MakeLimit(sort, 10);
+  MakeMemSink(limit, "out");
+  MakeMemSink(sort, "out2");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  FuseSortLimitRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_FALSE(sort->limit_value_set());
+
+  planpb::Operator pb;
+  ASSERT_OK(sort->ToProto(&pb));
+  EXPECT_EQ(planpb::SORT_OPERATOR, pb.op_type());
+}
+
+TEST_F(FuseSortLimitRuleTest, pem_only_limit_not_fused) {
+  MemorySourceIR* mem_src = MakeMemSource(MakeRelation());
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  SortIR* sort = MakeSort(mem_src, {"cpu0"}, {true});
+  LimitIR* limit = MakeLimit(sort, 10, /* pem_only */ true);
+  MakeMemSink(limit, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  FuseSortLimitRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -23,6 +23,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "src/carnot/planner/compiler/optimizer/fuse_sort_limit_rule.h"
 #include "src/carnot/planner/compiler/optimizer/merge_nodes_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unconnected_operators_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unused_columns_rule.h"
@@ -57,6 +58,11 @@ class Optimizer : public RuleExecutor<IR> {
     merge_nodes_batch->AddRule<MergeNodesRule>(compiler_state_);
   }
 
+  void CreateFuseSortLimitBatch() {
+    RuleBatch* fuse_sort_limit = CreateRuleBatch<FailOnMax>("FuseSortLimit", 2);
+    fuse_sort_limit->AddRule<FuseSortLimitRule>();
+  }
+
   void CreatePruneUnusedColumnsBatch() {
     RuleBatch* prune_unused_columns = CreateRuleBatch<FailOnMax>("PruneUnusedColumns", 2);
     prune_unused_columns->AddRule<PruneUnusedColumnsRule>();
@@ -65,6 +71,7 @@ class Optimizer : public RuleExecutor<IR> {
   Status Init() {
     CreatePruneUnconnectedOpsBatch();
     CreateMergeNodesBatch();
+    CreateFuseSortLimitBatch();
     CreatePruneUnusedColumnsBatch();
     return Status::OK();
   }
@@ -561,6 +561,12 @@ class OperatorTests : public ::testing::Test {
     return limit;
   }
 
+  SortIR* MakeSort(OperatorIR* parent, const std::vector<std::string>& sort_cols,
+                   const std::vector<bool>& ascending) {
+    SortIR* sort = graph->CreateNode<SortIR>(ast, parent, sort_cols, ascending).ConsumeValueOrDie();
+    return sort;
+  }
+
   BlockingAggIR* MakeBlockingAgg(OperatorIR* parent, const std::vector<ColumnIR*>& columns,
                                  const ColExpressionVector& col_agg) {
     BlockingAggIR* agg =
@@ -1418,6 +1424,14 @@ void CompareCloneNode(LimitIR* new_ir, LimitIR* old_ir, const std::string& err_s
   EXPECT_EQ(new_ir->limit_value_set(), old_ir->limit_value_set()) << err_string;
 }
 
+template <>
+void CompareCloneNode(SortIR* new_ir, SortIR* old_ir, const std::string& err_string) {
+  EXPECT_EQ(new_ir->sort_cols(), old_ir->sort_cols()) << err_string;
+  EXPECT_EQ(new_ir->ascending(), old_ir->ascending()) << err_string;
+  EXPECT_EQ(new_ir->limit_value_set(), old_ir->limit_value_set()) << err_string;
+  EXPECT_EQ(new_ir->limit_value(), old_ir->limit_value()) << err_string;
+}
+
 template <>
 void CompareCloneNode(FuncIR* new_ir, FuncIR* old_ir, const std::string& err_string) {
   EXPECT_TRUE(new_ir->Equals(old_ir)) << err_string;
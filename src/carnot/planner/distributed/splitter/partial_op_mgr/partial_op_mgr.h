@@ -87,6 +87,24 @@ class LimitOperatorMgr : public PartialOperatorMgr {
                                             OperatorIR* op) const override;
 };
 
+/**
+ * @brief TopKOperatorMgr manages splitting a Sort with a limit (a TopK) over the boundary. The
+ * Prepare TopK keeps the top rows of each agent, and the Merge TopK keeps the top rows of those,
+ * so each agent sends at most k rows instead of all of its rows.
+ */
+class TopKOperatorMgr : public PartialOperatorMgr {
+ public:
+  bool Matches(OperatorIR* op) const override {
+    if (!Match(op, Sort())) {
+      return false;
+    }
+    return static_cast<SortIR*>(op)->limit_value_set();
+  }
+  StatusOr<OperatorIR*> CreatePrepareOperator(IR* plan, OperatorIR* op) const override;
+  StatusOr<OperatorIR*> CreateMergeOperator(IR* plan, OperatorIR* new_parent,
+                                            OperatorIR* op) const override;
+};
+
 /**
  * @brief AggOperatorMgr manages splitting aggregates into partial aggregate and the merging node
  * over a network boundary.
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/memory_source_predicate_push_down_rule.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+namespace {
+
+// Returns the predicate op for `column <opcode> constant`, flipping the comparison if the constant
+// is on the left hand side.
+std::optional<planpb::SourceColumnPredicate::Op> PredicateOp(FuncIR::Opcode opcode,
+                                                            bool column_on_left) {
+  switch (opcode) {
+    case FuncIR::Opcode::eq:
+      return planpb::SourceColumnPredicate::EQUAL;
+    case FuncIR::Opcode::neq:
+      return planpb::SourceColumnPredicate::NOT_EQUAL;
+    case FuncIR::Opcode::lt:
+      return column_on_left ? planpb::SourceColumnPredicate::LESS_THAN
+                            : planpb::SourceColumnPredicate::GREATER_THAN;
+    case FuncIR::Opcode::lteq:
+      return column_on_left ? planpb::SourceColumnPredicate::LESS_THAN_EQUAL
+                            : planpb::SourceColumnPredicate::GREATER_THAN_EQUAL;
+    case FuncIR::Opcode::gt:
+      return column_on_left ? planpb::SourceColumnPredicate::GREATER_THAN
+                            : planpb::SourceColumnPredicate::LESS_THAN;
+    case FuncIR::Opcode::gteq:
+      return column_on_left ? planpb::SourceColumnPredicate::GREATER_THAN_EQUAL
+                            : planpb::SourceColumnPredicate::LESS_THAN_EQUAL;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Whether a constant of type `value_type` can be compared against the zone maps of a column of
+// type `column_type`.
+bool CanCompare(types::DataType column_type, types::DataType value_type) {
+  switch (column_type) {
+    case types::DataType::INT64:
+    case types::DataType::STRING:
+      return value_type == column_type;
+    case types::DataType::TIME64NS:
+    case types::DataType::FLOAT64:
+      return value_type == column_type || value_type == types::DataType::INT64;
+    default:
+      return false;
+  }
+}
+
+bool SamePredicates(const std::vector<planpb::SourceColumnPredicate>& a,
+                    const std::vector<planpb::SourceColumnPredicate>& b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const auto& lhs, const auto& rhs) {
+                      return google::protobuf::util::MessageDifferencer::Equals(lhs, rhs);
+                    });
+}
+
+}  // namespace
+
+Status MemorySourcePredicatePushdownRule::CollectPredicates(
+    MemorySourceIR* mem_src, ExpressionIR* expr,
+    std::vector<planpb::SourceColumnPredicate>* predicates) {
+  if (!Match(expr, Func())) {
+    return Status::OK();
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  if (func->opcode() == FuncIR::Opcode::logand) {
+    for (ExpressionIR* arg : func->all_args()) {
+      PL_RETURN_IF_ERROR(CollectPredicates(mem_src, arg, predicates));
+    }
+    return Status::OK();
+  }
+  if (func->all_args().size() != 2) {
+    return Status::OK();
+  }
+
+  ExpressionIR* lhs = func->all_args()[0];
+  ExpressionIR* rhs = func->all_args()[1];
+  bool column_on_left = Match(lhs, ColumnNode()) && Match(rhs, DataNode());
+  bool column_on_right = Match(lhs, DataNode()) && Match(rhs, ColumnNode());
+  if (!column_on_left && !column_on_right) {
+    return Status::OK();
+  }
+  auto op = PredicateOp(func->opcode(), column_on_left);
+  if (!op.has_value()) {
+    return Status::OK();
+  }
+  auto column = static_cast<ColumnIR*>(column_on_left ? lhs : rhs);
+  auto value = static_cast<DataIR*>(column_on_left ? rhs : lhs);
+
+  const auto& col_names = mem_src->resolved_table_type()->ColumnNames();
+  auto it = std::find(col_names.begin(), col_names.end(), column->col_name());
+  if (it == col_names.end()) {
+    return Status::OK();
+  }
+  PL_ASSIGN_OR_RETURN(auto col_type,
+                      mem_src->resolved_table_type()->GetColumnType(column->col_name()));
+  auto col_data_type = std::static_pointer_cast<ValueType>(col_type)->data_type();
+  if (!CanCompare(col_data_type, value->EvaluatedDataType())) {
+    return Status::OK();
+  }
+
+  planpb::SourceColumnPredicate predicate;
+  predicate.set_column_idx(mem_src->column_index_map()[std::distance(col_names.begin(), it)]);
+  predicate.set_op(op.value());
+  PL_RETURN_IF_ERROR(value->ToProto(predicate.mutable_value()));
+  predicates->push_back(std::move(predicate));
+  return Status::OK();
+}
+
+StatusOr<bool> MemorySourcePredicatePushdownRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, MemorySource())) {
+    return false;
+  }
+  auto mem_src = static_cast<MemorySourceIR*>(ir_node);
+  if (!mem_src->is_type_resolved() || !mem_src->column_index_map_set()) {
+    return false;
+  }
+
+  // Collect the predicates of the chain of filters directly following the MemorySource. Every row
+  // the MemorySource outputs has to pass all of them, so they can be combined as a conjunction.
+  std::vector<planpb::SourceColumnPredicate> predicates;
+  OperatorIR* current_node = mem_src;
+  while (current_node->Children().size() == 1 && Match(current_node->Children()[0], Filter())) {
+    auto filter = static_cast<FilterIR*>(current_node->Children()[0]);
+    PL_RETURN_IF_ERROR(CollectPredicates(mem_src, filter->filter_expr(), &predicates));
+    current_node = filter;
+  }
+
+  // Annotate the columns that the predicates read, so that the MemorySource reads them first and
+  // only reads its other columns for the rows that satisfy the predicates. This only pays off if
+  // the MemorySource outputs other columns.
+  std::vector<int64_t> predicate_column_idxs;
+  for (const auto& predicate : predicates) {
+    if (std::find(predicate_column_idxs.begin(), predicate_column_idxs.end(),
+                  predicate.column_idx()) == predicate_column_idxs.end()) {
+      predicate_column_idxs.push_back(predicate.column_idx());
+    }
+  }
+  const auto& output_column_idxs = mem_src->column_index_map();
+  bool has_other_columns = std::any_of(
+      output_column_idxs.begin(), output_column_idxs.end(), [&](int64_t col_idx) {
+        return std::find(predicate_column_idxs.begin(), predicate_column_idxs.end(), col_idx) ==
+               predicate_column_idxs.end();
+      });
+  if (!has_other_columns) {
+    predicate_column_idxs.clear();
+  }
+
+  if (SamePredicates(predicates, mem_src->predicates()) &&
+      predicate_column_idxs == mem_src->predicate_column_idxs()) {
+    return false;
+  }
+  mem_src->SetPredicates(predicates);
+  mem_src->SetPredicateColumnIdxs(predicate_column_idxs);
+  return true;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief This rule copies simple comparisons between a column and a constant, from the filters
+ * directly following a MemorySource, into the MemorySource's predicates. The MemorySource uses
+ * them to skip table batches that can't match. The rule also annotates the columns the predicates
+ * read, so that the MemorySource can evaluate them on each batch before it reads the remaining
+ * columns, and only read those for the matching rows. The filters are left in place, since they
+ * can contain more than the predicates. It must run after FilterPushdownRule, so that filters have
+ * already been moved next to their MemorySource.
+ */
+class MemorySourcePredicatePushdownRule : public Rule {
+ public:
+  explicit MemorySourcePredicatePushdownRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ false, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode*) override;
+
+ private:
+  Status CollectPredicates(MemorySourceIR* mem_src, ExpressionIR* expr,
+                           std::vector<planpb::SourceColumnPredicate>* predicates);
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
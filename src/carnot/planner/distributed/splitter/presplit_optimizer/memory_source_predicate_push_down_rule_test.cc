@@ -0,0 +1,161 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/memory_source_predicate_push_down_rule.h"
+#include "src/carnot/planner/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using ::testing::ElementsAre;
+
+class MemorySourcePredicatePushdownTest : public testutils::DistributedRulesTest {
+ protected:
+  FuncIR* MakeBinaryOpFunc(const std::string& python_op, ExpressionIR* left,
+                           ExpressionIR* right) {
+    return graph
+        ->CreateNode<FuncIR>(ast, FuncIR::op_map.find(python_op)->second,
+                             std::vector<ExpressionIR*>({left, right}))
+        .ConsumeValueOrDie();
+  }
+
+  MemorySourceIR* MakeResolvedMemSource(const Relation& relation,
+                                        const std::vector<std::string>& columns) {
+    compiler_state_->relation_map()->emplace("source", relation);
+    MemorySourceIR* src = MakeMemSource("source", columns);
+    EXPECT_OK(src->ResolveType(compiler_state_.get()));
+    return src;
+  }
+};
+
+TEST_F(MemorySourcePredicatePushdownTest, conjunction_of_filters) {
+  Relation relation({types::DataType::TIME64NS, types::DataType::STRING, types::DataType::INT64},
+                    {"time_", "service", "latency"});
+  // Only select a subset of the columns, so that column indices of the predicates have to be
+  // mapped back to the table's column indices.
+  MemorySourceIR* src = MakeResolvedMemSource(relation, {"latency", "service"});
+
+  auto latency_gt = MakeBinaryOpFunc(">", MakeColumn("latency", 0), MakeInt(100));
+  auto service_eq = MakeEqualsFunc(MakeColumn("service", 0), MakeString("carts"));
+  FilterIR* filter1 = MakeFilter(src, MakeAndFunc(latency_gt, service_eq));
+  // The constant is on the left hand side, so the comparison is flipped.
+  FilterIR* filter2 =
+      MakeFilter(filter1, MakeBinaryOpFunc("<=", MakeInt(500), MakeColumn("latency", 0)));
+  MakeMemSink(filter2, "foo", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  ASSERT_OK_AND_ASSIGN(bool result, rule.Execute(graph.get()));
+  EXPECT_TRUE(result);
+
+  ASSERT_EQ(3, src->predicates().size());
+  EXPECT_EQ(2, src->predicates()[0].column_idx());
+  EXPECT_EQ(planpb::SourceColumnPredicate::GREATER_THAN, src->predicates()[0].op());
+  EXPECT_EQ(100, src->predicates()[0].value().int64_value());
+  EXPECT_EQ(1, src->predicates()[1].column_idx());
+  EXPECT_EQ(planpb::SourceColumnPredicate::EQUAL, src->predicates()[1].op());
+  EXPECT_EQ("carts", src->predicates()[1].value().string_value());
+  EXPECT_EQ(2, src->predicates()[2].column_idx());
+  EXPECT_EQ(planpb::SourceColumnPredicate::GREATER_THAN_EQUAL, src->predicates()[2].op());
+  EXPECT_EQ(500, src->predicates()[2].value().int64_value());
+
+  // The filters stay in place.
+  EXPECT_THAT(src->Children(), ElementsAre(filter1));
+  EXPECT_THAT(filter1->Children(), ElementsAre(filter2));
+
+  // Running the rule again doesn't change anything.
+  ASSERT_OK_AND_ASSIGN(result, rule.Execute(graph.get()));
+  EXPECT_FALSE(result);
+
+  planpb::Operator pb;
+  ASSERT_OK(src->ToProto(&pb));
+  EXPECT_EQ(3, pb.mem_source_op().predicates_size());
+  // Every column the source outputs is read by the predicates, so there is nothing to materialize
+  // late.
+  EXPECT_EQ(0, pb.mem_source_op().predicate_column_idxs_size());
+}
+
+TEST_F(MemorySourcePredicatePushdownTest, annotates_predicate_columns) {
+  Relation relation({types::DataType::TIME64NS, types::DataType::STRING, types::DataType::INT64,
+                     types::DataType::STRING},
+                    {"time_", "service", "latency", "req_body"});
+  MemorySourceIR* src = MakeResolvedMemSource(relation, {"latency", "service", "req_body"});
+
+  auto latency_gt = MakeBinaryOpFunc(">", MakeColumn("latency", 0), MakeInt(100));
+  auto service_eq = MakeEqualsFunc(MakeColumn("service", 0), MakeString("carts"));
+  auto latency_lt = MakeBinaryOpFunc("<", MakeColumn("latency", 0), MakeInt(500));
+  FilterIR* filter = MakeFilter(src, MakeAndFunc(MakeAndFunc(latency_gt, service_eq), latency_lt));
+  MakeMemSink(filter, "foo", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  ASSERT_OK_AND_ASSIGN(bool result, rule.Execute(graph.get()));
+  EXPECT_TRUE(result);
+  EXPECT_EQ(3, src->predicates().size());
+  EXPECT_THAT(src->predicate_column_idxs(), ElementsAre(2, 1));
+
+  planpb::Operator pb;
+  ASSERT_OK(src->ToProto(&pb));
+  EXPECT_THAT(pb.mem_source_op().predicate_column_idxs(), ElementsAre(2, 1));
+}
+
+TEST_F(MemorySourcePredicatePushdownTest, unsupported_expressions) {
+  Relation relation({types::DataType::INT64, types::DataType::INT64, types::DataType::BOOLEAN},
+                    {"abc", "xyz", "flag"});
+  MemorySourceIR* src = MakeResolvedMemSource(relation, {"abc", "xyz", "flag"});
+
+  // Comparisons between two columns, disjunctions, non-comparison functions, and unsupported column
+  // types can't be checked against zone maps.
+  auto two_cols = MakeEqualsFunc(MakeColumn("abc", 0), MakeColumn("xyz", 0));
+  auto disjunction = MakeOrFunc(MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(1)),
+                                MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(2)));
+  auto non_comparison = MakeFunc("contains", {MakeColumn("abc", 0), MakeInt(1)});
+  auto bool_col = MakeEqualsFunc(MakeColumn("flag", 0),
+                                 graph->CreateNode<BoolIR>(ast, true).ConsumeValueOrDie());
+  FilterIR* filter = MakeFilter(
+      src, MakeAndFunc(MakeAndFunc(two_cols, disjunction), MakeAndFunc(non_comparison, bool_col)));
+  MakeMemSink(filter, "foo", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  ASSERT_OK_AND_ASSIGN(bool result, rule.Execute(graph.get()));
+  EXPECT_FALSE(result);
+  EXPECT_EQ(0, src->predicates().size());
+}
+
+TEST_F(MemorySourcePredicatePushdownTest, filter_after_map_is_ignored) {
+  Relation relation({types::DataType::INT64}, {"abc"});
+  MemorySourceIR* src = MakeResolvedMemSource(relation, {"abc"});
+  MapIR* map = MakeMap(src, {{"abc", MakeAddFunc(MakeColumn("abc", 0), MakeInt(1))}}, false);
+  FilterIR* filter = MakeFilter(map, MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(2)));
+  MakeMemSink(filter, "foo", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  ASSERT_OK_AND_ASSIGN(bool result, rule.Execute(graph.get()));
+  EXPECT_FALSE(result);
+  EXPECT_EQ(0, src->predicates().size());
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
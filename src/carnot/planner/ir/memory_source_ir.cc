@@ -64,6 +64,12 @@ Status MemorySourceIR::ToProto(planpb::Operator* op) const {
   }
 
   pb->set_streaming(streaming());
+  for (const auto& predicate : predicates_) {
+    *pb->add_predicates() = predicate;
+  }
+  for (int64_t col_idx : predicate_column_idxs_) {
+    pb->add_predicate_column_idxs(col_idx);
+  }
   return Status::OK();
 }
 
@@ -106,6 +112,8 @@ Status MemorySourceIR::CopyFromNodeImpl(const IRNode* node,
   column_index_map_set_ = source_ir->column_index_map_set_;
   column_index_map_ = source_ir->column_index_map_;
   streaming_ = source_ir->streaming_;
+  predicates_ = source_ir->predicates_;
+  predicate_column_idxs_ = source_ir->predicate_column_idxs_;
 
   return Status::OK();
 }
@@ -102,6 +102,20 @@ class MemorySourceIR : public OperatorIR {
 
   void SetColumnNames(const std::vector<std::string>& col_names) { column_names_ = col_names; }
 
+  // Predicates on the source table's columns, which the MemorySource uses to skip batches of the
+  // table that can't match. These don't replace the filters that they were derived from.
+  const std::vector<planpb::SourceColumnPredicate>& predicates() const { return predicates_; }
+  void SetPredicates(const std::vector<planpb::SourceColumnPredicate>& predicates) {
+    predicates_ = predicates;
+  }
+
+  // The table columns that the predicates read. If set, the MemorySource only reads the other
+  // columns for the rows that satisfy the predicates, and drops the rest.
+  const std::vector<int64_t>& predicate_column_idxs() const { return predicate_column_idxs_; }
+  void SetPredicateColumnIdxs(const std::vector<int64_t>& predicate_column_idxs) {
+    predicate_column_idxs_ = predicate_column_idxs;
+  }
+
   bool IsSource() const override { return true; }
 
   Status ResolveType(CompilerState* compiler_state);
@@ -126,6 +140,9 @@ class MemorySourceIR : public OperatorIR {
 
   types::TabletID tablet_value_;
   bool has_tablet_value_ = false;
+
+  std::vector<planpb::SourceColumnPredicate> predicates_;
+  std::vector<int64_t> predicate_column_idxs_;
 };
 
 }  // namespace planner
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/ir/sort_ir.h"
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_join.h>
+
+#include "src/carnot/planner/ir/ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+Status SortIR::Init(OperatorIR* parent, const std::vector<std::string>& sort_cols,
+                    const std::vector<bool>& ascending) {
+  DCHECK_EQ(sort_cols.size(), ascending.size());
+  if (sort_cols.empty()) {
+    return CreateIRNodeError("Expected at least one column to sort by");
+  }
+  PL_RETURN_IF_ERROR(AddParent(parent));
+  sort_cols_ = sort_cols;
+  ascending_ = ascending;
+  return Status::OK();
+}
+
+std::string SortIR::DebugString() const {
+  return absl::Substitute("$0(id=$1, by=[$2]$3)", type_string(), id(),
+                          absl::StrJoin(sort_cols_, ","),
+                          limit_value_set_ ? absl::StrCat(", limit=", limit_value_) : "");
+}
+
+Status SortIR::ResolveType(CompilerState* /* compiler_state */) {
+  DCHECK_EQ(1U, parent_types().size());
+  auto parent_table_type = std::static_pointer_cast<TableType>(parent_types()[0]);
+  for (const auto& col_name : sort_cols_) {
+    if (!parent_table_type->HasColumn(col_name)) {
+      return CreateIRNodeError("Column '$0' not found in parent dataframe", col_name);
+    }
+  }
+  PL_ASSIGN_OR_RETURN(auto type_ptr, OperatorIR::DefaultResolveType(parent_types()));
+  return SetResolvedType(type_ptr);
+}
+
+StatusOr<std::vector<absl::flat_hash_set<std::string>>> SortIR::RequiredInputColumns() const {
+  DCHECK(is_type_resolved());
+  absl::flat_hash_set<std::string> required(resolved_table_type()->ColumnNames().begin(),
+                                            resolved_table_type()->ColumnNames().end());
+  required.insert(sort_cols_.begin(), sort_cols_.end());
+  return std::vector<absl::flat_hash_set<std::string>>{required};
+}
+
+StatusOr<absl::flat_hash_set<std::string>> SortIR::PruneOutputColumnsToImpl(
+    const absl::flat_hash_set<std::string>& output_cols) {
+  // The sort columns are kept in the output, so that the output of a TopK that runs on the PEMs
+  // can be merged by another TopK on Kelvin.
+  absl::flat_hash_set<std::string> kept_columns = output_cols;
+  kept_columns.insert(sort_cols_.begin(), sort_cols_.end());
+  return kept_columns;
+}
+
+Status SortIR::ToProto(planpb::Operator* op) const {
+  DCHECK_EQ(parents().size(), 1UL);
+  DCHECK(parents()[0]->is_type_resolved());
+  auto parent_table_type = parents()[0]->resolved_table_type();
+  auto parent_id = parents()[0]->id();
+
+  google::protobuf::RepeatedPtrField<planpb::SortKey>* sort_keys;
+  google::protobuf::RepeatedPtrField<planpb::Column>* columns;
+  if (limit_value_set_) {
+    op->set_op_type(planpb::TOPK_OPERATOR);
+    auto pb = op->mutable_topk_op();
+    pb->set_k(limit_value_);
+    sort_keys = pb->mutable_sort_keys();
+    columns = pb->mutable_columns();
+  } else {
+    op->set_op_type(planpb::SORT_OPERATOR);
+    auto pb = op->mutable_sort_op();
+    sort_keys = pb->mutable_sort_keys();
+    columns = pb->mutable_columns();
+  }
+
+  for (const auto& [i, col_name] : Enumerate(sort_cols_)) {
+    if (!parent_table_type->HasColumn(col_name)) {
+      return CreateIRNodeError("Column '$0' not found in parent dataframe", col_name);
+    }
+    planpb::SortKey* key = sort_keys->Add();
+    key->set_index(parent_table_type->GetColumnIndex(col_name));
+    key->set_descending(!ascending_[i]);
+  }
+
+  DCHECK(is_type_resolved());
+  for (const std::string& col_name : resolved_table_type()->ColumnNames()) {
+    planpb::Column* col_pb = columns->Add();
+    col_pb->set_node(parent_id);
+    DCHECK(parent_table_type->HasColumn(col_name));
+    col_pb->set_index(parent_table_type->GetColumnIndex(col_name));
+  }
+  return Status::OK();
+}
+
+Status SortIR::CopyFromNodeImpl(const IRNode* node, absl::flat_hash_map<const IRNode*, IRNode*>*) {
+  const SortIR* sort = static_cast<const SortIR*>(node);
+  sort_cols_ = sort->sort_cols_;
+  ascending_ = sort->ascending_;
+  limit_value_ = sort->limit_value_;
+  limit_value_set_ = sort->limit_value_set_;
+  return Status::OK();
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
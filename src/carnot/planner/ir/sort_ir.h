@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/ir/operator_ir.h"
+#include "src/carnot/planner/types/types.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * @brief The SortIR orders the rows of its parent by a list of columns.
+ *
+ * A Sort followed by a Limit is fused into a single Sort with a limit, which compiles to a TopK
+ * operator instead of a Sort. Only the TopK can be split across the PEMs and Kelvin.
+ */
+class SortIR : public OperatorIR {
+ public:
+  SortIR() = delete;
+  explicit SortIR(int64_t id) : OperatorIR(id, IRNodeType::kSort) {}
+
+  Status Init(OperatorIR* parent, const std::vector<std::string>& sort_cols,
+              const std::vector<bool>& ascending);
+
+  Status ToProto(planpb::Operator*) const override;
+  std::string DebugString() const override;
+
+  const std::vector<std::string>& sort_cols() const { return sort_cols_; }
+  const std::vector<bool>& ascending() const { return ascending_; }
+
+  void SetLimitValue(int64_t value) {
+    limit_value_ = value;
+    limit_value_set_ = true;
+  }
+  bool limit_value_set() const { return limit_value_set_; }
+  int64_t limit_value() const { return limit_value_; }
+
+  Status CopyFromNodeImpl(const IRNode* node,
+                          absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) override;
+  bool IsBlocking() const override { return true; }
+
+  Status ResolveType(CompilerState* compiler_state);
+  StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override;
+
+ protected:
+  StatusOr<absl::flat_hash_set<std::string>> PruneOutputColumnsToImpl(
+      const absl::flat_hash_set<std::string>& output_cols) override;
+
+ private:
+  std::vector<std::string> sort_cols_;
+  std::vector<bool> ascending_;
+  int64_t limit_value_ = 0;
+  bool limit_value_set_ = false;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
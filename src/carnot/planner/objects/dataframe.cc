@@ -270,6 +270,31 @@ StatusOr<QLObjectPtr> LimitHandler(CompilerState* compiler_state, IR* graph, Ope
   return Dataframe::Create(compiler_state, limit_op, visitor);
 }
 
+// Handles the sort() DataFrame logic.
+StatusOr<QLObjectPtr> SortHandler(CompilerState* compiler_state, IR* graph, OperatorIR* op,
+                                  const pypa::AstPtr& ast, const ParsedArgs& args,
+                                  ASTVisitor* visitor) {
+  PL_ASSIGN_OR_RETURN(std::vector<std::string> sort_cols,
+                      ParseAsListOfStrings(args.GetArg("by"), "by"));
+  PL_ASSIGN_OR_RETURN(std::vector<BoolIR*> ascending_irs,
+                      ParseAsListOf<BoolIR>(args.GetArg("ascending"), "ascending"));
+  std::vector<bool> ascending;
+  for (BoolIR* ascending_ir : ascending_irs) {
+    ascending.push_back(ascending_ir->val());
+  }
+  // A single value applies to every column.
+  if (ascending.size() == 1) {
+    ascending.resize(sort_cols.size(), ascending[0]);
+  }
+  if (ascending.size() != sort_cols.size()) {
+    return CreateAstError(ast, "Length of 'ascending' ($0) must match length of 'by' ($1)",
+                          ascending.size(), sort_cols.size());
+  }
+
+  PL_ASSIGN_OR_RETURN(SortIR * sort_op, graph->CreateNode<SortIR>(ast, op, sort_cols, ascending));
+  return Dataframe::Create(compiler_state, sort_op, visitor);
+}
+
 class SubscriptHandler {
  public:
   /**
@@ -437,6 +462,23 @@ Status Dataframe::Init() {
     return Status::OK();
   }
 
+  /**
+   * # Equivalent to the python method method syntax:
+   * def sort(self, by, ascending=True):
+   *     ...
+   */
+  PL_ASSIGN_OR_RETURN(
+      std::shared_ptr<FuncObject> sortfn,
+      FuncObject::Create(
+          kSortOpID, {"by", "ascending"}, {{"ascending", "True"}},
+          /* has_variable_len_args */ false,
+          /* has_variable_len_kwargs */ false,
+          std::bind(&SortHandler, compiler_state_, graph(), op(), std::placeholders::_1,
+                    std::placeholders::_2, std::placeholders::_3),
+          ast_visitor()));
+  PL_RETURN_IF_ERROR(sortfn->SetDocString(kSortOpDocstring));
+  AddMethod(kSortOpID, sortfn);
+
   /**
    * # Equivalent to the python method method syntax:
    * def merge(self, right, how, left_on, right_on, suffixes=['_x', '_y']):
@@ -281,6 +281,32 @@ class Dataframe : public QLObject {
     px.DataFrame: DataFrame with the first n rows.
   )doc";
 
+  inline static constexpr char kSortOpID[] = "sort";
+  inline static constexpr char kSortOpDocstring[] = R"doc(
+  Sorts the rows of the DataFrame by the values of the passed in columns.
+
+  Returns a DataFrame with the same columns, with its rows ordered by the first column in `by`,
+  then by the second, and so on. Sorting is done on Kelvin once all of the data has arrived.
+  A sort followed by `head(n)` only keeps the top n rows, which each PEM computes locally before
+  sending them to Kelvin.
+
+  :topic: dataframe_ops
+  :opname: Sort
+
+  Examples:
+    df = px.DataFrame('http_events')
+    # Keep the 10 slowest requests.
+    df = df.sort('latency', ascending=False).head(10)
+
+  Args:
+    by (Union[str,List[str]]): DataFrame columns to sort by, either as a string or a list.
+    ascending (Union[bool,List[bool]]): Sort ascending or descending. Either a single value
+      that applies to all of the columns, or a list of values, one per column in `by`.
+
+  Returns:
+    px.DataFrame: DataFrame with the rows in sorted order.
+  )doc";
+
   inline static constexpr char kMergeOpID[] = "merge";
   inline static constexpr char kMergeOpDocstring[] = R"doc(
   Merges the input DataFrame with this one using a database-style join.
@@ -335,6 +335,45 @@ columns {
   index: 2
 }
 )";
+// Sorts by the second column descending, then the first ascending, and outputs the first and third
+// columns.
+constexpr char kSortOperator1[] = R"(
+sort_keys {
+  index: 1
+  descending: true
+}
+sort_keys {
+  index: 0
+}
+columns {
+  node: 1
+  index: 0
+}
+columns {
+  node: 1
+  index: 2
+}
+)";
+
+constexpr char kTopKOperator1[] = R"(
+k: 3
+sort_keys {
+  index: 1
+  descending: true
+}
+sort_keys {
+  index: 0
+}
+columns {
+  node: 1
+  index: 0
+}
+columns {
+  node: 1
+  index: 2
+}
+)";
+
 // relation 1: [abc, time_]
 // relation 2: [time_, abc]
 // maps to output relation:
@@ -833,6 +872,79 @@ constexpr char kLinearPlanFragment[] = R"(
   }
 )";
 
+constexpr char kBlockingAggPlanFragment[] = R"(
+  id: 1,
+  dag {
+    nodes {
+      id: 1
+      sorted_children: 2
+    }
+    nodes {
+      id: 2
+      sorted_children: 3
+      sorted_parents: 1
+    }
+    nodes {
+      id: 3
+      sorted_parents: 2
+    }
+  }
+  nodes {
+    id: 1
+    op {
+      op_type: MEMORY_SOURCE_OPERATOR
+      mem_source_op {
+        name: "numbers"
+        column_idxs: 0
+        column_types: INT64
+        column_names: "group"
+        column_idxs: 1
+        column_types: INT64
+        column_names: "value"
+      }
+    }
+  }
+  nodes {
+    id: 2
+    op {
+      op_type: AGGREGATE_OPERATOR
+      agg_op {
+        windowed: false
+        values {
+          name: "sum"
+          id: 0
+          args {
+            column {
+              node: 1
+              index: 1
+            }
+          }
+          args_data_types: INT64
+        }
+        groups {
+          node: 1
+          index: 0
+        }
+        group_names: "group"
+        value_names: "sum"
+      }
+    }
+  }
+  nodes {
+    id: 3
+    op {
+      op_type: MEMORY_SINK_OPERATOR
+      mem_sink_op {
+        name: "output"
+        column_types: INT64
+        column_types: INT64
+        column_names: "group"
+        column_names: "sum"
+      }
+    }
+  }
+)";
+
 constexpr char kPlanWithFiveNodes[] = R"(
   dag {
     nodes {
@@ -1478,6 +1590,20 @@ planpb::Operator CreateTestDropLimit1PB() {
   return op;
 }
 
+planpb::Operator CreateTestSort1PB() {
+  planpb::Operator op;
+  auto op_proto = absl::Substitute(kOperatorProtoTmpl, "SORT_OPERATOR", "sort_op", kSortOperator1);
+  CHECK(google::protobuf::TextFormat::MergeFromString(op_proto, &op)) << "Failed to parse proto";
+  return op;
+}
+
+planpb::Operator CreateTestTopK1PB() {
+  planpb::Operator op;
+  auto op_proto = absl::Substitute(kOperatorProtoTmpl, "TOPK_OPERATOR", "topk_op", kTopKOperator1);
+  CHECK(google::protobuf::TextFormat::MergeFromString(op_proto, &op)) << "Failed to parse proto";
+  return op;
+}
+
 planpb::Operator CreateTestJoinWithTimePB() {
   planpb::Operator op;
   auto op_proto = absl::Substitute(kOperatorProtoTmpl, "JOIN_OPERATOR", "join_op", kJoinOperator1);
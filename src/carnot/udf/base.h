@@ -58,6 +58,7 @@ class BaseFunc {
   using Float64Value = types::Float64Value;
   using UInt128Value = types::UInt128Value;
   using StringValue = types::StringValue;
+  using StringViewValue = types::StringViewValue;
 };
 
 }  // namespace udf
@@ -74,10 +74,18 @@ class AnyUDA : public BaseFunc {
  *      Status Init(FunctionContext *ctx, UDFValue... init_args) {}
  *  This function is called once during initialization of each instance (many instances
  *  may exists in a given query). The arguments are as provided by the query.
+ *
+ * UDFs whose result depends on state outside of their arguments, such as the metadata state,
+ * must hide Deterministic() with a version that returns false.
  */
 class ScalarUDF : public AnyUDF {
  public:
   ~ScalarUDF() override = default;
+
+  /**
+   * Whether Exec always returns the same value for the same arguments.
+   */
+  static constexpr bool Deterministic() { return true; }
 };
 
 /**
@@ -104,6 +112,13 @@ class ScalarUDF : public AnyUDF {
 class UDA : public AnyUDA {
  public:
   ~UDA() override = default;
+
+  /**
+   * An estimate of the bytes that the state of an instance takes up, which aggregates track
+   * against their memory limit. UDAs whose state is bigger than a few values, such as sketches,
+   * hide this with their own estimate.
+   */
+  static constexpr int64_t StateBytesEstimate() { return 64; }
 };
 
 // SFINAE test for init fn.
@@ -183,6 +198,15 @@ static constexpr std::array<types::DataType, sizeof...(Types)> GetArgumentTypesH
       {types::ValueTypeTraits<Types>::data_type...});
 }
 
+// Returns, for each argument, whether it's a StringViewValue, i.e. whether it borrows the string
+// from the input instead of copying it.
+template <typename ReturnType, typename TUDF, typename... Types>
+static constexpr std::array<bool, sizeof...(Types)> GetArgumentViewsHelper(
+    ReturnType (TUDF::*)(FunctionContext*, Types...)) {
+  return std::array<bool, sizeof...(Types)>(
+      {std::is_same_v<std::decay_t<Types>, types::StringViewValue>...});
+}
+
 template <typename ReturnType, typename TUDF, typename... Types>
 static constexpr types::DataType ReturnTypeHelper(ReturnType (TUDF::*)(Types...)) {
   return types::ValueTypeTraits<ReturnType>::data_type;
@@ -211,6 +235,12 @@ class ScalarUDFTraits {
    */
   static constexpr auto ExecArguments() { return GetArgumentTypesHelper(&T::Exec); }
 
+  /**
+   * Whether each argument of Exec is a StringViewValue.
+   * @return an array with an entry per argument.
+   */
+  static constexpr auto ExecArgumentViews() { return GetArgumentViewsHelper(&T::Exec); }
+
   /**
    * Return types of the Exec function
    * @return A types::UDFDataType which is the return type of the Exec function.
@@ -351,6 +381,7 @@ template <typename T>
 class UDATraits {
  public:
   static constexpr auto UpdateArgumentTypes() { return GetArgumentTypesHelper<void>(&T::Update); }
+  static constexpr auto UpdateArgumentViews() { return GetArgumentViewsHelper<void>(&T::Update); }
   static constexpr types::DataType FinalizeReturnType() { return ReturnTypeHelper(&T::Finalize); }
 
   /**
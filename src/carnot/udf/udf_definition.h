@@ -111,6 +111,7 @@ class ScalarUDFDefinition : public UDFDefinition {
     } else {
       executor_ = udfspb::UDFSourceExecutor::UDF_ALL;
     }
+    deterministic_ = TUDF::Deterministic();
 
     return Status::OK();
   }
@@ -144,6 +145,8 @@ class ScalarUDFDefinition : public UDFDefinition {
   const std::vector<types::DataType>& exec_arguments() const { return exec_arguments_; }
   const std::vector<types::DataType>& init_arguments() const { return init_arguments_; }
   udfspb::UDFSourceExecutor executor() const { return executor_; }
+  // Whether the UDF always returns the same value for the same arguments.
+  bool deterministic() const { return deterministic_; }
 
   const std::vector<types::DataType>& RegistryArgTypes() override { return registry_arguments_; }
   size_t Arity() const { return exec_arguments_.size(); }
@@ -155,6 +158,7 @@ class ScalarUDFDefinition : public UDFDefinition {
   std::vector<types::DataType> registry_arguments_;
   types::DataType exec_return_type_;
   udfspb::UDFSourceExecutor executor_;
+  bool deterministic_ = true;
   std::function<std::unique_ptr<ScalarUDF>()> make_fn_;
   std::function<Status(ScalarUDF*, FunctionContext* ctx,
                        const std::vector<const types::ColumnWrapper*>& inputs,
@@ -207,8 +211,11 @@ class UDADefinition : public UDFDefinition {
     merge_fn_ = UDAWrapper<T>::Merge;
     finalize_arrow_fn_ = UDAWrapper<T>::FinalizeArrow;
     finalize_value_fn = UDAWrapper<T>::FinalizeValue;
+    serialize_arrow_fn_ = UDAWrapper<T>::SerializeArrow;
+    deserialize_fn_ = UDAWrapper<T>::Deserialize;
 
     supports_partial_ = UDAWrapper<T>::SupportsPartial;
+    state_bytes_estimate_ = T::StateBytesEstimate();
     return Status::OK();
   }
 
@@ -221,6 +228,8 @@ class UDADefinition : public UDFDefinition {
   types::DataType finalize_return_type() const { return finalize_return_type_; }
 
   bool supports_partial() const { return supports_partial_; }
+  // The estimated bytes of the state of an instance, see UDA::StateBytesEstimate.
+  int64_t state_bytes_estimate() const { return state_bytes_estimate_; }
 
   std::unique_ptr<UDA> Make() { return make_fn_(); }
 
@@ -245,6 +254,13 @@ class UDADefinition : public UDFDefinition {
   Status FinalizeArrow(UDA* uda, FunctionContext* ctx, arrow::ArrayBuilder* output) {
     return finalize_arrow_fn_(uda, ctx, output);
   }
+  // Only supported if supports_partial() is true.
+  Status SerializeArrow(UDA* uda, FunctionContext* ctx, arrow::ArrayBuilder* output) {
+    return serialize_arrow_fn_(uda, ctx, output);
+  }
+  Status Deserialize(UDA* uda, FunctionContext* ctx, const types::StringValue& data) {
+    return deserialize_fn_(uda, ctx, data);
+  }
 
  private:
   std::vector<types::DataType> init_arguments_;
@@ -252,6 +268,7 @@ class UDADefinition : public UDFDefinition {
   std::vector<types::DataType> registry_arguments_;
   types::DataType finalize_return_type_;
   bool supports_partial_;
+  int64_t state_bytes_estimate_ = 0;
 
   std::function<std::unique_ptr<UDA>()> make_fn_;
   std::function<Status(UDA* uda, FunctionContext* ctx,
@@ -270,6 +287,10 @@ class UDADefinition : public UDFDefinition {
   std::function<Status(UDA* uda, FunctionContext* ctx,
                        const std::vector<std::shared_ptr<types::BaseValueType>>& inputs)>
       init_wrapper_fn_;
+  std::function<Status(UDA* uda, FunctionContext* ctx, arrow::ArrayBuilder* output)>
+      serialize_arrow_fn_;
+  std::function<Status(UDA* uda, FunctionContext* ctx, const types::StringValue& data)>
+      deserialize_fn_;
 };
 
 class UDTFDefinition : public UDFDefinition {
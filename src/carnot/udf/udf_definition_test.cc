@@ -44,6 +44,13 @@ class SubStrUDF : public ScalarUDF {
   types::StringValue Exec(FunctionContext*, types::StringValue str) { return str.substr(1, 2); }
 };
 
+class SubStrViewUDF : public ScalarUDF {
+ public:
+  types::StringValue Exec(FunctionContext*, types::StringViewValue str) {
+    return std::string(str.substr(1, 2));
+  }
+};
+
 class AddUDF : public ScalarUDF {
  public:
   types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
@@ -115,6 +122,33 @@ TEST(UDFDefinition, str_args) {
   EXPECT_EQ("el", out[2]);
 }
 
+TEST(UDFDefinition, str_view_args) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("substr_view");
+  EXPECT_OK(def.Init<SubStrViewUDF>());
+  EXPECT_THAT(def.exec_arguments(), ElementsAre(types::STRING));
+
+  types::StringValueColumnWrapper v1({"abcd", "defg", "hello"});
+  types::StringValueColumnWrapper out(v1.Size());
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&v1}, &out, v1.Size()));
+  EXPECT_EQ("bc", out[0]);
+  EXPECT_EQ("ef", out[1]);
+  EXPECT_EQ("el", out[2]);
+
+  std::vector<types::StringValue> v2 = {"abcd", "defg", "hello"};
+  auto v2a = ToArrow(v2, arrow::default_memory_pool());
+  auto output_builder = std::make_shared<arrow::StringBuilder>();
+  EXPECT_OK(ScalarUDFWrapper<SubStrViewUDF>::ExecBatchArrow(u.get(), &ctx, {v2a.get()},
+                                                            output_builder.get(), 3));
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* res_arr = static_cast<arrow::StringArray*>(res.get());
+  EXPECT_EQ("bc", res_arr->GetString(0));
+  EXPECT_EQ("ef", res_arr->GetString(1));
+  EXPECT_EQ("el", res_arr->GetString(2));
+}
+
 TEST(UDFDefinition, arrow_write) {
   auto ctx = FunctionContext(nullptr, nullptr);
   std::vector<types::Int64Value> v1 = {1, 2, 3};
@@ -198,6 +232,17 @@ class InitArgUDA : public udf::UDA {
   std::vector<std::string> updates_;
 };
 
+// Test UDA, sums the lengths of its string arguments.
+class LengthSumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::StringViewValue arg) { sum_ += arg.length(); }
+  void Merge(udf::FunctionContext*, const LengthSumUDA& other) { sum_ += other.sum_; }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+
+ protected:
+  int64_t sum_ = 0;
+};
+
 TEST(UDADefinition, without_merge) {
   auto ctx = FunctionContext(nullptr, nullptr);
   UDADefinition def("minsum");
@@ -253,6 +298,24 @@ TEST(UDADefinition, arrow_output) {
   EXPECT_EQ(5, casted->Value(0));
 }
 
+TEST(UDADefinition, str_view_args) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  UDADefinition def("lengthsum");
+  EXPECT_OK(def.Init<LengthSumUDA>());
+  EXPECT_THAT(def.update_arguments(), ElementsAre(types::STRING));
+
+  types::StringValueColumnWrapper v1({"abcd", "defg", "hello"});
+  std::vector<types::StringValue> v2 = {"a", "bc"};
+  auto v2a = ToArrow(v2, arrow::default_memory_pool());
+
+  types::Int64Value out;
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatchUpdate(u.get(), &ctx, {&v1}));
+  EXPECT_OK(def.ExecBatchUpdateArrow(u.get(), &ctx, {v2a.get()}));
+  EXPECT_OK(def.FinalizeValue(u.get(), &ctx, &out));
+  EXPECT_EQ(16, out.val);
+}
+
 TEST(UDADefinition, init_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   UDADefinition def("initarguda");
@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <absl/strings/match.h>
 #include <benchmark/benchmark.h>
 
 #include <random>
@@ -36,10 +37,12 @@ using px::carnot::udf::ScalarUDF;
 using px::carnot::udf::ScalarUDFDefinition;
 using px::carnot::udf::ScalarUDFWrapper;
 using px::types::BaseValueType;
+using px::types::BoolValue;
 using px::types::Int64Value;
 using px::types::Int64ValueColumnWrapper;
 using px::types::StringValue;
 using px::types::StringValueColumnWrapper;
+using px::types::StringViewValue;
 using px::types::ToArrow;
 
 using px::datagen::CreateLargeData;
@@ -62,6 +65,22 @@ class SubStrUDF : public ScalarUDF {
   StringValue Exec(FunctionContext*, StringValue v1) { return v1.substr(1, 2); }
 };
 
+// Same as SubStrUDF, but borrows its argument instead of copying it.
+class SubStrViewUDF : public ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext*, StringViewValue v1) { return std::string(v1.substr(1, 2)); }
+};
+
+class ContainsUDF : public ScalarUDF {
+ public:
+  BoolValue Exec(FunctionContext*, StringValue v1) { return absl::StrContains(v1, "abc"); }
+};
+
+class ContainsViewUDF : public ScalarUDF {
+ public:
+  BoolValue Exec(FunctionContext*, StringViewValue v1) { return absl::StrContains(v1, "abc"); }
+};
+
 // This benchmark add two columns using Int64ValueVectors.
 // NOLINTNEXTLINE : runtime/references.
 static void BM_AddInt64Values(benchmark::State& state) {
@@ -217,17 +236,18 @@ static void BM_AddInt64ValueToArrow(benchmark::State& state) {
   state.SetBytesProcessed(int64_t(state.iterations()) * 2 * vec1.size() * sizeof(int64_t));
 }
 
-// Benchmark doing substring on arrow.
+// Benchmark doing substring on arrow, on strings of width range(1).
+template <typename TUDF>
 // NOLINTNEXTLINE : runtime/references.
 static void BM_SubStrArrow(benchmark::State& state) {
-  int width = 10;
+  int width = state.range(1);
   auto data = GenerateStringValueVector(state.range(0), width);
   auto in_arr = ToArrow(data, arrow::default_memory_pool());
 
   // Create UDF.
   std::shared_ptr<arrow::Array> out;
   ScalarUDFDefinition def("substr");
-  CHECK(def.template Init<SubStrUDF>().ok());
+  CHECK(def.template Init<TUDF>().ok());
   auto u = def.Make();
   // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
   for (auto _ : state) {
@@ -235,8 +255,35 @@ static void BM_SubStrArrow(benchmark::State& state) {
       out.reset();
     }
     auto output_builder = std::make_shared<arrow::StringBuilder>();
-    auto res = ScalarUDFWrapper<SubStrUDF>::ExecBatchArrow(u.get(), nullptr, {in_arr.get()},
-                                                           output_builder.get(), data.size());
+    auto res = ScalarUDFWrapper<TUDF>::ExecBatchArrow(u.get(), nullptr, {in_arr.get()},
+                                                      output_builder.get(), data.size());
+    CHECK(res.ok());
+    CHECK(output_builder->Finish(&out).ok());
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * width * data.size());
+}
+
+// Benchmark a string predicate on arrow, on strings of width range(1).
+template <typename TUDF>
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ContainsArrow(benchmark::State& state) {
+  int width = state.range(1);
+  auto data = GenerateStringValueVector(state.range(0), width);
+  auto in_arr = ToArrow(data, arrow::default_memory_pool());
+
+  std::shared_ptr<arrow::Array> out;
+  ScalarUDFDefinition def("contains");
+  CHECK(def.template Init<TUDF>().ok());
+  auto u = def.Make();
+  // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
+  for (auto _ : state) {
+    if (out) {
+      out.reset();
+    }
+    auto output_builder = std::make_shared<arrow::BooleanBuilder>();
+    auto res = ScalarUDFWrapper<TUDF>::ExecBatchArrow(u.get(), nullptr, {in_arr.get()},
+                                                      output_builder.get(), data.size());
     CHECK(res.ok());
     CHECK(output_builder->Finish(&out).ok());
     benchmark::DoNotOptimize(out);
@@ -251,5 +298,18 @@ BENCHMARK(BM_AddInt64Values)->RangeMultiplier(2)->Range(1, 1 << 16);
 BENCHMARK(BM_ConvertToArrowString)->RangeMultiplier(2)->Range(1, 1 << 16);
 BENCHMARK(BM_ConvertToArrowInt64)->RangeMultiplier(2)->Range(1, 1 << 16);
 
-BENCHMARK(BM_SubStrArrow)->RangeMultiplier(2)->Range(1, 1 << 16);
+// The view variants of the string UDFs borrow their arguments from the arrow array, instead of
+// copying each of them into a StringValue.
+BENCHMARK_TEMPLATE(BM_SubStrArrow, SubStrUDF)
+    ->RangeMultiplier(4)
+    ->Ranges({{1, 1 << 16}, {10, 640}});
+BENCHMARK_TEMPLATE(BM_SubStrArrow, SubStrViewUDF)
+    ->RangeMultiplier(4)
+    ->Ranges({{1, 1 << 16}, {10, 640}});
+BENCHMARK_TEMPLATE(BM_ContainsArrow, ContainsUDF)
+    ->RangeMultiplier(4)
+    ->Ranges({{1, 1 << 16}, {10, 640}});
+BENCHMARK_TEMPLATE(BM_ContainsArrow, ContainsViewUDF)
+    ->RangeMultiplier(4)
+    ->Ranges({{1, 1 << 16}, {10, 640}});
 BENCHMARK(BM_SubStr)->RangeMultiplier(2)->Range(1, 1 << 16);
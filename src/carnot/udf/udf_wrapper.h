@@ -95,6 +95,20 @@ inline auto UnWrap<types::StringValue>(const types::StringValue& s) {
   return s;
 }
 
+/**
+ * Returns the argument at idx of an arrow array. Arguments that are StringViewValues borrow the
+ * string from the array, all others are copied out of it.
+ */
+template <types::DataType TArgType, bool TIsView>
+inline auto GetArgFromArrowArray(const arrow::Array* arr, int64_t idx) {
+  if constexpr (TIsView) {
+    static_assert(TArgType == types::STRING, "Only string arguments can be views");
+    return types::StringViewValue(types::GetStringViewFromArrowArray(arr, idx));
+  } else {
+    return types::GetValueFromArrowArray<TArgType>(arr, idx);
+  }
+}
+
 /**
  * This is the inner wrapper for the arrow type.
  * This performs type casting and storing the data in the output builder.
@@ -104,6 +118,8 @@ Status ExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput*
                         const std::vector<arrow::Array*>& args, std::index_sequence<I...>) {
   [[maybe_unused]] static constexpr auto exec_argument_types =
       ScalarUDFTraits<TUDF>::ExecArguments();
+  [[maybe_unused]] static constexpr auto exec_argument_views =
+      ScalarUDFTraits<TUDF>::ExecArgumentViews();
   CHECK(out->Reserve(count).ok());
   size_t reserved = count * kStringAssumedSizeHeuristic;
   size_t total_size = 0;
@@ -115,7 +131,8 @@ Status ExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput*
   }
   for (size_t idx = 0; idx < count; ++idx) {
     auto res = UnWrap(
-        udf->Exec(ctx, types::GetValueFromArrowArray<exec_argument_types[I]>(args[I], idx)...));
+        udf->Exec(ctx, GetArgFromArrowArray<exec_argument_types[I], exec_argument_views[I]>(
+                           args[I], idx)...));
 
     // We use doubling to make sure we minimize the number of allocations.
     // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
@@ -303,8 +320,10 @@ template <typename TUDA, std::size_t... I>
 Status UpdateWrapperArrow(TUDA* uda, FunctionContext* ctx, size_t count,
                           const std::vector<const arrow::Array*>& args, std::index_sequence<I...>) {
   constexpr auto update_argument_types = UDATraits<TUDA>::UpdateArgumentTypes();
+  [[maybe_unused]] constexpr auto update_argument_views = UDATraits<TUDA>::UpdateArgumentViews();
   for (size_t idx = 0; idx < count; ++idx) {
-    uda->Update(ctx, types::GetValueFromArrowArray<update_argument_types[I]>(args[I], idx)...);
+    uda->Update(ctx, GetArgFromArrowArray<update_argument_types[I], update_argument_views[I]>(
+                         args[I], idx)...);
   }
   return Status::OK();
 }
@@ -419,6 +438,40 @@ struct UDAWrapper {
     return Status::OK();
   }
 
+  /**
+   * Serialize the partial state of the UDA into an arrow string builder.
+   * @return Status of the serialize, an error if the UDA doesn't support partial aggregation.
+   */
+  static Status SerializeArrow(UDA* uda, FunctionContext* ctx, arrow::ArrayBuilder* output) {
+    if constexpr (SupportsPartial) {
+      DCHECK(output != nullptr);
+      auto* casted_builder = static_cast<arrow::StringBuilder*>(output);
+      auto* casted_uda = static_cast<TUDA*>(uda);
+      PL_RETURN_IF_ERROR(casted_builder->Append(UnWrap(casted_uda->Serialize(ctx))));
+      return Status::OK();
+    }
+    PL_UNUSED(uda);
+    PL_UNUSED(ctx);
+    PL_UNUSED(output);
+    return error::Unimplemented("UDA '$0' doesn't support partial aggregation",
+                                typeid(TUDA).name());
+  }
+
+  /**
+   * Deserialize a partial state, as serialized by SerializeArrow, into the UDA.
+   * @return Status of the deserialize, an error if the UDA doesn't support partial aggregation.
+   */
+  static Status Deserialize(UDA* uda, FunctionContext* ctx, const types::StringValue& data) {
+    if constexpr (SupportsPartial) {
+      return static_cast<TUDA*>(uda)->Deserialize(ctx, data);
+    }
+    PL_UNUSED(uda);
+    PL_UNUSED(ctx);
+    PL_UNUSED(data);
+    return error::Unimplemented("UDA '$0' doesn't support partial aggregation",
+                                typeid(TUDA).name());
+  }
+
   /**
    * Finalize the UDA into an UDA value type.
    * Unsafe casts are performed, so the passed in output UDA value must be of the correct
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -198,6 +199,21 @@ struct StringValue : BaseValueType, public std::string {
   const std::string& string() { return *this; }
 };
 
+/**
+ * The value type for borrowed string arguments. UDFs can take a StringViewValue instead of a
+ * StringValue as an Exec/Update argument, in which case they are passed a view of the string in
+ * the input column, rather than a copy of it. The view is only valid for the duration of the call,
+ * so it must be copied to be kept (e.g. in UDA state). It can't be returned from a UDF.
+ */
+struct StringViewValue : BaseValueType, public std::string_view {
+  using std::string_view::string_view;
+  // NOLINTNEXTLINE: implicit constructor.
+  StringViewValue(std::string_view str) : std::string_view(str) {}
+  // NOLINTNEXTLINE: implicit constructor.
+  StringViewValue(const std::string& str) : std::string_view(str) {}
+  int64_t bytes() const { return sizeof(char) * this->length(); }
+};
+
 /**
  * Get the value out of the fixed sized union (by type).
  * @tparam T The type to pull out.
@@ -356,6 +372,18 @@ struct ValueTypeTraits<StringValue> {
   using native_type = std::string;
 };
 
+// StringViewValue isn't a valid ValueType (it can't be stored or returned), but it maps to STRING
+// so that it can be used for UDF arguments.
+template <>
+struct ValueTypeTraits<StringViewValue> {
+  static constexpr bool is_fixed_size = false;
+  static constexpr DataType data_type = types::STRING;
+  using arrow_type = arrow::StringType;
+  using arrow_builder_type = arrow::StringBuilder;
+  using arrow_array_type = arrow::StringArray;
+  using native_type = std::string_view;
+};
+
 /**
  * Store traits based on the native ValueType.
  * @tparam T The DataType.
@@ -17,13 +17,17 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/util/bit-util.h>
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <absl/strings/str_format.h>
 #include "src/common/base/base.h"
+#include "src/common/zlib/zlib_wrapper.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/schema/row_batch.h"
@@ -159,6 +163,10 @@ Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
 }
 
 Status RowBatch::ToProto(table_store::schemapb::RowBatchData* proto) const {
+  if (has_selection()) {
+    PL_ASSIGN_OR_RETURN(auto compacted, Compact(arrow::default_memory_pool()));
+    return compacted->ToProto(proto);
+  }
   proto->set_num_rows(num_rows_);
   proto->set_eow(eow_);
   proto->set_eos(eos_);
@@ -223,6 +231,242 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromProto(
   return output_rb;
 }
 
+namespace {
+
+using schemapb::ColumnarRowBatchData;
+
+// The uncompressed size of a buffer comes from the (untrusted) proto, so it's bounded before
+// allocating the output of the decompression. Row batches sent between agents are at most about
+// 1MB, so a buffer is never anywhere near this size.
+constexpr int64_t kMaxUncompressedBufferSize = 64 * 1024 * 1024;
+// deflate can't compress data by more than a factor of about 1032.
+constexpr int64_t kMaxDeflateRatio = 1032;
+
+// ProtoBuffer is an arrow buffer that points into memory owned by another object, such as the
+// bytes of a proto, and keeps that object alive.
+class ProtoBuffer : public arrow::Buffer {
+ public:
+  ProtoBuffer(std::string_view data, std::shared_ptr<const void> owner)
+      : arrow::Buffer(reinterpret_cast<const uint8_t*>(data.data()), data.size()),
+        owner_(std::move(owner)) {}
+
+ private:
+  std::shared_ptr<const void> owner_;
+};
+
+std::string_view BytesView(const uint8_t* data, int64_t size) {
+  return std::string_view(reinterpret_cast<const char*>(data), size);
+}
+
+Status SetColumnarBuffer(std::string_view data, ColumnarRowBatchData::Compression compression,
+                         ColumnarRowBatchData::Buffer* buffer) {
+  if (compression == ColumnarRowBatchData::COMPRESSION_GZIP && !data.empty()) {
+    PL_ASSIGN_OR_RETURN(std::string compressed, zlib::Deflate(data));
+    // Buffers that don't compress, such as random IDs, are sent as is.
+    if (compressed.size() < data.size()) {
+      buffer->set_data(std::move(compressed));
+      buffer->set_uncompressed_size(data.size());
+      return Status::OK();
+    }
+  }
+  buffer->set_data(data.data(), data.size());
+  return Status::OK();
+}
+
+StatusOr<std::shared_ptr<arrow::Buffer>> GetColumnarBuffer(
+    const ColumnarRowBatchData::Buffer& buffer, const std::shared_ptr<const void>& owner) {
+  if (buffer.uncompressed_size() == 0) {
+    return std::shared_ptr<arrow::Buffer>(std::make_shared<ProtoBuffer>(buffer.data(), owner));
+  }
+  int64_t uncompressed_size = buffer.uncompressed_size();
+  if (uncompressed_size < 0 || uncompressed_size > kMaxUncompressedBufferSize ||
+      uncompressed_size > kMaxDeflateRatio * static_cast<int64_t>(buffer.data().size()) + 64) {
+    return error::InvalidArgument("Invalid uncompressed size $0 for a $1 byte buffer",
+                                  uncompressed_size, buffer.data().size());
+  }
+  // An output block larger than the uncompressed size inflates the buffer in a single pass.
+  PL_ASSIGN_OR_RETURN(std::string data,
+                      zlib::Inflate(buffer.data(), uncompressed_size + 1));
+  if (static_cast<int64_t>(data.size()) != uncompressed_size) {
+    return error::InvalidArgument("Expected $0 bytes after decompression, got $1",
+                                  uncompressed_size, data.size());
+  }
+  auto inflated = std::make_shared<const std::string>(std::move(data));
+  return std::shared_ptr<arrow::Buffer>(std::make_shared<ProtoBuffer>(*inflated, inflated));
+}
+
+Status ColumnToColumnarProto(DataType data_type, const arrow::ArrayData& array,
+                             ColumnarRowBatchData::Compression compression,
+                             ColumnarRowBatchData::Column* col) {
+  col->set_data_type(data_type);
+  int64_t offset = array.offset;
+  int64_t length = array.length;
+  if (length == 0 && data_type != DataType::STRING) {
+    return Status::OK();
+  }
+
+  // PL_CARNOT_UPDATE_FOR_NEW_TYPES
+  switch (data_type) {
+    case DataType::BOOLEAN: {
+      const uint8_t* bits = array.buffers[1]->data();
+      int64_t num_bytes = arrow::BitUtil::BytesForBits(length);
+      if (offset % 8 == 0) {
+        return SetColumnarBuffer(BytesView(bits + offset / 8, num_bytes), compression,
+                                 col->mutable_data());
+      }
+      // A slice that doesn't start at a byte boundary has to be repacked.
+      std::string packed(num_bytes, '\0');
+      auto* packed_bits = reinterpret_cast<uint8_t*>(packed.data());
+      for (int64_t i = 0; i < length; ++i) {
+        if (arrow::BitUtil::GetBit(bits, offset + i)) {
+          arrow::BitUtil::SetBit(packed_bits, i);
+        }
+      }
+      return SetColumnarBuffer(packed, compression, col->mutable_data());
+    }
+    case DataType::STRING: {
+      std::vector<int32_t> rebased_offsets(length + 1, 0);
+      const int32_t* offsets = rebased_offsets.data();
+      if (length > 0) {
+        offsets = reinterpret_cast<const int32_t*>(array.buffers[1]->data()) + offset;
+      }
+      int32_t start = offsets[0];
+      int32_t end = offsets[length];
+      // The offsets of a slice are rebased to start at 0.
+      if (start != 0) {
+        for (int64_t i = 0; i <= length; ++i) {
+          rebased_offsets[i] = offsets[i] - start;
+        }
+        offsets = rebased_offsets.data();
+      }
+      PL_RETURN_IF_ERROR(SetColumnarBuffer(
+          BytesView(reinterpret_cast<const uint8_t*>(offsets), (length + 1) * sizeof(int32_t)),
+          compression, col->mutable_offsets()));
+      if (end == start) {
+        return Status::OK();
+      }
+      return SetColumnarBuffer(BytesView(array.buffers[2]->data() + start, end - start),
+                               compression, col->mutable_data());
+    }
+    case DataType::INT64:
+    case DataType::UINT128:
+    case DataType::FLOAT64:
+    case DataType::TIME64NS: {
+      int64_t width = types::ArrowTypeToBytes(types::ToArrowType(data_type));
+      return SetColumnarBuffer(BytesView(array.buffers[1]->data() + offset * width, length * width),
+                               compression, col->mutable_data());
+    }
+    default:
+      return error::Internal("Unsupported data type '$0' in ToColumnarProto",
+                             magic_enum::enum_name(data_type));
+  }
+}
+
+template <DataType T>
+std::shared_ptr<arrow::DataType> ArrowDataType() {
+  return std::make_shared<typename types::DataTypeTraits<T>::arrow_type>();
+}
+
+StatusOr<std::shared_ptr<arrow::Array>> ColumnFromColumnarProto(
+    const ColumnarRowBatchData::Column& col, int64_t num_rows,
+    const std::shared_ptr<const void>& owner) {
+  DataType data_type = col.data_type();
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<arrow::Buffer> data, GetColumnarBuffer(col.data(), owner));
+  // The first buffer is the validity bitmap, which is left empty since there are no nulls.
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers{nullptr};
+  std::shared_ptr<arrow::DataType> arrow_type;
+
+  // PL_CARNOT_UPDATE_FOR_NEW_TYPES
+  switch (data_type) {
+    case DataType::STRING: {
+      PL_ASSIGN_OR_RETURN(std::shared_ptr<arrow::Buffer> offsets,
+                          GetColumnarBuffer(col.offsets(), owner));
+      if (offsets->size() != static_cast<int64_t>((num_rows + 1) * sizeof(int32_t))) {
+        return error::InvalidArgument("Expected $0 string offsets, got $1 bytes", num_rows + 1,
+                                      offsets->size());
+      }
+      const auto* offset_values = reinterpret_cast<const int32_t*>(offsets->data());
+      if (offset_values[0] != 0 || offset_values[num_rows] != data->size()) {
+        return error::InvalidArgument("String offsets don't match the $0 bytes of string data",
+                                      data->size());
+      }
+      // Together with the first and last offsets, this keeps every offset within the data.
+      for (int64_t i = 0; i < num_rows; ++i) {
+        if (offset_values[i] > offset_values[i + 1]) {
+          return error::InvalidArgument("String offsets aren't sorted");
+        }
+      }
+      buffers.push_back(std::move(offsets));
+      buffers.push_back(std::move(data));
+      arrow_type = ArrowDataType<DataType::STRING>();
+      break;
+    }
+    case DataType::BOOLEAN:
+    case DataType::INT64:
+    case DataType::UINT128:
+    case DataType::FLOAT64:
+    case DataType::TIME64NS: {
+      int64_t expected_size =
+          data_type == DataType::BOOLEAN
+              ? arrow::BitUtil::BytesForBits(num_rows)
+              : num_rows * types::ArrowTypeToBytes(types::ToArrowType(data_type));
+      if (data->size() != expected_size) {
+        return error::InvalidArgument("Expected $0 bytes of $1 data, got $2", expected_size,
+                                      magic_enum::enum_name(data_type), data->size());
+      }
+      buffers.push_back(std::move(data));
+#define TYPE_CASE(_dt_) arrow_type = ArrowDataType<_dt_>();
+      PL_SWITCH_FOREACH_DATATYPE(data_type, TYPE_CASE);
+#undef TYPE_CASE
+      break;
+    }
+    default:
+      return error::InvalidArgument("Received unknown column data type '$0' in FromColumnarProto",
+                                    magic_enum::enum_name(data_type));
+  }
+  return arrow::MakeArray(
+      arrow::ArrayData::Make(arrow_type, num_rows, std::move(buffers), /* null_count */ 0));
+}
+
+}  // namespace
+
+Status RowBatch::ToColumnarProto(schemapb::ColumnarRowBatchData* proto,
+                                 schemapb::ColumnarRowBatchData::Compression compression) const {
+  if (has_selection()) {
+    PL_ASSIGN_OR_RETURN(auto compacted, Compact(arrow::default_memory_pool()));
+    return compacted->ToColumnarProto(proto, compression);
+  }
+  proto->set_num_rows(num_rows_);
+  proto->set_eow(eow_);
+  proto->set_eos(eos_);
+  proto->set_compression(compression);
+
+  for (auto col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    PL_RETURN_IF_ERROR(ColumnToColumnarProto(desc_.type(col_idx), *ColumnAt(col_idx)->data(),
+                                             compression, proto->add_cols()));
+  }
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromColumnarProto(
+    const schemapb::ColumnarRowBatchData& proto, std::shared_ptr<const void> owner) {
+  std::vector<DataType> types;
+  std::vector<std::shared_ptr<arrow::Array>> data_columns;
+  for (const auto& col : proto.cols()) {
+    types.push_back(col.data_type());
+    PL_ASSIGN_OR_RETURN(auto data_column, ColumnFromColumnarProto(col, proto.num_rows(), owner));
+    data_columns.push_back(std::move(data_column));
+  }
+
+  auto output_rb = std::make_unique<RowBatch>(RowDescriptor(types), proto.num_rows());
+  output_rb->set_eow(proto.eow());
+  output_rb->set_eos(proto.eos());
+  for (const auto& data_column : data_columns) {
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(data_column));
+  }
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromColumnBuilders(
     const RowDescriptor& desc, bool eow, bool eos,
     std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders) {
@@ -252,6 +496,59 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::WithZeroRows(const RowDescriptor&
   return RowBatch::FromColumnBuilders(desc, eow, eos, &builders);
 }
 
+template <DataType T>
+StatusOr<std::shared_ptr<arrow::Array>> SelectRowsImpl(const arrow::Array* input_col,
+                                                       const std::vector<int64_t>& rows,
+                                                       arrow::MemoryPool* mem_pool) {
+  auto builder = MakeArrowBuilder(T, mem_pool);
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder.get());
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(rows.size()));
+  if constexpr (T == DataType::STRING) {
+    const auto* typed_col = static_cast<const arrow::StringArray*>(input_col);
+    int64_t data_size = 0;
+    for (auto row : rows) {
+      data_size += typed_col->value_length(row);
+    }
+    PL_RETURN_IF_ERROR(typed_builder->ReserveData(data_size));
+    for (auto row : rows) {
+      auto value = typed_col->GetView(row);
+      typed_builder->UnsafeAppend(value.data(), value.size());
+    }
+  } else {
+    for (auto row : rows) {
+      typed_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_col, row));
+    }
+  }
+  std::shared_ptr<arrow::Array> output_col;
+  PL_RETURN_IF_ERROR(builder->Finish(&output_col));
+  return output_col;
+}
+
+StatusOr<std::shared_ptr<arrow::Array>> SelectRows(const arrow::Array* input_col,
+                                                   const std::vector<int64_t>& rows,
+                                                   arrow::MemoryPool* mem_pool) {
+#define TYPE_CASE(_dt_) return SelectRowsImpl<_dt_>(input_col, rows, mem_pool);
+  PL_SWITCH_FOREACH_DATATYPE(types::ArrowToDataType(input_col->type_id()), TYPE_CASE);
+#undef TYPE_CASE
+  return error::Internal("Unsupported column type");
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::Compact(arrow::MemoryPool* mem_pool) const {
+  auto output_rb = std::make_unique<RowBatch>(desc_, num_selected_rows());
+  output_rb->set_eow(eow_);
+  output_rb->set_eos(eos_);
+  for (const auto& col : columns_) {
+    if (!has_selection()) {
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(col));
+      continue;
+    }
+    PL_ASSIGN_OR_RETURN(auto output_col, SelectRows(col.get(), *selection_, mem_pool));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(output_col));
+  }
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::Slice(int64_t offset, int64_t length) const {
   if (offset + length > num_rows() || offset < 0) {
     return error::InvalidArgument("Slice(offset=$0, length=$1) on rowbatch of length $2 is invalid",
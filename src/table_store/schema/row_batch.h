@@ -19,6 +19,7 @@
 #pragma once
 
 #include <arrow/array.h>
+#include <arrow/memory_pool.h>
 #include <arrow/type.h>
 #include <map>
 #include <memory>
@@ -53,6 +54,23 @@ class RowBatch {
   static StatusOr<std::unique_ptr<RowBatch>> FromProto(
       const table_store::schemapb::RowBatchData& row_batch_proto);
 
+  /**
+   * Serializes the row batch as the raw buffers of its columns. Unlike ToProto, the values aren't
+   * visited one by one, apart from string offsets and booleans of slices that need to be rebased.
+   */
+  Status ToColumnarProto(
+      table_store::schemapb::ColumnarRowBatchData* row_batch_proto,
+      table_store::schemapb::ColumnarRowBatchData::Compression compression =
+          table_store::schemapb::ColumnarRowBatchData::COMPRESSION_NONE) const;
+  /**
+   * Deserializes a row batch serialized by ToColumnarProto. Uncompressed buffers aren't copied:
+   * the arrays point into the proto, and hold a reference to `owner`, which must keep the proto
+   * alive.
+   */
+  static StatusOr<std::unique_ptr<RowBatch>> FromColumnarProto(
+      const table_store::schemapb::ColumnarRowBatchData& row_batch_proto,
+      std::shared_ptr<const void> owner);
+
   static StatusOr<std::unique_ptr<RowBatch>> FromColumnBuilders(
       const RowDescriptor& desc, bool eow, bool eos,
       std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders);
@@ -120,14 +138,49 @@ class RowBatch {
 
   int64_t NumBytes() const;
 
+  /**
+   * The selection vector of the row batch. If set, only the rows of the columns at these indices
+   * (in increasing order) are part of the batch, which lets operators such as filters drop rows
+   * without copying the columns. num_rows() is still the length of the columns. Consumers that need
+   * dense columns call Compact.
+   */
+  const std::shared_ptr<const std::vector<int64_t>>& selection() const { return selection_; }
+  void set_selection(std::shared_ptr<const std::vector<int64_t>> selection) {
+    selection_ = std::move(selection);
+  }
+  bool has_selection() const { return selection_ != nullptr; }
+
+  /**
+   * @ return the number of rows that are part of the batch, i.e. the number of selected rows if
+   * the batch has a selection vector, and num_rows() otherwise.
+   */
+  int64_t num_selected_rows() const {
+    return selection_ != nullptr ? static_cast<int64_t>(selection_->size()) : num_rows_;
+  }
+
+  /**
+   * Returns a row batch with only the selected rows of this one, copied into dense columns, and
+   * the same eow and eos. If the batch has no selection vector the columns are shared instead.
+   */
+  StatusOr<std::unique_ptr<RowBatch>> Compact(arrow::MemoryPool* mem_pool) const;
+
  private:
   RowDescriptor desc_;
   int64_t num_rows_;
   bool eow_ = false;
   bool eos_ = false;
   std::vector<std::shared_ptr<arrow::Array>> columns_;
+  std::shared_ptr<const std::vector<int64_t>> selection_;
 };
 
+/**
+ * Copies the values of the given rows of an array into a new array.
+ * @param rows the indices of the rows to copy.
+ */
+StatusOr<std::shared_ptr<arrow::Array>> SelectRows(const arrow::Array* input_col,
+                                                   const std::vector<int64_t>& rows,
+                                                   arrow::MemoryPool* mem_pool);
+
 // Append a scalar value to an arrow::Array.
 template <types::DataType T>
 Status CopyValue(arrow::ArrayBuilder* output_col_builder,
@@ -19,6 +19,7 @@
 #include <arrow/array.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
+#include <memory>
 #include <vector>
 
 #include "src/common/testing/testing.h"
@@ -231,6 +232,133 @@ TEST_F(RowBatchTest, slice) {
   ASSERT_EQ(status2.msg(), "Slice(offset=-1, length=3) on rowbatch of length 3 is invalid");
 }
 
+TEST_F(RowBatchTest, compact_selection) {
+  EXPECT_FALSE(rb_->has_selection());
+  EXPECT_EQ(3, rb_->num_selected_rows());
+
+  rb_->set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2}));
+  rb_->set_eow(true);
+  EXPECT_TRUE(rb_->has_selection());
+  EXPECT_EQ(3, rb_->num_rows());
+  EXPECT_EQ(2, rb_->num_selected_rows());
+
+  ASSERT_OK_AND_ASSIGN(auto output_rb, rb_->Compact(arrow::default_memory_pool()));
+  EXPECT_FALSE(output_rb->has_selection());
+  EXPECT_EQ(2, output_rb->num_rows());
+  EXPECT_TRUE(output_rb->eow());
+  EXPECT_FALSE(output_rb->eos());
+  EXPECT_EQ(
+      "RowBatch(eow=1, eos=0):\n  [\n  true,\n  true\n]\n  [\n  3,\n  5\n]\n  [\n  "
+      "3.3,\n  5.6\n]\n",
+      output_rb->DebugString());
+}
+
+TEST_F(RowBatchTest, select_string_rows) {
+  std::vector<types::StringValue> in = {"abc", "", "defgh", "ij"};
+  auto col = types::ToArrow(in, arrow::default_memory_pool());
+  ASSERT_OK_AND_ASSIGN(auto output_col,
+                       SelectRows(col.get(), {3, 1, 2}, arrow::default_memory_pool()));
+  std::vector<types::StringValue> expected = {"ij", "", "defgh"};
+  EXPECT_TRUE(output_col->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+}
+
+TEST_F(RowBatchTest, to_proto_with_selection) {
+  auto rb = std::make_unique<RowBatch>(*rd_, 3);
+  AddColumns(rb.get());
+  rb->set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1}));
+
+  table_store::schemapb::RowBatchData proto;
+  EXPECT_OK(rb->ToProto(&proto));
+  EXPECT_EQ(1, proto.num_rows());
+  EXPECT_EQ(4, proto.cols(1).int64_data().data(0));
+}
+
+TEST_F(RowBatchTest, to_from_columnar_proto) {
+  table_store::schemapb::RowBatchData input_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kTestRowBatchProto, &input_proto));
+  ASSERT_OK_AND_ASSIGN(auto input_rb, RowBatch::FromProto(input_proto));
+
+  auto columnar_proto = std::make_shared<table_store::schemapb::ColumnarRowBatchData>();
+  EXPECT_OK(input_rb->ToColumnarProto(columnar_proto.get()));
+  EXPECT_EQ(3, columnar_proto->num_rows());
+  EXPECT_TRUE(columnar_proto->eow());
+  EXPECT_EQ(3 * sizeof(int64_t), columnar_proto->cols(1).data().data().size());
+
+  ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromColumnarProto(*columnar_proto, columnar_proto));
+  EXPECT_EQ(input_rb->desc(), rb->desc());
+  // The int64 values are read from the proto, rather than copied out of it.
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(columnar_proto->cols(1).data().data().data()),
+            rb->ColumnAt(1)->data()->buffers[1]->data());
+
+  table_store::schemapb::RowBatchData output_proto;
+  EXPECT_OK(rb->ToProto(&output_proto));
+  google::protobuf::util::MessageDifferencer differ;
+  EXPECT_TRUE(differ.Compare(input_proto, output_proto));
+}
+
+TEST_F(RowBatchTest, columnar_proto_slices_and_compression) {
+  std::vector<types::StringValue> strings = {"abc", "", "defgh"};
+  auto desc = std::vector<types::DataType>(
+      {types::DataType::BOOLEAN, types::DataType::INT64, types::DataType::STRING});
+  RowBatch rb(RowDescriptor(desc), 3);
+  ASSERT_OK(rb.AddColumn(rb_->ColumnAt(0)));
+  ASSERT_OK(rb.AddColumn(rb_->ColumnAt(1)));
+  ASSERT_OK(rb.AddColumn(types::ToArrow(strings, arrow::default_memory_pool())));
+  // The slice starts in the middle of the boolean bits and the string values.
+  ASSERT_OK_AND_ASSIGN(auto slice, rb.Slice(1, 2));
+
+  for (auto compression : {table_store::schemapb::ColumnarRowBatchData::COMPRESSION_NONE,
+                           table_store::schemapb::ColumnarRowBatchData::COMPRESSION_GZIP}) {
+    auto proto = std::make_shared<table_store::schemapb::ColumnarRowBatchData>();
+    EXPECT_OK(slice->ToColumnarProto(proto.get(), compression));
+    EXPECT_EQ(compression, proto->compression());
+    ASSERT_OK_AND_ASSIGN(auto output_rb, RowBatch::FromColumnarProto(*proto, proto));
+    EXPECT_EQ(slice->DebugString(), output_rb->DebugString());
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto empty_rb, RowBatch::WithZeroRows(RowDescriptor(desc), true, true));
+  auto empty_proto = std::make_shared<table_store::schemapb::ColumnarRowBatchData>();
+  EXPECT_OK(empty_rb->ToColumnarProto(empty_proto.get()));
+  ASSERT_OK_AND_ASSIGN(auto output_rb, RowBatch::FromColumnarProto(*empty_proto, empty_proto));
+  EXPECT_EQ(0, output_rb->num_rows());
+  EXPECT_EQ(3, output_rb->num_columns());
+  EXPECT_TRUE(output_rb->eos());
+}
+
+TEST_F(RowBatchTest, columnar_proto_invalid_sizes) {
+  auto proto = std::make_shared<table_store::schemapb::ColumnarRowBatchData>();
+  EXPECT_OK(rb_->ToColumnarProto(proto.get()));
+  proto->mutable_cols(1)->mutable_data()->mutable_data()->resize(2 * sizeof(int64_t));
+  EXPECT_NOT_OK(RowBatch::FromColumnarProto(*proto, proto));
+}
+
+TEST_F(RowBatchTest, columnar_proto_invalid_string_offsets) {
+  std::vector<types::StringValue> strings = {"abc", "", "defgh"};
+  RowBatch rb(RowDescriptor({types::DataType::STRING}), 3);
+  ASSERT_OK(rb.AddColumn(types::ToArrow(strings, arrow::default_memory_pool())));
+  auto proto = std::make_shared<table_store::schemapb::ColumnarRowBatchData>();
+  EXPECT_OK(rb.ToColumnarProto(proto.get()));
+  ASSERT_OK(RowBatch::FromColumnarProto(*proto, proto).status());
+
+  // The first and last offsets are valid, but the ones in between point past the data.
+  auto* offsets = reinterpret_cast<int32_t*>(
+      proto->mutable_cols(0)->mutable_offsets()->mutable_data()->data());
+  offsets[1] = 100;
+  offsets[2] = 1;
+  EXPECT_NOT_OK(RowBatch::FromColumnarProto(*proto, proto));
+}
+
+TEST_F(RowBatchTest, columnar_proto_invalid_uncompressed_size) {
+  auto proto = std::make_shared<table_store::schemapb::ColumnarRowBatchData>();
+  EXPECT_OK(rb_->ToColumnarProto(proto.get(),
+                                 table_store::schemapb::ColumnarRowBatchData::COMPRESSION_GZIP));
+  auto* buffer = proto->mutable_cols(1)->mutable_data();
+  buffer->set_uncompressed_size(-1);
+  EXPECT_NOT_OK(RowBatch::FromColumnarProto(*proto, proto));
+  buffer->set_uncompressed_size(int64_t{1} << 40);
+  EXPECT_NOT_OK(RowBatch::FromColumnarProto(*proto, proto));
+}
+
 }  // namespace schema
 }  // namespace table_store
 }  // namespace px
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/compaction_scheduler.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+std::chrono::nanoseconds ThreadCPUTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+}  // namespace
+
+CompactionScheduler::CompactionScheduler(int num_workers,
+                                         std::chrono::nanoseconds cpu_budget_per_cycle,
+                                         arrow::MemoryPool* mem_pool)
+    : cpu_budget_per_cycle_(cpu_budget_per_cycle), mem_pool_(mem_pool) {
+  DCHECK_GT(num_workers, 0);
+  DCHECK_GT(cpu_budget_per_cycle.count(), 0);
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&CompactionScheduler::WorkerLoop, this);
+  }
+}
+
+CompactionScheduler::~CompactionScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    stopped_ = true;
+  }
+  work_cv_.notify_all();
+  cycle_done_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool CompactionScheduler::StartCycle(std::vector<std::shared_ptr<Table>> tables) {
+  // Computing the backlogs takes each table's hot lock, so it's done before taking lock_.
+  std::vector<std::pair<int64_t, std::shared_ptr<Table>>> backlogs;
+  for (auto& table : tables) {
+    auto backlog_bytes = table->CompactionBacklogBytes();
+    if (backlog_bytes > 0) {
+      backlogs.emplace_back(backlog_bytes, std::move(table));
+    }
+  }
+  std::stable_sort(backlogs.begin(), backlogs.end(),
+                   [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (cycle_running_) {
+      return false;
+    }
+    tables_.clear();
+    for (auto& [backlog_bytes, table] : backlogs) {
+      tables_.push_back(std::move(table));
+    }
+    next_table_idx_ = 0;
+    cycle_cpu_ns_ = 0;
+    cycle_running_ = !tables_.empty() && !BudgetExhausted();
+  }
+  work_cv_.notify_all();
+  return true;
+}
+
+void CompactionScheduler::WaitForCycle() {
+  std::unique_lock<std::mutex> lock(lock_);
+  cycle_done_cv_.wait(lock, [this] { return !cycle_running_ || stopped_; });
+}
+
+bool CompactionScheduler::BudgetExhausted() const {
+  return cycle_cpu_ns_.load() >= cpu_budget_per_cycle_.count();
+}
+
+void CompactionScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    work_cv_.wait(lock, [this] {
+      return stopped_ ||
+             (cycle_running_ && next_table_idx_ < tables_.size() && !BudgetExhausted());
+    });
+    if (stopped_) {
+      return;
+    }
+    auto table = tables_[next_table_idx_++];
+    ++num_busy_workers_;
+
+    lock.unlock();
+    auto s = CompactTable(table.get());
+    LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to compact table: $0", s.msg());
+    table.reset();
+    lock.lock();
+
+    --num_busy_workers_;
+    if (num_busy_workers_ == 0 && (next_table_idx_ == tables_.size() || BudgetExhausted())) {
+      // Release the tables, so that they aren't kept alive until the next cycle.
+      tables_.clear();
+      cycle_running_ = false;
+      cycle_done_cv_.notify_all();
+    }
+  }
+}
+
+Status CompactionScheduler::CompactTable(Table* table) {
+  bool compacted = true;
+  while (compacted && !BudgetExhausted()) {
+    auto start = ThreadCPUTime();
+    PL_ASSIGN_OR_RETURN(compacted, table->CompactBatch(mem_pool_));
+    cycle_cpu_ns_ += (ThreadCPUTime() - start).count();
+  }
+  // Tables don't refresh their gauges on writes, so they're refreshed once per compaction cycle.
+  return table->UpdateTableMetricGauges();
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/table/table.h"
+
+namespace px {
+namespace table_store {
+
+/**
+ * CompactionScheduler compacts the hot data of tables into cold batches on a pool of worker
+ * threads, instead of on the caller's thread.
+ *
+ * Compaction runs in cycles. Each cycle orders the given tables by their compaction backlog, and
+ * the workers compact the tables with the largest backlog first, one cold batch at a time. Once the
+ * workers together have used up the CPU time budget of the cycle, they stop compacting until the
+ * next cycle. Any backlog that is left over is compacted in the following cycles, where it again
+ * competes with the backlog of the other tables.
+ */
+class CompactionScheduler {
+ public:
+  /**
+   * @param num_workers the number of threads that compact tables in parallel.
+   * @param cpu_budget_per_cycle the total CPU time that the workers can spend on a single cycle.
+   * @param mem_pool arrow MemoryPool to be used for creating new cold batches.
+   */
+  CompactionScheduler(int num_workers, std::chrono::nanoseconds cpu_budget_per_cycle,
+                      arrow::MemoryPool* mem_pool);
+
+  /**
+   * Stops the workers. A cycle that is still running is stopped once each worker finishes the cold
+   * batch it is currently compacting.
+   */
+  ~CompactionScheduler();
+
+  /**
+   * StartCycle starts a compaction cycle for the given tables, and returns without waiting for it
+   * to finish.
+   * @param tables the tables to compact.
+   * @return false if the previous cycle is still running, in which case no new cycle is started.
+   */
+  bool StartCycle(std::vector<std::shared_ptr<Table>> tables);
+
+  /**
+   * WaitForCycle blocks until the current compaction cycle, if any, has finished.
+   */
+  void WaitForCycle();
+
+ private:
+  void WorkerLoop();
+  Status CompactTable(Table* table);
+  bool BudgetExhausted() const;
+
+  const std::chrono::nanoseconds cpu_budget_per_cycle_;
+  arrow::MemoryPool* mem_pool_;
+
+  std::mutex lock_;
+  std::condition_variable work_cv_;
+  std::condition_variable cycle_done_cv_;
+  // The tables of the current cycle, ordered by decreasing compaction backlog.
+  std::vector<std::shared_ptr<Table>> tables_;
+  size_t next_table_idx_ = 0;
+  int num_busy_workers_ = 0;
+  bool cycle_running_ = false;
+  bool stopped_ = false;
+
+  // CPU time the workers have spent compacting during the current cycle.
+  std::atomic<int64_t> cycle_cpu_ns_ = 0;
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/compaction_scheduler.h"
+
+namespace px {
+namespace table_store {
+
+class CompactionSchedulerTest : public ::testing::Test {
+ protected:
+  // Each batch written by WriteBatches is exactly one compacted batch.
+  std::shared_ptr<Table> MakeTable(int64_t num_batches) {
+    schema::Relation rel({types::DataType::INT64}, {"abc"});
+    auto table = std::make_shared<Table>("test_table", rel, 1024 * 1024, 10 * sizeof(int64_t));
+    for (int64_t i = 0; i < num_batches; ++i) {
+      schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), 10);
+      std::vector<types::Int64Value> col(10, i);
+      PL_CHECK_OK(rb.AddColumn(types::ToArrow(col, arrow::default_memory_pool())));
+      PL_CHECK_OK(table->WriteRowBatch(rb));
+    }
+    return table;
+  }
+};
+
+TEST_F(CompactionSchedulerTest, compacts_all_tables) {
+  auto table1 = MakeTable(5);
+  auto table2 = MakeTable(2);
+  auto table3 = MakeTable(0);
+  EXPECT_EQ(5 * 80, table1->CompactionBacklogBytes());
+  EXPECT_EQ(2 * 80, table2->CompactionBacklogBytes());
+
+  CompactionScheduler scheduler(/*num_workers*/ 2, std::chrono::seconds(10),
+                                arrow::default_memory_pool());
+  ASSERT_TRUE(scheduler.StartCycle({table1, table2, table3}));
+  scheduler.WaitForCycle();
+
+  EXPECT_EQ(0, table1->CompactionBacklogBytes());
+  EXPECT_EQ(0, table2->CompactionBacklogBytes());
+  EXPECT_EQ(5, table1->GetTableStats().compacted_batches);
+  EXPECT_EQ(2, table2->GetTableStats().compacted_batches);
+  EXPECT_EQ(0, table3->GetTableStats().compacted_batches);
+}
+
+TEST_F(CompactionSchedulerTest, largest_backlog_first_within_budget) {
+  auto table1 = MakeTable(2);
+  auto table2 = MakeTable(5);
+
+  // With a single worker and a tiny budget, only one batch of the table with the largest backlog
+  // is compacted per cycle.
+  CompactionScheduler scheduler(/*num_workers*/ 1, std::chrono::nanoseconds(1),
+                                arrow::default_memory_pool());
+  ASSERT_TRUE(scheduler.StartCycle({table1, table2}));
+  scheduler.WaitForCycle();
+  EXPECT_EQ(0, table1->GetTableStats().compacted_batches);
+  EXPECT_EQ(1, table2->GetTableStats().compacted_batches);
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(scheduler.StartCycle({table1, table2}));
+    scheduler.WaitForCycle();
+  }
+  // The backlog of table2 is now as small as that of table1, so table1 is compacted next, since it
+  // comes first.
+  EXPECT_EQ(3, table2->GetTableStats().compacted_batches);
+  ASSERT_TRUE(scheduler.StartCycle({table1, table2}));
+  scheduler.WaitForCycle();
+  EXPECT_EQ(1, table1->GetTableStats().compacted_batches);
+  EXPECT_EQ(3, table2->GetTableStats().compacted_batches);
+}
+
+}  // namespace table_store
+}  // namespace px
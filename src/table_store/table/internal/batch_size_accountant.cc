@@ -74,6 +74,23 @@ BatchSizeAccountant::BatchStats BatchSizeAccountant::CalcBatchStats(
   return stats;
 }
 
+uint64_t BatchSizeAccountant::CalcColdBatchBytes(
+    const BatchSizeAccountantNonMutableState& non_mutable_state,
+    const std::vector<ArrowArrayPtr>& columns) {
+  DCHECK(!columns.empty());
+  uint64_t bytes = non_mutable_state.per_row_fixed_size * columns[0]->length();
+  for (auto col_idx : non_mutable_state.variable_cols_indices) {
+    const auto* arr = static_cast<const arrow::StringArray*>(columns[col_idx].get());
+    bytes += arr->value_offset(arr->length()) - arr->value_offset(0);
+  }
+  return bytes;
+}
+
+void BatchSizeAccountant::NewColdBatch(uint64_t bytes) {
+  cold_bytes_ += bytes;
+  cold_batch_bytes_.push_back(bytes);
+}
+
 BatchSizeAccountant::CompactedBatchSpec* BatchSizeAccountant::NewCompactedBatchSpec() {
   auto& compacted_spec = compacted_batch_specs_.emplace_back();
   compacted_spec.num_rows = 0;
@@ -169,14 +186,20 @@ const BatchSizeAccountant::CompactedBatchSpec& BatchSizeAccountant::GetNextCompa
   return compacted_batch_specs_.front();
 }
 
-uint64_t BatchSizeAccountant::FinishCompactedBatch() {
+uint64_t BatchSizeAccountant::FinishCompactedBatch(uint64_t cold_bytes_saved) {
+  DCHECK(CompactedBatchReady());
+  DCHECK_LT(cold_bytes_saved, compacted_batch_specs_.front().bytes);
+  return FinishCompactedBatchWithBytes(compacted_batch_specs_.front().bytes - cold_bytes_saved);
+}
+
+uint64_t BatchSizeAccountant::FinishCompactedBatchWithBytes(uint64_t cold_batch_bytes) {
   DCHECK(CompactedBatchReady());
   auto spec = std::move(compacted_batch_specs_.front());
   compacted_batch_specs_.pop_front();
 
   hot_bytes_ -= spec.bytes;
-  cold_bytes_ += spec.bytes;
-  cold_batch_bytes_.push_back(spec.bytes);
+  cold_bytes_ += cold_batch_bytes;
+  cold_batch_bytes_.push_back(cold_batch_bytes);
 
   if (spec.hot_slices.back().last_slice_for_batch) {
     // If the last slice in the compacted batch was the last slice for the corresponding hot batch,
@@ -216,6 +239,16 @@ uint64_t BatchSizeAccountant::HotBytes() const { return hot_bytes_; }
 
 uint64_t BatchSizeAccountant::ColdBytes() const { return cold_bytes_; }
 
+uint64_t BatchSizeAccountant::CompactionBacklogBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& spec : compacted_batch_specs_) {
+    if (spec.bytes >= non_mutable_state_.compacted_size) {
+      bytes += spec.bytes;
+    }
+  }
+  return bytes;
+}
+
 const BatchSizeAccountantNonMutableState& BatchSizeAccountant::NonMutableState() const {
   return non_mutable_state_;
 }
@@ -103,6 +103,22 @@ class BatchSizeAccountant {
    * batch.
    */
   void NewHotBatch(const BatchStats& batch_stats);
+  /**
+   * CalcColdBatchBytes returns the number of bytes a cold batch made up of the given plain arrow
+   * columns is accounted as, measured the same way as hot batches. Like `CalcBatchStats`, it can be
+   * called without holding the lock that synchronizes the accountant.
+   * @param non_mutable_state, BatchSizeAccountant internal state.
+   * @param columns the columns of the batch.
+   * @return the number of bytes of the batch.
+   */
+  static uint64_t CalcColdBatchBytes(const BatchSizeAccountantNonMutableState& non_mutable_state,
+                                     const std::vector<ArrowArrayPtr>& columns);
+  /**
+   * NewColdBatch notifies the BatchSizeAccountant of a batch that was added to the cold store
+   * directly, without being compacted from the hot store (e.g. when restoring a snapshot).
+   * @param bytes the number of bytes of the batch, see `CalcColdBatchBytes`.
+   */
+  void NewColdBatch(uint64_t bytes);
   /**
    * ExpireHotBatch notifies the BatchSizeAccountant that a hot batch is being expired, and so it
    * should update its accounting accordingly.
@@ -130,10 +146,20 @@ class BatchSizeAccountant {
    * update hot_bytes_ and cold_bytes_ accordingly. It returns the number of rows that need to be
    * removed from start of the first hot batch in order to prevent duplicated data between the hot
    * and cold stores.
+   * @param cold_bytes_saved Number of bytes that the cold batch saves compared to the spec's
+   * estimate, because some of its columns were encoded. The cold batch is accounted as its
+   * estimated size minus these bytes.
    * @return Number of rows to remove from the front of the hot store, since those rows were moved
    * into the cold store via CompactedBatchSpec.
    */
-  uint64_t FinishCompactedBatch();
+  uint64_t FinishCompactedBatch(uint64_t cold_bytes_saved = 0);
+  /**
+   * FinishCompactedBatchWithBytes is like `FinishCompactedBatch`, but accounts the cold batch as
+   * the given number of bytes (e.g. its actual memory usage) instead of the spec's estimate.
+   * @param cold_batch_bytes Number of bytes of the cold batch.
+   * @return Number of rows to remove from the front of the hot store.
+   */
+  uint64_t FinishCompactedBatchWithBytes(uint64_t cold_batch_bytes);
   /**
    * @return the number of bytes stored in the hot store.
    */
@@ -142,6 +168,11 @@ class BatchSizeAccountant {
    * @return the number of bytes stored in the cold store.
    */
   uint64_t ColdBytes() const;
+  /**
+   * @return the number of hot bytes that are part of a compacted batch that is ready to be
+   * compacted, ie. the amount of data that compaction is behind by.
+   */
+  uint64_t CompactionBacklogBytes() const;
 
   const BatchSizeAccountantNonMutableState& NonMutableState() const;
 
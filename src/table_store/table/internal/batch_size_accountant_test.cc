@@ -101,6 +101,8 @@ TEST_P(BatchSizeAccountantTest, BatchStatsBasic) {
 TEST_P(BatchSizeAccountantTest, IndexThenCompact) {
   accountant_->NewHotBatch(
       BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(), *half_compaction_rb_));
+  // Half a compacted batch isn't ready to be compacted yet.
+  EXPECT_EQ(0, accountant_->CompactionBacklogBytes());
   accountant_->NewHotBatch(BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(),
                                                                *larger_than_compaction_rb_));
   accountant_->NewHotBatch(
@@ -110,6 +112,7 @@ TEST_P(BatchSizeAccountantTest, IndexThenCompact) {
 
   EXPECT_EQ(3 * half_compaction_rb_bytes_ + larger_than_compaction_rb_bytes_,
             accountant_->HotBytes());
+  EXPECT_EQ(accountant_->HotBytes(), accountant_->CompactionBacklogBytes());
 
   // These four hot batches, should be compacted into 3 cold batches, the first one is the entire
   // first hot batch, plus the first 3 rows of the larger_than_compaction_rb. The second compacted
@@ -148,6 +151,7 @@ TEST_P(BatchSizeAccountantTest, IndexThenCompact) {
   EXPECT_EQ(0, accountant_->FinishCompactedBatch());
 
   EXPECT_EQ(0, accountant_->HotBytes());
+  EXPECT_EQ(0, accountant_->CompactionBacklogBytes());
   EXPECT_EQ(3 * half_compaction_rb_bytes_ + larger_than_compaction_rb_bytes_,
             accountant_->ColdBytes());
 }
@@ -0,0 +1,461 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/cold_batch.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+// Returns the smallest width in bytes (1, 2 or 4) that can store the given value, or 0 if the value
+// needs more than 4 bytes.
+uint8_t PackedWidth(uint64_t max_value) {
+  if (max_value <= std::numeric_limits<uint8_t>::max()) {
+    return sizeof(uint8_t);
+  }
+  if (max_value <= std::numeric_limits<uint16_t>::max()) {
+    return sizeof(uint16_t);
+  }
+  if (max_value <= std::numeric_limits<uint32_t>::max()) {
+    return sizeof(uint32_t);
+  }
+  return 0;
+}
+
+void PackValue(uint64_t value, uint8_t width, size_t idx, std::vector<uint8_t>* packed) {
+  switch (width) {
+    case sizeof(uint8_t):
+      (*packed)[idx] = static_cast<uint8_t>(value);
+      return;
+    case sizeof(uint16_t): {
+      auto v = static_cast<uint16_t>(value);
+      std::memcpy(packed->data() + idx * width, &v, width);
+      return;
+    }
+    case sizeof(uint32_t): {
+      auto v = static_cast<uint32_t>(value);
+      std::memcpy(packed->data() + idx * width, &v, width);
+      return;
+    }
+  }
+  DCHECK(false) << "Unsupported packed width: " << width;
+}
+
+inline uint64_t UnpackValue(const std::vector<uint8_t>& packed, uint8_t width, size_t idx) {
+  switch (width) {
+    case sizeof(uint8_t):
+      return packed[idx];
+    case sizeof(uint16_t): {
+      uint16_t v;
+      std::memcpy(&v, packed.data() + idx * width, width);
+      return v;
+    }
+    case sizeof(uint32_t): {
+      uint32_t v;
+      std::memcpy(&v, packed.data() + idx * width, width);
+      return v;
+    }
+  }
+  DCHECK(false) << "Unsupported packed width: " << width;
+  return 0;
+}
+
+const int64_t* Int64Values(const arrow::Array* arr) {
+  // Both arrow::Int64Array and arrow::Time64Array store their values as a contiguous int64 buffer.
+  DCHECK(arr->type_id() == arrow::Type::INT64 || arr->type_id() == arrow::Type::TIME64);
+  return arr->data()->GetValues<int64_t>(1);
+}
+
+// Returns a FrameOfReferenceColumn if the encoding takes fewer bytes than the plain column.
+std::optional<std::pair<FrameOfReferenceColumn, uint64_t>> TryFrameOfReferenceEncode(
+    const arrow::Array* arr) {
+  const auto* values = Int64Values(arr);
+  size_t length = arr->length();
+  uint64_t plain_bytes = length * sizeof(int64_t);
+
+  FrameOfReferenceColumn col;
+  uint64_t max_offset = 0;
+  for (size_t block_start = 0; block_start < length;
+       block_start += FrameOfReferenceColumn::kBlockSize) {
+    size_t block_end = std::min(length, block_start + FrameOfReferenceColumn::kBlockSize);
+    auto [min_it, max_it] = std::minmax_element(values + block_start, values + block_end);
+    col.block_bases.push_back(*min_it);
+    max_offset =
+        std::max(max_offset, static_cast<uint64_t>(*max_it) - static_cast<uint64_t>(*min_it));
+  }
+  col.offset_width = PackedWidth(max_offset);
+  if (col.offset_width == 0) {
+    return std::nullopt;
+  }
+  uint64_t encoded_bytes = col.block_bases.size() * sizeof(int64_t) + length * col.offset_width;
+  if (encoded_bytes >= plain_bytes) {
+    return std::nullopt;
+  }
+
+  col.offsets.resize(length * col.offset_width);
+  for (size_t i = 0; i < length; ++i) {
+    auto base = col.block_bases[i / FrameOfReferenceColumn::kBlockSize];
+    PackValue(static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(base), col.offset_width, i,
+              &col.offsets);
+  }
+  return std::make_pair(std::move(col), plain_bytes - encoded_bytes);
+}
+
+// Returns a DictionaryColumn if the column has few enough distinct values that the encoding takes
+// fewer bytes than the plain column.
+StatusOr<std::optional<std::pair<DictionaryColumn, uint64_t>>> TryDictionaryEncode(
+    const arrow::Array* arr) {
+  using Result = std::optional<std::pair<DictionaryColumn, uint64_t>>;
+  const auto* str_arr = static_cast<const arrow::StringArray*>(arr);
+  size_t length = arr->length();
+  // Only consider dictionary encoding when at most half of the values are distinct.
+  size_t max_distinct = length / 2;
+
+  absl::flat_hash_map<std::string_view, uint32_t> dict_indices;
+  std::vector<std::string_view> dict_values;
+  std::vector<uint32_t> row_indices(length);
+  uint64_t plain_bytes = length * sizeof(int32_t);
+  uint64_t dict_bytes = 0;
+  for (size_t i = 0; i < length; ++i) {
+    auto view = str_arr->GetView(i);
+    std::string_view value(view.data(), view.size());
+    plain_bytes += value.size();
+    auto [it, inserted] = dict_indices.try_emplace(value, dict_values.size());
+    if (inserted) {
+      if (dict_values.size() == max_distinct) {
+        return Result(std::nullopt);
+      }
+      dict_values.push_back(value);
+      dict_bytes += sizeof(int32_t) + value.size();
+    }
+    row_indices[i] = it->second;
+  }
+
+  DictionaryColumn col;
+  col.index_width = PackedWidth(dict_values.size());
+  uint64_t encoded_bytes = dict_bytes + length * col.index_width;
+  if (encoded_bytes >= plain_bytes) {
+    return Result(std::nullopt);
+  }
+
+  arrow::StringBuilder builder;
+  PL_RETURN_IF_ERROR(builder.Reserve(dict_values.size()));
+  PL_RETURN_IF_ERROR(builder.ReserveData(dict_bytes - dict_values.size() * sizeof(int32_t)));
+  for (const auto& value : dict_values) {
+    builder.UnsafeAppend(value.data(), value.size());
+  }
+  std::shared_ptr<arrow::Array> dictionary;
+  PL_RETURN_IF_ERROR(builder.Finish(&dictionary));
+  col.dictionary = std::static_pointer_cast<arrow::StringArray>(dictionary);
+
+  col.indices.resize(length * col.index_width);
+  for (const auto& [i, idx] : Enumerate(row_indices)) {
+    PackValue(idx, col.index_width, i, &col.indices);
+  }
+  return Result(std::make_pair(std::move(col), plain_bytes - encoded_bytes));
+}
+
+uint64_t ArrayMemoryUsage(const arrow::Array& arr) {
+  uint64_t bytes = 0;
+  for (const auto& buffer : arr.data()->buffers) {
+    if (buffer != nullptr) {
+      bytes += TableMemoryPool::AllocationSize(buffer->capacity());
+    }
+  }
+  return bytes;
+}
+
+}  // namespace
+
+ColdBatch::ColdBatch(std::vector<ArrowArrayPtr> columns) {
+  DCHECK(!columns.empty());
+  length_ = columns[0]->length();
+  for (auto& arr : columns) {
+    col_types_.push_back(types::ArrowToDataType(arr->type_id()));
+    zone_maps_.push_back(ColumnZoneMap::Compute(col_types_.back(), arr.get()));
+    columns_.push_back(std::make_shared<const EncodedColumn>(PlainColumn{std::move(arr)}));
+  }
+}
+
+StatusOr<ColdBatch> ColdBatch::Encode(const schema::Relation& rel,
+                                      const std::vector<ArrowArrayPtr>& columns) {
+  DCHECK_EQ(rel.NumColumns(), columns.size());
+  DCHECK(!columns.empty());
+  ColdBatch batch;
+  batch.col_types_ = rel.col_types();
+  batch.length_ = columns[0]->length();
+  for (const auto& [col_idx, arr] : Enumerate(columns)) {
+    batch.zone_maps_.push_back(ColumnZoneMap::Compute(batch.col_types_[col_idx], arr.get()));
+    if (batch.length_ >= kMinRowsToEncode && arr->null_count() == 0) {
+      switch (batch.col_types_[col_idx]) {
+        case types::DataType::INT64:
+        case types::DataType::TIME64NS: {
+          auto encoded = TryFrameOfReferenceEncode(arr.get());
+          if (encoded.has_value()) {
+            batch.bytes_saved_ += encoded->second;
+            batch.columns_.push_back(
+                std::make_shared<const EncodedColumn>(std::move(encoded->first)));
+            continue;
+          }
+          break;
+        }
+        case types::DataType::STRING: {
+          PL_ASSIGN_OR_RETURN(auto encoded, TryDictionaryEncode(arr.get()));
+          if (encoded.has_value()) {
+            batch.bytes_saved_ += encoded->second;
+            batch.columns_.push_back(
+                std::make_shared<const EncodedColumn>(std::move(encoded->first)));
+            continue;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    batch.columns_.push_back(std::make_shared<const EncodedColumn>(PlainColumn{arr}));
+  }
+  return batch;
+}
+
+StatusOr<std::vector<ArrowArrayPtr>> ColdBatch::Decode() const {
+  std::vector<ArrowArrayPtr> out;
+  for (size_t col_idx = 0; col_idx < columns_.size(); ++col_idx) {
+    PL_ASSIGN_OR_RETURN(auto arr,
+                        DecodeSlice(col_idx, 0, length_, arrow::default_memory_pool()));
+    out.push_back(std::move(arr));
+  }
+  return out;
+}
+
+void ColdBatch::ReplaceColumns(std::vector<ArrowArrayPtr> columns) {
+  DCHECK_EQ(columns.size(), columns_.size());
+  columns_.clear();
+  for (auto& arr : columns) {
+    DCHECK_EQ(static_cast<size_t>(arr->length()), length_);
+    columns_.push_back(std::make_shared<const EncodedColumn>(PlainColumn{std::move(arr)}));
+  }
+  bytes_saved_ = 0;
+}
+
+ColdBatch ColdBatch::Pin() const {
+  ColdBatch pinned;
+  pinned.col_types_ = col_types_;
+  pinned.columns_ = columns_;
+  pinned.length_ = length_;
+  pinned.bytes_saved_ = bytes_saved_;
+  return pinned;
+}
+
+uint64_t ColdBatch::MemoryUsage() const {
+  uint64_t bytes = 0;
+  for (const auto& col : columns_) {
+    std::visit(overloaded{
+                   [&bytes](const PlainColumn& plain) { bytes += ArrayMemoryUsage(*plain.array); },
+                   [&bytes](const DictionaryColumn& dict) {
+                     bytes += ArrayMemoryUsage(*dict.dictionary) + dict.indices.capacity();
+                   },
+                   [&bytes](const FrameOfReferenceColumn& frame) {
+                     bytes += frame.block_bases.capacity() * sizeof(int64_t) +
+                              frame.offsets.capacity();
+                   },
+               },
+               *col);
+  }
+  return bytes;
+}
+
+bool ColdBatch::MayMatch(const std::vector<ColumnPredicate>& predicates) const {
+  for (const auto& pred : predicates) {
+    DCHECK_LT(static_cast<size_t>(pred.col_idx), zone_maps_.size());
+    if (!zone_maps_[pred.col_idx].MayMatch(pred.op, pred.value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t ColdBatch::GetInt64Value(int64_t col_idx, int64_t row_idx) const {
+  const auto& col = *columns_[col_idx];
+  if (const auto* for_col = std::get_if<FrameOfReferenceColumn>(&col)) {
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(for_col->block_bases[row_idx / FrameOfReferenceColumn::kBlockSize]) +
+        UnpackValue(for_col->offsets, for_col->offset_width, row_idx));
+  }
+  DCHECK(std::holds_alternative<PlainColumn>(col));
+  return Int64Values(std::get<PlainColumn>(col).array.get())[row_idx];
+}
+
+Time ColdBatch::GetTimeValue(int64_t time_col_idx, int64_t row_idx) const {
+  return GetInt64Value(time_col_idx, row_idx);
+}
+
+int64_t ColdBatch::FindTimeFirstGreaterThanOrEqual(int64_t time_col_idx, Time time) const {
+  int64_t lo = 0;
+  int64_t hi = length_;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (GetInt64Value(time_col_idx, mid) < time) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == static_cast<int64_t>(length_)) {
+    return -1;
+  }
+  return lo;
+}
+
+int64_t ColdBatch::FindTimeFirstGreaterThan(int64_t time_col_idx, Time time) const {
+  int64_t lo = 0;
+  int64_t hi = length_;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (GetInt64Value(time_col_idx, mid) <= time) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <types::DataType TDataType>
+Status ColdBatch::AppendInt64Slice(int64_t col_idx, size_t row_offset, size_t batch_size,
+                                   arrow::ArrayBuilder* builder) const {
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<TDataType>::arrow_builder_type*>(builder);
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(batch_size));
+  for (size_t i = row_offset; i < row_offset + batch_size; ++i) {
+    typed_builder->UnsafeAppend(GetInt64Value(col_idx, i));
+  }
+  return Status::OK();
+}
+
+template <types::DataType TDataType>
+void ColdBatch::AppendInt64Rows(int64_t col_idx, size_t row_offset,
+                                const std::vector<int64_t>& rows,
+                                arrow::ArrayBuilder* builder) const {
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<TDataType>::arrow_builder_type*>(builder);
+  for (auto row : rows) {
+    typed_builder->UnsafeAppend(GetInt64Value(col_idx, row_offset + row));
+  }
+}
+
+StatusOr<ArrowArrayPtr> ColdBatch::DecodeSlice(int64_t col_idx, size_t row_offset,
+                                               size_t batch_size,
+                                               arrow::MemoryPool* mem_pool) const {
+  const auto& col = *columns_[col_idx];
+  if (const auto* plain = std::get_if<PlainColumn>(&col)) {
+    return plain->array->Slice(row_offset, batch_size);
+  }
+
+  auto builder = types::MakeArrowBuilder(col_types_[col_idx], mem_pool);
+  ArrowArrayPtr out;
+  if (std::holds_alternative<FrameOfReferenceColumn>(col)) {
+    if (col_types_[col_idx] == types::DataType::TIME64NS) {
+      PL_RETURN_IF_ERROR(AppendInt64Slice<types::DataType::TIME64NS>(col_idx, row_offset,
+                                                                     batch_size, builder.get()));
+    } else {
+      PL_RETURN_IF_ERROR(AppendInt64Slice<types::DataType::INT64>(col_idx, row_offset, batch_size,
+                                                                  builder.get()));
+    }
+  } else {
+    const auto& dict_col = std::get<DictionaryColumn>(col);
+    auto* typed_builder = static_cast<arrow::StringBuilder*>(builder.get());
+    std::vector<uint32_t> dict_indices(batch_size);
+    int64_t data_bytes = 0;
+    for (size_t i = 0; i < batch_size; ++i) {
+      dict_indices[i] = UnpackValue(dict_col.indices, dict_col.index_width, row_offset + i);
+      data_bytes += dict_col.dictionary->value_length(dict_indices[i]);
+    }
+    PL_RETURN_IF_ERROR(typed_builder->Reserve(batch_size));
+    PL_RETURN_IF_ERROR(typed_builder->ReserveData(data_bytes));
+    for (auto dict_idx : dict_indices) {
+      typed_builder->UnsafeAppend(dict_col.dictionary->GetView(dict_idx));
+    }
+  }
+  PL_RETURN_IF_ERROR(builder->Finish(&out));
+  return out;
+}
+
+StatusOr<ArrowArrayPtr> ColdBatch::GetColumnRows(int64_t col_idx, size_t row_offset,
+                                                 const std::vector<int64_t>& rows,
+                                                 arrow::MemoryPool* mem_pool) const {
+  const auto& col = *columns_[col_idx];
+  if (const auto* plain = std::get_if<PlainColumn>(&col)) {
+    return schema::SelectRows(plain->array->Slice(row_offset).get(), rows, mem_pool);
+  }
+
+  auto builder = types::MakeArrowBuilder(col_types_[col_idx], mem_pool);
+  PL_RETURN_IF_ERROR(builder->Reserve(rows.size()));
+  if (std::holds_alternative<FrameOfReferenceColumn>(col)) {
+    if (col_types_[col_idx] == types::DataType::TIME64NS) {
+      AppendInt64Rows<types::DataType::TIME64NS>(col_idx, row_offset, rows, builder.get());
+    } else {
+      AppendInt64Rows<types::DataType::INT64>(col_idx, row_offset, rows, builder.get());
+    }
+  } else {
+    const auto& dict_col = std::get<DictionaryColumn>(col);
+    auto* typed_builder = static_cast<arrow::StringBuilder*>(builder.get());
+    std::vector<uint32_t> dict_indices(rows.size());
+    int64_t data_bytes = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      dict_indices[i] = UnpackValue(dict_col.indices, dict_col.index_width, row_offset + rows[i]);
+      data_bytes += dict_col.dictionary->value_length(dict_indices[i]);
+    }
+    PL_RETURN_IF_ERROR(typed_builder->ReserveData(data_bytes));
+    for (auto dict_idx : dict_indices) {
+      typed_builder->UnsafeAppend(dict_col.dictionary->GetView(dict_idx));
+    }
+  }
+  ArrowArrayPtr out;
+  PL_RETURN_IF_ERROR(builder->Finish(&out));
+  return out;
+}
+
+Status ColdBatch::AddBatchSliceToRowBatch(size_t row_offset, size_t batch_size,
+                                          const std::vector<int64_t>& cols,
+                                          schema::RowBatch* output_rb,
+                                          arrow::MemoryPool* mem_pool) const {
+  for (auto col_idx : cols) {
+    PL_ASSIGN_OR_RETURN(auto arr, DecodeSlice(col_idx, row_offset, batch_size, mem_pool));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
+  }
+  return Status::OK();
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
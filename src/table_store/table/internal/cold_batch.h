@@ -0,0 +1,243 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/memory_pool.h>
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "src/common/base/status.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/table/internal/table_memory_pool.h"
+#include "src/table_store/table/internal/types.h"
+#include "src/table_store/table/internal/zone_map.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * PlainColumn stores a cold column as a regular arrow::Array. This is used for column types without
+ * a specialized encoding, and for columns where encoding would not save any space.
+ */
+struct PlainColumn {
+  ArrowArrayPtr array;
+};
+
+/**
+ * DictionaryColumn stores a string column as an arrow::StringArray of its distinct values, and a
+ * packed index into that dictionary for each row. Indices are stored with the smallest width (1, 2
+ * or 4 bytes) that can address the whole dictionary.
+ */
+struct DictionaryColumn {
+  std::shared_ptr<arrow::StringArray> dictionary;
+  uint8_t index_width = 0;
+  std::vector<uint8_t> indices;
+};
+
+/**
+ * FrameOfReferenceColumn stores an int64 or time64 column in blocks of `kBlockSize` rows. Each
+ * block stores its minimum value as a base, and each row stores its offset from the block's base
+ * using the smallest width (1, 2 or 4 bytes) that fits the offsets of every block. Unlike a running
+ * delta encoding, every row can be decoded without decoding its predecessors, so the time column
+ * can still be binary searched without materializing it.
+ */
+struct FrameOfReferenceColumn {
+  static constexpr size_t kBlockSize = 128;
+  std::vector<int64_t> block_bases;
+  uint8_t offset_width = 0;
+  std::vector<uint8_t> offsets;
+};
+
+using EncodedColumn = std::variant<PlainColumn, DictionaryColumn, FrameOfReferenceColumn>;
+
+/**
+ * ColdBatch is a single compacted batch in the cold store. Each column is stored in one of the
+ * `EncodedColumn` representations, chosen at compaction time by `ColdBatch::Encode`. Columns are
+ * only decoded when they are read, and only for the requested slice of rows, so queries only pay
+ * for the columns and rows they actually request. Each column also keeps a ColumnZoneMap, computed
+ * from the unencoded values, so that queries can skip batches that cannot match their predicates.
+ */
+class ColdBatch {
+ public:
+  /**
+   * Batches with fewer rows than this are always stored as plain arrow arrays, since the fixed
+   * overhead of the encodings outweighs their savings on small batches.
+   */
+  static constexpr size_t kMinRowsToEncode = 64;
+
+  /**
+   * Creates a ColdBatch that stores the given arrow arrays as is.
+   * @param columns the arrow arrays for each column in the batch.
+   */
+  explicit ColdBatch(std::vector<ArrowArrayPtr> columns);
+
+  ColdBatch() = default;
+  ColdBatch(ColdBatch&&) = default;
+  ColdBatch& operator=(ColdBatch&&) = default;
+
+  /**
+   * Encode creates a ColdBatch from the given arrow arrays, choosing for each column the
+   * representation that uses the least memory. String columns with few distinct values are
+   * dictionary encoded, and int64/time64 columns are frame-of-reference encoded.
+   * @param rel the relation of the table the batch belongs to.
+   * @param columns the arrow arrays for each column in the batch.
+   * @return the encoded ColdBatch, or an error if building a dictionary fails.
+   */
+  static StatusOr<ColdBatch> Encode(const schema::Relation& rel,
+                                    const std::vector<ArrowArrayPtr>& columns);
+
+  /**
+   * Length returns the number of rows in this batch.
+   * @return number of rows.
+   */
+  size_t Length() const { return length_; }
+
+  /**
+   * BytesSavedByEncoding returns how many fewer bytes this batch takes compared to storing every
+   * column as a plain arrow array. The plain size is measured the same way as
+   * `BatchSizeAccountant`, so this can be subtracted from the accountant's estimate of the batch.
+   * @return number of bytes saved.
+   */
+  uint64_t BytesSavedByEncoding() const { return bytes_saved_; }
+
+  /**
+   * MemoryUsage returns the number of bytes the columns of this batch take up in memory. Arrow
+   * buffers are counted with the size class they take up in a TableMemoryPool.
+   * @return number of bytes.
+   */
+  uint64_t MemoryUsage() const;
+
+  /**
+   * IsEncoded returns whether the given column is stored in a non-plain representation.
+   * @param col_idx index of the column.
+   */
+  bool IsEncoded(int64_t col_idx) const {
+    return !std::holds_alternative<PlainColumn>(*columns_[col_idx]);
+  }
+
+  /**
+   * Decode returns every column of this batch as a plain arrow array.
+   * @return the decoded columns, or an error if decoding fails.
+   */
+  StatusOr<std::vector<ArrowArrayPtr>> Decode() const;
+
+  /**
+   * ReplaceColumns replaces the storage of every column with the given plain arrow arrays, which
+   * must hold the same values as the current columns (e.g. the columns after being written to
+   * disk). The zone maps are kept, since the values don't change.
+   * @param columns the arrow arrays for each column in the batch.
+   */
+  void ReplaceColumns(std::vector<ArrowArrayPtr> columns);
+
+  /**
+   * Pin returns a batch that shares the columns of this batch, without copying them. The pinned
+   * batch stays readable after this batch is removed from its store or its columns are replaced,
+   * so a Cursor can pin a batch while holding the store's lock, and decode it after releasing the
+   * lock. The pinned batch has no zone maps, so MayMatch must not be called on it.
+   * @return the pinned batch.
+   */
+  ColdBatch Pin() const;
+
+  /**
+   * MayMatch returns whether any row of this batch could satisfy all of the given predicates,
+   * according to the batch's zone maps. It never returns false if such a row exists.
+   * @param predicates, a conjunction of predicates on the columns of this batch.
+   */
+  bool MayMatch(const std::vector<ColumnPredicate>& predicates) const;
+
+  /**
+   * GetTimeValue returns the value of the time column at the given row index.
+   * @param time_col_idx, the index of the column to get the time value from.
+   * @param row_idx, the index of the row to get.
+   * @return the time value at the given row index.
+   */
+  Time GetTimeValue(int64_t time_col_idx, int64_t row_idx) const;
+  /**
+   * FindTimeFirstGreaterThanOrEqual returns the first row index within this batch that has time
+   * greater than or equal to the given time.
+   * @param time_col_idx, column index to use for times.
+   * @param time, the time to search for.
+   * @return row index of the first such row, or -1 if no such row exists.
+   */
+  int64_t FindTimeFirstGreaterThanOrEqual(int64_t time_col_idx, Time time) const;
+  /**
+   * FindTimeFirstGreaterThan returns the first row index within this batch that has time greater
+   * than the given time.
+   * @param time_col_idx, column index to use for times.
+   * @param time, the time to search for.
+   * @return row index of the first such row, or Length() if no such row exists.
+   */
+  int64_t FindTimeFirstGreaterThan(int64_t time_col_idx, Time time) const;
+  /**
+   * AddBatchSliceToRowBatch decodes a slice of the requested columns of this batch and adds them
+   * to the given output schema::RowBatch. Plain columns are sliced without copying.
+   * @param row_offset, row index within this batch to start the output slice at.
+   * @param batch_size, size of the output slice.
+   * @param cols, a vector of column indices to include in the output slice.
+   * @param output_rb, a pointer to the row batch to add the columns to.
+   * @param mem_pool, the pool to allocate decoded columns from.
+   * @return Status, errors if decoding or adding columns to the row batch fails.
+   */
+  Status AddBatchSliceToRowBatch(size_t row_offset, size_t batch_size,
+                                 const std::vector<int64_t>& cols, schema::RowBatch* output_rb,
+                                 arrow::MemoryPool* mem_pool = arrow::default_memory_pool()) const;
+
+  /**
+   * GetColumnRows decodes the given rows of a column of this batch, e.g. the rows selected by a
+   * LateMaterialization. Only the selected rows are read, so the rows of a memory mapped column
+   * that aren't selected are never paged in.
+   * @param col_idx, index of the column to decode.
+   * @param row_offset, row index within this batch that the row indices are relative to.
+   * @param rows, the indices of the rows to decode, relative to row_offset.
+   * @param mem_pool, the pool to allocate the decoded column from.
+   * @return the decoded column, or an error if decoding fails.
+   */
+  StatusOr<ArrowArrayPtr> GetColumnRows(int64_t col_idx, size_t row_offset,
+                                        const std::vector<int64_t>& rows,
+                                        arrow::MemoryPool* mem_pool) const;
+
+ private:
+  // Returns the int64 value of an INT64 or TIME64NS column at the given row.
+  int64_t GetInt64Value(int64_t col_idx, int64_t row_idx) const;
+  template <types::DataType TDataType>
+  Status AppendInt64Slice(int64_t col_idx, size_t row_offset, size_t batch_size,
+                          arrow::ArrayBuilder* builder) const;
+  template <types::DataType TDataType>
+  void AppendInt64Rows(int64_t col_idx, size_t row_offset, const std::vector<int64_t>& rows,
+                       arrow::ArrayBuilder* builder) const;
+  StatusOr<ArrowArrayPtr> DecodeSlice(int64_t col_idx, size_t row_offset, size_t batch_size,
+                                      arrow::MemoryPool* mem_pool) const;
+
+  std::vector<types::DataType> col_types_;
+  // Columns are immutable once built, and shared with the batches returned by Pin().
+  std::vector<std::shared_ptr<const EncodedColumn>> columns_;
+  std::vector<ColumnZoneMap> zone_maps_;
+  size_t length_ = 0;
+  uint64_t bytes_saved_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/table/internal/cold_batch.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class ColdBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = std::make_unique<schema::Relation>(
+        std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::INT64,
+                                     types::DataType::STRING, types::DataType::STRING,
+                                     types::DataType::FLOAT64},
+        std::vector<std::string>{"time_", "latency", "service", "req_body", "cpu"});
+  }
+
+  // Builds columns where time is monotonically increasing, latency is small but unordered, the
+  // service column only has a handful of distinct values and req_body is unique per row.
+  std::vector<ArrowArrayPtr> MakeColumns(size_t num_rows) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> latencies;
+    std::vector<types::StringValue> services;
+    std::vector<types::StringValue> bodies;
+    std::vector<types::Float64Value> cpus;
+    for (size_t i = 0; i < num_rows; ++i) {
+      times.emplace_back(1'600'000'000'000'000'000 + static_cast<int64_t>(i) * 1000);
+      latencies.emplace_back((i * 7919) % 5000);
+      services.emplace_back(absl::StrCat("px-sock-shop/service-", i % 5));
+      bodies.emplace_back(absl::StrCat("body ", i));
+      cpus.emplace_back(0.5 * i);
+    }
+    return {
+        types::ToArrow(times, arrow::default_memory_pool()),
+        types::ToArrow(latencies, arrow::default_memory_pool()),
+        types::ToArrow(services, arrow::default_memory_pool()),
+        types::ToArrow(bodies, arrow::default_memory_pool()),
+        types::ToArrow(cpus, arrow::default_memory_pool()),
+    };
+  }
+
+  std::unique_ptr<schema::Relation> rel_;
+};
+
+TEST_F(ColdBatchTest, EncodesColumnsThatBenefit) {
+  auto columns = MakeColumns(1000);
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(*rel_, columns));
+
+  EXPECT_EQ(1000, batch.Length());
+  EXPECT_TRUE(batch.IsEncoded(0));
+  EXPECT_TRUE(batch.IsEncoded(1));
+  EXPECT_TRUE(batch.IsEncoded(2));
+  EXPECT_FALSE(batch.IsEncoded(3));
+  EXPECT_FALSE(batch.IsEncoded(4));
+  EXPECT_GT(batch.BytesSavedByEncoding(), 0);
+}
+
+TEST_F(ColdBatchTest, SmallBatchesAreNotEncoded) {
+  auto columns = MakeColumns(ColdBatch::kMinRowsToEncode - 1);
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(*rel_, columns));
+
+  for (size_t col_idx = 0; col_idx < rel_->NumColumns(); ++col_idx) {
+    EXPECT_FALSE(batch.IsEncoded(col_idx));
+  }
+  EXPECT_EQ(0, batch.BytesSavedByEncoding());
+}
+
+TEST_F(ColdBatchTest, DecodeSlices) {
+  auto columns = MakeColumns(1000);
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(*rel_, columns));
+
+  std::vector<int64_t> cols = {0, 1, 2, 3, 4};
+  std::vector<types::DataType> col_types;
+  for (auto col_idx : cols) {
+    col_types.push_back(rel_->col_types()[col_idx]);
+  }
+  for (const auto& [offset, size] : std::vector<std::pair<size_t, size_t>>{
+           {0, 1000}, {0, 1}, {127, 2}, {300, 450}, {999, 1}}) {
+    schema::RowBatch rb(schema::RowDescriptor(col_types), size);
+    ASSERT_OK(batch.AddBatchSliceToRowBatch(offset, size, cols, &rb));
+    for (auto col_idx : cols) {
+      EXPECT_TRUE(rb.ColumnAt(col_idx)->Equals(columns[col_idx]->Slice(offset, size)))
+          << absl::Substitute("col $0, offset $1, size $2", col_idx, offset, size);
+    }
+  }
+}
+
+TEST_F(ColdBatchTest, GetColumnRows) {
+  auto columns = MakeColumns(1000);
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(*rel_, columns));
+
+  auto* pool = arrow::default_memory_pool();
+  std::vector<int64_t> rows = {0, 3, 4, 250, 499};
+  for (int64_t col_idx = 0; col_idx < 5; ++col_idx) {
+    ASSERT_OK_AND_ASSIGN(auto arr, batch.GetColumnRows(col_idx, 500, rows, pool));
+    ASSERT_OK_AND_ASSIGN(auto expected,
+                         schema::SelectRows(columns[col_idx]->Slice(500).get(), rows, pool));
+    // The time column must come back as a time64 array, not an int64 one.
+    EXPECT_TRUE(arr->type()->Equals(columns[col_idx]->type())) << col_idx;
+    EXPECT_TRUE(arr->Equals(expected)) << col_idx;
+  }
+}
+
+TEST_F(ColdBatchTest, DecodeOnlyRequestedColumns) {
+  auto columns = MakeColumns(500);
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(*rel_, columns));
+
+  schema::RowBatch rb(schema::RowDescriptor({types::DataType::STRING}), 100);
+  ASSERT_OK(batch.AddBatchSliceToRowBatch(200, 100, {2}, &rb));
+  ASSERT_EQ(1, rb.num_columns());
+  EXPECT_TRUE(rb.ColumnAt(0)->Equals(columns[2]->Slice(200, 100)));
+}
+
+TEST_F(ColdBatchTest, TimeSearch) {
+  auto columns = MakeColumns(1000);
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(*rel_, columns));
+  ASSERT_TRUE(batch.IsEncoded(0));
+
+  int64_t start = 1'600'000'000'000'000'000;
+  EXPECT_EQ(start + 5000, batch.GetTimeValue(0, 5));
+  EXPECT_EQ(0, batch.FindTimeFirstGreaterThanOrEqual(0, start - 1));
+  EXPECT_EQ(5, batch.FindTimeFirstGreaterThanOrEqual(0, start + 5000));
+  EXPECT_EQ(6, batch.FindTimeFirstGreaterThanOrEqual(0, start + 5001));
+  EXPECT_EQ(-1, batch.FindTimeFirstGreaterThanOrEqual(0, start + 1'000'000));
+  EXPECT_EQ(6, batch.FindTimeFirstGreaterThan(0, start + 5000));
+  EXPECT_EQ(1000, batch.FindTimeFirstGreaterThan(0, start + 1'000'000));
+}
+
+TEST_F(ColdBatchTest, WideRangeIsNotFrameOfReferenceEncoded) {
+  std::vector<types::Int64Value> values;
+  for (size_t i = 0; i < 200; ++i) {
+    values.emplace_back(i % 2 == 0 ? 0 : std::numeric_limits<int64_t>::max());
+  }
+  schema::Relation rel({types::DataType::INT64}, {"val"});
+  std::vector<ArrowArrayPtr> columns = {types::ToArrow(values, arrow::default_memory_pool())};
+  ASSERT_OK_AND_ASSIGN(auto batch, ColdBatch::Encode(rel, columns));
+  EXPECT_FALSE(batch.IsEncoded(0));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
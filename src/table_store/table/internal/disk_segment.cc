@@ -0,0 +1,452 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <arrow/buffer.h>
+#include <arrow/util/bit-util.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+#include "src/table_store/table/internal/disk_segment.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+// "PXSEGMNT" and "PXBATCH1" in little endian.
+constexpr uint64_t kSegmentMagic = 0x544e4d4745535850;
+constexpr uint64_t kBatchMagic = 0x3148435441425850;
+constexpr uint32_t kSegmentVersion = 1;
+// Buffers within a record are aligned the same way arrow aligns its own allocations.
+constexpr uint64_t kBufferAlignment = 64;
+
+struct SegmentHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t num_columns;
+  // Followed by `num_columns` int32 data types.
+};
+
+struct BatchRecordHeader {
+  uint64_t magic;
+  int64_t first_row_id;
+  int64_t last_row_id;
+  int64_t first_time;
+  int64_t last_time;
+  int64_t num_rows;
+  uint64_t record_size;
+  uint32_t num_buffers;
+  uint32_t has_times;
+  // Followed by `num_buffers` BufferLocations, and then the buffers themselves.
+};
+
+struct BufferLocation {
+  uint64_t offset;
+  uint64_t size;
+};
+
+uint64_t PageSize() {
+  static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+Status WriteAll(int fd, const uint8_t* data, uint64_t size, uint64_t file_offset) {
+  while (size > 0) {
+    ssize_t written = pwrite(fd, data, size, file_offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return error::Internal("Failed to write to disk segment: $0", std::strerror(errno));
+    }
+    data += written;
+    size -= written;
+    file_offset += written;
+  }
+  return Status::OK();
+}
+
+// An arrow::Buffer over a memory mapped region of a segment file. The segment is kept alive for as
+// long as any buffer points into it.
+class MappedBuffer : public arrow::Buffer {
+ public:
+  MappedBuffer(const uint8_t* data, int64_t size, std::shared_ptr<const DiskSegment> segment)
+      : arrow::Buffer(data, size), segment_(std::move(segment)) {}
+  ~MappedBuffer() override { munmap(const_cast<uint8_t*>(data_), size_); }
+
+ private:
+  std::shared_ptr<const DiskSegment> segment_;
+};
+
+// RecordBuilder lays out the buffers of a batch into a single record.
+class RecordBuilder {
+ public:
+  // Reserves space for a buffer of the given size, and returns a pointer to write it to.
+  uint8_t* AddBuffer(uint64_t size) {
+    uint64_t offset = AlignUp(buffers_size_, kBufferAlignment);
+    locations_.push_back(BufferLocation{offset, size});
+    buffers_size_ = offset + size;
+    data_.resize(buffers_size_);
+    return data_.data() + offset;
+  }
+
+  void AddBuffer(const uint8_t* data, uint64_t size) {
+    std::memcpy(AddBuffer(size), data, size);
+  }
+
+  // Returns the finished record, with the given header at its start.
+  std::vector<uint8_t> Finish(BatchRecordHeader header) {
+    uint64_t prefix_size = AlignUp(
+        sizeof(BatchRecordHeader) + locations_.size() * sizeof(BufferLocation), kBufferAlignment);
+    header.num_buffers = locations_.size();
+    header.record_size = AlignUp(prefix_size + buffers_size_, PageSize());
+
+    std::vector<uint8_t> record(header.record_size, 0);
+    std::memcpy(record.data(), &header, sizeof(header));
+    for (auto& location : locations_) {
+      location.offset += prefix_size;
+    }
+    std::memcpy(record.data() + sizeof(header), locations_.data(),
+                locations_.size() * sizeof(BufferLocation));
+    std::memcpy(record.data() + prefix_size, data_.data(), data_.size());
+    return record;
+  }
+
+  const std::vector<BufferLocation>& locations() const { return locations_; }
+
+ private:
+  std::vector<BufferLocation> locations_;
+  std::vector<uint8_t> data_;
+  uint64_t buffers_size_ = 0;
+};
+
+// Adds the value buffers of the column to the record. Validity bitmaps are not stored, since
+// columns with nulls aren't supported. Sliced arrays are rewritten so that they start at offset 0.
+Status AddColumnBuffers(types::DataType type, const arrow::Array* arr, RecordBuilder* builder) {
+  if (arr->null_count() > 0) {
+    return error::Unimplemented("Columns with nulls can't be written to a disk segment.");
+  }
+  const auto& buffers = arr->data()->buffers;
+  int64_t length = arr->length();
+  int64_t offset = arr->offset();
+  switch (type) {
+    case types::DataType::BOOLEAN: {
+      uint64_t size = arrow::BitUtil::BytesForBits(length);
+      if (offset % 8 == 0) {
+        builder->AddBuffer(buffers[1]->data() + offset / 8, size);
+        return Status::OK();
+      }
+      uint8_t* out = builder->AddBuffer(size);
+      std::memset(out, 0, size);
+      for (int64_t i = 0; i < length; ++i) {
+        if (arrow::BitUtil::GetBit(buffers[1]->data(), offset + i)) {
+          arrow::BitUtil::SetBit(out, i);
+        }
+      }
+      return Status::OK();
+    }
+    case types::DataType::INT64:
+    case types::DataType::TIME64NS:
+    case types::DataType::FLOAT64:
+    case types::DataType::UINT128: {
+      int64_t width = types::ArrowTypeToBytes(types::ToArrowType(type));
+      builder->AddBuffer(buffers[1]->data() + offset * width, length * width);
+      return Status::OK();
+    }
+    case types::DataType::STRING: {
+      const auto* str_arr = static_cast<const arrow::StringArray*>(arr);
+      int32_t base = str_arr->value_offset(0);
+      auto* offsets =
+          reinterpret_cast<int32_t*>(builder->AddBuffer((length + 1) * sizeof(int32_t)));
+      for (int64_t i = 0; i <= length; ++i) {
+        offsets[i] = str_arr->value_offset(i) - base;
+      }
+      builder->AddBuffer(str_arr->value_data()->data() + base,
+                         str_arr->value_offset(length) - base);
+      return Status::OK();
+    }
+    default:
+      return error::Unimplemented("Data type $0 can't be written to a disk segment.",
+                                  types::ToString(type));
+  }
+}
+
+
+int NumBuffers(types::DataType type) { return type == types::DataType::STRING ? 2 : 1; }
+
+// Checks that a buffer read back from a segment has the size its column requires, so that corrupt
+// files can't cause reads past the end of a buffer.
+Status ValidateBuffers(types::DataType type, int64_t num_rows,
+                       const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+  switch (type) {
+    case types::DataType::BOOLEAN:
+      if (buffers[1]->size() < arrow::BitUtil::BytesForBits(num_rows)) {
+        return error::Internal("Boolean buffer is too small");
+      }
+      return Status::OK();
+    case types::DataType::STRING: {
+      if (buffers[1]->size() != static_cast<int64_t>((num_rows + 1) * sizeof(int32_t))) {
+        return error::Internal("String offsets buffer has the wrong size");
+      }
+      const auto* offsets = reinterpret_cast<const int32_t*>(buffers[1]->data());
+      if (offsets[0] != 0 || offsets[num_rows] != buffers[2]->size()) {
+        return error::Internal("String offsets don't match the string data");
+      }
+      for (int64_t i = 0; i < num_rows; ++i) {
+        if (offsets[i] > offsets[i + 1]) {
+          return error::Internal("String offsets aren't sorted");
+        }
+      }
+      return Status::OK();
+    }
+    default:
+      if (buffers[1]->size() < num_rows * types::ArrowTypeToBytes(types::ToArrowType(type))) {
+        return error::Internal("Value buffer is too small");
+      }
+      return Status::OK();
+  }
+}
+
+}  // namespace
+
+DiskSegment::DiskSegment(std::filesystem::path path, const schema::Relation& rel, int fd,
+                         bool persistent)
+    : path_(std::move(path)), col_types_(rel.col_types()), fd_(fd), persistent_(persistent) {}
+
+DiskSegment::~DiskSegment() {
+  close(fd_);
+  if (persistent_) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::remove(path_, ec);
+  LOG_IF(WARNING, ec) << absl::Substitute("Failed to remove disk segment $0: $1", path_.string(),
+                                          ec.message());
+}
+
+StatusOr<std::shared_ptr<DiskSegment>> DiskSegment::Create(const std::filesystem::path& path,
+                                                           const schema::Relation& rel,
+                                                           bool persistent) {
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return error::Internal("Failed to create disk segment $0: $1", path.string(),
+                           std::strerror(errno));
+  }
+  std::shared_ptr<DiskSegment> segment(new DiskSegment(path, rel, fd, persistent));
+
+  // The header takes up a whole page, so that every batch record starts at a page boundary and can
+  // be mapped on its own.
+  std::vector<uint8_t> header(PageSize(), 0);
+  SegmentHeader segment_header{kSegmentMagic, kSegmentVersion,
+                               static_cast<uint32_t>(rel.NumColumns())};
+  DCHECK_LE(sizeof(segment_header) + rel.NumColumns() * sizeof(int32_t), header.size());
+  std::memcpy(header.data(), &segment_header, sizeof(segment_header));
+  for (const auto& [col_idx, type] : Enumerate(rel.col_types())) {
+    int32_t type_value = type;
+    std::memcpy(header.data() + sizeof(segment_header) + col_idx * sizeof(int32_t), &type_value,
+                sizeof(int32_t));
+  }
+  PL_RETURN_IF_ERROR(WriteAll(fd, header.data(), header.size(), 0));
+  segment->size_ = header.size();
+  return segment;
+}
+
+StatusOr<std::vector<DiskSegment::Batch>> DiskSegment::Open(const std::filesystem::path& path,
+                                                            const schema::Relation& rel) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open disk segment $0: $1", path.string(),
+                           std::strerror(errno));
+  }
+  std::shared_ptr<DiskSegment> segment(new DiskSegment(path, rel, fd, /*persistent*/ true));
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return error::Internal("Failed to stat disk segment $0: $1", path.string(),
+                           std::strerror(errno));
+  }
+  segment->size_ = st.st_size;
+  if (segment->size_ < PageSize()) {
+    return error::InvalidArgument("Disk segment $0 is too small", path.string());
+  }
+
+  void* mapping = mmap(nullptr, segment->size_, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    return error::Internal("Failed to map disk segment $0: $1", path.string(),
+                           std::strerror(errno));
+  }
+  const auto* data = static_cast<const uint8_t*>(mapping);
+  auto mapped = std::make_shared<MappedBuffer>(data, segment->size_, segment);
+
+  SegmentHeader segment_header;
+  std::memcpy(&segment_header, data, sizeof(segment_header));
+  if (segment_header.magic != kSegmentMagic || segment_header.version != kSegmentVersion) {
+    return error::InvalidArgument("$0 is not a disk segment", path.string());
+  }
+  if (segment_header.num_columns != rel.NumColumns()) {
+    return error::InvalidArgument("Disk segment $0 has $1 columns, expected $2", path.string(),
+                                  segment_header.num_columns, rel.NumColumns());
+  }
+  for (const auto& [col_idx, type] : Enumerate(rel.col_types())) {
+    int32_t type_value;
+    std::memcpy(&type_value, data + sizeof(segment_header) + col_idx * sizeof(int32_t),
+                sizeof(int32_t));
+    if (type_value != type) {
+      return error::InvalidArgument("Disk segment $0 has the wrong type for column $1",
+                                    path.string(), col_idx);
+    }
+  }
+
+  size_t num_buffers = 0;
+  for (const auto& type : rel.col_types()) {
+    num_buffers += NumBuffers(type);
+  }
+  std::vector<Batch> batches;
+  uint64_t offset = PageSize();
+  while (offset < segment->size_) {
+    BatchRecordHeader header;
+    if (segment->size_ - offset < sizeof(header)) {
+      return error::InvalidArgument("Disk segment $0 has a truncated record", path.string());
+    }
+    std::memcpy(&header, data + offset, sizeof(header));
+    uint64_t locations_size = num_buffers * sizeof(BufferLocation);
+    if (header.magic != kBatchMagic || header.num_buffers != num_buffers ||
+        header.record_size < sizeof(header) + locations_size ||
+        header.record_size > segment->size_ - offset || header.num_rows <= 0) {
+      return error::InvalidArgument("Disk segment $0 has an invalid record at offset $1",
+                                    path.string(), offset);
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> locations;
+    for (size_t i = 0; i < num_buffers; ++i) {
+      BufferLocation location;
+      std::memcpy(&location, data + offset + sizeof(header) + i * sizeof(BufferLocation),
+                  sizeof(location));
+      if (location.offset > header.record_size ||
+          location.size > header.record_size - location.offset) {
+        return error::InvalidArgument("Disk segment $0 has an invalid buffer at offset $1",
+                                      path.string(), offset);
+      }
+      locations.emplace_back(offset + location.offset, location.size);
+    }
+
+    Batch batch;
+    batch.row_ids = {header.first_row_id, header.last_row_id};
+    if (header.has_times) {
+      batch.times = TimeInterval{header.first_time, header.last_time};
+    }
+    PL_ASSIGN_OR_RETURN(batch.columns, segment->MakeColumns(mapped, header.num_rows, locations));
+    batches.push_back(std::move(batch));
+    offset += header.record_size;
+  }
+  return batches;
+}
+
+StatusOr<DiskSegment::WrittenRecord> DiskSegment::WriteRecord(
+    RowIDInterval row_ids, std::optional<TimeInterval> times,
+    const std::vector<ArrowArrayPtr>& columns) {
+  DCHECK_EQ(columns.size(), col_types_.size());
+  DCHECK(!columns.empty());
+  RecordBuilder builder;
+  for (const auto& [col_idx, arr] : Enumerate(columns)) {
+    PL_RETURN_IF_ERROR(AddColumnBuffers(col_types_[col_idx], arr.get(), &builder));
+  }
+
+  BatchRecordHeader header = {};
+  header.magic = kBatchMagic;
+  header.first_row_id = row_ids.first;
+  header.last_row_id = row_ids.second;
+  header.has_times = times.has_value();
+  header.first_time = times.has_value() ? times->first : -1;
+  header.last_time = times.has_value() ? times->second : -1;
+  header.num_rows = columns[0]->length();
+  auto record = builder.Finish(header);
+
+  WrittenRecord written;
+  written.offset = size_;
+  written.size = record.size();
+  for (const auto& location : builder.locations()) {
+    written.buffer_locations.emplace_back(location.offset, location.size);
+  }
+  PL_RETURN_IF_ERROR(WriteAll(fd_, record.data(), record.size(), written.offset));
+  size_ += record.size();
+  return written;
+}
+
+StatusOr<std::vector<ArrowArrayPtr>> DiskSegment::MakeColumns(
+    const std::shared_ptr<arrow::Buffer>& record, int64_t num_rows,
+    const std::vector<std::pair<uint64_t, uint64_t>>& buffer_locations) const {
+  std::vector<ArrowArrayPtr> out;
+  size_t buffer_idx = 0;
+  for (const auto& type : col_types_) {
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers = {nullptr};
+    for (int i = 0; i < NumBuffers(type); ++i, ++buffer_idx) {
+      const auto& [offset, size] = buffer_locations[buffer_idx];
+      buffers.push_back(arrow::SliceBuffer(record, offset, size));
+    }
+    PL_RETURN_IF_ERROR(ValidateBuffers(type, num_rows, buffers));
+    auto arrow_type = types::MakeArrowBuilder(type, arrow::default_memory_pool())->type();
+    out.push_back(arrow::MakeArray(
+        arrow::ArrayData::Make(arrow_type, num_rows, std::move(buffers), /*null_count*/ 0)));
+  }
+  return out;
+}
+
+StatusOr<std::vector<ArrowArrayPtr>> DiskSegment::Append(
+    RowIDInterval row_ids, std::optional<TimeInterval> times,
+    const std::vector<ArrowArrayPtr>& columns) {
+  PL_ASSIGN_OR_RETURN(auto written, WriteRecord(row_ids, times, columns));
+  void* mapping = mmap(nullptr, written.size, PROT_READ, MAP_SHARED, fd_, written.offset);
+  if (mapping == MAP_FAILED) {
+    return error::Internal("Failed to map disk segment $0: $1", path_.string(),
+                           std::strerror(errno));
+  }
+  auto mapped = std::make_shared<MappedBuffer>(static_cast<const uint8_t*>(mapping), written.size,
+                                               shared_from_this());
+  return MakeColumns(mapped, columns[0]->length(), written.buffer_locations);
+}
+
+Status DiskSegment::Write(RowIDInterval row_ids, std::optional<TimeInterval> times,
+                          const std::vector<ArrowArrayPtr>& columns) {
+  return WriteRecord(row_ids, times, columns).status();
+}
+
+Status DiskSegment::Sync() {
+  if (fsync(fd_) != 0) {
+    return error::Internal("Failed to sync disk segment $0: $1", path_.string(),
+                           std::strerror(errno));
+  }
+  return Status::OK();
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "src/common/base/status.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * DiskSegment is an append-only file of table batches. Each batch is stored as a page aligned
+ * record that holds the batch's RowID and time intervals, followed by the raw arrow buffers of
+ * each column in the same layout arrow uses in memory. Appended records are memory mapped, and the
+ * arrays returned by `Append` point directly into the mapping, so batches on disk are read without
+ * any copying or deserialization, and the kernel pages them in and out as needed.
+ *
+ * Unless created as a persistent segment, the file is removed once the DiskSegment and every array
+ * that points into it are destroyed. Persistent segments (e.g. table store snapshots) can be
+ * opened again with `Open`, which maps the whole file back in.
+ */
+class DiskSegment : public std::enable_shared_from_this<DiskSegment> {
+ public:
+  /**
+   * Batch is a single batch read back from a segment.
+   */
+  struct Batch {
+    RowIDInterval row_ids;
+    std::optional<TimeInterval> times;
+    std::vector<ArrowArrayPtr> columns;
+  };
+
+  /**
+   * Creates a new, empty segment file at the given path, for batches of the given relation.
+   * @param path the path of the segment file. Any existing file at the path is truncated.
+   * @param rel the relation of the batches stored in the segment.
+   * @param persistent if false, the file is removed once the segment is no longer referenced.
+   * @return the DiskSegment or an error if the file could not be created.
+   */
+  static StatusOr<std::shared_ptr<DiskSegment>> Create(const std::filesystem::path& path,
+                                                       const schema::Relation& rel,
+                                                       bool persistent = false);
+
+  /**
+   * Open maps an existing persistent segment file, and returns all of its batches. The returned
+   * arrays point into the mapping, so they are only paged in as they are read. The file is not
+   * modified or removed.
+   * @param path the path of the segment file.
+   * @param rel the expected relation of the batches stored in the segment.
+   * @return the batches in the order they were appended, or an error if the file is not a valid
+   * segment for the relation.
+   */
+  static StatusOr<std::vector<Batch>> Open(const std::filesystem::path& path,
+                                           const schema::Relation& rel);
+
+  ~DiskSegment();
+
+  /**
+   * Append writes a batch to the end of the segment, and returns arrays of the batch's columns
+   * that are backed by the segment file.
+   * @param row_ids the RowID interval of the batch.
+   * @param times the time interval of the batch, if the table has a time column.
+   * @param columns the columns of the batch. Columns with nulls are not supported.
+   * @return the memory mapped columns, or an error if the batch couldn't be written.
+   */
+  StatusOr<std::vector<ArrowArrayPtr>> Append(RowIDInterval row_ids,
+                                              std::optional<TimeInterval> times,
+                                              const std::vector<ArrowArrayPtr>& columns);
+
+  /**
+   * Write is the same as `Append`, but doesn't map the written batch.
+   */
+  Status Write(RowIDInterval row_ids, std::optional<TimeInterval> times,
+               const std::vector<ArrowArrayPtr>& columns);
+
+  /**
+   * Sync flushes the segment file to disk.
+   */
+  Status Sync();
+
+  /**
+   * @return the number of bytes written to the segment file.
+   */
+  uint64_t Size() const { return size_; }
+
+  const std::filesystem::path& path() const { return path_; }
+
+ private:
+  DiskSegment(std::filesystem::path path, const schema::Relation& rel, int fd, bool persistent);
+
+  struct WrittenRecord {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    // Offset and size of each buffer, relative to the start of the record.
+    std::vector<std::pair<uint64_t, uint64_t>> buffer_locations;
+  };
+  // Writes the batch as a record at the end of the file.
+  StatusOr<WrittenRecord> WriteRecord(RowIDInterval row_ids, std::optional<TimeInterval> times,
+                                      const std::vector<ArrowArrayPtr>& columns);
+  // Creates arrays for the columns of a record from a mapping of the record.
+  StatusOr<std::vector<ArrowArrayPtr>> MakeColumns(
+      const std::shared_ptr<arrow::Buffer>& record, int64_t num_rows,
+      const std::vector<std::pair<uint64_t, uint64_t>>& buffer_locations) const;
+
+  const std::filesystem::path path_;
+  const std::vector<types::DataType> col_types_;
+  int fd_;
+  const bool persistent_;
+  uint64_t size_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/disk_segment.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class DiskSegmentTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = std::make_unique<schema::Relation>(
+        std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::INT64,
+                                     types::DataType::STRING, types::DataType::FLOAT64,
+                                     types::DataType::BOOLEAN},
+        std::vector<std::string>{"time_", "latency", "service", "cpu", "ok"});
+  }
+
+  std::vector<ArrowArrayPtr> MakeColumns(int64_t first_time, size_t num_rows) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> latencies;
+    std::vector<types::StringValue> services;
+    std::vector<types::Float64Value> cpus;
+    std::vector<types::BoolValue> oks;
+    for (size_t i = 0; i < num_rows; ++i) {
+      times.emplace_back(first_time + static_cast<int64_t>(i));
+      latencies.emplace_back((i * 7919) % 5000);
+      services.emplace_back(absl::StrCat("service-", i % 7));
+      cpus.emplace_back(0.25 * i);
+      oks.emplace_back(i % 3 == 0);
+    }
+    return {
+        types::ToArrow(times, arrow::default_memory_pool()),
+        types::ToArrow(latencies, arrow::default_memory_pool()),
+        types::ToArrow(services, arrow::default_memory_pool()),
+        types::ToArrow(cpus, arrow::default_memory_pool()),
+        types::ToArrow(oks, arrow::default_memory_pool()),
+    };
+  }
+
+  px::testing::TempDir temp_dir_;
+  std::unique_ptr<schema::Relation> rel_;
+};
+
+TEST_F(DiskSegmentTest, AppendReturnsMappedColumns) {
+  ASSERT_OK_AND_ASSIGN(auto segment, DiskSegment::Create(temp_dir_.path() / "segment", *rel_));
+  auto header_size = segment->Size();
+  EXPECT_GT(header_size, 0);
+
+  auto columns1 = MakeColumns(1000, 100);
+  auto columns2 = MakeColumns(2000, 37);
+  ASSERT_OK_AND_ASSIGN(auto disk_columns1, segment->Append({0, 99}, TimeInterval{1000, 1099},
+                                                           columns1));
+  ASSERT_OK_AND_ASSIGN(auto disk_columns2, segment->Append({100, 136}, TimeInterval{2000, 2036},
+                                                           columns2));
+
+  ASSERT_EQ(columns1.size(), disk_columns1.size());
+  for (size_t i = 0; i < columns1.size(); ++i) {
+    EXPECT_TRUE(disk_columns1[i]->Equals(*columns1[i])) << "column " << i;
+    EXPECT_TRUE(disk_columns2[i]->Equals(*columns2[i])) << "column " << i;
+  }
+  EXPECT_GT(segment->Size(), header_size);
+  EXPECT_TRUE(std::filesystem::exists(segment->path()));
+  EXPECT_EQ(segment->Size(), std::filesystem::file_size(segment->path()));
+}
+
+TEST_F(DiskSegmentTest, SlicedColumnsAreRebased) {
+  ASSERT_OK_AND_ASSIGN(auto segment, DiskSegment::Create(temp_dir_.path() / "segment", *rel_));
+  auto columns = MakeColumns(1000, 100);
+  std::vector<ArrowArrayPtr> sliced;
+  for (const auto& col : columns) {
+    // An offset that isn't a multiple of 8 requires the boolean column to be bit shifted.
+    sliced.push_back(col->Slice(13, 50));
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto disk_columns, segment->Append({13, 62}, std::nullopt, sliced));
+  for (size_t i = 0; i < sliced.size(); ++i) {
+    EXPECT_EQ(0, disk_columns[i]->offset());
+    EXPECT_TRUE(disk_columns[i]->Equals(*sliced[i])) << "column " << i;
+  }
+}
+
+TEST_F(DiskSegmentTest, ColumnsWithNullsAreRejected) {
+  schema::Relation rel({types::DataType::INT64}, {"abc"});
+  ASSERT_OK_AND_ASSIGN(auto segment, DiskSegment::Create(temp_dir_.path() / "segment", rel));
+
+  arrow::Int64Builder builder;
+  ASSERT_TRUE(builder.Append(1).ok());
+  ASSERT_TRUE(builder.AppendNull().ok());
+  std::shared_ptr<arrow::Array> arr;
+  ASSERT_TRUE(builder.Finish(&arr).ok());
+
+  EXPECT_NOT_OK(segment->Append({0, 1}, std::nullopt, {arr}));
+}
+
+TEST_F(DiskSegmentTest, PersistentSegmentCanBeReopened) {
+  auto path = temp_dir_.path() / "segment";
+  auto columns1 = MakeColumns(1000, 100);
+  auto columns2 = MakeColumns(2000, 37);
+  {
+    ASSERT_OK_AND_ASSIGN(auto segment, DiskSegment::Create(path, *rel_, /*persistent*/ true));
+    ASSERT_OK(segment->Write({0, 99}, TimeInterval{1000, 1099}, columns1));
+    ASSERT_OK(segment->Write({100, 136}, std::nullopt, columns2));
+    ASSERT_OK(segment->Sync());
+  }
+  ASSERT_TRUE(std::filesystem::exists(path));
+
+  ASSERT_OK_AND_ASSIGN(auto batches, DiskSegment::Open(path, *rel_));
+  ASSERT_EQ(2, batches.size());
+  EXPECT_EQ(RowIDInterval(0, 99), batches[0].row_ids);
+  EXPECT_EQ(TimeInterval(1000, 1099), batches[0].times);
+  EXPECT_EQ(RowIDInterval(100, 136), batches[1].row_ids);
+  EXPECT_FALSE(batches[1].times.has_value());
+  for (size_t i = 0; i < columns1.size(); ++i) {
+    EXPECT_TRUE(batches[0].columns[i]->Equals(*columns1[i])) << "column " << i;
+    EXPECT_TRUE(batches[1].columns[i]->Equals(*columns2[i])) << "column " << i;
+  }
+
+  // Opening a segment doesn't remove it.
+  batches.clear();
+  EXPECT_TRUE(std::filesystem::exists(path));
+}
+
+TEST_F(DiskSegmentTest, OpenChecksRelation) {
+  auto path = temp_dir_.path() / "segment";
+  {
+    ASSERT_OK_AND_ASSIGN(auto segment, DiskSegment::Create(path, *rel_, /*persistent*/ true));
+    ASSERT_OK(segment->Write({0, 9}, TimeInterval{1000, 1009}, MakeColumns(1000, 10)));
+  }
+  schema::Relation other_rel({types::DataType::TIME64NS, types::DataType::STRING,
+                              types::DataType::STRING, types::DataType::FLOAT64,
+                              types::DataType::BOOLEAN},
+                             {"time_", "latency", "service", "cpu", "ok"});
+  EXPECT_NOT_OK(DiskSegment::Open(path, other_rel));
+  EXPECT_NOT_OK(DiskSegment::Open(temp_dir_.path() / "does_not_exist", *rel_));
+}
+
+TEST_F(DiskSegmentTest, FileRemovedOnceUnreferenced) {
+  ASSERT_OK_AND_ASSIGN(auto segment, DiskSegment::Create(temp_dir_.path() / "segment", *rel_));
+  ASSERT_OK_AND_ASSIGN(auto disk_columns,
+                       segment->Append({0, 9}, TimeInterval{1000, 1009}, MakeColumns(1000, 10)));
+  auto path = segment->path();
+
+  // The returned arrays keep the segment alive.
+  segment.reset();
+  EXPECT_TRUE(std::filesystem::exists(path));
+  EXPECT_EQ(1009, types::GetValueFromArrowArray<types::DataType::TIME64NS>(
+                      disk_columns[0].get(), 9));
+
+  disk_columns.clear();
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
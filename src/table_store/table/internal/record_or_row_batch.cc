@@ -16,9 +16,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <iterator>
+#include <memory>
 #include <vector>
 
 #include "src/common/base/utils.h"
+#include "src/shared/types/arrow_adapter.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
 
 namespace px {
@@ -107,18 +110,19 @@ void RecordOrRowBatch::RemovePrefix(size_t num_rows) { row_offset_ += num_rows;
 
 Status RecordOrRowBatch::AddBatchSliceToRowBatch(size_t row_start, size_t batch_size,
                                                  const std::vector<int64_t>& cols,
-                                                 schema::RowBatch* output_rb) const {
+                                                 schema::RowBatch* output_rb,
+                                                 arrow::MemoryPool* mem_pool) const {
   row_start += row_offset_;
   return std::visit(
       overloaded{
-          [row_start, batch_size, cols,
-           output_rb](const RecordBatchWithCache& record_batch_w_cache) {
+          [row_start, batch_size, cols, output_rb,
+           mem_pool](const RecordBatchWithCache& record_batch_w_cache) {
             for (auto col_idx : cols) {
               if (!record_batch_w_cache.cache_validity[col_idx]) {
                 // Arrow array wasn't in cache, convert it to arrow and then add
                 // to cache.
-                auto arr = (*record_batch_w_cache.record_batch)[col_idx]->ConvertToArrow(
-                    arrow::default_memory_pool());
+                auto arr =
+                    (*record_batch_w_cache.record_batch)[col_idx]->ConvertToArrow(mem_pool);
                 record_batch_w_cache.arrow_cache[col_idx] = arr;
                 record_batch_w_cache.cache_validity[col_idx] = true;
               }
@@ -138,6 +142,77 @@ Status RecordOrRowBatch::AddBatchSliceToRowBatch(size_t row_start, size_t batch_
       batch_);
 }
 
+RecordOrRowBatch RecordOrRowBatch::Pin(const std::vector<int64_t>& cols,
+                                       arrow::MemoryPool* mem_pool) const {
+  auto pinned = std::visit(
+      overloaded{
+          [&cols, mem_pool](const RecordBatchWithCache& record_batch_w_cache) {
+            for (auto col_idx : cols) {
+              if (!record_batch_w_cache.cache_validity[col_idx]) {
+                record_batch_w_cache.arrow_cache[col_idx] =
+                    (*record_batch_w_cache.record_batch)[col_idx]->ConvertToArrow(mem_pool);
+                record_batch_w_cache.cache_validity[col_idx] = true;
+              }
+            }
+            return RecordOrRowBatch(RecordBatchWithCache{
+                std::make_unique<types::ColumnWrapperRecordBatch>(
+                    *record_batch_w_cache.record_batch),
+                record_batch_w_cache.arrow_cache,
+                record_batch_w_cache.cache_validity,
+            });
+          },
+          [](const schema::RowBatch& row_batch) { return RecordOrRowBatch(row_batch); },
+      },
+      batch_);
+  pinned.row_offset_ = row_offset_;
+  return pinned;
+}
+
+StatusOr<ArrowArrayPtr> RecordOrRowBatch::GetColumnRows(int64_t col_idx, size_t row_start,
+                                                        const std::vector<int64_t>& rows,
+                                                        arrow::MemoryPool* mem_pool) const {
+  row_start += row_offset_;
+  return std::visit(
+      overloaded{
+          [col_idx, row_start, &rows,
+           mem_pool](const RecordBatchWithCache& record_batch_w_cache) -> StatusOr<ArrowArrayPtr> {
+            if (record_batch_w_cache.cache_validity[col_idx]) {
+              return schema::SelectRows(
+                  record_batch_w_cache.arrow_cache[col_idx]->Slice(row_start).get(), rows,
+                  mem_pool);
+            }
+            auto* col_wrapper = (*record_batch_w_cache.record_batch)[col_idx].get();
+            auto data_type = col_wrapper->data_type();
+            auto builder = types::MakeTypeErasedArrowBuilder(data_type, mem_pool);
+            PL_RETURN_IF_ERROR(builder->Reserve(rows.size()));
+            if (data_type == types::DataType::STRING) {
+              size_t data_size = 0;
+              for (auto row : rows) {
+                data_size += col_wrapper->GetView(row_start + row).size();
+              }
+              PL_RETURN_IF_ERROR(builder->ReserveData(data_size));
+            }
+#define TYPE_CASE(_dt_)                                                  \
+  auto typed_builder = types::GetTypedArrowBuilder<_dt_>(builder.get()); \
+  for (auto row : rows) {                                                \
+    types::ColumnWrapperIterator<_dt_> it(col_wrapper, row_start + row); \
+    typed_builder->UnsafeAppendValues(it, std::next(it));                \
+  }
+            PL_SWITCH_FOREACH_DATATYPE(data_type, TYPE_CASE);
+#undef TYPE_CASE
+            ArrowArrayPtr out;
+            PL_RETURN_IF_ERROR(builder->Finish(&out));
+            return out;
+          },
+          [col_idx, row_start, &rows,
+           mem_pool](const schema::RowBatch& row_batch) -> StatusOr<ArrowArrayPtr> {
+            return schema::SelectRows(row_batch.ColumnAt(col_idx)->Slice(row_start).get(), rows,
+                                      mem_pool);
+          },
+      },
+      batch_);
+}
+
 void RecordOrRowBatch::UnsafeAppendColumnToBuilder(types::TypeErasedArrowBuilder* builder,
                                                    types::DataType data_type, int64_t col_idx,
                                                    size_t start_row, size_t end_row) const {
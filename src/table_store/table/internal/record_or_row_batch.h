@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <arrow/memory_pool.h>
+
 #include <utility>
 #include <variant>
 #include <vector>
@@ -47,6 +49,7 @@ class RecordOrRowBatch {
   explicit RecordOrRowBatch(const schema::RowBatch& row_batch) : batch_(row_batch) {}
 
   RecordOrRowBatch(RecordOrRowBatch&&) = default;
+  RecordOrRowBatch& operator=(RecordOrRowBatch&&) = default;
 
   /**
    * Length returns the number of rows in this record or row batch.
@@ -94,11 +97,37 @@ class RecordOrRowBatch {
    * @param batch_size, size of the output slice.
    * @param cols, a vector of column indices to include in the output slice.
    * @param output_rb, a pointer to the row batch to add the columns to.
+   * @param mem_pool, the pool to allocate columns from, when they need to be converted to arrow.
    * @return Status, errors if adding columns to the row batch fails.
    */
   Status AddBatchSliceToRowBatch(size_t row_start, size_t batch_size,
-                                 const std::vector<int64_t>& cols,
-                                 schema::RowBatch* output_rb) const;
+                                 const std::vector<int64_t>& cols, schema::RowBatch* output_rb,
+                                 arrow::MemoryPool* mem_pool = arrow::default_memory_pool()) const;
+
+  /**
+   * Pin returns a batch that shares the columns of this batch, without copying them, so that it
+   * can be read after this batch is removed from the hot store (e.g. by a Cursor that reads it
+   * without holding the store's lock). The given columns are converted to arrow and cached in this
+   * batch first, so that compaction and other readers reuse the conversion.
+   * @param cols, the columns to convert to arrow before pinning.
+   * @param mem_pool, the pool to allocate converted columns from.
+   * @return the pinned batch.
+   */
+  RecordOrRowBatch Pin(const std::vector<int64_t>& cols, arrow::MemoryPool* mem_pool) const;
+
+  /**
+   * GetColumnRows returns the given rows of a column of this record or row batch, e.g. the rows
+   * selected by a LateMaterialization. Record batch columns that haven't been converted to arrow
+   * yet only have the selected rows converted, and the conversion isn't cached.
+   * @param col_idx, index of the column.
+   * @param row_start, row index within this batch that the row indices are relative to.
+   * @param rows, the indices of the rows to get, relative to row_start.
+   * @param mem_pool, the pool to allocate the output column from.
+   * @return the arrow array with the selected rows.
+   */
+  StatusOr<ArrowArrayPtr> GetColumnRows(int64_t col_idx, size_t row_start,
+                                        const std::vector<int64_t>& rows,
+                                        arrow::MemoryPool* mem_pool) const;
 
   /**
    * UnsafeAppendColumnToBuilder appends a slice of a column of this record or row batch to the
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <optional>
@@ -28,6 +29,8 @@
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/record_or_row_batch.h"
 #include "src/table_store/table/internal/types.h"
 
 namespace px {
@@ -54,10 +57,25 @@ void constexpr_else_static_assert_false() {
 }
 
 /**
- * StoreWithRowTimeAccounting stores a deque of batches (hot or cold) and keeps track of the first
- * and last unique RowID's for each batch, as well as the first and last times for each batch (if
- * there is a time column in the table). The template parameter specifies whether this is the Hot or
- * Cold store. Since the logic between the Hot and Cold stores is roughly identical, this class
+ * PinnedBatchSlice is a slice of a batch of a StoreWithRowTimeAccounting, returned by
+ * `PinNextBatchSlice`. The pinned batch shares the columns of the batch in the store, so the slice
+ * can be read after the store's lock is released, even if the batch is expired or compacted in the
+ * meantime.
+ */
+template <typename TBatch>
+struct PinnedBatchSlice {
+  // Unset if every remaining batch of the store was skipped because of the predicates, in which
+  // case the slice has no rows.
+  std::optional<TBatch> batch;
+  size_t row_offset = 0;
+  size_t batch_size = 0;
+};
+
+/**
+ * StoreWithRowTimeAccounting stores a deque of batches (hot, cold or disk) and keeps track of the
+ * first and last unique RowID's for each batch, as well as the first and last times for each batch
+ * (if there is a time column in the table). The template parameter specifies whether this is the
+ * Hot, Cold or Disk store. Since the logic between the stores is roughly identical, this class
  * deduplicates that logic while allowing the explicit batch accesses to use the correct Hot or Cold
  * batch methods.
  *
@@ -72,30 +90,47 @@ class StoreWithRowTimeAccounting {
   using TBatch = typename StoreTypeTraits<TStoreType>::batch_type;
 
  public:
-  StoreWithRowTimeAccounting(const schema::Relation& rel, int64_t time_col_idx)
-      : rel_(rel), time_col_idx_(time_col_idx) {}
+  /**
+   * @param rel the relation of the stored batches.
+   * @param time_col_idx the index of the time column, or -1 if there is none.
+   * @param mem_pool the pool to allocate columns from when batches are read.
+   */
+  StoreWithRowTimeAccounting(const schema::Relation& rel, int64_t time_col_idx,
+                             arrow::MemoryPool* mem_pool = arrow::default_memory_pool())
+      : rel_(rel), time_col_idx_(time_col_idx), mem_pool_(mem_pool) {}
 
   /**
-   * GetNextRowBatch returns the next row batch in this store after the given unique row id.
-   * @param last_read_row_id, pointer to the unique RowID of the last read row. The outputted batch
-   * should include only rows with a RowID greater than this RowID. After determining the output
-   * batch, this pointer is updated to point to the RowID of the last row in the outputted batch.
+   * PinNextBatchSlice finds the slice of the next batch in this store after the given unique row
+   * id, and pins it (see `PinnedBatchSlice`), so that it can be read with `ReadBatchSlice` after
+   * the store's lock is released. Pinning doesn't decode any columns of cold or disk batches.
+   * @param last_read_row_id, pointer to the unique RowID of the last read row. The slice should
+   * include only rows with a RowID greater than this RowID. After determining the slice, this
+   * pointer is updated to point to the RowID of the last row in the slice.
    * @param hints, pointer to a BatchHints object (usually from a Table::Cursor), that provides a
    * hint to the store about which batch should be next. If the hint is correct, no searching for
    * the right batch is required, otherwise searching is performed as usual. This is purely an
    * optimization and passing a `nullptr` for hints is accepted.
-   * @param stop_row_id, an optional unique RowID to stop the batch at. If provided, the batch will
-   * be sliced such that no rows are included with `RowID >= stop_row_id.value()`.
-   * @param cols, a vector of column indices to include in the outputted row batch.
-   * @return a unique_ptr to the RowBatch or nullptr if there are no more rows in this store that
-   * match the parameters above. On error returns a Status.
+   * @param stop_row_id, an optional unique RowID to stop the slice at. If provided, the slice will
+   * be shortened such that no rows are included with `RowID >= stop_row_id.value()`.
+   * @param cols, a vector of column indices that will be read from the slice.
+   * @param predicates, a conjunction of predicates used to skip batches whose zone maps show that
+   * none of their rows can match. Only the `Cold` and `Disk` stores have zone maps, the `Hot`
+   * store ignores this. Rows of the slice are not filtered by the predicates.
+   * @param batches_skipped, if not null, incremented by the number of batches skipped because of
+   * the predicates.
+   * @param late_materialization, if not null, the slice will be read with late materialization.
+   * @return the pinned slice, or std::nullopt if there are no more rows in this store that match
+   * the parameters above. If every remaining batch in the store was skipped, a slice without a
+   * batch is returned instead, since the cursor still moved forward.
    */
-  StatusOr<std::unique_ptr<schema::RowBatch>> GetNextRowBatch(
+  std::optional<PinnedBatchSlice<TBatch>> PinNextBatchSlice(
       RowID* last_read_row_id, BatchHints* hints, std::optional<RowID> stop_row_id,
-      const std::vector<int64_t>& cols) const {
+      const std::vector<int64_t>& cols, const std::vector<ColumnPredicate>& predicates = {},
+      int64_t* batches_skipped = nullptr,
+      const LateMaterialization* late_materialization = nullptr) const {
     auto start_row_id = *last_read_row_id + 1;
     if (batches_.empty() || start_row_id < FirstRowID() || start_row_id > LastRowID()) {
-      return std::unique_ptr<schema::RowBatch>(nullptr);
+      return std::nullopt;
     }
     if (DCHECK_IS_ON() && stop_row_id.has_value()) {
       DCHECK_LT(start_row_id, stop_row_id.value());
@@ -108,34 +143,89 @@ class StoreWithRowTimeAccounting {
       batch_id = FindBatchIDFromRowID(start_row_id);
     }
 
-    const auto& batch = GetBatchFromBatchID(batch_id);
+    if constexpr (TStoreType != StoreType::Hot) {
+      while (!predicates.empty() && !GetBatchFromBatchID(batch_id).MayMatch(predicates)) {
+        if (batches_skipped != nullptr) {
+          (*batches_skipped)++;
+        }
+        start_row_id = BatchLastRowID(batch_id) + 1;
+        batch_id++;
+        bool reached_stop = stop_row_id.has_value() && start_row_id >= stop_row_id.value();
+        if (reached_stop || batch_id > LastBatchID()) {
+          if (reached_stop) {
+            start_row_id = stop_row_id.value();
+          }
+          *last_read_row_id = start_row_id - 1;
+          hints->batch_id = batch_id;
+          hints->hint_type = TStoreType;
+          return PinnedBatchSlice<TBatch>{};
+        }
+      }
+    }
+
     RowID batch_first_row_id = BatchFirstRowID(batch_id);
     RowID batch_last_row_id = BatchLastRowID(batch_id);
-    size_t row_offset = start_row_id - batch_first_row_id;
-    size_t batch_size = batch_last_row_id - start_row_id + 1;
+    PinnedBatchSlice<TBatch> slice;
+    slice.row_offset = start_row_id - batch_first_row_id;
+    slice.batch_size = batch_last_row_id - start_row_id + 1;
     if (stop_row_id.has_value() && batch_last_row_id >= stop_row_id.value()) {
       // Reduce batch size if the batch extends past the given stop row.
-      batch_size -= (batch_last_row_id - stop_row_id.value()) + 1;
+      slice.batch_size -= (batch_last_row_id - stop_row_id.value()) + 1;
     }
+    const auto& batch = GetBatchFromBatchID(batch_id);
+    if constexpr (TStoreType == StoreType::Hot) {
+      // Hot batches are converted to arrow (and cached) while the lock is held, but only the
+      // columns that are read in full.
+      slice.batch.emplace(
+          batch.Pin(late_materialization != nullptr ? late_materialization->predicate_cols : cols,
+                    mem_pool_));
+    } else {
+      slice.batch.emplace(batch.Pin());
+    }
+
+    // Update the ptr to the last read row.
+    *last_read_row_id = start_row_id + slice.batch_size - 1;
+
+    // Set hints to point to the next batch in the current store. It's fine if that batch doesn't
+    // exist, as the next call will ignore the hints if that's the case.
+    hints->batch_id = batch_id + 1;
+    hints->hint_type = TStoreType;
+    return slice;
+  }
 
+  /**
+   * ReadBatchSlice reads the given columns of a slice pinned by `PinNextBatchSlice`. It doesn't
+   * access the batches of the store, so it must be called without holding the store's lock, so
+   * that decoding and late materialization don't block writers and compaction.
+   * @param slice, the pinned slice.
+   * @param cols, a vector of column indices to include in the outputted row batch.
+   * @param late_materialization, if not null, the batch is read with late materialization, and
+   * only holds the rows that it selects.
+   * @return a unique_ptr to the RowBatch. On error returns a Status.
+   */
+  StatusOr<std::unique_ptr<schema::RowBatch>> ReadBatchSlice(
+      const PinnedBatchSlice<TBatch>& slice, const std::vector<int64_t>& cols,
+      const LateMaterialization* late_materialization = nullptr) const {
     // Get column types for row descriptor.
     std::vector<types::DataType> col_types;
     for (int64_t col_idx : cols) {
       DCHECK(static_cast<size_t>(col_idx) < rel_.NumColumns());
       col_types.push_back(rel_.col_types()[col_idx]);
     }
+    if (!slice.batch.has_value()) {
+      return schema::RowBatch::WithZeroRows(schema::RowDescriptor(col_types), /*eow*/ false,
+                                            /*eos*/ false);
+    }
+
+    const auto& batch = slice.batch.value();
+    if (late_materialization != nullptr) {
+      return LateMaterializeBatchSlice(batch, slice.row_offset, slice.batch_size, cols, col_types,
+                                       *late_materialization);
+    }
     auto output_rb =
-        std::make_unique<schema::RowBatch>(schema::RowDescriptor(col_types), batch_size);
+        std::make_unique<schema::RowBatch>(schema::RowDescriptor(col_types), slice.batch_size);
     PL_RETURN_IF_ERROR(
-        AddBatchSliceToRowBatch(batch, row_offset, batch_size, cols, output_rb.get()));
-
-    // Update the ptr to the last read row.
-    *last_read_row_id = start_row_id + batch_size - 1;
-
-    // Set hints to point to the next batch in the current store. It's fine if that batch doesn't
-    // exist, as the next call will ignore the hints if that's the case.
-    hints->batch_id = batch_id + 1;
-    hints->hint_type = TStoreType;
+        AddBatchSliceToRowBatch(batch, slice.row_offset, slice.batch_size, cols, output_rb.get()));
     return output_rb;
   }
 
@@ -154,6 +244,17 @@ class StoreWithRowTimeAccounting {
     return batches_.front();
   }
 
+  /**
+   * BatchAt gets a reference to the batch at the given position in the store, where 0 is the
+   * first batch. Appending to the store doesn't invalidate the reference, only removing the batch
+   * does.
+   * @return reference to the batch.
+   */
+  const TBatch& BatchAt(size_t index) const {
+    DCHECK_LT(index, batches_.size());
+    return batches_[index];
+  }
+
   /**
    * PopFront removes the first batch in the store, and returns an rvalue reference to it.
    * @return rvalue reference to the removed batch.
@@ -340,69 +441,68 @@ class StoreWithRowTimeAccounting {
     return first_batch_id_ + std::distance(row_ids_.begin(), it);
   }
 
-  size_t BatchLength(const TBatch& batch) const {
-    if constexpr (std::is_same_v<ColdBatch, TBatch>) {
-      return batch[0]->length();
-    } else if constexpr (std::is_same_v<HotBatch, TBatch>) {
-      return batch.Length();
-    } else {
-      constexpr_else_static_assert_false();
-    }
-  }
+  size_t BatchLength(const TBatch& batch) const { return batch.Length(); }
 
   size_t FindTimeFirstGreaterThanOrEqual(const TBatch& batch, Time time) const {
-    if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::SearchArrowArrayGreaterThanOrEqual<types::DataType::TIME64NS>(
-          batch[time_col_idx_].get(), time);
-    } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
-      return batch.FindTimeFirstGreaterThanOrEqual(time_col_idx_, time);
-    } else {
-      constexpr_else_static_assert_false();
-    }
+    return batch.FindTimeFirstGreaterThanOrEqual(time_col_idx_, time);
   }
 
   size_t FindTimeFirstGreaterThan(const TBatch& batch, Time time) const {
-    if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::SearchArrowArrayLessThanOrEqual<types::DataType::TIME64NS>(
-                 batch[time_col_idx_].get(), time) +
-             1;
-    } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
-      return batch.FindTimeFirstGreaterThan(time_col_idx_, time);
-    } else {
-      constexpr_else_static_assert_false();
-    }
+    return batch.FindTimeFirstGreaterThan(time_col_idx_, time);
   }
 
   Time GetTimeValue(const TBatch& batch, int64_t row_idx) const {
-    if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::GetValueFromArrowArray<types::DataType::TIME64NS>(batch[time_col_idx_].get(),
-                                                                      row_idx);
-    } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
-      return batch.GetTimeValue(time_col_idx_, row_idx);
-    } else {
-      constexpr_else_static_assert_false();
-    }
+    return batch.GetTimeValue(time_col_idx_, row_idx);
   }
 
   Status AddBatchSliceToRowBatch(const TBatch& batch, size_t row_offset, size_t batch_size,
                                  const std::vector<int64_t>& cols,
                                  schema::RowBatch* output_rb) const {
-    if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      for (auto col_idx : cols) {
-        auto arr = batch[col_idx]->Slice(row_offset, batch_size);
-        PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
+    return batch.AddBatchSliceToRowBatch(row_offset, batch_size, cols, output_rb, mem_pool_);
+  }
+
+  StatusOr<std::unique_ptr<schema::RowBatch>> LateMaterializeBatchSlice(
+      const TBatch& batch, size_t row_offset, size_t batch_size, const std::vector<int64_t>& cols,
+      const std::vector<types::DataType>& col_types,
+      const LateMaterialization& late_materialization) const {
+    const auto& predicate_cols = late_materialization.predicate_cols;
+    std::vector<types::DataType> predicate_col_types;
+    for (int64_t col_idx : predicate_cols) {
+      predicate_col_types.push_back(rel_.col_types()[col_idx]);
+    }
+    schema::RowBatch predicate_rb(schema::RowDescriptor(predicate_col_types), batch_size);
+    PL_RETURN_IF_ERROR(
+        AddBatchSliceToRowBatch(batch, row_offset, batch_size, predicate_cols, &predicate_rb));
+    PL_ASSIGN_OR_RETURN(auto rows, late_materialization.select_rows(predicate_rb));
+
+    auto output_rb =
+        std::make_unique<schema::RowBatch>(schema::RowDescriptor(col_types), rows.size());
+    if (rows.size() == batch_size) {
+      // Every row is selected, so the columns can be sliced as usual.
+      PL_RETURN_IF_ERROR(
+          AddBatchSliceToRowBatch(batch, row_offset, batch_size, cols, output_rb.get()));
+      return output_rb;
+    }
+    for (int64_t col_idx : cols) {
+      ArrowArrayPtr arr;
+      auto it = std::find(predicate_cols.begin(), predicate_cols.end(), col_idx);
+      if (it != predicate_cols.end()) {
+        // Predicate columns were already read.
+        PL_ASSIGN_OR_RETURN(
+            arr, schema::SelectRows(predicate_rb.ColumnAt(it - predicate_cols.begin()).get(), rows,
+                                    mem_pool_));
+      } else {
+        PL_ASSIGN_OR_RETURN(arr, batch.GetColumnRows(col_idx, row_offset, rows, mem_pool_));
       }
-      return Status::OK();
-    } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
-      return batch.AddBatchSliceToRowBatch(row_offset, batch_size, cols, output_rb);
-    } else {
-      constexpr_else_static_assert_false();
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
     }
+    return output_rb;
   }
 
   BatchID first_batch_id_ = 0;
   const schema::Relation& rel_;
   const int64_t time_col_idx_;
+  arrow::MemoryPool* mem_pool_;
   std::deque<TBatch> batches_;
   std::deque<RowIDInterval> row_ids_;
   std::deque<TimeInterval> times_;
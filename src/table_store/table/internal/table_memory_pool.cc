@@ -0,0 +1,178 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/internal/table_memory_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+bool IsPooled(int64_t size) {
+  return size > 0 && size <= TableMemoryPool::kMaxPooledAllocationSize;
+}
+
+}  // namespace
+
+TableMemoryPool::Ptr TableMemoryPool::Create(arrow::MemoryPool* backing_pool,
+                                             int64_t max_cached_bytes) {
+  return Ptr(new TableMemoryPool(backing_pool, max_cached_bytes));
+}
+
+TableMemoryPool::TableMemoryPool(arrow::MemoryPool* backing_pool, int64_t max_cached_bytes)
+    : backing_pool_(backing_pool), max_cached_bytes_(max_cached_bytes) {}
+
+int64_t TableMemoryPool::AllocationSize(int64_t size) {
+  if (!IsPooled(size)) {
+    return size;
+  }
+  if (size <= kMinAllocationSize) {
+    return kMinAllocationSize;
+  }
+  // Sizes in (2^k, 2^(k+1)] are rounded up to a multiple of 2^k / 4.
+  int64_t step = (int64_t{1} << (63 - __builtin_clzll(size - 1))) / 4;
+  return (size + step - 1) / step * step;
+}
+
+arrow::Status TableMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  int64_t alloc_size = AllocationSize(size);
+  bool reused = false;
+  if (IsPooled(size)) {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    auto it = free_lists_.find(alloc_size);
+    if (it != free_lists_.end() && !it->second.empty()) {
+      *out = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= alloc_size;
+      ++num_reused_allocations_;
+      reused = true;
+    }
+  }
+  if (!reused) {
+    auto status = backing_pool_->Allocate(alloc_size, out);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  bytes_allocated_ += alloc_size;
+  max_memory_ = std::max(max_memory_, bytes_allocated_);
+  return arrow::Status::OK();
+}
+
+arrow::Status TableMemoryPool::Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  int64_t old_alloc_size = AllocationSize(old_size);
+  int64_t new_alloc_size = AllocationSize(new_size);
+  if (IsPooled(old_size) && IsPooled(new_size) && old_alloc_size == new_alloc_size) {
+    // The buffer already has room for the new size.
+    return arrow::Status::OK();
+  }
+  if (!IsPooled(old_size) && !IsPooled(new_size) && old_size > 0) {
+    auto status = backing_pool_->Reallocate(old_size, new_size, ptr);
+    if (!status.ok()) {
+      return status;
+    }
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    bytes_allocated_ += new_size - old_size;
+    max_memory_ = std::max(max_memory_, bytes_allocated_);
+    return arrow::Status::OK();
+  }
+
+  uint8_t* out;
+  auto status = Allocate(new_size, &out);
+  if (!status.ok()) {
+    return status;
+  }
+  std::memcpy(out, *ptr, std::min(old_size, new_size));
+  Free(*ptr, old_size);
+  *ptr = out;
+  return arrow::Status::OK();
+}
+
+void TableMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  int64_t alloc_size = AllocationSize(size);
+  bool cached = false;
+  bool delete_pool = false;
+  {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    bytes_allocated_ -= alloc_size;
+    if (IsPooled(size) && !released_ && cached_bytes_ + alloc_size <= max_cached_bytes_) {
+      free_lists_[alloc_size].push_back(buffer);
+      cached_bytes_ += alloc_size;
+      cached = true;
+    }
+    delete_pool = released_ && bytes_allocated_ == 0;
+  }
+  if (!cached) {
+    backing_pool_->Free(buffer, alloc_size);
+  }
+  if (delete_pool) {
+    delete this;
+  }
+}
+
+void TableMemoryPool::Release() {
+  absl::flat_hash_map<int64_t, std::vector<uint8_t*>> free_lists;
+  bool delete_pool;
+  {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    released_ = true;
+    free_lists = std::move(free_lists_);
+    free_lists_.clear();
+    cached_bytes_ = 0;
+    delete_pool = bytes_allocated_ == 0;
+  }
+  for (const auto& [alloc_size, buffers] : free_lists) {
+    for (auto* buffer : buffers) {
+      backing_pool_->Free(buffer, alloc_size);
+    }
+  }
+  if (delete_pool) {
+    delete this;
+  }
+}
+
+int64_t TableMemoryPool::bytes_allocated() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return bytes_allocated_;
+}
+
+int64_t TableMemoryPool::max_memory() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return max_memory_;
+}
+
+int64_t TableMemoryPool::cached_bytes() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return cached_bytes_;
+}
+
+int64_t TableMemoryPool::num_reused_allocations() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return num_reused_allocations_;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/base/internal/spinlock.h>
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * TableMemoryPool is the arrow::MemoryPool of a single table. It accounts for every byte the table
+ * allocates through arrow, and recycles freed buffers instead of returning them to the backing
+ * pool.
+ *
+ * Allocations are rounded up to size classes, four per power of two, so that a freed buffer can be
+ * reused for any later allocation of the same class. Freed buffers are cached per class up to a
+ * byte limit. In steady state a table expires about as many cold batches as it compacts, so the
+ * buffers of expired batches are reused for new ones, rather than churning the system allocator.
+ * Allocations larger than `kMaxPooledAllocationSize` are passed through to the backing pool.
+ *
+ * Buffers can outlive the table, e.g. when a query still holds a slice of a cold batch. Arrow
+ * buffers only keep a raw pointer to their pool, so the pool isn't destroyed with the table: once
+ * released (see `Ptr`), it deletes itself when the last of its buffers is freed.
+ */
+class TableMemoryPool : public arrow::MemoryPool {
+ public:
+  struct Releaser {
+    void operator()(TableMemoryPool* pool) const { pool->Release(); }
+  };
+  using Ptr = std::unique_ptr<TableMemoryPool, Releaser>;
+
+  static constexpr int64_t kMinAllocationSize = 64;
+  static constexpr int64_t kMaxPooledAllocationSize = 1024 * 1024;
+  static constexpr int64_t kDefaultMaxCachedBytes = 1024 * 1024;
+
+  /**
+   * @param backing_pool the pool that buffers are allocated from when none can be reused.
+   * @param max_cached_bytes the maximum number of bytes of freed buffers to keep for reuse.
+   */
+  static Ptr Create(arrow::MemoryPool* backing_pool = arrow::default_memory_pool(),
+                    int64_t max_cached_bytes = kDefaultMaxCachedBytes);
+
+  /**
+   * AllocationSize returns the number of bytes that an allocation of the given size takes up,
+   * i.e. its size rounded up to its size class.
+   */
+  static int64_t AllocationSize(int64_t size);
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  /**
+   * @return the number of bytes currently allocated from this pool, rounded up to size classes.
+   * Cached buffers are not included.
+   */
+  int64_t bytes_allocated() const override;
+  int64_t max_memory() const override;
+  std::string backend_name() const override { return "table"; }
+
+  /**
+   * @return the number of bytes of freed buffers that are kept for reuse.
+   */
+  int64_t cached_bytes() const;
+
+  /**
+   * @return the number of allocations that reused a cached buffer.
+   */
+  int64_t num_reused_allocations() const;
+
+ private:
+  TableMemoryPool(arrow::MemoryPool* backing_pool, int64_t max_cached_bytes);
+  ~TableMemoryPool() override = default;
+
+  // Frees the cached buffers, and deletes the pool once all of its buffers are freed.
+  void Release();
+
+  arrow::MemoryPool* backing_pool_;
+  const int64_t max_cached_bytes_;
+
+  mutable absl::base_internal::SpinLock lock_;
+  // Freed buffers by their allocation size.
+  absl::flat_hash_map<int64_t, std::vector<uint8_t*>> free_lists_ ABSL_GUARDED_BY(lock_);
+  int64_t bytes_allocated_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t max_memory_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t cached_bytes_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t num_reused_allocations_ ABSL_GUARDED_BY(lock_) = 0;
+  bool released_ ABSL_GUARDED_BY(lock_) = false;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/table/internal/table_memory_pool.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+TEST(TableMemoryPoolTest, AllocationSizeRoundsToSizeClasses) {
+  EXPECT_EQ(0, TableMemoryPool::AllocationSize(0));
+  EXPECT_EQ(64, TableMemoryPool::AllocationSize(1));
+  EXPECT_EQ(64, TableMemoryPool::AllocationSize(64));
+  EXPECT_EQ(80, TableMemoryPool::AllocationSize(65));
+  EXPECT_EQ(128, TableMemoryPool::AllocationSize(128));
+  EXPECT_EQ(160, TableMemoryPool::AllocationSize(129));
+  EXPECT_EQ(1280, TableMemoryPool::AllocationSize(1000 + 100));
+  EXPECT_EQ(64 * 1024, TableMemoryPool::AllocationSize(64 * 1024));
+  // Allocations that aren't pooled keep their size.
+  int64_t large = TableMemoryPool::kMaxPooledAllocationSize + 1;
+  EXPECT_EQ(large, TableMemoryPool::AllocationSize(large));
+}
+
+TEST(TableMemoryPoolTest, FreedBuffersAreReused) {
+  auto pool = TableMemoryPool::Create();
+  uint8_t* buf1;
+  ASSERT_TRUE(pool->Allocate(1000, &buf1).ok());
+  EXPECT_EQ(1024, pool->bytes_allocated());
+
+  pool->Free(buf1, 1000);
+  EXPECT_EQ(0, pool->bytes_allocated());
+  EXPECT_EQ(1024, pool->cached_bytes());
+
+  // Any allocation of the same size class reuses the buffer.
+  uint8_t* buf2;
+  ASSERT_TRUE(pool->Allocate(900, &buf2).ok());
+  EXPECT_EQ(buf1, buf2);
+  EXPECT_EQ(1, pool->num_reused_allocations());
+  EXPECT_EQ(0, pool->cached_bytes());
+  EXPECT_EQ(1024, pool->bytes_allocated());
+  pool->Free(buf2, 900);
+}
+
+TEST(TableMemoryPoolTest, CacheIsBounded) {
+  auto pool = TableMemoryPool::Create(arrow::default_memory_pool(), /*max_cached_bytes*/ 2048);
+  std::vector<uint8_t*> bufs(3);
+  for (auto& buf : bufs) {
+    ASSERT_TRUE(pool->Allocate(1024, &buf).ok());
+  }
+  EXPECT_EQ(3 * 1024, pool->bytes_allocated());
+  EXPECT_EQ(3 * 1024, pool->max_memory());
+  for (auto* buf : bufs) {
+    pool->Free(buf, 1024);
+  }
+  EXPECT_EQ(0, pool->bytes_allocated());
+  EXPECT_EQ(2048, pool->cached_bytes());
+
+  // Large allocations bypass the cache.
+  uint8_t* large;
+  int64_t large_size = TableMemoryPool::kMaxPooledAllocationSize * 2;
+  ASSERT_TRUE(pool->Allocate(large_size, &large).ok());
+  EXPECT_EQ(large_size, pool->bytes_allocated());
+  pool->Free(large, large_size);
+  EXPECT_EQ(0, pool->bytes_allocated());
+  EXPECT_EQ(2048, pool->cached_bytes());
+}
+
+TEST(TableMemoryPoolTest, ReallocateKeepsData) {
+  auto pool = TableMemoryPool::Create();
+  uint8_t* buf;
+  ASSERT_TRUE(pool->Allocate(100, &buf).ok());
+  std::memset(buf, 7, 100);
+
+  // Growing within the size class keeps the buffer.
+  uint8_t* orig = buf;
+  ASSERT_TRUE(pool->Reallocate(100, 112, &buf).ok());
+  EXPECT_EQ(orig, buf);
+
+  ASSERT_TRUE(pool->Reallocate(112, 4000, &buf).ok());
+  EXPECT_EQ(4096, pool->bytes_allocated());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(7, buf[i]);
+  }
+  pool->Free(buf, 4000);
+  EXPECT_EQ(0, pool->bytes_allocated());
+}
+
+TEST(TableMemoryPoolTest, ReleasedPoolOutlivesItsBuffers) {
+  auto pool = TableMemoryPool::Create();
+  uint8_t* buf;
+  ASSERT_TRUE(pool->Allocate(100, &buf).ok());
+  auto* raw_pool = pool.get();
+
+  // Releasing the pool while a buffer is still allocated keeps it alive until the buffer is freed,
+  // after which it deletes itself.
+  pool.reset();
+  EXPECT_EQ(112, raw_pool->bytes_allocated());
+  raw_pool->Free(buf, 100);
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -21,11 +21,13 @@
 #include <arrow/array.h>
 
 #include <deque>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include "src/common/base/statusor.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/types.h"
 #include "src/table_store/schema/row_batch.h"
@@ -53,6 +55,7 @@ struct RecordBatchWithCache {
 enum StoreType {
   Hot,
   Cold,
+  Disk,
 };
 
 struct BatchHints {
@@ -60,9 +63,26 @@ struct BatchHints {
   BatchID batch_id;
 };
 
-class RecordOrRowBatch;
+/**
+ * RowSelector returns the indices of the rows of a batch that a reader needs, in increasing order,
+ * given the batch's predicate columns (see LateMaterialization).
+ */
+using RowSelector = std::function<StatusOr<std::vector<int64_t>>(const schema::RowBatch&)>;
 
-using ColdBatch = std::vector<ArrowArrayPtr>;
+/**
+ * LateMaterialization describes a read that only materializes the rows a reader needs. The
+ * predicate columns of each batch are read first and passed to `select_rows`, and the remaining
+ * columns are only read for the selected rows. Batches that are read this way hold the selected
+ * rows only.
+ */
+struct LateMaterialization {
+  // Indices of the table columns that select_rows reads, in the order it gets them.
+  std::vector<int64_t> predicate_cols;
+  RowSelector select_rows;
+};
+
+class RecordOrRowBatch;
+class ColdBatch;
 
 template <StoreType type>
 struct StoreTypeTraits {};
@@ -74,6 +94,11 @@ template <>
 struct StoreTypeTraits<StoreType::Cold> {
   using batch_type = ColdBatch;
 };
+// Batches in the disk store are ColdBatches whose columns are memory mapped from a DiskSegment.
+template <>
+struct StoreTypeTraits<StoreType::Disk> {
+  using batch_type = ColdBatch;
+};
 
 }  // namespace internal
 }  // namespace table_store
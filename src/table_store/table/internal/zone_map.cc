@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <absl/container/flat_hash_set.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+
+#include "src/table_store/table/internal/zone_map.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+template <typename T>
+bool BoundsMayMatch(const T& min, const T& max, ColumnPredicate::Op op, const T& value) {
+  switch (op) {
+    case ColumnPredicate::Op::kEqual:
+      return !(value < min) && !(max < value);
+    case ColumnPredicate::Op::kNotEqual:
+      return !(min == value && max == value);
+    case ColumnPredicate::Op::kLessThan:
+      return min < value;
+    case ColumnPredicate::Op::kLessThanEqual:
+      return !(value < min);
+    case ColumnPredicate::Op::kGreaterThan:
+      return value < max;
+    case ColumnPredicate::Op::kGreaterThanEqual:
+      return !(max < value);
+  }
+  return true;
+}
+
+}  // namespace
+
+ColumnZoneMap ColumnZoneMap::Compute(types::DataType type, const arrow::Array* arr) {
+  ColumnZoneMap zone_map;
+  if (arr->length() == 0 || arr->null_count() > 0) {
+    return zone_map;
+  }
+  switch (type) {
+    case types::DataType::INT64:
+    case types::DataType::TIME64NS: {
+      const auto* values = arr->data()->GetValues<int64_t>(1);
+      auto [min_it, max_it] = std::minmax_element(values, values + arr->length());
+      zone_map.bounds_ = Bounds<int64_t>{*min_it, *max_it};
+      break;
+    }
+    case types::DataType::FLOAT64: {
+      const auto* values = static_cast<const arrow::DoubleArray*>(arr)->raw_values();
+      if (std::any_of(values, values + arr->length(), [](double v) { return std::isnan(v); })) {
+        break;
+      }
+      auto [min_it, max_it] = std::minmax_element(values, values + arr->length());
+      zone_map.bounds_ = Bounds<double>{*min_it, *max_it};
+      break;
+    }
+    case types::DataType::STRING: {
+      const auto* str_arr = static_cast<const arrow::StringArray*>(arr);
+      std::string_view min;
+      std::string_view max;
+      absl::flat_hash_set<std::string_view> distinct;
+      bool track_distinct = true;
+      for (int64_t i = 0; i < str_arr->length(); ++i) {
+        auto view = str_arr->GetView(i);
+        std::string_view value(view.data(), view.size());
+        if (i == 0 || value < min) {
+          min = value;
+        }
+        if (i == 0 || value > max) {
+          max = value;
+        }
+        if (track_distinct) {
+          distinct.insert(value);
+          if (distinct.size() > kMaxBloomFilterEntries) {
+            track_distinct = false;
+            distinct.clear();
+          }
+        }
+      }
+      if (min.size() <= kMaxStringBoundSize && max.size() <= kMaxStringBoundSize) {
+        zone_map.bounds_ = Bounds<std::string>{std::string(min), std::string(max)};
+      }
+      if (track_distinct) {
+        auto bloom_filter_or_s =
+            bloomfilter::XXHash64BloomFilter::Create(distinct.size(), kBloomFilterErrorRate);
+        // Without a bloom filter the zone map is only less selective, so errors are not fatal.
+        if (bloom_filter_or_s.ok()) {
+          zone_map.bloom_filter_ = bloom_filter_or_s.ConsumeValueOrDie();
+          for (const auto& value : distinct) {
+            zone_map.bloom_filter_->Insert(value);
+          }
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return zone_map;
+}
+
+bool ColumnZoneMap::MayMatch(ColumnPredicate::Op op, const ColumnPredicate::Value& value) const {
+  if (const auto* bounds = std::get_if<Bounds<int64_t>>(&bounds_)) {
+    if (const auto* v = std::get_if<int64_t>(&value)) {
+      return BoundsMayMatch(bounds->min, bounds->max, op, *v);
+    }
+    return true;
+  }
+  if (const auto* bounds = std::get_if<Bounds<double>>(&bounds_)) {
+    if (const auto* v = std::get_if<double>(&value)) {
+      return BoundsMayMatch(bounds->min, bounds->max, op, *v);
+    }
+    if (const auto* v = std::get_if<int64_t>(&value)) {
+      return BoundsMayMatch(bounds->min, bounds->max, op, static_cast<double>(*v));
+    }
+    return true;
+  }
+  const auto* v = std::get_if<std::string>(&value);
+  if (v == nullptr) {
+    return true;
+  }
+  if (op == ColumnPredicate::Op::kEqual && bloom_filter_ != nullptr &&
+      !bloom_filter_->Contains(*v)) {
+    return false;
+  }
+  if (const auto* bounds = std::get_if<Bounds<std::string>>(&bounds_)) {
+    return BoundsMayMatch(bounds->min, bounds->max, op, *v);
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+
+#include <memory>
+#include <string>
+#include <variant>
+
+#include "src/shared/bloomfilter/bloomfilter.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * ColumnPredicate is a comparison of a table column against a constant, eg. `latency > 100`. A
+ * conjunction of ColumnPredicates can be given to a Table::Cursor so that it skips cold batches
+ * that cannot contain a matching row. The predicates never filter individual rows, so the caller
+ * still has to apply the full filter to the batches it receives.
+ */
+struct ColumnPredicate {
+  enum class Op {
+    kEqual,
+    kNotEqual,
+    kLessThan,
+    kLessThanEqual,
+    kGreaterThan,
+    kGreaterThanEqual,
+  };
+  using Value = std::variant<int64_t, double, std::string>;
+
+  int64_t col_idx;
+  Op op;
+  Value value;
+};
+
+/**
+ * ColumnZoneMap summarizes the values of a single column of a cold batch, so that a
+ * ColumnPredicate can be checked against the whole batch without decoding it. INT64, TIME64NS and
+ * FLOAT64 columns keep their min and max. STRING columns keep their min and max when those are
+ * short, and a bloom filter of their values when the batch has few distinct values.
+ */
+class ColumnZoneMap {
+ public:
+  /**
+   * Strings longer than this are not kept as bounds, since they would be copied for each batch.
+   */
+  static constexpr size_t kMaxStringBoundSize = 128;
+  /**
+   * String columns with more distinct values than this don't get a bloom filter.
+   */
+  static constexpr size_t kMaxBloomFilterEntries = 256;
+  static constexpr double kBloomFilterErrorRate = 0.01;
+
+  /**
+   * Compute builds the zone map of the given arrow array. Columns with an unsupported type, with
+   * nulls, or with NaNs get an empty zone map which matches every predicate.
+   * @param type the pixie data type of the column.
+   * @param arr the column's values.
+   * @return the zone map of the column.
+   */
+  static ColumnZoneMap Compute(types::DataType type, const arrow::Array* arr);
+
+  /**
+   * MayMatch returns whether a row of the column could satisfy `<column> <op> <value>`. It never
+   * returns false if such a row exists.
+   */
+  bool MayMatch(ColumnPredicate::Op op, const ColumnPredicate::Value& value) const;
+
+  /**
+   * @return whether this zone map can rule out any predicates.
+   */
+  bool empty() const {
+    return std::holds_alternative<std::monostate>(bounds_) && bloom_filter_ == nullptr;
+  }
+
+ private:
+  template <typename T>
+  struct Bounds {
+    T min;
+    T max;
+  };
+
+  std::variant<std::monostate, Bounds<int64_t>, Bounds<double>, Bounds<std::string>> bounds_;
+  std::unique_ptr<bloomfilter::XXHash64BloomFilter> bloom_filter_;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
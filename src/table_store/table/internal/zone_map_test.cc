@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/zone_map.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+using Op = ColumnPredicate::Op;
+
+TEST(ColumnZoneMapTest, Int64Bounds) {
+  std::vector<types::Int64Value> values = {10, 50, 20, 40};
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::INT64, arr.get());
+
+  EXPECT_TRUE(zone_map.MayMatch(Op::kEqual, int64_t{30}));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kEqual, int64_t{51}));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kEqual, int64_t{9}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kNotEqual, int64_t{10}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kLessThan, int64_t{11}));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kLessThan, int64_t{10}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kLessThanEqual, int64_t{10}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kGreaterThan, int64_t{49}));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kGreaterThan, int64_t{50}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kGreaterThanEqual, int64_t{50}));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kGreaterThanEqual, int64_t{51}));
+  // Values of a different type can't be checked, so they always match.
+  EXPECT_TRUE(zone_map.MayMatch(Op::kEqual, std::string("abc")));
+}
+
+TEST(ColumnZoneMapTest, NotEqualSingleValue) {
+  std::vector<types::Int64Value> values = {7, 7, 7};
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::INT64, arr.get());
+
+  EXPECT_FALSE(zone_map.MayMatch(Op::kNotEqual, int64_t{7}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kNotEqual, int64_t{8}));
+}
+
+TEST(ColumnZoneMapTest, Float64Bounds) {
+  std::vector<types::Float64Value> values = {0.5, 1.5, -2.5};
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::FLOAT64, arr.get());
+
+  EXPECT_TRUE(zone_map.MayMatch(Op::kGreaterThan, 1.0));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kGreaterThan, 1.5));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kLessThan, int64_t{-3}));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kLessThan, int64_t{-2}));
+}
+
+TEST(ColumnZoneMapTest, Float64WithNaNMatchesEverything) {
+  std::vector<types::Float64Value> values = {0.5, std::nan(""), 1.0};
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::FLOAT64, arr.get());
+
+  EXPECT_TRUE(zone_map.empty());
+  EXPECT_TRUE(zone_map.MayMatch(Op::kGreaterThan, 100.0));
+}
+
+TEST(ColumnZoneMapTest, StringBloomFilter) {
+  std::vector<types::StringValue> values = {"carts", "orders", "carts", "payment"};
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::STRING, arr.get());
+
+  EXPECT_TRUE(zone_map.MayMatch(Op::kEqual, std::string("orders")));
+  // "front-end" is within the bounds of the column, so only the bloom filter can rule it out.
+  EXPECT_FALSE(zone_map.MayMatch(Op::kEqual, std::string("front-end")));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kEqual, std::string("zipkin")));
+  EXPECT_TRUE(zone_map.MayMatch(Op::kGreaterThan, std::string("orders")));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kGreaterThan, std::string("payment")));
+}
+
+TEST(ColumnZoneMapTest, HighCardinalityStringsUseBoundsOnly) {
+  std::vector<types::StringValue> values;
+  for (size_t i = 0; i < 2 * ColumnZoneMap::kMaxBloomFilterEntries; ++i) {
+    values.emplace_back(absl::StrCat("b", i));
+  }
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::STRING, arr.get());
+
+  EXPECT_TRUE(zone_map.MayMatch(Op::kEqual, std::string("b1000000")));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kEqual, std::string("a")));
+  EXPECT_FALSE(zone_map.MayMatch(Op::kEqual, std::string("c")));
+}
+
+TEST(ColumnZoneMapTest, UnsupportedTypeMatchesEverything) {
+  std::vector<types::BoolValue> values = {true, true};
+  auto arr = types::ToArrow(values, arrow::default_memory_pool());
+  auto zone_map = ColumnZoneMap::Compute(types::DataType::BOOLEAN, arr.get());
+
+  EXPECT_TRUE(zone_map.empty());
+  EXPECT_TRUE(zone_map.MayMatch(Op::kEqual, int64_t{0}));
+}
+
+TEST(ColumnZoneMapTest, ColdBatchConjunction) {
+  std::vector<types::Int64Value> latencies = {100, 200, 300};
+  std::vector<types::StringValue> services = {"carts", "carts", "orders"};
+  ColdBatch batch({types::ToArrow(latencies, arrow::default_memory_pool()),
+                   types::ToArrow(services, arrow::default_memory_pool())});
+
+  EXPECT_TRUE(batch.MayMatch({}));
+  EXPECT_TRUE(batch.MayMatch({{0, Op::kGreaterThan, int64_t{250}},
+                              {1, Op::kEqual, std::string("orders")}}));
+  EXPECT_FALSE(batch.MayMatch({{0, Op::kGreaterThan, int64_t{250}},
+                               {1, Op::kEqual, std::string("catalogue")}}));
+  EXPECT_FALSE(batch.MayMatch({{0, Op::kLessThan, int64_t{100}},
+                               {1, Op::kEqual, std::string("orders")}}));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -17,23 +17,31 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <iterator>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include <absl/strings/str_format.h>
+#include <absl/strings/str_replace.h>
 #include "internal/store_with_row_accounting.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
+#include "src/common/fs/fs_wrapper.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/schema/relation.h"
 #include "src/table_store/table/internal/batch_size_accountant.h"
+#include "src/table_store/table/internal/cold_batch.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
 #include "src/table_store/table/internal/types.h"
 #include "src/table_store/table/table.h"
@@ -45,11 +53,37 @@ DEFINE_int32(table_store_table_size_limit,
              "The maximal size a table allows. When the size grows beyond this limit, "
              "old data will be discarded.");
 
+DEFINE_bool(table_store_cold_batch_encoding,
+            gflags::BoolFromEnv("PL_TABLE_STORE_COLD_BATCH_ENCODING", true),
+            "If true, cold batches store low-cardinality string columns with dictionary encoding "
+            "and int64/time columns with frame-of-reference encoding.");
+
+DEFINE_bool(table_store_account_allocated_bytes,
+            gflags::BoolFromEnv("PL_TABLE_STORE_ACCOUNT_ALLOCATED_BYTES", false),
+            "If true, cold batches count towards the table size limit with the memory they "
+            "actually use, rather than with the estimated size of the rows they contain.");
+
+DEFINE_string(table_store_disk_tier_dir, gflags::StringFromEnv("PL_TABLE_STORE_DISK_TIER_DIR", ""),
+              "If set, cold batches expired from a table are written to memory mapped segment "
+              "files under this directory and remain queryable, instead of being dropped.");
+
+DEFINE_int64(table_store_disk_tier_table_size_limit,
+             gflags::Int64FromEnv("PL_TABLE_STORE_DISK_TIER_TABLE_SIZE_LIMIT",
+                                  1024LL * 1024 * 1024),
+             "The maximal number of bytes each table keeps in the disk tier. When the size grows "
+             "beyond this limit, the oldest data on disk is discarded.");
+
+DEFINE_int64(table_store_disk_tier_segment_size,
+             gflags::Int64FromEnv("PL_TABLE_STORE_DISK_TIER_SEGMENT_SIZE", 64 * 1024 * 1024),
+             "The size at which the disk tier starts a new segment file. Segment files are only "
+             "removed once all of their batches have been expired.");
+
 namespace px {
 namespace table_store {
 
-Table::Cursor::Cursor(const Table* table, StartSpec start, StopSpec stop)
-    : table_(table), hints_(internal::BatchHints{}) {
+Table::Cursor::Cursor(const Table* table, StartSpec start, StopSpec stop,
+                      PredicateSpec predicates)
+    : table_(table), hints_(internal::BatchHints{}), predicates_(std::move(predicates)) {
   AdvanceToStart(start);
   StopStateFromSpec(std::move(stop));
 }
@@ -171,10 +205,10 @@ Table::Table(std::string_view table_name, const schema::Relation& relation, size
              size_t compacted_batch_size)
     : metrics_(&(GetMetricsRegistry()), std::string(table_name)),
       rel_(relation),
+      mem_pool_(internal::TableMemoryPool::Create()),
       max_table_size_(max_table_size),
       compacted_batch_size_(compacted_batch_size),
-      // TODO(james): move mem_pool into constructor.
-      compactor_(rel_, arrow::default_memory_pool()) {
+      compactor_(rel_, mem_pool_.get()) {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   for (const auto& [i, col_name] : Enumerate(rel_.col_names())) {
@@ -184,9 +218,9 @@ Table::Table(std::string_view table_name, const schema::Relation& relation, size
   }
   batch_size_accountant_ = internal::BatchSizeAccountant::Create(rel_, compacted_batch_size_);
   hot_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Hot>>(
-      rel_, time_col_idx_);
+      rel_, time_col_idx_, mem_pool_.get());
   cold_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Cold>>(
-      rel_, time_col_idx_);
+      rel_, time_col_idx_, mem_pool_.get());
 }
 
 Status Table::ToProto(table_store::schemapb::Table* table_proto) const {
@@ -212,29 +246,66 @@ Status Table::ToProto(table_store::schemapb::Table* table_proto) const {
 StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetNextRowBatch(
     Cursor* cursor, const std::vector<int64_t>& cols) const {
   DCHECK(!cursor->Done()) << "Calling GetNextRowBatch on an exhausted Cursor";
-  absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  PL_ASSIGN_OR_RETURN(auto rb,
-                      cold_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
-                                                   cursor->StopRowID(), cols));
-  if (rb == nullptr) {
-    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    PL_ASSIGN_OR_RETURN(rb, hot_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
-                                                        cursor->StopRowID(), cols));
-    if (rb == nullptr && hot_store_->Size() > 0) {
-      // If the cursor was pointing to an expired row batch, update the cursor to point to the start
-      // of the table, then try to get the next row batch.
-      *cursor->LastReadRowID() = hot_store_->FirstRowID() - 1;
-      if (!cursor->Done()) {
-        PL_ASSIGN_OR_RETURN(rb,
-                            hot_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
-                                                        cursor->StopRowID(), cols));
+  const auto* late_materialization = cursor->GetLateMaterialization();
+  // The store locks are only held to find and pin the next batch slice. Decoding the slice and
+  // evaluating the late materialization's predicates happen after the locks are released, so that
+  // slow reads don't stall writers and compaction spinning on the locks.
+  std::optional<internal::PinnedBatchSlice<ColdBatch>> disk_slice;
+  std::optional<internal::PinnedBatchSlice<ColdBatch>> cold_slice;
+  std::optional<internal::PinnedBatchSlice<internal::HotBatch>> hot_slice;
+  {
+    absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+    if (disk_store_ != nullptr && disk_store_->Size() > 0) {
+      if (*cursor->LastReadRowID() + 1 < disk_store_->FirstRowID()) {
+        // The cursor was pointing to a batch that has been expired from the disk tier, so continue
+        // from the oldest batch that is still on disk.
+        *cursor->LastReadRowID() = disk_store_->FirstRowID() - 1;
+      }
+      auto stop_row_id = cursor->StopRowID();
+      if (!stop_row_id.has_value() || *cursor->LastReadRowID() + 1 < stop_row_id.value()) {
+        disk_slice = disk_store_->PinNextBatchSlice(
+            cursor->LastReadRowID(), cursor->Hints(), stop_row_id, cols, cursor->Predicates(),
+            cursor->BatchesSkippedCounter(), late_materialization);
+      }
+    }
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    if (!disk_slice.has_value()) {
+      cold_slice = cold_store_->PinNextBatchSlice(
+          cursor->LastReadRowID(), cursor->Hints(), cursor->StopRowID(), cols, cursor->Predicates(),
+          cursor->BatchesSkippedCounter(), late_materialization);
+    }
+    if (!disk_slice.has_value() && !cold_slice.has_value()) {
+      absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+      hot_slice = hot_store_->PinNextBatchSlice(cursor->LastReadRowID(), cursor->Hints(),
+                                                cursor->StopRowID(), cols, /*predicates*/ {},
+                                                /*batches_skipped*/ nullptr, late_materialization);
+      if (!hot_slice.has_value() && hot_store_->Size() > 0) {
+        // If the cursor was pointing to an expired row batch, update the cursor to point to the
+        // start of the table, then try to get the next row batch.
+        *cursor->LastReadRowID() = hot_store_->FirstRowID() - 1;
+        if (!cursor->Done()) {
+          hot_slice = hot_store_->PinNextBatchSlice(
+              cursor->LastReadRowID(), cursor->Hints(), cursor->StopRowID(), cols,
+              /*predicates*/ {}, /*batches_skipped*/ nullptr, late_materialization);
+        }
       }
     }
   }
-  if (rb == nullptr) {
-    return error::InvalidArgument("Data after Cursor is not in the table.");
+  // The stores are never replaced once created, and reading a pinned slice doesn't access their
+  // batches, so the slices are read without holding the locks.
+  if (disk_slice.has_value()) {
+    return ABSL_TS_UNCHECKED_READ(disk_store_)
+        ->ReadBatchSlice(disk_slice.value(), cols, late_materialization);
+  }
+  if (cold_slice.has_value()) {
+    return ABSL_TS_UNCHECKED_READ(cold_store_)
+        ->ReadBatchSlice(cold_slice.value(), cols, late_materialization);
+  }
+  if (hot_slice.has_value()) {
+    return ABSL_TS_UNCHECKED_READ(hot_store_)
+        ->ReadBatchSlice(hot_slice.value(), cols, late_materialization);
   }
-  return rb;
+  return error::InvalidArgument("Data after Cursor is not in the table.");
 }
 
 Status Table::ExpireRowBatches(int64_t row_batch_size) {
@@ -242,16 +313,12 @@ Status Table::ExpireRowBatches(int64_t row_batch_size) {
     return error::InvalidArgument("RowBatch size ($0) is bigger than maximum table size ($1).",
                                   row_batch_size, max_table_size_);
   }
-  int64_t bytes;
-  {
-    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
-  }
-  while (bytes + row_batch_size > max_table_size_) {
-    PL_RETURN_IF_ERROR(ExpireBatch());
-    {
-      absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-      bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
+  while (table_bytes_.load(std::memory_order_relaxed) + row_batch_size > max_table_size_) {
+    PL_ASSIGN_OR_RETURN(bool expired, ExpireBatch());
+    if (!expired) {
+      // The oldest batches are being compacted. Rather than waiting for the compaction, the table
+      // goes over its limit until a later write expires them (see table_bytes_).
+      break;
     }
     {
       absl::base_internal::SpinLockHolder lock(&stats_lock_);
@@ -299,29 +366,68 @@ Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
       ABSL_TS_UNCHECKED_READ(batch_size_accountant_)->NonMutableState(), record_or_row_batch);
 
   PL_RETURN_IF_ERROR(ExpireRowBatches(batch_stats.bytes));
+  auto batch_bytes = batch_stats.bytes;
 
+  auto& shard = hot_write_shards_[std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+                                  kNumHotWriteShards];
+  uint64_t write_idx;
   {
+    absl::base_internal::SpinLockHolder shard_lock(&shard.lock);
+    shard.queued.emplace_back(std::move(record_or_row_batch), std::move(batch_stats));
+    write_idx = ++shard.num_queued;
+  }
+  // Another writer might have already moved the batch into the hot store while this writer was
+  // waiting for hot_lock_. Either way, the batch is readable once WriteHot returns.
+  if (shard.num_merged.load(std::memory_order_acquire) < write_idx) {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    auto batch_length = record_or_row_batch.Length();
-    batch_size_accountant_->NewHotBatch(std::move(batch_stats));
-    hot_store_->EmplaceBack(next_row_id_, std::move(record_or_row_batch));
-    next_row_id_ += batch_length;
+    if (shard.num_merged.load(std::memory_order_acquire) < write_idx) {
+      MergeHotWriteShards();
+    }
   }
 
   {
     absl::base_internal::SpinLockHolder lock(&stats_lock_);
     ++batches_added_;
     metrics_.batches_added_counter.Increment();
-    bytes_added_ += batch_stats.bytes;
-    metrics_.bytes_added_counter.Increment(batch_stats.bytes);
+    bytes_added_ += batch_bytes;
+    metrics_.bytes_added_counter.Increment(batch_bytes);
   }
-
-  // Make sure locks are released for this call, since they are reacquired inside.
-  PL_RETURN_IF_ERROR(UpdateTableMetricGauges());
+  // The gauges aren't refreshed on writes, since GetTableStats takes all of the table's locks.
+  // Compaction refreshes them instead (see UpdateTableMetricGauges).
   return Status::OK();
 }
 
+void Table::MergeHotWriteShards() {
+  for (auto& shard : hot_write_shards_) {
+    std::vector<std::pair<internal::RecordOrRowBatch, internal::BatchSizeAccountant::BatchStats>>
+        queued;
+    uint64_t num_queued;
+    {
+      absl::base_internal::SpinLockHolder shard_lock(&shard.lock);
+      queued.swap(shard.queued);
+      num_queued = shard.num_queued;
+    }
+    for (auto& [batch, batch_stats] : queued) {
+      auto batch_length = batch.Length();
+      batch_size_accountant_->NewHotBatch(batch_stats);
+      hot_store_->EmplaceBack(next_row_id_, std::move(batch));
+      next_row_id_ += batch_length;
+    }
+    shard.num_merged.store(num_queued, std::memory_order_release);
+  }
+  UpdateTableBytes();
+}
+
+void Table::UpdateTableBytes() {
+  auto bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
+  table_bytes_.store(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
 Table::RowID Table::FirstRowID() const {
+  absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+  if (disk_store_ != nullptr && disk_store_->Size() > 0) {
+    return disk_store_->FirstRowID();
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   if (cold_store_->Size() > 0) {
     return cold_store_->FirstRowID();
@@ -334,6 +440,7 @@ Table::RowID Table::FirstRowID() const {
 }
 
 Table::RowID Table::LastRowID() const {
+  absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   if (hot_store_->Size() > 0) {
@@ -342,10 +449,14 @@ Table::RowID Table::LastRowID() const {
   if (cold_store_->Size() > 0) {
     return cold_store_->LastRowID();
   }
+  if (disk_store_ != nullptr && disk_store_->Size() > 0) {
+    return disk_store_->LastRowID();
+  }
   return -1;
 }
 
 Table::Time Table::MaxTime() const {
+  absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   if (hot_store_->Size() > 0) {
@@ -354,12 +465,23 @@ Table::Time Table::MaxTime() const {
   if (cold_store_->Size() > 0) {
     return cold_store_->MaxTime();
   }
+  if (disk_store_ != nullptr && disk_store_->Size() > 0) {
+    return disk_store_->MaxTime();
+  }
   return -1;
 }
 
 Table::RowID Table::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
+  absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+  std::optional<RowID> optional_row_id;
+  if (disk_store_ != nullptr) {
+    optional_row_id = disk_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
+    if (optional_row_id.has_value()) {
+      return optional_row_id.value();
+    }
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  auto optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
+  optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
   }
@@ -372,8 +494,16 @@ Table::RowID Table::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
 }
 
 Table::RowID Table::FindRowIDFromTimeFirstGreaterThan(Time time) const {
+  absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+  std::optional<RowID> optional_row_id;
+  if (disk_store_ != nullptr) {
+    optional_row_id = disk_store_->FindRowIDFromTimeFirstGreaterThan(time);
+    if (optional_row_id.has_value()) {
+      return optional_row_id.value();
+    }
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  auto optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThan(time);
+  optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThan(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
   }
@@ -393,14 +523,25 @@ TableStats Table::GetTableStats() const {
   int64_t num_batches = 0;
   int64_t hot_bytes = 0;
   int64_t cold_bytes = 0;
+  int64_t disk_bytes = 0;
+  int64_t compaction_backlog_bytes = 0;
   {
+    absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+    if (disk_store_ != nullptr) {
+      min_time = disk_store_->MinTime();
+      num_batches += disk_store_->Size();
+      disk_bytes = disk_bytes_;
+    }
     absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-    min_time = cold_store_->MinTime();
+    if (min_time == -1) {
+      min_time = cold_store_->MinTime();
+    }
     num_batches += cold_store_->Size();
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     num_batches += hot_store_->Size();
     hot_bytes = batch_size_accountant_->HotBytes();
     cold_bytes = batch_size_accountant_->ColdBytes();
+    compaction_backlog_bytes = batch_size_accountant_->CompactionBacklogBytes();
     if (min_time == -1) {
       min_time = hot_store_->MinTime();
     }
@@ -414,93 +555,382 @@ TableStats Table::GetTableStats() const {
   info.bytes = hot_bytes + cold_bytes;
   info.hot_bytes = hot_bytes;
   info.cold_bytes = cold_bytes;
+  info.disk_bytes = disk_bytes;
   info.compacted_batches = compacted_batches_;
+  info.compaction_backlog_bytes = compaction_backlog_bytes;
+  info.memory_pool_bytes = mem_pool_->bytes_allocated();
+  info.memory_pool_cached_bytes = mem_pool_->cached_bytes();
   info.max_table_size = max_table_size_;
   info.min_time = min_time;
 
   return info;
 }
 
-Status Table::CompactSingleBatchUnlocked(arrow::MemoryPool*) {
-  const auto& compaction_spec = batch_size_accountant_->GetNextCompactedBatchSpec();
+StatusOr<bool> Table::CompactSingleBatch(arrow::MemoryPool*,
+                                         std::unique_ptr<schema::RowBatch>* observed_rb) {
+  auto start = std::chrono::steady_clock::now();
+  internal::BatchSizeAccountant::CompactedBatchSpec compaction_spec;
+  RowID first_row_id;
+  // The hot batches of each slice of the compaction spec. Batches don't move when other batches
+  // are appended to the hot store, and only compaction and ExpireHot remove them, which both hold
+  // compaction_lock_. So the batches can be read without holding hot_lock_.
+  std::vector<const internal::RecordOrRowBatch*> slice_batches;
+  {
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    if (!batch_size_accountant_->CompactedBatchReady()) {
+      return false;
+    }
+    compaction_spec = batch_size_accountant_->GetNextCompactedBatchSpec();
+    first_row_id = hot_store_->FirstRowID() + compaction_spec.hot_slices.front().start_row;
+    size_t batch_idx = 0;
+    for (const auto& hot_slice : compaction_spec.hot_slices) {
+      slice_batches.push_back(&hot_store_->BatchAt(batch_idx));
+      if (hot_slice.last_slice_for_batch) {
+        batch_idx++;
+      }
+    }
+  }
 
+  // Copying and encoding the compacted batch is done without holding any locks, so that writers
+  // and readers aren't blocked on it.
   PL_RETURN_IF_ERROR(
       compactor_.Reserve(compaction_spec.num_rows, compaction_spec.variable_col_bytes));
+  for (const auto& [i, hot_slice] : Enumerate(compaction_spec.hot_slices)) {
+    compactor_.UnsafeAppendBatchSlice(*slice_batches[i], hot_slice.start_row, hot_slice.end_row);
+  }
+  PL_ASSIGN_OR_RETURN(std::vector<ArrowArrayPtr> out_columns, compactor_.Finish());
 
-  RowID first_row_id = -1;
-  for (auto hot_slice : compaction_spec.hot_slices) {
-    if (first_row_id == -1) {
-      first_row_id = hot_store_->FirstRowID() + hot_slice.start_row;
-    }
-
-    compactor_.UnsafeAppendBatchSlice(hot_store_->front(), hot_slice.start_row, hot_slice.end_row);
-    if (hot_slice.last_slice_for_batch) {
-      hot_store_->PopFront();
+  // The observers get the unencoded columns, which the RowBatch keeps alive after the cold batch
+  // took ownership of them.
+  if (!compaction_observers_.empty()) {
+    *observed_rb = std::make_unique<schema::RowBatch>(schema::RowDescriptor(rel_.col_types()),
+                                                      compaction_spec.num_rows);
+    for (const auto& col : out_columns) {
+      PL_RETURN_IF_ERROR((*observed_rb)->AddColumn(col));
     }
   }
 
-  PL_ASSIGN_OR_RETURN(std::vector<ArrowArrayPtr> out_columns, compactor_.Finish());
-
-  cold_store_->EmplaceBack(first_row_id, out_columns);
+  std::optional<ColdBatch> cold_batch;
+  if (FLAGS_table_store_cold_batch_encoding) {
+    PL_ASSIGN_OR_RETURN(cold_batch, ColdBatch::Encode(rel_, out_columns));
+  } else {
+    cold_batch.emplace(std::move(out_columns));
+  }
+  uint64_t cold_bytes_saved = cold_batch->BytesSavedByEncoding();
+  uint64_t cold_batch_bytes =
+      FLAGS_table_store_account_allocated_bytes ? cold_batch->MemoryUsage() : 0;
 
-  auto num_rows_to_remove = batch_size_accountant_->FinishCompactedBatch();
-  if (num_rows_to_remove > 0) {
-    hot_store_->RemovePrefix(num_rows_to_remove);
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    for (const auto& hot_slice : compaction_spec.hot_slices) {
+      if (hot_slice.last_slice_for_batch) {
+        hot_store_->PopFront();
+      }
+    }
+    cold_store_->EmplaceBack(first_row_id, std::move(cold_batch.value()));
+
+    auto num_rows_to_remove =
+        FLAGS_table_store_account_allocated_bytes
+            ? batch_size_accountant_->FinishCompactedBatchWithBytes(cold_batch_bytes)
+            : batch_size_accountant_->FinishCompactedBatch(cold_bytes_saved);
+    if (num_rows_to_remove > 0) {
+      hot_store_->RemovePrefix(num_rows_to_remove);
+    }
+    UpdateTableBytes();
   }
 
   {
     absl::base_internal::SpinLockHolder stat_lock(&stats_lock_);
     compacted_batches_++;
     metrics_.compacted_batches_counter.Increment();
+    metrics_.compaction_time_ns_counter.Increment(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             start)
+            .count());
   }
-  return Status::OK();
+  return true;
 }
 
 Status Table::CompactHotToCold(arrow::MemoryPool* mem_pool) {
-  bool next_ready = false;
+  // compaction_lock_ is taken once per batch, so that writers can expire hot batches in between.
+  bool compacted = true;
+  while (compacted) {
+    PL_ASSIGN_OR_RETURN(compacted, CompactBatch(mem_pool));
+  }
+  return UpdateTableMetricGauges();
+}
+
+StatusOr<bool> Table::CompactBatch(arrow::MemoryPool* mem_pool) {
+  std::unique_ptr<schema::RowBatch> observed_rb;
+  absl::ReleasableMutexLock compaction_lock(&compaction_lock_);
+  PL_ASSIGN_OR_RETURN(bool compacted, CompactSingleBatch(mem_pool, &observed_rb));
+  if (observed_rb == nullptr) {
+    return compacted;
+  }
+  auto observers = compaction_observers_;
+  // The observers are called without holding compaction_lock_, so that they don't hold up writers
+  // that expire hot batches. observer_lock_ is taken before it's released, so that the calls stay
+  // serialized and in compaction order.
+  absl::MutexLock observer_lock(&observer_lock_);
+  compaction_lock.Release();
+  for (const auto& observer : observers) {
+    auto s = observer->OnCompactedBatch(*observed_rb);
+    LOG_IF(ERROR, !s.ok()) << absl::Substitute("Compaction observer failed: $0", s.msg());
+  }
+  return true;
+}
+
+void Table::AddCompactionObserver(std::shared_ptr<CompactionObserver> observer) {
+  absl::MutexLock compaction_lock(&compaction_lock_);
+  compaction_observers_.push_back(std::move(observer));
+}
+
+int64_t Table::CompactionBacklogBytes() const {
+  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+  return batch_size_accountant_->CompactionBacklogBytes();
+}
+
+Status Table::EnableDiskTierFromFlags(std::string_view table_name) {
+  // Table names are not unique across TableStores in the same process, so each table gets its own
+  // numbered directory.
+  static std::atomic<int64_t> next_disk_tier_id = 0;
+  auto dir_name = absl::Substitute("$0-$1", absl::StrReplaceAll(table_name, {{"/", "_"}}),
+                                   next_disk_tier_id++);
+  return EnableDiskTier(std::filesystem::path(FLAGS_table_store_disk_tier_dir) / dir_name,
+                        FLAGS_table_store_disk_tier_table_size_limit);
+}
+
+Status Table::EnableDiskTier(const std::filesystem::path& dir, int64_t max_disk_bytes) {
+  if (max_disk_bytes <= 0) {
+    return error::InvalidArgument("Disk tier size limit must be positive, got $0", max_disk_bytes);
+  }
+  absl::MutexLock expire_lock(&expire_cold_lock_);
+  if (!disk_dir_.empty()) {
+    return error::AlreadyExists("Disk tier is already enabled in $0", disk_dir_.string());
+  }
+  if (fs::Exists(dir)) {
+    PL_RETURN_IF_ERROR(fs::RemoveAll(dir));
+  }
+  PL_RETURN_IF_ERROR(fs::CreateDirectories(dir));
+  disk_dir_ = dir;
+
+  absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+  max_disk_bytes_ = max_disk_bytes;
+  disk_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Disk>>(
+      rel_, time_col_idx_);
+  return Status::OK();
+}
+
+StatusOr<std::vector<Table::ArrowArrayPtr>> Table::WriteToDisk(
+    RowIDInterval row_ids, std::optional<TimeInterval> times,
+    const std::vector<ArrowArrayPtr>& columns, int64_t* bytes) {
+  if (disk_segment_ == nullptr ||
+      static_cast<int64_t>(disk_segment_->Size()) >= FLAGS_table_store_disk_tier_segment_size) {
+    // The previous segment's file is removed once all of its batches have been expired.
+    PL_ASSIGN_OR_RETURN(disk_segment_,
+                        internal::DiskSegment::Create(
+                            disk_dir_ / absl::Substitute("segment-$0", next_disk_segment_id_++),
+                            rel_));
+  }
+  auto size_before = disk_segment_->Size();
+  PL_ASSIGN_OR_RETURN(auto disk_columns, disk_segment_->Append(row_ids, times, columns));
+  *bytes = disk_segment_->Size() - size_before;
+  return disk_columns;
+}
+
+StatusOr<std::optional<Table::RowIDInterval>> Table::WriteSnapshot(
+    const std::filesystem::path& path, RowID after_row_id) const {
+  // Hot batches are usually much smaller than compacted ones, so only compacted batches are
+  // included, by stopping the cursor at the first hot row.
+  RowID stop_row_id;
   {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    next_ready = batch_size_accountant_->CompactedBatchReady();
+    stop_row_id = hot_store_->Size() > 0 ? hot_store_->FirstRowID() : next_row_id_;
+  }
+  Cursor cursor(this);
+  cursor.stop_.stop_row_id = stop_row_id;
+  auto* last_read_row_id = cursor.LastReadRowID();
+  *last_read_row_id = std::max(*last_read_row_id, after_row_id);
+
+  std::vector<int64_t> cols(rel_.NumColumns());
+  std::iota(cols.begin(), cols.end(), 0);
+  // The segment is only created once there is a batch to write.
+  std::shared_ptr<internal::DiskSegment> segment;
+  std::optional<RowIDInterval> written_row_ids;
+  while (!cursor.Done()) {
+    PL_ASSIGN_OR_RETURN(auto rb, cursor.GetNextRowBatch(cols));
+    if (rb->num_rows() == 0) {
+      continue;
+    }
+    RowID last_row_id = *last_read_row_id;
+    RowIDInterval row_ids = {last_row_id - rb->num_rows() + 1, last_row_id};
+    std::optional<TimeInterval> times;
+    if (time_col_idx_ != -1) {
+      const auto* time_col = rb->ColumnAt(time_col_idx_).get();
+      times = {types::GetValueFromArrowArray<types::DataType::TIME64NS>(time_col, 0),
+               types::GetValueFromArrowArray<types::DataType::TIME64NS>(time_col,
+                                                                        rb->num_rows() - 1)};
+    }
+    if (segment == nullptr) {
+      PL_ASSIGN_OR_RETURN(segment,
+                          internal::DiskSegment::Create(path, rel_, /*persistent*/ true));
+      written_row_ids = RowIDInterval{row_ids.first, row_ids.second};
+    }
+    PL_RETURN_IF_ERROR(segment->Write(row_ids, times, rb->columns()));
+    written_row_ids->second = row_ids.second;
+  }
+  if (segment != nullptr) {
+    PL_RETURN_IF_ERROR(segment->Sync());
+  }
+  return written_row_ids;
+}
+
+Status Table::RestoreSnapshot(const std::vector<std::filesystem::path>& paths) {
+  std::vector<internal::DiskSegment::Batch> batches;
+  for (const auto& path : paths) {
+    PL_ASSIGN_OR_RETURN(auto segment_batches, internal::DiskSegment::Open(path, rel_));
+    for (auto& batch : segment_batches) {
+      // Rows in the table have consecutive RowIDs, so the batches before a gap are dropped.
+      if (!batches.empty() && batch.row_ids.first != batches.back().row_ids.second + 1) {
+        batches.clear();
+      }
+      batches.push_back(std::move(batch));
+    }
   }
-  while (next_ready) {
+
+  // Only restore the newest batches that fit within the table's size limit.
+  auto non_mutable_state = ABSL_TS_UNCHECKED_READ(batch_size_accountant_)->NonMutableState();
+  std::vector<uint64_t> batch_bytes;
+  for (const auto& batch : batches) {
+    batch_bytes.push_back(
+        internal::BatchSizeAccountant::CalcColdBatchBytes(non_mutable_state, batch.columns));
+  }
+  size_t first_batch = batches.size();
+  int64_t total_bytes = 0;
+  while (first_batch > 0 &&
+         total_bytes + static_cast<int64_t>(batch_bytes[first_batch - 1]) <= max_table_size_) {
+    total_bytes += batch_bytes[--first_batch];
+  }
+  if (first_batch == batches.size()) {
+    return Status::OK();
+  }
+
+  // Computing the zone maps reads the batches from disk, so it's done before taking any locks.
+  std::vector<ColdBatch> cold_batches;
+  for (size_t i = first_batch; i < batches.size(); ++i) {
+    cold_batches.emplace_back(std::move(batches[i].columns));
+  }
+
+  {
     absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    // We have to check CompactedBatchReady() again, in case hot batches were expired since the last
-    // check.
-    if (!batch_size_accountant_->CompactedBatchReady()) {
-      break;
+    if (next_row_id_ != 0) {
+      return error::FailedPrecondition("Snapshots can only be restored into empty tables.");
+    }
+    next_row_id_ = batches[first_batch].row_ids.first;
+    for (auto&& [i, batch] : Enumerate(cold_batches)) {
+      auto length = batch.Length();
+      cold_store_->EmplaceBack(next_row_id_, std::move(batch));
+      batch_size_accountant_->NewColdBatch(batch_bytes[first_batch + i]);
+      next_row_id_ += length;
     }
-    PL_RETURN_IF_ERROR(CompactSingleBatchUnlocked(mem_pool));
-    next_ready = batch_size_accountant_->CompactedBatchReady();
+    UpdateTableBytes();
   }
-  return Status::OK();
+  return UpdateTableMetricGauges();
 }
 
 StatusOr<bool> Table::ExpireCold() {
-  absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  if (cold_store_->Size() == 0) {
-    return false;
+  absl::MutexLock expire_lock(&expire_cold_lock_);
+  if (disk_dir_.empty()) {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    if (cold_store_->Size() == 0) {
+      return false;
+    }
+    cold_store_->PopFront();
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    batch_size_accountant_->ExpireColdBatch();
+    UpdateTableBytes();
+    return true;
+  }
+
+  RowIDInterval row_ids;
+  std::optional<TimeInterval> times;
+  std::vector<ArrowArrayPtr> columns;
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    if (cold_store_->Size() == 0) {
+      return false;
+    }
+    const auto& batch = cold_store_->front();
+    row_ids = {cold_store_->FirstRowID(), cold_store_->FirstRowID() + batch.Length() - 1};
+    if (time_col_idx_ != -1) {
+      times = {batch.GetTimeValue(time_col_idx_, 0),
+               batch.GetTimeValue(time_col_idx_, batch.Length() - 1)};
+    }
+    PL_ASSIGN_OR_RETURN(columns, batch.Decode());
+  }
+
+  // Writing to disk happens without holding any store locks, so that reads and writes of the table
+  // aren't blocked on IO. The cold front can't change in the meantime, since only ExpireCold
+  // removes cold batches.
+  int64_t bytes = 0;
+  auto disk_columns_or_s = WriteToDisk(row_ids, times, columns, &bytes);
+  if (!disk_columns_or_s.ok()) {
+    LOG(ERROR) << absl::Substitute("Failed to write batch to disk tier, dropping it instead: $0",
+                                   disk_columns_or_s.msg());
+  }
+
+  {
+    absl::base_internal::SpinLockHolder disk_lock(&disk_lock_);
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    ColdBatch batch = std::move(cold_store_->front());
+    cold_store_->PopFront();
+    // Batches that are bigger than the entire disk budget are dropped.
+    if (disk_columns_or_s.ok() && bytes <= max_disk_bytes_) {
+      while (disk_bytes_ + bytes > max_disk_bytes_) {
+        disk_store_->PopFront();
+        disk_bytes_ -= disk_batch_bytes_.front();
+        disk_batch_bytes_.pop_front();
+      }
+      batch.ReplaceColumns(disk_columns_or_s.ConsumeValueOrDie());
+      disk_store_->EmplaceBack(row_ids.first, std::move(batch));
+      disk_bytes_ += bytes;
+      disk_batch_bytes_.push_back(bytes);
+    }
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    batch_size_accountant_->ExpireColdBatch();
+    UpdateTableBytes();
   }
-  cold_store_->PopFront();
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-  batch_size_accountant_->ExpireColdBatch();
   return true;
 }
 
-Status Table::ExpireHot() {
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-  if (hot_store_->Size() == 0) {
+StatusOr<bool> Table::ExpireHot() {
+  // Hot batches can't be removed while they are compacted, and writers don't wait for compaction.
+  if (!compaction_lock_.TryLock()) {
+    return false;
+  }
+  bool expired = false;
+  {
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    if (hot_store_->Size() > 0) {
+      hot_store_->PopFront();
+      batch_size_accountant_->ExpireHotBatch();
+      UpdateTableBytes();
+      expired = true;
+    }
+  }
+  compaction_lock_.Unlock();
+  if (!expired) {
     return error::InvalidArgument("Failed to expire row batch, no row batches in table");
   }
-  hot_store_->PopFront();
-  batch_size_accountant_->ExpireHotBatch();
-  return Status::OK();
+  return true;
 }
 
-Status Table::ExpireBatch() {
+StatusOr<bool> Table::ExpireBatch() {
   PL_ASSIGN_OR_RETURN(auto expired_cold, ExpireCold());
   if (expired_cold) {
-    return Status::OK();
+    return true;
   }
   // If we get to this point then there were no cold batches to expire, so we try to expire a hot
   // batch.
@@ -513,6 +943,9 @@ Status Table::UpdateTableMetricGauges() {
   // Set gauge values
   metrics_.cold_bytes_gauge.Set(stats.cold_bytes);
   metrics_.hot_bytes_gauge.Set(stats.hot_bytes);
+  metrics_.disk_bytes_gauge.Set(stats.disk_bytes);
+  metrics_.compaction_backlog_bytes_gauge.Set(stats.compaction_backlog_bytes);
+  metrics_.memory_pool_bytes_gauge.Set(stats.memory_pool_bytes);
   metrics_.num_batches_gauge.Set(stats.num_batches);
   metrics_.max_table_size_gauge.Set(stats.max_table_size);
   // Compute retention gauge
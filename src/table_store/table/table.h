@@ -22,7 +22,10 @@
 #include <arrow/array.h>
 #include <arrow/record_batch.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <deque>
+#include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
@@ -32,6 +35,7 @@
 #include <vector>
 
 #include <absl/base/internal/spinlock.h>
+#include <absl/base/optimization.h>
 #include <absl/strings/str_format.h>
 #include "src/common/base/base.h"
 #include "src/common/metrics/metrics.h"
@@ -43,12 +47,20 @@
 #include "src/table_store/schemapb/schema.pb.h"
 #include "src/table_store/table/internal/arrow_array_compactor.h"
 #include "src/table_store/table/internal/batch_size_accountant.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/disk_segment.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
 #include "src/table_store/table/internal/store_with_row_accounting.h"
+#include "src/table_store/table/internal/table_memory_pool.h"
 #include "src/table_store/table/internal/types.h"
 #include "src/table_store/table/table_metrics.h"
 
 DECLARE_int32(table_store_table_size_limit);
+DECLARE_bool(table_store_cold_batch_encoding);
+DECLARE_bool(table_store_account_allocated_bytes);
+DECLARE_string(table_store_disk_tier_dir);
+DECLARE_int64(table_store_disk_tier_table_size_limit);
+DECLARE_int64(table_store_disk_tier_segment_size);
 
 namespace px {
 namespace table_store {
@@ -59,15 +71,40 @@ struct TableStats {
   int64_t bytes;
   int64_t hot_bytes;
   int64_t cold_bytes;
+  int64_t disk_bytes;
   int64_t num_batches;
   int64_t batches_added;
   int64_t batches_expired;
   int64_t bytes_added;
   int64_t compacted_batches;
+  int64_t compaction_backlog_bytes;
+  int64_t memory_pool_bytes;
+  int64_t memory_pool_cached_bytes;
   int64_t max_table_size;
   int64_t min_time;
 };
 
+/**
+ * CompactionObserver is notified of the rows that a Table compacts from its hot store into its cold
+ * store, eg. to incrementally maintain derived data such as rollups. Batches are compacted in RowID
+ * order, so every compacted row is observed exactly once and in RowID order (see `Concurrent
+ * Writes` in Table for how that relates to the order of writes). Rows that are expired before
+ * they are compacted are not observed.
+ */
+class CompactionObserver {
+ public:
+  virtual ~CompactionObserver() = default;
+
+  /**
+   * Called after the rows of `rb` were moved into the cold store. Calls for the same table are
+   * serialized, and made without holding any of the table's store locks or its compaction lock, so
+   * the observer can write to the table.
+   * @param rb the compacted rows, with the table's relation.
+   * @return error if the observer failed to process the rows. The rows remain compacted either way.
+   */
+  virtual Status OnCompactedBatch(const schema::RowBatch& rb) = 0;
+};
+
 /**
  * Table stores data in two separate partitions, hot and cold. Hot data is "hot" from the
  * perspective of writes, in other words data is first written to the hot partitiion, and then later
@@ -78,12 +115,56 @@ struct TableStats {
  * and `Time and Row Indexing` below).
  *
  * Synchronization Scheme:
- * The hot and cold partitions are synchronized separately with spinlocks.
+ * The hot, cold and disk partitions are synchronized separately with spinlocks. When more than one
+ * is held, they are always acquired in the order disk, cold, hot. Cursors only hold them to pin
+ * the next batch slice (see `internal::PinnedBatchSlice`); decoding and late materialization happen
+ * after the locks are released.
+ *
+ * Concurrent Writes:
+ * Writers queue their batches in one of `kNumHotWriteShards` shards, picked by the hash of the
+ * writer's thread ID, and the queued batches are merged into the hot store shard by shard (see
+ * `HotWriteShard`). RowIDs are assigned on the merge, so the rows of each thread are in the order
+ * that thread wrote them, but batches that different threads write concurrently get RowIDs in
+ * shard order rather than in the order of the writes. Batches that are written after a write
+ * returns always come after it.
+ *
+ * Size Limit:
+ * Writers check the table's size against `max_table_size_` without holding any locks (see
+ * `table_bytes_`), and expire the oldest batches until the new batch fits. So concurrent writers
+ * can each add a batch on top of the same check, and a writer that finds the oldest hot batches
+ * being compacted doesn't wait for the compaction to expire them. In both cases the table goes over
+ * its limit by the size of those batches, until a later write expires enough batches again.
  *
  * Compaction Scheme:
  * Hot batches are compacted into batches of size roughly `compacted_batch_size_` +/- the size of a
  * single row.  The compaction routine should be called periodically but that is not the
- * responsibility of this class.
+ * responsibility of this class. Unless disabled with `--table_store_cold_batch_encoding=false`,
+ * compacted batches are encoded as they enter the cold store (see `internal::ColdBatch`): low
+ * cardinality string columns are dictionary encoded and int64/time columns are frame-of-reference
+ * encoded. The savings are credited to the cold store's byte accounting, so the same table size
+ * limit retains more history. Encoded columns are decoded on read, only for the columns and rows
+ * requested from the Cursor. Every cold batch also keeps a zone map of each column (min/max, and a
+ * bloom filter for low cardinality strings), which Cursors with a PredicateSpec use to skip
+ * batches.
+ * Each compacted batch is also passed to the table's `CompactionObserver`s, eg. to maintain
+ * rollups of the table incrementally.
+ *
+ * Memory:
+ * Arrow arrays that the table allocates (compacted cold batches, arrow conversions of hot batches,
+ * and columns decoded for Cursors) are allocated from the table's own `internal::TableMemoryPool`,
+ * which reports the table's real arrow memory usage and recycles the buffers of expired batches
+ * for new ones. With `--table_store_account_allocated_bytes`, cold batches count towards
+ * `max_table_size_` with their actual memory usage instead of the estimate of the hot batches they
+ * were compacted from.
+ *
+ * Disk Tier:
+ * If enabled (see `EnableDiskTier` and `--table_store_disk_tier_dir`), cold batches that would be
+ * expired to stay within `max_table_size_` are instead written to append-only segment files (see
+ * `internal::DiskSegment`) and moved into a third, disk store. Disk batches are memory mapped, so
+ * they don't count towards the table's memory limit, and have a separate byte budget after which
+ * the oldest disk batches are expired. Disk batches keep their RowIDs, times and zone maps, so
+ * Cursors continue reading from the disk store into the cold and hot stores without noticing the
+ * difference. Batches are written to disk outside of the store spinlocks.
  *
  * Time and Row Indexing:
  * The first and last values of the time columns for each batch are stored in
@@ -116,17 +197,26 @@ class Table : public NotCopyable {
  public:
   static inline constexpr int64_t kMaxBatchesPerCompactionCall = 256;
   using StopPosition = int64_t;
+  using ColumnPredicate = internal::ColumnPredicate;
+  using LateMaterialization = internal::LateMaterialization;
   static inline std::shared_ptr<Table> Create(std::string_view table_name,
                                               const schema::Relation& relation) {
     // Create naked pointer, because std::make_shared() cannot access the private ctor.
-    return std::shared_ptr<Table>(
+    auto table = std::shared_ptr<Table>(
         new Table(table_name, relation, FLAGS_table_store_table_size_limit));
+    if (!FLAGS_table_store_disk_tier_dir.empty()) {
+      auto s = table->EnableDiskTierFromFlags(table_name);
+      LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to enable disk tier for table $0: $1",
+                                                 table_name, s.msg());
+    }
+    return table;
   }
 
   /**
    * Cursor allows iterating the table, while guaranteeing that no row is returned twice (even when
    * compactions occur between accesses). {Start,Stop}Spec specify what rows the cursor should begin
-   * and end at when iterating the cursor.
+   * and end at when iterating the cursor. An optional PredicateSpec lets the cursor skip cold
+   * batches that cannot contain rows the caller is interested in.
    */
   class Cursor {
    public:
@@ -173,8 +263,19 @@ class Table : public NotCopyable {
       Time stop_time = -1;
     };
 
+    /**
+     * PredicateSpec is a conjunction of column predicates. Cold batches whose zone maps show that
+     * none of their rows satisfy all of the predicates are skipped by the cursor. Batches that are
+     * returned are not filtered, so callers must still apply their full filter to their rows.
+     */
+    struct PredicateSpec {
+      std::vector<ColumnPredicate> predicates;
+    };
+
     explicit Cursor(const Table* table) : Cursor(table, StartSpec{}, StopSpec{}) {}
-    Cursor(const Table* table, StartSpec start, StopSpec stop);
+    Cursor(const Table* table, StartSpec start, StopSpec stop)
+        : Cursor(table, std::move(start), std::move(stop), PredicateSpec{}) {}
+    Cursor(const Table* table, StartSpec start, StopSpec stop, PredicateSpec predicates);
 
     // In the case of StopType == Infinite or StopType == StopAtTime, this returns whether the table
     // has the next batch ready. In the case of StopType == CurrentEndOfTable, this returns !Done().
@@ -188,6 +289,13 @@ class Table : public NotCopyable {
     bool Done();
     // Change the StopSpec of the cursor.
     void UpdateStopSpec(StopSpec stop);
+    // Read the following batches with late materialization, so that they only hold the rows that
+    // `late_materialization` selects (see internal::LateMaterialization).
+    void SetLateMaterialization(LateMaterialization late_materialization) {
+      late_materialization_ = std::move(late_materialization);
+    }
+    // Returns the number of cold batches skipped so far because of the cursor's PredicateSpec.
+    int64_t BatchesSkipped() const { return batches_skipped_; }
 
    private:
     void AdvanceToStart(const StartSpec& start);
@@ -198,6 +306,11 @@ class Table : public NotCopyable {
     internal::RowID* LastReadRowID();
     internal::BatchHints* Hints();
     std::optional<internal::RowID> StopRowID() const;
+    const std::vector<ColumnPredicate>& Predicates() const { return predicates_.predicates; }
+    int64_t* BatchesSkippedCounter() { return &batches_skipped_; }
+    const LateMaterialization* GetLateMaterialization() const {
+      return late_materialization_.has_value() ? &late_materialization_.value() : nullptr;
+    }
 
     struct StopState {
       StopSpec spec;
@@ -210,6 +323,9 @@ class Table : public NotCopyable {
     internal::BatchHints hints_;
     RowID last_read_row_id_;
     StopState stop_;
+    PredicateSpec predicates_;
+    int64_t batches_skipped_ = 0;
+    std::optional<LateMaterialization> late_materialization_;
 
     friend class Table;
   };
@@ -296,16 +412,88 @@ class Table : public NotCopyable {
 
   /**
    * Compacts hot batches into compacted_batch_size_ sized cold batches. Each call to
-   * CompactHotToCold will create a maximum of kMaxBatchesPerCompactionCall cold batches.
-   * @param mem_pool arrow MemoryPool to be used for creating new cold batches.
+   * CompactHotToCold will create a maximum of kMaxBatchesPerCompactionCall cold batches. Hot data
+   * is copied into each cold batch without holding the table's locks, so writes and reads only wait
+   * for the finished batch to be swapped into the cold store. Batches are compacted one at a time
+   * (see CompactBatch), and the CompactionObservers are called between batches.
+   * @param mem_pool unused, cold batches are allocated from the table's own memory pool.
    */
   Status CompactHotToCold(arrow::MemoryPool* mem_pool);
 
+  /**
+   * CompactBatch compacts at most one batch of hot data into a cold batch. This allows callers to
+   * bound the time spent compacting a table (see CompactionScheduler). Unlike CompactHotToCold,
+   * it doesn't refresh the table's gauges.
+   * @param mem_pool unused, cold batches are allocated from the table's own memory pool.
+   * @return whether a batch was compacted, false if there is no compacted batch ready.
+   */
+  StatusOr<bool> CompactBatch(arrow::MemoryPool* mem_pool);
+
+  /**
+   * UpdateTableMetricGauges refreshes the table's gauges from `GetTableStats`. Writes don't
+   * refresh them, since that takes all of the table's locks, so callers that compact the table
+   * (e.g. CompactionScheduler) refresh them periodically instead.
+   */
+  Status UpdateTableMetricGauges();
+
+  /**
+   * @return the number of hot bytes that are ready to be compacted.
+   */
+  int64_t CompactionBacklogBytes() const;
+
+  /**
+   * Adds an observer that is called with every batch this table compacts from now on.
+   * @param observer the observer, which is kept alive as long as the table.
+   */
+  void AddCompactionObserver(std::shared_ptr<CompactionObserver> observer);
+
+  /**
+   * Enables the disk tier for this table. From then on, cold batches that are expired because the
+   * table reached its maximum size are written to segment files in the given directory, and remain
+   * readable until the table's disk budget is used up.
+   * @param dir the directory to write this table's segment files to. Any existing contents are
+   * removed, so it must not be shared with other tables.
+   * @param max_disk_bytes the maximum number of bytes of batches to keep on disk.
+   * @return error if the directory couldn't be created, or the disk tier was already enabled.
+   */
+  Status EnableDiskTier(const std::filesystem::path& dir, int64_t max_disk_bytes);
+
+  /**
+   * WriteSnapshot writes the compacted batches of the table (from the disk tier and the cold store)
+   * that come after the given row to a segment file, that can later be loaded with
+   * `RestoreSnapshot`. Rows that are still in the hot store are not included. Batches are written
+   * one at a time, without blocking writes to the table.
+   * @param path the path of the segment file to write. Any existing file at the path is truncated.
+   * @param after_row_id the last row of the table's previous snapshot, so that only the rows added
+   * since are written, or -1 to write every compacted batch.
+   * @return the RowIDs of the first and last rows written, or nullopt if there are no new compacted
+   * rows, in which case no file is written.
+   */
+  StatusOr<std::optional<RowIDInterval>> WriteSnapshot(const std::filesystem::path& path,
+                                                       RowID after_row_id = -1) const;
+
+  /**
+   * RestoreSnapshot memory maps the batches of segment files written by `WriteSnapshot` into the
+   * cold store of this table, so that they can be queried without being copied into memory. The
+   * table must not have any rows yet. Rows keep the RowIDs they were written with, so that later
+   * snapshots can add to the same segments. If the snapshot is bigger than the table's maximum
+   * size, only the newest batches that fit are restored. The files must not be modified
+   * afterwards, but can be removed.
+   * @param paths the paths of the segment files, in the order of their rows. If the rows of a
+   * segment don't follow on from those of the previous one, only the segments after the gap are
+   * restored.
+   * @return error if the table isn't empty, or a file isn't a valid snapshot of this table.
+   */
+  Status RestoreSnapshot(const std::vector<std::filesystem::path>& paths);
+
  private:
   TableMetrics metrics_;
 
   schema::Relation rel_;
 
+  // Declared before the stores, so that it's released after their batches are freed.
+  internal::TableMemoryPool::Ptr mem_pool_;
+
   mutable absl::base_internal::SpinLock stats_lock_;
   int64_t batches_expired_ ABSL_GUARDED_BY(stats_lock_) = 0;
   int64_t batches_added_ ABSL_GUARDED_BY(stats_lock_) = 0;
@@ -317,11 +505,51 @@ class Table : public NotCopyable {
   std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Hot>> hot_store_
       ABSL_GUARDED_BY(hot_lock_);
 
+  // Writers don't append to the hot store directly. Each writer queues its batch in the shard of
+  // its thread, and then whichever writer holds hot_lock_ moves the queued batches of all shards
+  // into the hot store at once. Concurrent writers therefore mostly contend on their shard's lock,
+  // and hot_lock_ is taken once for a group of writes rather than once per write.
+  struct alignas(ABSL_CACHELINE_SIZE) HotWriteShard {
+    absl::base_internal::SpinLock lock;
+    std::vector<std::pair<internal::RecordOrRowBatch, internal::BatchSizeAccountant::BatchStats>>
+        queued ABSL_GUARDED_BY(lock);
+    // Number of batches ever queued in this shard.
+    uint64_t num_queued ABSL_GUARDED_BY(lock) = 0;
+    // Number of batches of this shard that have been moved into the hot store.
+    std::atomic<uint64_t> num_merged = 0;
+  };
+  static constexpr size_t kNumHotWriteShards = 8;
+  std::array<HotWriteShard, kNumHotWriteShards> hot_write_shards_;
+
+  // Serializes compactions. Compaction copies hot batches into cold batches without holding
+  // hot_lock_ or cold_lock_, which is only safe as long as no hot batches are removed in the
+  // meantime, so expiring hot batches also takes this lock. Writers only try to take it, and skip
+  // expiring hot batches if a compaction holds it.
+  absl::Mutex compaction_lock_;
+  // Serializes the calls to the CompactionObservers, which are made after compaction_lock_ is
+  // released. Taken while holding compaction_lock_, so the calls are in compaction order.
+  absl::Mutex observer_lock_;
+
   mutable absl::base_internal::SpinLock cold_lock_;
   std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Cold>> cold_store_
       ABSL_GUARDED_BY(cold_lock_);
   std::deque<int64_t> cold_batch_bytes_ ABSL_GUARDED_BY(cold_lock_);
 
+  // Serializes expiring cold batches, which for the disk tier includes writing them to disk while
+  // not holding any of the store spinlocks.
+  absl::Mutex expire_cold_lock_;
+  std::filesystem::path disk_dir_ ABSL_GUARDED_BY(expire_cold_lock_);
+  std::shared_ptr<internal::DiskSegment> disk_segment_ ABSL_GUARDED_BY(expire_cold_lock_);
+  int64_t next_disk_segment_id_ ABSL_GUARDED_BY(expire_cold_lock_) = 0;
+
+  mutable absl::base_internal::SpinLock disk_lock_;
+  std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Disk>> disk_store_
+      ABSL_GUARDED_BY(disk_lock_);
+  // Number of bytes each disk batch takes up in its segment file.
+  std::deque<int64_t> disk_batch_bytes_ ABSL_GUARDED_BY(disk_lock_);
+  int64_t disk_bytes_ ABSL_GUARDED_BY(disk_lock_) = 0;
+  int64_t max_disk_bytes_ ABSL_GUARDED_BY(disk_lock_) = 0;
+
   // Counter to assign a unique row ID to each row. Synchronized by hot_lock_ since its only
   // accessed on a hot write.
   int64_t next_row_id_ ABSL_GUARDED_BY(hot_lock_) = 0;
@@ -329,19 +557,38 @@ class Table : public NotCopyable {
 
   Status WriteHot(internal::RecordOrRowBatch&& record_or_row_batch);
 
-  Status ExpireBatch();
-  Status ExpireHot();
+  // Expire the oldest batch of the table.
+  // @return false if the oldest batch is hot and being compacted, so it can't be expired now.
+  StatusOr<bool> ExpireBatch();
+  StatusOr<bool> ExpireHot();
   StatusOr<bool> ExpireCold();
+  Status EnableDiskTierFromFlags(std::string_view table_name);
+  StatusOr<std::vector<ArrowArrayPtr>> WriteToDisk(RowIDInterval row_ids,
+                                                   std::optional<TimeInterval> times,
+                                                   const std::vector<ArrowArrayPtr>& columns,
+                                                   int64_t* bytes)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(expire_cold_lock_);
   Status ExpireRowBatches(int64_t row_batch_size);
-  Status CompactSingleBatchUnlocked(arrow::MemoryPool* mem_pool)
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_lock_) ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
-  Status UpdateTableMetricGauges();
+  void MergeHotWriteShards() ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
+  // Publishes the hot and cold bytes of batch_size_accountant_ to table_bytes_. Must be called
+  // whenever they change.
+  void UpdateTableBytes() ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
+  // Sets observed_rb to the compacted rows if the table has CompactionObservers.
+  StatusOr<bool> CompactSingleBatch(arrow::MemoryPool* mem_pool,
+                                    std::unique_ptr<schema::RowBatch>* observed_rb)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(compaction_lock_);
 
   Time MaxTime() const;
 
   std::unique_ptr<internal::BatchSizeAccountant> batch_size_accountant_ ABSL_GUARDED_BY(hot_lock_);
-
-  internal::ArrowArrayCompactor compactor_;
+  // The hot and cold bytes of batch_size_accountant_, so that writers can check whether the table
+  // needs to expire batches without taking hot_lock_. Since the check and the write aren't atomic,
+  // the table can briefly exceed max_table_size_ (see `Size Limit` above).
+  std::atomic<int64_t> table_bytes_ = 0;
+
+  internal::ArrowArrayCompactor compactor_ ABSL_GUARDED_BY(compaction_lock_);
+  std::vector<std::shared_ptr<CompactionObserver>> compaction_observers_
+      ABSL_GUARDED_BY(compaction_lock_);
 
   friend class Cursor;
 };
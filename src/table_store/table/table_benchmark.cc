@@ -24,6 +24,7 @@
 #include <numeric>
 #include <random>
 #include <thread>
+#include <vector>
 
 #include "src/shared/types/types.h"
 #include "src/table_store/table/table.h"
@@ -360,6 +361,71 @@ static void BM_TableThreaded(benchmark::State& state) {
   state.counters["Write"] = benchmark::Counter(write_average_time);
 }
 
+// Measures write throughput of state.range(0) threads writing to the same table, while another
+// thread repeatedly scans the table, and compaction runs in the background.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableContendedWriteAndScan(benchmark::State& state) {
+  int64_t table_size = 16 * 1024 * 1024;
+  int64_t compaction_size = 64 * 1024;
+  int64_t batch_length = 256;
+  int64_t batches_per_writer = 1024;
+  int64_t num_writers = state.range(0);
+
+  int64_t rows_scanned = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto table = MakeTable(table_size, compaction_size);
+    // Create the batches up front, so that only writing them to the table is measured.
+    std::vector<std::vector<std::unique_ptr<types::ColumnWrapperRecordBatch>>> writer_batches(
+        num_writers);
+    int64_t time_counter = 0;
+    for (auto& batches : writer_batches) {
+      for (int64_t i = 0; i < batches_per_writer; ++i) {
+        batches.push_back(MakeHotBatch(batch_length, &time_counter));
+      }
+    }
+    absl::Notification writers_done;
+    state.ResumeTiming();
+
+    std::thread compaction_thread([&]() {
+      while (!writers_done.WaitForNotificationWithTimeout(absl::Milliseconds(5))) {
+        PL_CHECK_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+      }
+    });
+    std::thread scan_thread([&]() {
+      while (!writers_done.HasBeenNotified()) {
+        Table::Cursor cursor(table.get());
+        while (!cursor.Done()) {
+          auto batch_or_s = cursor.GetNextRowBatch({0, 1});
+          if (!batch_or_s.ok()) {
+            // The rest of the table was expired before it could be read.
+            break;
+          }
+          rows_scanned += batch_or_s.ValueOrDie()->num_rows();
+        }
+      }
+    });
+    std::vector<std::thread> writer_threads;
+    for (auto& batches : writer_batches) {
+      writer_threads.emplace_back([&table, &batches]() {
+        for (auto& batch : batches) {
+          PL_CHECK_OK(table->TransferRecordBatch(std::move(batch)));
+        }
+      });
+    }
+    for (auto& writer_thread : writer_threads) {
+      writer_thread.join();
+    }
+    writers_done.Notify();
+    scan_thread.join();
+    compaction_thread.join();
+  }
+
+  int64_t batch_size = batch_length * sizeof(int64_t) + batch_length * sizeof(double);
+  state.SetBytesProcessed(state.iterations() * num_writers * batches_per_writer * batch_size);
+  state.counters["RowsScanned"] = benchmark::Counter(rows_scanned, benchmark::Counter::kIsRate);
+}
+
 BENCHMARK(BM_TableReadAllHot);
 BENCHMARK(BM_TableReadAllCold);
 BENCHMARK(BM_TableReadLastBatchAllHot)->Iterations(1000);
@@ -368,5 +434,6 @@ BENCHMARK(BM_TableWriteEmpty);
 BENCHMARK(BM_TableWriteFull);
 BENCHMARK(BM_TableCompaction);
 BENCHMARK(BM_TableThreaded)->UseManualTime()->Iterations(1);
+BENCHMARK(BM_TableContendedWriteAndScan)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
 
 }  // namespace px::table_store
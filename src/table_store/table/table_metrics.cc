@@ -36,6 +36,11 @@ TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_nam
                           .Help("Current hot data bytes in the table")
                           .Register(*registry)
                           .Add({{"name", table_name}})),
+      disk_bytes_gauge(prometheus::BuildGauge()
+                           .Name("table_disk_bytes")
+                           .Help("Current bytes of the table stored in the disk tier")
+                           .Register(*registry)
+                           .Add({{"name", table_name}})),
       num_batches_gauge(prometheus::BuildGauge()
                             .Name("table_num_batches")
                             .Help("Current number of row batches in the table")
@@ -58,6 +63,26 @@ TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_nam
               .Help("Total batches compacted in the table in the table's lifetime")
               .Register(*registry)
               .Add({{"name", table_name}})),
+      compaction_time_ns_counter(
+          prometheus::BuildCounter()
+              .Name("table_compaction_time_ns")
+              .Help("Total time spent compacting batches of the table. Divided by "
+                    "table_compacted_batches, this is the average compaction latency per batch")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      compaction_backlog_bytes_gauge(
+          prometheus::BuildGauge()
+              .Name("table_compaction_backlog_bytes")
+              .Help("Current hot data bytes in the table that are ready to be compacted")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      memory_pool_bytes_gauge(
+          prometheus::BuildGauge()
+              .Name("table_memory_pool_bytes")
+              .Help("Current bytes of arrow memory allocated by the table, including columns "
+                    "held by running queries")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
       max_table_size_gauge(prometheus::BuildGauge()
                                .Name("table_max_table_size")
                                .Help("The cap on the table size")
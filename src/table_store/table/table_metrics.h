@@ -28,10 +28,14 @@ struct TableMetrics {
   prometheus::Counter& bytes_added_counter;
   prometheus::Gauge& cold_bytes_gauge;
   prometheus::Gauge& hot_bytes_gauge;
+  prometheus::Gauge& disk_bytes_gauge;
   prometheus::Gauge& num_batches_gauge;
   prometheus::Counter& batches_added_counter;
   prometheus::Counter& batches_expired_counter;
   prometheus::Counter& compacted_batches_counter;
+  prometheus::Counter& compaction_time_ns_counter;
+  prometheus::Gauge& compaction_backlog_bytes_gauge;
+  prometheus::Gauge& memory_pool_bytes_gauge;
   prometheus::Gauge& max_table_size_gauge;
   prometheus::Gauge& retention_ns_gauge;
 };
@@ -16,15 +16,69 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "src/common/base/file.h"
+#include "src/common/fs/fs_wrapper.h"
+#include "src/table_store/schemapb/schema.pb.h"
 #include "src/table_store/table/table_store.h"
 
 namespace px {
 namespace table_store {
 
+namespace {
+
+constexpr char kSnapshotManifestFile[] = "manifest.pb";
+constexpr char kSegmentFileExtension[] = ".seg";
+
+StatusOr<schemapb::TableStoreSnapshot> ReadSnapshotManifest(const std::filesystem::path& dir) {
+  PL_ASSIGN_OR_RETURN(auto contents, ReadFileToString(dir / kSnapshotManifestFile,
+                                                      std::ios_base::in | std::ios_base::binary));
+  schemapb::TableStoreSnapshot manifest;
+  if (!manifest.ParseFromString(contents)) {
+    return error::InvalidArgument("Failed to parse table store snapshot manifest in $0",
+                                  dir.string());
+  }
+  return manifest;
+}
+
+// Moves `from` to `to`, replacing `to` if it exists.
+Status Rename(const std::filesystem::path& from, const std::filesystem::path& to) {
+  std::error_code ec;
+  std::filesystem::rename(from, to, ec);
+  if (ec) {
+    return error::Internal("Failed to rename $0 to $1: $2", from.string(), to.string(),
+                           ec.message());
+  }
+  return Status::OK();
+}
+
+// Flushes a file or directory to disk, so that its contents (or for a directory, the entries added
+// to or renamed within it) survive a crash.
+Status SyncPath(const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open $0: $1", path.string(), std::strerror(errno));
+  }
+  int ret = fsync(fd);
+  int fsync_errno = errno;
+  close(fd);
+  if (ret != 0) {
+    return error::Internal("Failed to sync $0: $1", path.string(), std::strerror(fsync_errno));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
 std::unique_ptr<std::unordered_map<std::string, schema::Relation>> TableStore::GetRelationMap() {
   auto map = std::make_unique<RelationMap>();
   map->reserve(name_to_relation_map_.size());
@@ -165,5 +219,140 @@ Status TableStore::RunCompaction(arrow::MemoryPool* mem_pool) {
   return Status::OK();
 }
 
+std::vector<std::shared_ptr<Table>> TableStore::GetTables() const {
+  std::vector<std::shared_ptr<Table>> tables;
+  for (const auto& [key, table] : name_to_table_map_) {
+    tables.push_back(table);
+  }
+  return tables;
+}
+
+Status TableStore::WriteSnapshot(const std::filesystem::path& dir) {
+  PL_RETURN_IF_ERROR(fs::CreateDirectories(dir));
+  int64_t generation = 0;
+  if (fs::Exists(dir / kSnapshotManifestFile)) {
+    PL_ASSIGN_OR_RETURN(auto prev_manifest, ReadSnapshotManifest(dir));
+    generation = prev_manifest.generation() + 1;
+  }
+
+  absl::flat_hash_map<Table*, std::vector<uint64_t>> table_ids;
+  for (const auto& [key, table] : id_to_table_map_) {
+    table_ids[table.get()].push_back(key.table_id_);
+  }
+
+  // Each table only writes the rows added since its last snapshot to a new segment, which is named
+  // by generation, so that the files of previous snapshots, which are kept or may be mapped by
+  // restored tables, are never overwritten.
+  schemapb::TableStoreSnapshot manifest;
+  manifest.set_generation(generation);
+  absl::flat_hash_map<Table*, std::vector<SnapshotSegment>> snapshot_segments;
+  for (const auto& [key, table] : name_to_table_map_) {
+    auto* table_pb = manifest.add_tables();
+    table_pb->set_name(key.name_);
+    table_pb->set_tablet_id(key.tablet_id_);
+    for (auto id : table_ids[table.get()]) {
+      table_pb->add_table_ids(id);
+    }
+    PL_RETURN_IF_ERROR(table->GetRelation().ToProto(table_pb->mutable_relation()));
+
+    // Segments whose rows have all been expired from the table are dropped.
+    auto& segments = snapshot_segments[table.get()];
+    auto first_row_id = table->FirstRowID();
+    for (const auto& segment : snapshot_segments_[table.get()]) {
+      if (first_row_id >= 0 && segment.last_row_id() >= first_row_id) {
+        segments.push_back(segment);
+      }
+    }
+    auto file = absl::StrCat(generation, "-", manifest.tables_size() - 1, kSegmentFileExtension);
+    PL_ASSIGN_OR_RETURN(auto row_ids,
+                        table->WriteSnapshot(dir / file, segments.empty()
+                                                             ? -1
+                                                             : segments.back().last_row_id()));
+    if (row_ids.has_value()) {
+      auto& segment = segments.emplace_back();
+      segment.set_file(file);
+      segment.set_first_row_id(row_ids->first);
+      segment.set_last_row_id(row_ids->second);
+    }
+    for (const auto& segment : segments) {
+      *table_pb->add_segments() = segment;
+    }
+  }
+
+  // The manifest is replaced atomically, which makes the new snapshot visible. It's synced before
+  // the rename and the directory after it, so that the files of the previous snapshot are only
+  // removed once the new manifest is durable.
+  auto tmp_manifest_path = dir / absl::StrCat(kSnapshotManifestFile, ".tmp");
+  PL_RETURN_IF_ERROR(WriteFileFromString(tmp_manifest_path, manifest.SerializeAsString(),
+                                         std::ios_base::out | std::ios_base::binary));
+  PL_RETURN_IF_ERROR(SyncPath(tmp_manifest_path));
+  PL_RETURN_IF_ERROR(Rename(tmp_manifest_path, dir / kSnapshotManifestFile));
+  PL_RETURN_IF_ERROR(SyncPath(dir));
+  snapshot_segments_ = std::move(snapshot_segments);
+
+  // Remove the segment files of previous snapshots. Restored tables that still map them keep
+  // their data until they are unmapped.
+  absl::flat_hash_set<std::string> current_files;
+  for (const auto& table_pb : manifest.tables()) {
+    for (const auto& segment : table_pb.segments()) {
+      current_files.insert(segment.file());
+    }
+  }
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    auto file_name = entry.path().filename().string();
+    if (entry.path().extension() == kSegmentFileExtension && !current_files.contains(file_name)) {
+      PL_RETURN_IF_ERROR(fs::Remove(entry.path()));
+    }
+  }
+  return Status::OK();
+}
+
+Status TableStore::RestoreSnapshot(const std::filesystem::path& dir) {
+  PL_ASSIGN_OR_RETURN(auto manifest, ReadSnapshotManifest(dir));
+  for (const auto& table_pb : manifest.tables()) {
+    schema::Relation relation;
+    PL_RETURN_IF_ERROR(relation.FromProto(&table_pb.relation()));
+
+    std::shared_ptr<Table> table;
+    bool registered = false;
+    auto name_iter = name_to_table_map_.find(NameTablet{table_pb.name(), table_pb.tablet_id()});
+    if (name_iter != name_to_table_map_.end()) {
+      table = name_iter->second;
+      registered = true;
+    } else {
+      table = Table::Create(table_pb.name(), relation);
+    }
+    auto relation_iter = name_to_relation_map_.find(table_pb.name());
+    if (table->GetRelation() != relation ||
+        (relation_iter != name_to_relation_map_.end() && relation_iter->second != relation)) {
+      LOG(WARNING) << absl::Substitute(
+          "Skipping restore of table $0, its relation changed since the snapshot.",
+          table_pb.name());
+      continue;
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto& segment : table_pb.segments()) {
+      paths.push_back(dir / segment.file());
+    }
+    auto s = table->RestoreSnapshot(paths);
+    if (!s.ok()) {
+      LOG(WARNING) << absl::Substitute("Failed to restore table $0 from snapshot: $1",
+                                       table_pb.name(), s.msg());
+      continue;
+    }
+    // The next snapshot adds to the restored segments, whose rows kept their RowIDs.
+    snapshot_segments_[table.get()].assign(table_pb.segments().begin(), table_pb.segments().end());
+    if (registered) {
+      continue;
+    }
+    RegisterTableName(table_pb.name(), table_pb.tablet_id(), relation, table);
+    for (auto table_id : table_pb.table_ids()) {
+      RegisterTableID(table_id, TableInfo{table_pb.name(), relation}, table_pb.tablet_id(), table);
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace table_store
 }  // namespace px
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -25,12 +26,14 @@
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 
 #include "src/common/base/base.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/hash_utils.h"
 #include "src/table_store/schema/relation.h"
 #include "src/table_store/schema/schema.h"
+#include "src/table_store/schemapb/schema.pb.h"
 #include "src/table_store/table/table.h"
 #include "src/table_store/table/tablets_group.h"
 
@@ -167,6 +170,37 @@ class TableStore {
 
   Status RunCompaction(arrow::MemoryPool* mem_pool);
 
+  /**
+   * @return every table in the table store, including each tablet of a tabletized table.
+   */
+  std::vector<std::shared_ptr<Table>> GetTables() const;
+
+  /**
+   * WriteSnapshot checkpoints the table store to the given directory: the registration of every
+   * table (name, tablet, IDs and relation), and the compacted data of each table (see
+   * `Table::WriteSnapshot`). Only the rows compacted since the last snapshot written or restored
+   * by this table store are written, to a new segment per table; the earlier segments whose rows
+   * are still in the table are kept. A snapshot only replaces the previous snapshot in the
+   * directory once it has been completely written and synced, so a crash while writing a snapshot
+   * leaves the previous one intact.
+   * @param dir the directory to write the snapshot to. Created if it doesn't exist. Snapshots of
+   * different table stores must not share a directory.
+   * @return error if the snapshot couldn't be written.
+   */
+  Status WriteSnapshot(const std::filesystem::path& dir);
+
+  /**
+   * RestoreSnapshot loads the latest snapshot in the given directory. Tables that are not yet
+   * registered are created and registered as they were when the snapshot was written. The data of
+   * each table is memory mapped into the table, which must be empty, so queries can cover the time
+   * before the snapshot right away. Tables whose relation has changed since the snapshot are
+   * skipped.
+   * @param dir the directory the snapshot was written to.
+   * @return error if the snapshot's manifest couldn't be read. Failures to restore individual
+   * tables are logged and skipped.
+   */
+  Status RestoreSnapshot(const std::filesystem::path& dir);
+
  private:
   void RegisterTableName(const std::string& table_name, const types::TabletID& tablet_id,
                          const schema::Relation& table_relation,
@@ -197,6 +231,10 @@ class TableStore {
   absl::flat_hash_map<std::string, schema::Relation> name_to_relation_map_;
   // Mapping from id to name and relation pair for adding new tablets.
   absl::flat_hash_map<uint64_t, TableInfo> id_to_table_info_map_;
+  using SnapshotSegment = schemapb::TableStoreSnapshot::Segment;
+  // The segments of each table in the last snapshot that was written or restored, which the next
+  // snapshot adds to.
+  absl::flat_hash_map<Table*, std::vector<SnapshotSegment>> snapshot_segments_;
 };
 
 }  // namespace table_store
@@ -20,9 +20,13 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <string>
 #include <vector>
 
 #include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
 #include "src/table_store/schema/relation.h"
 #include "src/table_store/schema/row_descriptor.h"
 #include "src/table_store/table/table_store.h"
@@ -146,6 +150,133 @@ TEST_F(TableStoreTest, table_id_aliasing) {
   EXPECT_EQ(table->GetTableStats().batches_added, 2);
 }
 
+TEST_F(TableStoreTest, snapshot_and_restore) {
+  px::testing::TempDir snapshot_dir;
+  {
+    auto table_store = TableStore();
+    // Each batch of MakeRel1ColumnWrapperBatch is 27 bytes, so each is compacted on its own.
+    table_store.AddTable(std::make_shared<Table>("a", rel1, 1024, 27), "a", 1);
+    EXPECT_OK(table_store.AddTableAlias(5, "a"));
+    EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+    EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+    EXPECT_OK(table_store.RunCompaction(arrow::default_memory_pool()));
+    // This batch is still in the hot store, so it isn't part of the snapshot.
+    EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+
+    EXPECT_OK(table_store.WriteSnapshot(snapshot_dir.path()));
+    // A second snapshot replaces the first one.
+    EXPECT_OK(table_store.WriteSnapshot(snapshot_dir.path()));
+  }
+  int num_segment_files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(snapshot_dir.path())) {
+    num_segment_files += entry.path().extension() == ".seg";
+  }
+  EXPECT_EQ(1, num_segment_files);
+
+  auto table_store = TableStore();
+  ASSERT_OK(table_store.RestoreSnapshot(snapshot_dir.path()));
+  EXPECT_THAT(table_store.GetTableIDs(), ::testing::UnorderedElementsAre(1, 5));
+  Table* table = table_store.GetTable("a");
+  ASSERT_NE(nullptr, table);
+  EXPECT_EQ(table, table_store.GetTable(5));
+  EXPECT_EQ(rel1, table->GetRelation());
+  EXPECT_EQ(54, table->GetTableStats().cold_bytes);
+
+  Table::Cursor cursor(table);
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({0, 1}));
+    ASSERT_EQ(3, rb->num_rows());
+    EXPECT_EQ(5.0, types::GetValueFromArrowArray<types::DataType::FLOAT64>(
+                       rb->ColumnAt(1).get(), 1));
+  }
+  EXPECT_TRUE(cursor.Done());
+
+  // New data is appended after the restored data.
+  EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+  EXPECT_EQ(81, table->GetTableStats().bytes);
+}
+
+TEST_F(TableStoreTest, incremental_snapshot_reuses_segments) {
+  px::testing::TempDir snapshot_dir;
+  auto segment_files = [&]() {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(snapshot_dir.path())) {
+      if (entry.path().extension() == ".seg") {
+        files.push_back(entry.path().filename().string());
+      }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  };
+  {
+    auto table_store = TableStore();
+    table_store.AddTable(std::make_shared<Table>("a", rel1, 1024, 27), "a", 1);
+    EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+    EXPECT_OK(table_store.RunCompaction(arrow::default_memory_pool()));
+    EXPECT_OK(table_store.WriteSnapshot(snapshot_dir.path()));
+    auto first_files = segment_files();
+    ASSERT_EQ(1, first_files.size());
+
+    // Only the newly compacted batch is written, to a second segment.
+    EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+    EXPECT_OK(table_store.RunCompaction(arrow::default_memory_pool()));
+    EXPECT_OK(table_store.WriteSnapshot(snapshot_dir.path()));
+    auto second_files = segment_files();
+    ASSERT_EQ(2, second_files.size());
+    EXPECT_THAT(second_files, ::testing::Contains(first_files[0]));
+  }
+
+  auto table_store = TableStore();
+  // The table is registered before the restore, so that new batches are compacted on their own.
+  table_store.AddTable(std::make_shared<Table>("a", rel1, 1024, 27), "a", 1);
+  ASSERT_OK(table_store.RestoreSnapshot(snapshot_dir.path()));
+  Table* table = table_store.GetTable("a");
+  ASSERT_NE(nullptr, table);
+  EXPECT_EQ(54, table->GetTableStats().cold_bytes);
+
+  // A snapshot of the restored table adds to the restored segments.
+  EXPECT_OK(table_store.AppendData(1, "", MakeRel1ColumnWrapperBatch()));
+  EXPECT_OK(table_store.RunCompaction(arrow::default_memory_pool()));
+  EXPECT_OK(table_store.WriteSnapshot(snapshot_dir.path()));
+  EXPECT_EQ(3, segment_files().size());
+
+  auto restored_store = TableStore();
+  ASSERT_OK(restored_store.RestoreSnapshot(snapshot_dir.path()));
+  table = restored_store.GetTable("a");
+  ASSERT_NE(nullptr, table);
+  EXPECT_EQ(81, table->GetTableStats().cold_bytes);
+  Table::Cursor cursor(table);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({0, 1}));
+    ASSERT_EQ(3, rb->num_rows());
+  }
+  EXPECT_TRUE(cursor.Done());
+}
+
+TEST_F(TableStoreTest, restore_snapshot_into_registered_tables) {
+  px::testing::TempDir snapshot_dir;
+  {
+    auto table_store = TableStore();
+    table_store.AddTable(std::make_shared<Table>("a", rel1, 1024, 27), "a");
+    table_store.AddTable(std::make_shared<Table>("b", rel1, 1024, 27), "b");
+    EXPECT_OK(table_store.GetTable("a")->TransferRecordBatch(MakeRel1ColumnWrapperBatch()));
+    EXPECT_OK(table_store.GetTable("b")->TransferRecordBatch(MakeRel1ColumnWrapperBatch()));
+    EXPECT_OK(table_store.RunCompaction(arrow::default_memory_pool()));
+    EXPECT_OK(table_store.WriteSnapshot(snapshot_dir.path()));
+  }
+
+  auto table_store = TableStore();
+  table_store.AddTable(table1, "a");
+  // The relation of table b changed, so its data can't be restored.
+  table_store.AddTable(table2, "b");
+  ASSERT_OK(table_store.RestoreSnapshot(snapshot_dir.path()));
+
+  EXPECT_EQ(table1.get(), table_store.GetTable("a"));
+  EXPECT_EQ(27, table1->GetTableStats().bytes);
+  EXPECT_EQ(table2.get(), table_store.GetTable("b"));
+  EXPECT_EQ(0, table2->GetTableStats().bytes);
+}
+
 using TableStoreDeathTest = TableStoreTest;
 TEST_F(TableStoreDeathTest, rewrite_fails) {
   auto table_store = TableStore();
@@ -20,7 +20,9 @@
 #include <arrow/array.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
+#include <unistd.h>
 #include <random>
+#include <thread>
 #include <vector>
 
 #include "src/common/testing/testing.h"
@@ -204,6 +206,233 @@ TEST(TableTest, bytes_test_w_compaction) {
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size + rb3_size);
 }
 
+TEST(TableTest, cold_batch_encoding) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::STRING}, {"time_", "service"});
+  schema::RowDescriptor rd(rel.col_types());
+
+  int64_t num_rows = 1024;
+  std::vector<types::Time64NSValue> times;
+  std::vector<types::StringValue> services;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    times.emplace_back(1000 * i);
+    services.emplace_back(absl::StrCat("service-", i % 4));
+  }
+  auto times_arrow = types::ToArrow(times, arrow::default_memory_pool());
+  auto services_arrow = types::ToArrow(services, arrow::default_memory_pool());
+  schema::RowBatch rb(rd, num_rows);
+  EXPECT_OK(rb.AddColumn(times_arrow));
+  EXPECT_OK(rb.AddColumn(services_arrow));
+  int64_t rb_size = num_rows * (sizeof(int64_t) + sizeof(uint32_t)) + num_rows * 9 * sizeof(char);
+
+  Table table("test_table", rel, 128 * 1024, rb_size);
+  EXPECT_OK(table.WriteRowBatch(rb));
+  EXPECT_EQ(rb_size, table.GetTableStats().bytes);
+
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(0, stats.hot_bytes);
+  // Both columns should be encoded in the cold store, so the batch is accounted as fewer bytes.
+  EXPECT_LT(stats.cold_bytes, rb_size / 2);
+
+  Table::Cursor cursor(&table);
+  auto out_rb = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  EXPECT_TRUE(out_rb->ColumnAt(0)->Equals(times_arrow));
+  EXPECT_TRUE(out_rb->ColumnAt(1)->Equals(services_arrow));
+
+  Table::Cursor time_cursor(&table,
+                            Table::Cursor::StartSpec{Table::Cursor::StartSpec::StartAtTime, 1500},
+                            Table::Cursor::StopSpec{});
+  out_rb = time_cursor.GetNextRowBatch({1}).ConsumeValueOrDie();
+  EXPECT_TRUE(out_rb->ColumnAt(0)->Equals(services_arrow->Slice(2)));
+}
+
+TEST(TableTest, late_materialization_cursor) {
+  schema::Relation rel({types::DataType::BOOLEAN, types::DataType::INT64}, {"col1", "col2"});
+  std::shared_ptr<Table> table_ptr = Table::Create("table_name", rel);
+
+  for (const auto& [col1, col2] :
+       std::vector<std::pair<std::vector<types::BoolValue>, std::vector<types::Int64Value>>>{
+           {{true, false, true}, {1, 2, 3}}, {{false, false}, {5, 6}}}) {
+    auto rb_wrapper = std::make_unique<types::ColumnWrapperRecordBatch>();
+    rb_wrapper->push_back(
+        types::ColumnWrapper::FromArrow(types::ToArrow(col1, arrow::default_memory_pool())));
+    rb_wrapper->push_back(
+        types::ColumnWrapper::FromArrow(types::ToArrow(col2, arrow::default_memory_pool())));
+    EXPECT_OK(table_ptr->TransferRecordBatch(std::move(rb_wrapper)));
+  }
+
+  // Select the rows with an odd col2.
+  Table::Cursor cursor(table_ptr.get());
+  cursor.SetLateMaterialization(Table::LateMaterialization{
+      {1}, [](const schema::RowBatch& predicate_rb) -> StatusOr<std::vector<int64_t>> {
+        EXPECT_EQ(1, predicate_rb.num_columns());
+        auto* col2 = predicate_rb.ColumnAt(0).get();
+        std::vector<int64_t> rows;
+        for (int64_t i = 0; i < predicate_rb.num_rows(); ++i) {
+          if (types::GetValueFromArrowArray<types::DataType::INT64>(col2, i) % 2 == 1) {
+            rows.push_back(i);
+          }
+        }
+        return rows;
+      }});
+
+  auto rb1 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  ASSERT_EQ(2, rb1->num_rows());
+  std::vector<types::BoolValue> col1_out1 = {true, true};
+  std::vector<types::Int64Value> col2_out1 = {1, 3};
+  EXPECT_TRUE(rb1->ColumnAt(0)->Equals(types::ToArrow(col1_out1, arrow::default_memory_pool())));
+  EXPECT_TRUE(rb1->ColumnAt(1)->Equals(types::ToArrow(col2_out1, arrow::default_memory_pool())));
+
+  auto rb2 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+  ASSERT_EQ(1, rb2->num_rows());
+  std::vector<types::BoolValue> col1_out2 = {false};
+  std::vector<types::Int64Value> col2_out2 = {5};
+  EXPECT_TRUE(rb2->ColumnAt(0)->Equals(types::ToArrow(col1_out2, arrow::default_memory_pool())));
+  EXPECT_TRUE(rb2->ColumnAt(1)->Equals(types::ToArrow(col2_out2, arrow::default_memory_pool())));
+  EXPECT_TRUE(cursor.Done());
+}
+
+TEST(TableTest, late_materialization_runs_without_table_locks) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "col2"});
+  Table table("test_table", rel, 128 * 1024, /*compacted_batch_size*/ 1);
+  auto write_batch = [&table](int64_t time) {
+    schema::RowBatch rb(schema::RowDescriptor({types::DataType::TIME64NS, types::DataType::INT64}),
+                        1);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(std::vector<types::Time64NSValue>{time},
+                                          arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(
+        types::ToArrow(std::vector<types::Int64Value>{time}, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+  };
+  write_batch(1);
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  write_batch(2);
+  EXPECT_GT(table.GetTableStats().hot_bytes, 0);
+
+  // The predicates of a late materialization run after the cursor released the table's locks, so
+  // they can't block (or deadlock with) writers or other readers of the table.
+  Table::Cursor cursor(&table);
+  int64_t next_time = 3;
+  cursor.SetLateMaterialization(Table::LateMaterialization{
+      {1}, [&](const schema::RowBatch&) -> StatusOr<std::vector<int64_t>> {
+        write_batch(next_time++);
+        table.GetTableStats();
+        return std::vector<int64_t>{0};
+      }});
+
+  // The first batch is read from the cold store, the second one from the hot store.
+  for (int64_t time : {1, 2}) {
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({1}));
+    ASSERT_EQ(1, rb->num_rows());
+    EXPECT_EQ(time,
+              types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(0).get(), 0));
+  }
+}
+
+TEST(TableTest, predicate_cursor_skips_cold_batches) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64, types::DataType::STRING},
+                       {"time_", "latency", "service"});
+  schema::RowDescriptor rd(rel.col_types());
+
+  int64_t num_batches = 4;
+  int64_t rows_per_batch = 100;
+  // Each row has 8 bytes of time and latency each, and a 4 byte offset plus 5 chars of service.
+  int64_t rb_size = rows_per_batch * (2 * sizeof(int64_t) + sizeof(uint32_t) + 5 * sizeof(char));
+  Table table("test_table", rel, 128 * 1024, rb_size);
+  for (int64_t batch_idx = 0; batch_idx < num_batches; ++batch_idx) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> latencies;
+    std::vector<types::StringValue> services;
+    for (int64_t i = 0; i < rows_per_batch; ++i) {
+      times.emplace_back(batch_idx * rows_per_batch + i);
+      latencies.emplace_back(batch_idx * 1000 + i);
+      services.emplace_back(absl::StrCat("svc-", batch_idx));
+    }
+    schema::RowBatch rb(rd, rows_per_batch);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(latencies, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(services, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+  }
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_EQ(0, table.GetTableStats().hot_bytes);
+
+  using Op = Table::ColumnPredicate::Op;
+  Table::Cursor latency_cursor(
+      &table, Table::Cursor::StartSpec{}, Table::Cursor::StopSpec{},
+      Table::Cursor::PredicateSpec{{{1, Op::kGreaterThanEqual, int64_t{2050}}}});
+  auto out_rb = latency_cursor.GetNextRowBatch({1}).ConsumeValueOrDie();
+  ASSERT_EQ(rows_per_batch, out_rb->num_rows());
+  EXPECT_EQ(2000,
+            types::GetValueFromArrowArray<types::DataType::INT64>(out_rb->ColumnAt(0).get(), 0));
+  EXPECT_EQ(2, latency_cursor.BatchesSkipped());
+  out_rb = latency_cursor.GetNextRowBatch({1}).ConsumeValueOrDie();
+  ASSERT_EQ(rows_per_batch, out_rb->num_rows());
+  EXPECT_TRUE(latency_cursor.Done());
+
+  Table::Cursor service_cursor(
+      &table, Table::Cursor::StartSpec{}, Table::Cursor::StopSpec{},
+      Table::Cursor::PredicateSpec{{{2, Op::kEqual, std::string("svc-1")}}});
+  out_rb = service_cursor.GetNextRowBatch({2}).ConsumeValueOrDie();
+  ASSERT_EQ(rows_per_batch, out_rb->num_rows());
+  EXPECT_EQ("svc-1", types::GetValueFromArrowArray<types::DataType::STRING>(
+                         out_rb->ColumnAt(0).get(), 0));
+  // The remaining batches can't match, so the cursor skips to the end with an empty batch.
+  out_rb = service_cursor.GetNextRowBatch({2}).ConsumeValueOrDie();
+  EXPECT_EQ(0, out_rb->num_rows());
+  EXPECT_TRUE(service_cursor.Done());
+  EXPECT_EQ(3, service_cursor.BatchesSkipped());
+}
+
+TEST(TableTest, disk_tier_keeps_expired_cold_batches) {
+  // Encoding changes the size of cold batches in memory, and with it which batches are expired.
+  FLAGS_table_store_cold_batch_encoding = false;
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "latency"});
+  schema::RowDescriptor rd(rel.col_types());
+
+  int64_t rows_per_batch = 100;
+  int64_t rb_size = rows_per_batch * 2 * sizeof(int64_t);
+  int64_t page_size = sysconf(_SC_PAGESIZE);
+  Table table("test_table", rel, 3 * rb_size, rb_size);
+  px::testing::TempDir temp_dir;
+  // Each batch takes up a single page of its segment file, so the disk tier holds two batches.
+  ASSERT_OK(table.EnableDiskTier(temp_dir.path() / "test_table", 2 * page_size));
+
+  for (int64_t batch_idx = 0; batch_idx < 6; ++batch_idx) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> latencies;
+    for (int64_t i = 0; i < rows_per_batch; ++i) {
+      times.emplace_back(batch_idx * rows_per_batch + i);
+      latencies.emplace_back(batch_idx * 1000 + i);
+    }
+    schema::RowBatch rb(rd, rows_per_batch);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(latencies, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+    EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  }
+
+  // Batches 0, 1 and 2 were expired from memory, and batch 0 was then expired from disk.
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(3, stats.batches_expired);
+  EXPECT_EQ(3 * rb_size, stats.bytes);
+  EXPECT_EQ(2 * page_size, stats.disk_bytes);
+  EXPECT_EQ(5, stats.num_batches);
+  EXPECT_EQ(100, stats.min_time);
+  EXPECT_EQ(150, table.FindRowIDFromTimeFirstGreaterThanOrEqual(150));
+
+  // Cursors read from the disk tier into the batches in memory.
+  Table::Cursor cursor(&table);
+  for (int64_t batch_idx = 1; batch_idx < 6; ++batch_idx) {
+    ASSERT_OK_AND_ASSIGN(auto out_rb, cursor.GetNextRowBatch({1}));
+    ASSERT_EQ(rows_per_batch, out_rb->num_rows());
+    EXPECT_EQ(batch_idx * 1000,
+              types::GetValueFromArrowArray<types::DataType::INT64>(out_rb->ColumnAt(0).get(), 0));
+  }
+  EXPECT_TRUE(cursor.Done());
+  FLAGS_table_store_cold_batch_encoding = true;
+}
+
 TEST(TableTest, expiry_test) {
   auto rd = schema::RowDescriptor({types::DataType::INT64, types::DataType::STRING});
   schema::Relation rel(rd.types(), {"col1", "col2"});
@@ -864,9 +1093,205 @@ TEST(TableTest, threaded) {
   reader_thread.join();
 }
 
+TEST(TableTest, threaded_multiple_writers) {
+  schema::Relation rel({types::DataType::INT64, types::DataType::INT64}, {"writer", "seq"});
+  std::shared_ptr<Table> table_ptr =
+      std::make_shared<Table>("test_table", rel, 8 * 1024 * 1024, 5 * 1024);
+
+  const int num_writers = 4;
+  const int64_t num_batches = 200;
+  const int64_t batch_size = 100;
+
+  absl::Notification done;
+  std::thread compaction_thread([table_ptr, &done]() {
+    while (!done.WaitForNotificationWithTimeout(absl::Milliseconds(1))) {
+      EXPECT_OK(table_ptr->CompactHotToCold(arrow::default_memory_pool()));
+    }
+  });
+
+  std::vector<std::thread> writer_threads;
+  for (int writer = 0; writer < num_writers; ++writer) {
+    writer_threads.emplace_back([table_ptr, writer, num_batches, batch_size]() {
+      int64_t seq = 0;
+      for (int64_t i = 0; i < num_batches; ++i) {
+        std::vector<types::Int64Value> writer_col(batch_size, writer);
+        std::vector<types::Int64Value> seq_col;
+        for (int64_t row_idx = 0; row_idx < batch_size; ++row_idx) {
+          seq_col.emplace_back(seq++);
+        }
+        auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+        auto writer_wrapper = std::make_shared<types::Int64ValueColumnWrapper>(batch_size);
+        writer_wrapper->Clear();
+        writer_wrapper->AppendFromVector(writer_col);
+        auto seq_wrapper = std::make_shared<types::Int64ValueColumnWrapper>(batch_size);
+        seq_wrapper->Clear();
+        seq_wrapper->AppendFromVector(seq_col);
+        wrapper_batch->push_back(writer_wrapper);
+        wrapper_batch->push_back(seq_wrapper);
+        EXPECT_OK(table_ptr->TransferRecordBatch(std::move(wrapper_batch)));
+      }
+    });
+  }
+  for (auto& writer_thread : writer_threads) {
+    writer_thread.join();
+  }
+  done.Notify();
+  compaction_thread.join();
+  EXPECT_OK(table_ptr->CompactHotToCold(arrow::default_memory_pool()));
+
+  // Every row is in the table exactly once, and the rows of each writer are in the order they were
+  // written.
+  std::vector<int64_t> next_seq(num_writers, 0);
+  Table::Cursor cursor(table_ptr.get());
+  while (!cursor.Done()) {
+    auto batch = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
+    auto writer_col = std::static_pointer_cast<arrow::Int64Array>(batch->ColumnAt(0));
+    auto seq_col = std::static_pointer_cast<arrow::Int64Array>(batch->ColumnAt(1));
+    for (int64_t i = 0; i < batch->num_rows(); ++i) {
+      ASSERT_EQ(next_seq[writer_col->Value(i)]++, seq_col->Value(i));
+    }
+  }
+  for (int writer = 0; writer < num_writers; ++writer) {
+    EXPECT_EQ(num_batches * batch_size, next_seq[writer]);
+  }
+
+  auto stats = table_ptr->GetTableStats();
+  EXPECT_EQ(num_writers * num_batches, stats.batches_added);
+  // Each row is two int64 values.
+  EXPECT_EQ(num_writers * num_batches * batch_size * 16, stats.bytes_added);
+  EXPECT_LT(stats.hot_bytes, 5 * 1024);
+}
+
 // This test was add when `NextBatch` and `BatchSlice`'s were still around, and there was a bug with
 // generation handling of `BatchSlice`'s. Maintaining so as not to decrease test coverage, but this
 // bug should no longer even be plausible.
+class RecordingCompactionObserver : public CompactionObserver {
+ public:
+  Status OnCompactedBatch(const schema::RowBatch& rb) override {
+    for (int64_t i = 0; i < rb.num_rows(); ++i) {
+      values.push_back(types::GetValueFromArrowArray<types::DataType::INT64>(
+          rb.ColumnAt(0).get(), i));
+    }
+    return Status::OK();
+  }
+
+  std::vector<int64_t> values;
+};
+
+TEST(TableTest, compaction_observer_sees_compacted_rows) {
+  schema::Relation rel({types::DataType::INT64}, {"col1"});
+  Table table("test_table", rel, 128 * 1024, 4 * sizeof(int64_t));
+  auto observer = std::make_shared<RecordingCompactionObserver>();
+  table.AddCompactionObserver(observer);
+
+  for (int64_t i = 0; i < 3; ++i) {
+    auto rb = schema::RowBatch(schema::RowDescriptor(rel.col_types()), 3);
+    std::vector<types::Int64Value> col = {3 * i, 3 * i + 1, 3 * i + 2};
+    ASSERT_OK(rb.AddColumn(types::ToArrow(col, arrow::default_memory_pool())));
+    ASSERT_OK(table.WriteRowBatch(rb));
+  }
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+
+  // Only the rows of full cold batches are compacted, the last row stays in the hot store.
+  EXPECT_THAT(observer->values, ::testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Adds another observer to the table when it's first called, which takes the table's compaction
+// lock.
+class AddingCompactionObserver : public CompactionObserver {
+ public:
+  AddingCompactionObserver(Table* table, std::shared_ptr<CompactionObserver> observer)
+      : table_(table), observer_(std::move(observer)) {}
+
+  Status OnCompactedBatch(const schema::RowBatch&) override {
+    if (observer_ != nullptr) {
+      table_->AddCompactionObserver(std::move(observer_));
+      observer_ = nullptr;
+    }
+    return Status::OK();
+  }
+
+ private:
+  Table* table_;
+  std::shared_ptr<CompactionObserver> observer_;
+};
+
+TEST(TableTest, compaction_observer_runs_between_batches) {
+  schema::Relation rel({types::DataType::INT64}, {"col1"});
+  Table table("test_table", rel, 128 * 1024, 4 * sizeof(int64_t));
+  auto observer = std::make_shared<RecordingCompactionObserver>();
+  table.AddCompactionObserver(std::make_shared<AddingCompactionObserver>(&table, observer));
+
+  for (int64_t i = 0; i < 3; ++i) {
+    auto rb = schema::RowBatch(schema::RowDescriptor(rel.col_types()), 3);
+    std::vector<types::Int64Value> col = {3 * i, 3 * i + 1, 3 * i + 2};
+    ASSERT_OK(rb.AddColumn(types::ToArrow(col, arrow::default_memory_pool())));
+    ASSERT_OK(table.WriteRowBatch(rb));
+  }
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+
+  // The observers are called without the compaction lock, and before the next batch is compacted,
+  // so the added observer sees the second batch.
+  EXPECT_THAT(observer->values, ::testing::ElementsAre(4, 5, 6, 7));
+}
+
+TEST(TableTest, writes_dont_wait_for_compaction_to_expire) {
+  schema::Relation rel({types::DataType::INT64}, {"col1"});
+  const int64_t batch_rows = 16;
+  const int64_t batch_bytes = batch_rows * sizeof(int64_t);
+  const int64_t max_table_size = 32 * batch_bytes;
+  Table table("test_table", rel, max_table_size, 4 * batch_bytes);
+  auto write_batch = [&table, batch_rows](int64_t value) {
+    auto rb = schema::RowBatch(schema::RowDescriptor({types::DataType::INT64}), batch_rows);
+    std::vector<types::Int64Value> col(batch_rows, value);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(col, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+  };
+
+  absl::Notification done;
+  std::thread compaction_thread([&table, &done]() {
+    while (!done.HasBeenNotified()) {
+      EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+    }
+  });
+  // Writes that find the oldest hot batches being compacted skip expiring them, rather than
+  // waiting for the compaction.
+  for (int64_t i = 0; i < 10000; ++i) {
+    write_batch(i);
+  }
+  done.Notify();
+  compaction_thread.join();
+
+  // Once nothing is compacted, a write expires batches until the table is within its limit again.
+  write_batch(10000);
+  auto stats = table.GetTableStats();
+  EXPECT_GT(stats.batches_expired, 0);
+  EXPECT_LE(stats.hot_bytes + stats.cold_bytes, max_table_size);
+}
+
+TEST(TableTest, allocated_bytes_accounting) {
+  FLAGS_table_store_account_allocated_bytes = true;
+  schema::Relation rel({types::DataType::INT64}, {"col1"});
+  int64_t max_table_size = 4 * 1024;
+  Table table("test_table", rel, max_table_size, 10 * sizeof(int64_t));
+  for (int64_t i = 0; i < 100; ++i) {
+    auto rb = schema::RowBatch(schema::RowDescriptor(rel.col_types()), 10);
+    std::vector<types::Int64Value> col(10, i);
+    ASSERT_OK(rb.AddColumn(types::ToArrow(col, arrow::default_memory_pool())));
+    ASSERT_OK(table.WriteRowBatch(rb));
+    ASSERT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  }
+
+  auto stats = table.GetTableStats();
+  EXPECT_GT(stats.batches_expired, 0);
+  EXPECT_EQ(0, stats.hot_bytes);
+  // Cold batches are accounted as the memory they take up in the table's pool, so the pool stays
+  // within the table's size limit.
+  EXPECT_EQ(stats.memory_pool_bytes, stats.cold_bytes);
+  EXPECT_LE(stats.bytes, max_table_size);
+  FLAGS_table_store_account_allocated_bytes = false;
+}
+
 TEST(TableTest, NextBatch_generation_bug) {
   auto rd = schema::RowDescriptor({types::DataType::INT64, types::DataType::STRING});
   schema::Relation rel(rd.types(), {"col1", "col2"});
@@ -65,6 +65,16 @@ DEFINE_string(vizier_id, gflags::StringFromEnv("PL_VIZIER_ID", ""), "The ID of t
 DEFINE_string(vizier_name, gflags::StringFromEnv("PL_VIZIER_NAME", ""),
               "The name of the cluster according to vizier.");
 
+DEFINE_int32(table_store_compaction_threads,
+             gflags::Int32FromEnv("PL_TABLE_STORE_COMPACTION_THREADS", 2),
+             "The number of threads that compact the tables of the table store.");
+
+DEFINE_int32(table_store_compaction_cpu_budget_ms,
+             gflags::Int32FromEnv("PL_TABLE_STORE_COMPACTION_CPU_BUDGET_MS", 10 * 1000),
+             "The CPU time that all compaction threads together can spend on a single table "
+             "store compaction cycle. Tables that aren't fully compacted within the budget are "
+             "compacted in the next cycle.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -335,12 +345,19 @@ Status Manager::PostRegisterHook(uint32_t asid) {
     PL_RETURN_IF_ERROR(metrics_nats_connector_->Connect(dispatcher_.get()));
   }
 
+  // TODO(james): when we change ExecState::exec_mem_pool to not return just the default pool, we
+  // will need to figure out how to use the correct memory pool here, but for now we can just use
+  // the default pool.
+  compaction_scheduler_ = std::make_unique<table_store::CompactionScheduler>(
+      FLAGS_table_store_compaction_threads,
+      std::chrono::milliseconds(FLAGS_table_store_compaction_cpu_budget_ms),
+      arrow::default_memory_pool());
   tablestore_compaction_timer_ = dispatcher()->CreateTimer([this]() {
-    // TODO(james): when we change ExecState::exec_mem_pool to not return just the default pool, we
-    // will need to figure out how to use the correct memory pool here, but for now we can just use
-    // the default pool.
-    auto status = table_store()->RunCompaction(arrow::default_memory_pool());
-    LOG_IF(ERROR, !status.ok()) << status.msg();
+    // The table store isn't thread safe, so its tables are listed on the dispatcher thread, and
+    // only compacted on the scheduler's threads.
+    if (!compaction_scheduler_->StartCycle(table_store()->GetTables())) {
+      LOG(WARNING) << "Previous table store compaction cycle is still running, skipping cycle.";
+    }
     if (tablestore_compaction_timer_) {
       tablestore_compaction_timer_->EnableTimer(kTableStoreCompactionPeriod);
     }
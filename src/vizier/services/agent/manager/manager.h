@@ -32,6 +32,7 @@
 #include "src/common/metrics/memory_metrics.h"
 #include "src/common/uuid/uuid.h"
 #include "src/shared/metadata/metadata.h"
+#include "src/table_store/table/compaction_scheduler.h"
 #include "src/vizier/funcs/context/vizier_context.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/chan_cache.h"
@@ -237,6 +238,8 @@ class Manager : public px::NotCopyable {
 
   // Timer to manage table store compaction.
   px::event::TimerUPtr tablestore_compaction_timer_;
+  // Compacts the table store's tables on a pool of worker threads, started by the timer above.
+  std::unique_ptr<table_store::CompactionScheduler> compaction_scheduler_;
 
   px::metrics::MemoryMetrics memory_metrics_;
   // Timer to collect MemoryMetrics for this agent.
@@ -18,6 +18,10 @@
 
 #include "src/vizier/services/agent/pem/pem_manager.h"
 
+#include <absl/strings/substitute.h>
+#include <absl/time/time.h>
+
+#include "src/carnot/exec/rollup_table.h"
 #include "src/common/system/config.h"
 #include "src/vizier/services/agent/manager/exec.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -43,6 +47,26 @@ DEFINE_int32(table_store_proc_exit_events_limit_bytes,
              gflags::Int32FromEnv("PL_TABLE_STORE_PROC_EXIT_EVENTS_LIMIT_BYTES", 10 * 1024 * 1024),
              "The maximum amount of data to store in the proc_exit_events table.");
 
+DEFINE_string(table_store_snapshot_dir, gflags::StringFromEnv("PL_TABLE_STORE_SNAPSHOT_DIR", ""),
+              "The directory to periodically snapshot the table store to, so that its data can be "
+              "restored when the PEM restarts. Snapshots are disabled if empty.");
+
+DEFINE_int32(table_store_snapshot_period_s,
+             gflags::Int32FromEnv("PL_TABLE_STORE_SNAPSHOT_PERIOD_S", 60),
+             "The period in seconds between snapshots of the table store.");
+
+DEFINE_string(table_store_rollups, gflags::StringFromEnv("PL_TABLE_STORE_ROLLUPS", ""),
+              "Rollup tables to maintain as the source tables are compacted, separated by ';'. "
+              "Each is <rollup_table>:<source_table>:<bucket_size>:<allowed_lateness>"
+              "[:<group_by>:<aggregates>], for example "
+              "'http_events_10s:http_events:10s:5s:service:latency=mean(latency_ns)'. A rollup "
+              "without group by columns and aggregates rolls up an earlier rollup into coarser "
+              "buckets. See carnot::exec::ParseRollupSpecs.");
+
+DEFINE_int32(table_store_rollup_table_limit_bytes,
+             gflags::Int32FromEnv("PL_TABLE_STORE_ROLLUP_TABLE_LIMIT_BYTES", 16 * 1024 * 1024),
+             "The maximum amount of data to store in each rollup table.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -66,6 +90,8 @@ Status PEMManager::PostRegisterHookImpl() {
       std::bind(&px::md::AgentMetadataStateManager::CurrentAgentMetadataState, mds_manager()));
 
   PL_RETURN_IF_ERROR(InitSchemas());
+  PL_RETURN_IF_ERROR(InitRollups());
+  RestoreTableStoreSnapshot();
   PL_RETURN_IF_ERROR(stirling_->RunAsThread());
 
   auto execute_query_handler = std::make_shared<ExecuteQueryMessageHandler>(
@@ -84,6 +110,12 @@ Status PEMManager::PostRegisterHookImpl() {
 Status PEMManager::StopImpl(std::chrono::milliseconds) {
   stirling_->Stop();
   stirling_.reset();
+  if (table_store_snapshot_timer_) {
+    table_store_snapshot_timer_->DisableTimer();
+    table_store_snapshot_timer_.reset();
+    // Take a final snapshot now that no more data is being pushed into the table store.
+    WriteTableStoreSnapshot();
+  }
   return Status::OK();
 }
 
@@ -130,6 +162,26 @@ Status PEMManager::InitSchemas() {
   return Status::OK();
 }
 
+Status PEMManager::InitRollups() {
+  if (FLAGS_table_store_rollups.empty()) {
+    return Status::OK();
+  }
+  PL_ASSIGN_OR_RETURN(auto specs, carnot::exec::ParseRollupSpecs(
+                                      FLAGS_table_store_rollups,
+                                      FLAGS_table_store_rollup_table_limit_bytes));
+  PL_ASSIGN_OR_RETURN(auto rollups, carnot::exec::CreateRollupTables(specs, table_store(),
+                                                                     carnot()->FuncRegistry()));
+  for (const auto& [i, rollup] : Enumerate(rollups)) {
+    // Rollup tables are only written to by their rollups, not by Stirling, so they don't need an
+    // ID.
+    auto desc = absl::Substitute("Rollup of $0 into $1 buckets.", specs[i].source_table,
+                                 absl::FormatDuration(absl::FromChrono(specs[i].bucket_size)));
+    RelationInfo relation_info(specs[i].rollup_table, /*id*/ 0, desc, rollup->relation());
+    PL_RETURN_IF_ERROR(relation_info_manager()->AddRelationInfo(std::move(relation_info)));
+  }
+  return Status::OK();
+}
+
 Status PEMManager::InitClockConverters() {
   clock_converter_timer_ = dispatcher()->CreateTimer([this]() {
     auto clock_converter = px::system::Config::GetInstance().clock_converter();
@@ -160,6 +212,29 @@ void PEMManager::StartNodeMemoryCollector() {
   node_memory_timer_->EnableTimer(kNodeMemoryCollectionPeriod);
 }
 
+void PEMManager::RestoreTableStoreSnapshot() {
+  if (FLAGS_table_store_snapshot_dir.empty()) {
+    return;
+  }
+  auto s = table_store()->RestoreSnapshot(FLAGS_table_store_snapshot_dir);
+  LOG_IF(ERROR, !s.ok()) << "Failed to restore table store snapshot: " << s.msg();
+
+  table_store_snapshot_timer_ = dispatcher()->CreateTimer([this]() {
+    WriteTableStoreSnapshot();
+    if (table_store_snapshot_timer_) {
+      table_store_snapshot_timer_->EnableTimer(
+          std::chrono::seconds(FLAGS_table_store_snapshot_period_s));
+    }
+  });
+  table_store_snapshot_timer_->EnableTimer(
+      std::chrono::seconds(FLAGS_table_store_snapshot_period_s));
+}
+
+void PEMManager::WriteTableStoreSnapshot() {
+  auto s = table_store()->WriteSnapshot(FLAGS_table_store_snapshot_dir);
+  LOG_IF(ERROR, !s.ok()) << "Failed to write table store snapshot: " << s.msg();
+}
+
 }  // namespace agent
 }  // namespace vizier
 }  // namespace px
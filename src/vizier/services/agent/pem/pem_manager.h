@@ -81,8 +81,14 @@ class PEMManager : public Manager {
 
  private:
   Status InitSchemas();
+  // Creates the rollup tables declared by --table_store_rollups, once their source tables exist.
+  Status InitRollups();
   Status InitClockConverters();
   void StartNodeMemoryCollector();
+  // Restores the table store from the snapshot directory, if set, and starts snapshotting the
+  // table store periodically.
+  void RestoreTableStoreSnapshot();
+  void WriteTableStoreSnapshot();
   static services::shared::agent::AgentCapabilities Capabilities() {
     services::shared::agent::AgentCapabilities capabilities;
     capabilities.set_collects_data(true);
@@ -96,6 +102,8 @@ class PEMManager : public Manager {
   px::event::TimerUPtr clock_converter_timer_;
   // Timer for collecting info about the node's available memory.
   px::event::TimerUPtr node_memory_timer_;
+  // Timer for periodically snapshotting the table store.
+  px::event::TimerUPtr table_store_snapshot_timer_;
   prometheus::Gauge& node_available_memory_;
   prometheus::Gauge& node_total_memory_;
 };